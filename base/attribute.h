@@ -161,6 +161,9 @@ class AttributeQualifierPattern final {
 
   bool IsWildcard() const { return !value_.has_value(); }
 
+  // The qualifier matched by this pattern, or empty for wildcards.
+  const std::optional<AttributeQualifier>& qualifier() const { return value_; }
+
   bool IsMatch(const AttributeQualifier& qualifier) const {
     if (IsWildcard()) return true;
     return value_.value() == qualifier;
@@ -15,11 +15,9 @@
 #ifndef THIRD_PARTY_CEL_CPP_BASE_ATTRIBUTE_SET_H_
 #define THIRD_PARTY_CEL_CPP_BASE_ATTRIBUTE_SET_H_
 
-#include <vector>
-
-#include "absl/container/btree_set.h"
 #include "absl/types/span.h"
 #include "base/attribute.h"
+#include "base/internal/shared_sorted_set.h"
 
 namespace google::api::expr::runtime {
 class AttributeUtility;
@@ -34,9 +32,12 @@ class UnknownSet;
 
 // AttributeSet is a container for CEL attributes that are identified as
 // unknown during expression evaluation.
+//
+// Copies share storage, so passing sets between unknown values and merging
+// with an empty set or a subset are cheap.
 class AttributeSet final {
  private:
-  using Container = absl::btree_set<Attribute>;
+  using Container = base_internal::SharedSortedSet<Attribute>;
 
  public:
   using value_type = typename Container::value_type;
@@ -50,17 +51,13 @@ class AttributeSet final {
   AttributeSet& operator=(const AttributeSet&) = default;
   AttributeSet& operator=(AttributeSet&&) = default;
 
-  explicit AttributeSet(absl::Span<const Attribute> attributes) {
-    for (const auto& attr : attributes) {
-      Add(attr);
-    }
-  }
+  explicit AttributeSet(absl::Span<const Attribute> attributes)
+      : attributes_(
+            Container::FromRange(attributes.begin(), attributes.end())) {}
 
   AttributeSet(const AttributeSet& set1, const AttributeSet& set2)
       : attributes_(set1.attributes_) {
-    for (const auto& attr : set2.attributes_) {
-      Add(attr);
-    }
+    attributes_.insert(set2.attributes_);
   }
 
   iterator begin() const { return attributes_.begin(); }
@@ -95,11 +92,7 @@ class AttributeSet final {
 
   void Add(const Attribute& attribute) { attributes_.insert(attribute); }
 
-  void Add(const AttributeSet& other) {
-    for (const auto& attribute : other) {
-      Add(attribute);
-    }
-  }
+  void Add(const AttributeSet& other) { attributes_.insert(other.attributes_); }
 
   // Attribute container.
   Container attributes_;
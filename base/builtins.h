@@ -63,6 +63,9 @@ constexpr char kInDeprecated[] = "_in_";
 constexpr char kInFunction[] = "in";
 constexpr char kIndex[] = "_[_]";
 constexpr char kSize[] = "size";
+// Internal function used by map-building comprehensions (e.g. the
+// `transformMap` macro) to add entries to the accumulator.
+constexpr char kMapInsert[] = "cel.@mapInsert";
 
 constexpr char kTernary[] = "_?_:_";
 
@@ -0,0 +1,153 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_BASE_INTERNAL_SHARED_SORTED_SET_H_
+#define THIRD_PARTY_CEL_CPP_BASE_INTERNAL_SHARED_SORTED_SET_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+#include "absl/container/inlined_vector.h"
+
+namespace cel::base_internal {
+
+// Ordered set backing AttributeSet and FunctionResultSet.
+//
+// Elements are kept sorted and unique (by `operator<`) in a small inline
+// vector that is shared between copies, so copying a set or taking the union
+// with an empty set or a subset does not allocate. Mutations copy the storage
+// first if it is shared.
+template <typename T>
+class SharedSortedSet final {
+ private:
+  // Most unknown sets hold a single attribute or function result; keeping a
+  // couple inline lets the storage and its elements share one allocation.
+  using Storage = absl::InlinedVector<T, 2>;
+
+ public:
+  using value_type = T;
+  using size_type = size_t;
+  using iterator = typename Storage::const_iterator;
+  using const_iterator = typename Storage::const_iterator;
+  using storage_type = Storage;
+
+  // Builds a set from the elements in `[first, last)`, in any order. Sorts a
+  // single copy instead of inserting one element at a time.
+  template <typename InputIt>
+  static SharedSortedSet FromRange(InputIt first, InputIt last) {
+    Storage storage(first, last);
+    std::sort(storage.begin(), storage.end());
+    storage.erase(std::unique(storage.begin(), storage.end(),
+                              [](const T& lhs, const T& rhs) {
+                                return !(lhs < rhs) && !(rhs < lhs);
+                              }),
+                  storage.end());
+    return AdoptSorted(std::move(storage));
+  }
+
+  // Adopts `storage`, whose elements must already be sorted and unique.
+  static SharedSortedSet AdoptSorted(Storage storage) {
+    SharedSortedSet set;
+    if (!storage.empty()) {
+      set.rep_ = std::make_shared<Storage>(std::move(storage));
+    }
+    return set;
+  }
+
+  SharedSortedSet() = default;
+  SharedSortedSet(const SharedSortedSet&) = default;
+  SharedSortedSet(SharedSortedSet&&) = default;
+  SharedSortedSet& operator=(const SharedSortedSet&) = default;
+  SharedSortedSet& operator=(SharedSortedSet&&) = default;
+
+  iterator begin() const {
+    return rep_ != nullptr ? rep_->begin() : const_iterator();
+  }
+
+  const_iterator cbegin() const { return begin(); }
+
+  iterator end() const {
+    return rep_ != nullptr ? rep_->end() : const_iterator();
+  }
+
+  const_iterator cend() const { return end(); }
+
+  size_type size() const { return rep_ != nullptr ? rep_->size() : 0; }
+
+  bool empty() const { return size() == 0; }
+
+  // Inserts `value` if no equivalent element is present. Returns whether the
+  // set changed.
+  bool insert(const T& value) {
+    if (rep_ == nullptr) {
+      rep_ = std::make_shared<Storage>();
+      rep_->push_back(value);
+      return true;
+    }
+    auto it = std::lower_bound(rep_->begin(), rep_->end(), value);
+    if (it != rep_->end() && !(value < *it)) {
+      return false;
+    }
+    size_t pos = std::distance(rep_->begin(), it);
+    Storage& storage = MutableStorage();
+    storage.insert(storage.begin() + pos, value);
+    return true;
+  }
+
+  // Inserts every element of `other`, sharing its storage where possible.
+  void insert(const SharedSortedSet& other) {
+    if (other.empty() || rep_ == other.rep_) {
+      return;
+    }
+    if (empty() || std::includes(other.begin(), other.end(), begin(), end())) {
+      rep_ = other.rep_;
+      return;
+    }
+    if (std::includes(begin(), end(), other.begin(), other.end())) {
+      return;
+    }
+    auto merged = std::make_shared<Storage>();
+    merged->reserve(size() + other.size());
+    std::set_union(begin(), end(), other.begin(), other.end(),
+                   std::back_inserter(*merged));
+    rep_ = std::move(merged);
+  }
+
+  bool operator==(const SharedSortedSet& other) const {
+    return rep_ == other.rep_ || (size() == other.size() &&
+                                  std::equal(begin(), end(), other.begin()));
+  }
+
+  bool operator!=(const SharedSortedSet& other) const {
+    return !operator==(other);
+  }
+
+ private:
+  Storage& MutableStorage() {
+    if (rep_.use_count() != 1) {
+      rep_ = std::make_shared<Storage>(*rep_);
+    }
+    return *rep_;
+  }
+
+  // Null when empty.
+  std::shared_ptr<Storage> rep_;
+};
+
+}  // namespace cel::base_internal
+
+#endif  // THIRD_PARTY_CEL_CPP_BASE_INTERNAL_SHARED_SORTED_SET_H_
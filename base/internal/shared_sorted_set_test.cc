@@ -0,0 +1,136 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "base/internal/shared_sorted_set.h"
+
+#include <vector>
+
+#include "internal/testing.h"
+
+namespace cel::base_internal {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+TEST(SharedSortedSet, Empty) {
+  SharedSortedSet<int> set;
+
+  EXPECT_TRUE(set.empty());
+  EXPECT_EQ(set.size(), 0);
+  EXPECT_THAT(set, IsEmpty());
+  EXPECT_EQ(set, SharedSortedSet<int>());
+}
+
+TEST(SharedSortedSet, InsertKeepsSortedAndUnique) {
+  SharedSortedSet<int> set;
+
+  EXPECT_TRUE(set.insert(3));
+  EXPECT_TRUE(set.insert(1));
+  EXPECT_TRUE(set.insert(2));
+  EXPECT_FALSE(set.insert(1));
+
+  EXPECT_THAT(set, ElementsAre(1, 2, 3));
+}
+
+TEST(SharedSortedSet, FromRangeSortsAndDropsDuplicates) {
+  const std::vector<int> values = {5, 3, 1, 3, 4, 5, 2, 1};
+
+  auto set = SharedSortedSet<int>::FromRange(values.begin(), values.end());
+
+  EXPECT_THAT(set, ElementsAre(1, 2, 3, 4, 5));
+  EXPECT_TRUE(SharedSortedSet<int>::FromRange(values.end(), values.end())
+                  .empty());
+}
+
+TEST(SharedSortedSet, AdoptSorted) {
+  auto set = SharedSortedSet<int>::AdoptSorted({1, 2, 4});
+
+  EXPECT_THAT(set, ElementsAre(1, 2, 4));
+  EXPECT_TRUE(set.insert(3));
+  EXPECT_THAT(set, ElementsAre(1, 2, 3, 4));
+  EXPECT_TRUE(SharedSortedSet<int>::AdoptSorted({}).empty());
+}
+
+TEST(SharedSortedSet, CopiesShareStorage) {
+  SharedSortedSet<int> set;
+  set.insert(1);
+  set.insert(2);
+
+  SharedSortedSet<int> copy = set;
+
+  EXPECT_EQ(copy.begin(), set.begin());
+  EXPECT_EQ(copy, set);
+}
+
+TEST(SharedSortedSet, InsertIntoCopyDoesNotModifyOriginal) {
+  SharedSortedSet<int> set;
+  set.insert(1);
+
+  SharedSortedSet<int> copy = set;
+  copy.insert(2);
+
+  EXPECT_THAT(set, ElementsAre(1));
+  EXPECT_THAT(copy, ElementsAre(1, 2));
+  EXPECT_NE(copy, set);
+}
+
+TEST(SharedSortedSet, UnionWithEmptySharesStorage) {
+  SharedSortedSet<int> set;
+  set.insert(1);
+
+  SharedSortedSet<int> merged;
+  merged.insert(set);
+  merged.insert(SharedSortedSet<int>());
+
+  EXPECT_EQ(merged.begin(), set.begin());
+  EXPECT_THAT(merged, ElementsAre(1));
+}
+
+TEST(SharedSortedSet, UnionWithSubsetSharesStorage) {
+  SharedSortedSet<int> small;
+  small.insert(2);
+  SharedSortedSet<int> large;
+  large.insert(1);
+  large.insert(2);
+  large.insert(3);
+
+  SharedSortedSet<int> merged = small;
+  merged.insert(large);
+  EXPECT_EQ(merged.begin(), large.begin());
+
+  merged.insert(small);
+  EXPECT_EQ(merged.begin(), large.begin());
+  EXPECT_THAT(merged, ElementsAre(1, 2, 3));
+}
+
+TEST(SharedSortedSet, Union) {
+  SharedSortedSet<int> set1;
+  set1.insert(1);
+  set1.insert(3);
+  SharedSortedSet<int> set2;
+  set2.insert(2);
+  set2.insert(3);
+  set2.insert(4);
+
+  SharedSortedSet<int> merged = set1;
+  merged.insert(set2);
+
+  EXPECT_THAT(merged, ElementsAre(1, 2, 3, 4));
+  EXPECT_THAT(set1, ElementsAre(1, 3));
+  EXPECT_THAT(set2, ElementsAre(2, 3, 4));
+}
+
+}  // namespace
+}  // namespace cel::base_internal
@@ -14,29 +14,22 @@
 #include "checker/internal/test_ast_helpers.h"
 
 #include <memory>
-#include <utility>
 
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
 #include "common/ast.h"
-#include "extensions/protobuf/ast_converters.h"
-#include "internal/status_macros.h"
 #include "parser/options.h"
 #include "parser/parser.h"
 
 namespace cel::checker_internal {
 
-using ::cel::extensions::CreateAstFromParsedExpr;
-using ::google::api::expr::parser::Parse;
+using ::google::api::expr::parser::ParseAst;
 
 absl::StatusOr<std::unique_ptr<Ast>> MakeTestParsedAst(
     absl::string_view expression) {
   static ParserOptions options;
   options.enable_optional_syntax = true;
-  CEL_ASSIGN_OR_RETURN(auto parsed,
-                       Parse(expression, /*description=*/expression, options));
-
-  return CreateAstFromParsedExpr(std::move(parsed));
+  return ParseAst(expression, /*description=*/expression, options);
 }
 
 }  // namespace cel::checker_internal
@@ -1060,7 +1060,7 @@ absl::Status AddEnumConstants(TypeCheckerBuilder& builder) {
 
 absl::Status AddComprehensionsV2Functions(TypeCheckerBuilder& builder) {
   FunctionDecl map_insert;
-  map_insert.set_name("@cel.mapInsert");
+  map_insert.set_name(builtin::kMapInsert);
   CEL_RETURN_IF_ERROR(map_insert.AddOverload(
       MakeOverloadDecl("@mapInsert_map_key_value", MapOfAB(), MapOfAB(),
                        TypeParamA(), TypeParamB())));
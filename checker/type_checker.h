@@ -27,6 +27,10 @@ namespace cel {
 //
 // Checks references and type agreement for a parsed CEL expression.
 //
+// Instances are immutable once built: `Check` only reads the configured
+// environment and keeps per-call state on its own arena, so a single instance
+// may be shared by any number of threads checking expressions concurrently.
+//
 // TODO: see Compiler for bundled parse and type check from a
 // source expression string.
 class TypeChecker {
@@ -14,14 +14,19 @@
 
 #include "common/internal/reference_count.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <cstring>
 #include <memory>
 #include <new>
 #include <string>
 #include <utility>
+#include <vector>
 
+#include "absl/base/attributes.h"
 #include "absl/base/nullability.h"
+#include "absl/base/optimization.h"
 #include "absl/log/absl_check.h"
 #include "absl/strings/string_view.h"
 #include "common/data.h"
@@ -99,13 +104,93 @@ class ReferenceCountedString final : public ReferenceCounted {
 #pragma GCC diagnostic pop
 #endif
 
+// Number of registered reference counts before the first sweep.
+constexpr size_t kInitialSweepThreshold = 1024;
+
 }  // namespace
 
+ABSL_CONST_INIT thread_local LocalReferenceCountScope*
+    LocalReferenceCountScope::current_ = nullptr;
+
+LocalReferenceCountScope::LocalReferenceCountScope()
+    : active_(current_ == nullptr), sweep_threshold_(kInitialSweepThreshold) {
+  if (active_) {
+    current_ = this;
+  }
+}
+
+LocalReferenceCountScope::~LocalReferenceCountScope() {
+  if (!active_) {
+    return;
+  }
+  current_ = nullptr;
+#ifdef CEL_ENABLE_LOCAL_REFERENCE_COUNTING
+  for (const ReferenceCount* refcount : refcounts_) {
+    if (refcount == nullptr) {
+      continue;
+    }
+    refcount->local_.store(false, std::memory_order_release);
+    if (refcount->weak_refcount_.load(std::memory_order_relaxed) == 0) {
+      const_cast<ReferenceCount*>(refcount)->Delete();
+    }
+  }
+#endif
+}
+
+#ifdef CEL_ENABLE_LOCAL_REFERENCE_COUNTING
+void LocalReferenceCountScope::Register(const ReferenceCount& refcount) {
+  ABSL_DCHECK(active_);
+  ABSL_DCHECK(!refcount.local());
+  refcount.local_.store(true, std::memory_order_release);
+  refcounts_.push_back(&refcount);
+  if (ABSL_PREDICT_FALSE(refcounts_.size() >= sweep_threshold_)) {
+    Sweep();
+  }
+}
+
+void LocalReferenceCountScope::Sweep() {
+  // `Finalize()` has already run for unreferenced control blocks, so deleting
+  // them only releases memory and never touches other reference counts.
+  auto live = std::remove_if(
+      refcounts_.begin(), refcounts_.end(), [](const ReferenceCount* refcount) {
+        if (refcount == nullptr) {
+          return true;
+        }
+        if (refcount->weak_refcount_.load(std::memory_order_relaxed) == 0) {
+          refcount->local_.store(false, std::memory_order_release);
+          const_cast<ReferenceCount*>(refcount)->Delete();
+          return true;
+        }
+        return false;
+      });
+  refcounts_.erase(live, refcounts_.end());
+  sweep_threshold_ = std::max(kInitialSweepThreshold, refcounts_.size() * 2);
+}
+
+void LocalReferenceCountScope::Unregister(const ReferenceCount& refcount) {
+  // Local control blocks are only touched by the thread owning the scope.
+  LocalReferenceCountScope* scope = current_;
+  ABSL_DCHECK(scope != nullptr);
+  if (ABSL_PREDICT_FALSE(scope == nullptr)) {
+    return;
+  }
+  // Recently registered control blocks are the likeliest to be destroyed.
+  // The entry is cleared rather than erased and dropped by the next sweep.
+  auto it = std::find(scope->refcounts_.rbegin(), scope->refcounts_.rend(),
+                      &refcount);
+  ABSL_DCHECK(it != scope->refcounts_.rend());
+  if (it != scope->refcounts_.rend()) {
+    *it = nullptr;
+  }
+}
+#endif  // CEL_ENABLE_LOCAL_REFERENCE_COUNTING
+
 std::pair<absl::Nonnull<const ReferenceCount*>, absl::string_view>
 MakeReferenceCountedString(absl::string_view value) {
   ABSL_DCHECK(!value.empty());
   const auto* refcount =
       ReferenceCountedString::New(value.data(), value.size());
+  LocalReferenceCountScope::Adopt(refcount);
   return std::pair{refcount,
                    absl::string_view(refcount->data(), refcount->size())};
 }
@@ -114,6 +199,7 @@ std::pair<absl::Nonnull<const ReferenceCount*>, absl::string_view>
 MakeReferenceCountedString(std::string&& value) {
   ABSL_DCHECK(!value.empty());
   const auto* refcount = new ReferenceCountedStdString(std::move(value));
+  LocalReferenceCountScope::Adopt(refcount);
   return std::pair{refcount,
                    absl::string_view(refcount->data(), refcount->size())};
 }
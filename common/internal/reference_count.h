@@ -21,11 +21,13 @@
 #define THIRD_PARTY_CEL_CPP_COMMON_INTERNAL_REFERENCE_COUNT_H_
 
 #include <atomic>
+#include <cstddef>
 #include <cstdint>
 #include <new>
 #include <string>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "absl/base/attributes.h"
 #include "absl/base/nullability.h"
@@ -46,6 +48,7 @@ struct AdoptRef final {
 inline constexpr AdoptRef kAdoptRef{};
 
 class ReferenceCount;
+class LocalReferenceCountScope;
 struct ReferenceCountFromThis;
 
 void SetReferenceCountForThat(ReferenceCountFromThis& that,
@@ -119,6 +122,102 @@ bool IsExpiredRef(const ReferenceCount& refcount) noexcept;
 ABSL_MUST_USE_RESULT
 bool IsExpiredRef(absl::Nullable<const ReferenceCount*> refcount) noexcept;
 
+// `LocalReferenceCountScope` makes reference counts created by the factories
+// below on the current thread while it is alive thread-local: they are updated
+// with plain loads and stores instead of atomic read-modify-write operations,
+// and the scope takes ownership of their control blocks, releasing them when it
+// is periodically swept or destroyed.
+// When the scope is destroyed, every surviving reference count is promoted to
+// an ordinary atomic one, so values may escape the scope.
+//
+// Objects created within the scope must not be referenced from other threads
+// until the scope is destroyed. Objects stored in state shared with other
+// threads must be created under a `SuspendLocalReferenceCounting`. Scopes do
+// not nest; constructing a scope while another is active on the same thread
+// has no effect.
+//
+// Local reference counting adds a flag to every control block and a check to
+// every reference count operation. It is therefore only compiled in when
+// `CEL_ENABLE_LOCAL_REFERENCE_COUNTING` is defined for the whole build, e.g.
+// with `--copt=-DCEL_ENABLE_LOCAL_REFERENCE_COUNTING`. Otherwise scopes have
+// no effect.
+class LocalReferenceCountScope final {
+ public:
+  LocalReferenceCountScope();
+
+  LocalReferenceCountScope(const LocalReferenceCountScope&) = delete;
+  LocalReferenceCountScope(LocalReferenceCountScope&&) = delete;
+  LocalReferenceCountScope& operator=(const LocalReferenceCountScope&) = delete;
+  LocalReferenceCountScope& operator=(LocalReferenceCountScope&&) = delete;
+
+  ~LocalReferenceCountScope();
+
+  // Returns the scope active on the current thread, if any.
+  static absl::Nullable<LocalReferenceCountScope*> Current() {
+    return current_;
+  }
+
+  // Hands `refcount` to the scope active on the current thread, if any.
+  // `refcount` must have just been allocated by the caller, must not yet be
+  // shared, and must release itself through `Delete()`.
+  static void Adopt(absl::Nonnull<const ReferenceCount*> refcount) {
+#ifdef CEL_ENABLE_LOCAL_REFERENCE_COUNTING
+    if (auto* scope = current_;
+        ABSL_PREDICT_FALSE(scope != nullptr && scope->suspensions_ == 0)) {
+      scope->Register(*refcount);
+    }
+#else
+    static_cast<void>(refcount);
+#endif
+  }
+
+ private:
+  friend class ReferenceCount;
+  friend class SuspendLocalReferenceCounting;
+
+  void Register(const ReferenceCount& refcount);
+
+  // Forgets `refcount`, which is being destroyed other than by the scope.
+  static void Unregister(const ReferenceCount& refcount);
+
+  // Releases control blocks which are no longer referenced.
+  void Sweep();
+
+  ABSL_CONST_INIT static thread_local LocalReferenceCountScope* current_;
+
+  bool active_;
+  // Number of live `SuspendLocalReferenceCounting` on this scope.
+  int suspensions_ = 0;
+  size_t sweep_threshold_;
+  std::vector<const ReferenceCount*> refcounts_;
+};
+
+// Makes reference counts created on the current thread ordinary atomic ones
+// while it is alive, even under a `LocalReferenceCountScope`. Used around code
+// whose results are stored in state shared with other threads, such as lazily
+// provided activation values.
+class SuspendLocalReferenceCounting final {
+ public:
+  SuspendLocalReferenceCounting() : scope_(LocalReferenceCountScope::current_) {
+    if (scope_ != nullptr) {
+      ++scope_->suspensions_;
+    }
+  }
+
+  SuspendLocalReferenceCounting(const SuspendLocalReferenceCounting&) = delete;
+  SuspendLocalReferenceCounting& operator=(
+      const SuspendLocalReferenceCounting&) = delete;
+
+  ~SuspendLocalReferenceCounting() {
+    if (scope_ != nullptr) {
+      --scope_->suspensions_;
+    }
+  }
+
+ private:
+  absl::Nullable<LocalReferenceCountScope*> const scope_;
+};
+
 // `ReferenceCount` is similar to the control block used by `std::shared_ptr`.
 // It is not meant to be interacted with directly in most cases, instead
 // `cel::Shared` should be used.
@@ -131,7 +230,15 @@ class alignas(8) ReferenceCount {
   ReferenceCount& operator=(const ReferenceCount&) = delete;
   ReferenceCount& operator=(ReferenceCount&&) = delete;
 
+#ifdef CEL_ENABLE_LOCAL_REFERENCE_COUNTING
+  virtual ~ReferenceCount() {
+    if (ABSL_PREDICT_FALSE(local())) {
+      LocalReferenceCountScope::Unregister(*this);
+    }
+  }
+#else
   virtual ~ReferenceCount() = default;
+#endif
 
  private:
   friend void StrongRef(const ReferenceCount& refcount) noexcept;
@@ -141,13 +248,31 @@ class alignas(8) ReferenceCount {
   friend void WeakUnref(const ReferenceCount& refcount) noexcept;
   friend bool IsUniqueRef(const ReferenceCount& refcount) noexcept;
   friend bool IsExpiredRef(const ReferenceCount& refcount) noexcept;
+  friend class LocalReferenceCountScope;
 
   virtual void Finalize() noexcept = 0;
 
   virtual void Delete() noexcept = 0;
 
+  // Whether the counts are owned by a `LocalReferenceCountScope`. Always false,
+  // and folded away, unless local reference counting is compiled in.
+  bool local() const noexcept {
+#ifdef CEL_ENABLE_LOCAL_REFERENCE_COUNTING
+    return local_.load(std::memory_order_acquire);
+#else
+    return false;
+#endif
+  }
+
   mutable std::atomic<int32_t> strong_refcount_ = 1;
   mutable std::atomic<int32_t> weak_refcount_ = 1;
+#ifdef CEL_ENABLE_LOCAL_REFERENCE_COUNTING
+  // Set while owned by a `LocalReferenceCountScope`. Counts are then only
+  // touched by the owning thread and updated without read-modify-write
+  // operations. Cleared with release semantics when the scope hands the
+  // control block back.
+  mutable std::atomic<bool> local_ = false;
+#endif
 };
 
 // ReferenceCount and its derivations must be at least as aligned as
@@ -222,13 +347,19 @@ absl::Nonnull<const ReferenceCount*> MakeDeletingReferenceCount(
     ABSL_DCHECK_EQ(to_delete->GetArena(), nullptr);
   }
   if constexpr (std::is_base_of_v<google::protobuf::MessageLite, T>) {
-    return new DeletingReferenceCount<google::protobuf::MessageLite>(to_delete);
+    auto* refcount =
+        new DeletingReferenceCount<google::protobuf::MessageLite>(to_delete);
+    LocalReferenceCountScope::Adopt(refcount);
+    return refcount;
   } else if constexpr (std::is_base_of_v<Data, T>) {
     auto* refcount = new DeletingReferenceCount<Data>(to_delete);
     common_internal::SetDataReferenceCount(to_delete, refcount);
+    LocalReferenceCountScope::Adopt(refcount);
     return refcount;
   } else {
-    return new DeletingReferenceCount<T>(to_delete);
+    auto* refcount = new DeletingReferenceCount<T>(to_delete);
+    LocalReferenceCountScope::Adopt(refcount);
+    return refcount;
   }
 }
 
@@ -239,6 +370,7 @@ MakeEmplacedReferenceCount(Args&&... args) {
   U* pointer;
   auto* const refcount =
       new EmplacedReferenceCount<U>(pointer, std::forward<Args>(args)...);
+  LocalReferenceCountScope::Adopt(refcount);
   if constexpr (IsArenaConstructible<U>::value) {
     ABSL_DCHECK_EQ(pointer->GetArena(), nullptr);
   }
@@ -283,6 +415,7 @@ std::pair<absl::Nonnull<T*>, absl::Nonnull<ReferenceCount*>> MakeReferenceCount(
   using U = std::remove_const_t<T>;
   auto* const refcount =
       new InlinedReferenceCount<U>(std::in_place, std::forward<Args>(args)...);
+  LocalReferenceCountScope::Adopt(refcount);
   auto* const pointer = refcount->value();
   if constexpr (std::is_base_of_v<ReferenceCountFromThis, U>) {
     SetReferenceCountForThat(*pointer, refcount);
@@ -291,9 +424,25 @@ std::pair<absl::Nonnull<T*>, absl::Nonnull<ReferenceCount*>> MakeReferenceCount(
                         static_cast<ReferenceCount*>(refcount));
 }
 
+namespace reference_count_internal {
+
+// Thread-local counterparts of `fetch_add` and `fetch_sub` for reference
+// counts owned by a `LocalReferenceCountScope`.
+inline int32_t LocalFetchAdd(std::atomic<int32_t>& count,
+                             int32_t delta) noexcept {
+  const auto value = count.load(std::memory_order_relaxed);
+  count.store(value + delta, std::memory_order_relaxed);
+  return value;
+}
+
+}  // namespace reference_count_internal
+
 inline void StrongRef(const ReferenceCount& refcount) noexcept {
   const auto count =
-      refcount.strong_refcount_.fetch_add(1, std::memory_order_relaxed);
+      ABSL_PREDICT_FALSE(refcount.local())
+          ? reference_count_internal::LocalFetchAdd(refcount.strong_refcount_,
+                                                    1)
+          : refcount.strong_refcount_.fetch_add(1, std::memory_order_relaxed);
   ABSL_DCHECK_GT(count, 0);
 }
 
@@ -305,7 +454,10 @@ inline void StrongRef(absl::Nullable<const ReferenceCount*> refcount) noexcept {
 
 inline void StrongUnref(const ReferenceCount& refcount) noexcept {
   const auto count =
-      refcount.strong_refcount_.fetch_sub(1, std::memory_order_acq_rel);
+      ABSL_PREDICT_FALSE(refcount.local())
+          ? reference_count_internal::LocalFetchAdd(refcount.strong_refcount_,
+                                                    -1)
+          : refcount.strong_refcount_.fetch_sub(1, std::memory_order_acq_rel);
   ABSL_DCHECK_GT(count, 0);
   ABSL_ASSUME(count > 0);
   if (ABSL_PREDICT_FALSE(count == 1)) {
@@ -330,6 +482,10 @@ inline bool StrengthenRef(const ReferenceCount& refcount) noexcept {
     if (count == 0) {
       return false;
     }
+    if (ABSL_PREDICT_FALSE(refcount.local())) {
+      refcount.strong_refcount_.store(count + 1, std::memory_order_relaxed);
+      return true;
+    }
     if (refcount.strong_refcount_.compare_exchange_weak(
             count, count + 1, std::memory_order_release,
             std::memory_order_relaxed)) {
@@ -346,7 +502,9 @@ inline bool StrengthenRef(
 
 inline void WeakRef(const ReferenceCount& refcount) noexcept {
   const auto count =
-      refcount.weak_refcount_.fetch_add(1, std::memory_order_relaxed);
+      ABSL_PREDICT_FALSE(refcount.local())
+          ? reference_count_internal::LocalFetchAdd(refcount.weak_refcount_, 1)
+          : refcount.weak_refcount_.fetch_add(1, std::memory_order_relaxed);
   ABSL_DCHECK_GT(count, 0);
 }
 
@@ -357,6 +515,14 @@ inline void WeakRef(absl::Nullable<const ReferenceCount*> refcount) noexcept {
 }
 
 inline void WeakUnref(const ReferenceCount& refcount) noexcept {
+  if (ABSL_PREDICT_FALSE(refcount.local())) {
+    // The owning scope releases the control block once it observes the weak
+    // count at zero.
+    const auto count =
+        reference_count_internal::LocalFetchAdd(refcount.weak_refcount_, -1);
+    ABSL_DCHECK_GT(count, 0);
+    return;
+  }
   const auto count =
       refcount.weak_refcount_.fetch_sub(1, std::memory_order_acq_rel);
   ABSL_DCHECK_GT(count, 0);
@@ -14,10 +14,12 @@
 
 #include "common/internal/reference_count.h"
 
+#include <thread>  // NOLINT(build/c++11)
 #include <tuple>
 
 #include "google/protobuf/struct.pb.h"
 #include "absl/base/nullability.h"
+#include "absl/strings/string_view.h"
 #include "common/data.h"
 #include "internal/testing.h"
 #include "google/protobuf/arena.h"
@@ -82,6 +84,123 @@ TEST(ReferenceCount, Weak) {
   WeakUnref(refcount);
 }
 
+TEST(LocalReferenceCountScope, Strong) {
+  bool destructed = false;
+  Object* object;
+  ReferenceCount* refcount;
+  {
+    LocalReferenceCountScope scope;
+    EXPECT_EQ(LocalReferenceCountScope::Current(), &scope);
+    std::tie(object, refcount) = MakeReferenceCount<Subobject>(destructed);
+    StrongRef(refcount);
+    StrongUnref(refcount);
+    EXPECT_TRUE(IsUniqueRef(refcount));
+    StrongUnref(refcount);
+    EXPECT_TRUE(destructed);
+  }
+  EXPECT_EQ(LocalReferenceCountScope::Current(), nullptr);
+}
+
+TEST(LocalReferenceCountScope, Weak) {
+  bool destructed = false;
+  Object* object;
+  ReferenceCount* refcount;
+  LocalReferenceCountScope scope;
+  std::tie(object, refcount) = MakeReferenceCount<Subobject>(destructed);
+  WeakRef(refcount);
+  ASSERT_TRUE(StrengthenRef(refcount));
+  StrongUnref(refcount);
+  EXPECT_TRUE(IsUniqueRef(refcount));
+  StrongUnref(refcount);
+  EXPECT_TRUE(destructed);
+  EXPECT_TRUE(IsExpiredRef(refcount));
+  ASSERT_FALSE(StrengthenRef(refcount));
+  WeakUnref(refcount);
+}
+
+TEST(LocalReferenceCountScope, EscapedReferenceCountsArePromoted) {
+  bool destructed = false;
+  Object* object;
+  ReferenceCount* refcount;
+  {
+    LocalReferenceCountScope scope;
+    std::tie(object, refcount) = MakeReferenceCount<Subobject>(destructed);
+    StrongRef(refcount);
+  }
+  // Shared with other threads once the scope ends.
+  std::thread thread([refcount]() { StrongUnref(refcount); });
+  thread.join();
+  EXPECT_TRUE(IsUniqueRef(refcount));
+  EXPECT_FALSE(destructed);
+  StrongUnref(refcount);
+  EXPECT_TRUE(destructed);
+}
+
+TEST(LocalReferenceCountScope, ReleasesUnreferencedControlBlocks) {
+  // Enough short-lived reference counts to trigger sweeping while the scope is
+  // active. Leaks are caught by the sanitizers.
+  LocalReferenceCountScope scope;
+  for (int i = 0; i < 10000; ++i) {
+    StrongUnref(
+        MakeReferenceCountedString(absl::string_view("hello world")).first);
+  }
+}
+
+TEST(LocalReferenceCountScope, NestedScopesAreInert) {
+  LocalReferenceCountScope scope;
+  {
+    LocalReferenceCountScope nested;
+    EXPECT_EQ(LocalReferenceCountScope::Current(), &scope);
+  }
+  EXPECT_EQ(LocalReferenceCountScope::Current(), &scope);
+}
+
+TEST(LocalReferenceCountScope, SuspendedScopeSharesReferenceCounts) {
+  bool destructed = false;
+  Object* object;
+  ReferenceCount* refcount;
+  LocalReferenceCountScope scope;
+  {
+    SuspendLocalReferenceCounting suspend;
+    std::tie(object, refcount) = MakeReferenceCount<Subobject>(destructed);
+  }
+  // Shared with another thread while the scope is still active. Updates
+  // without read-modify-write operations would lose some of the counts.
+  auto churn = [refcount]() {
+    for (int i = 0; i < 100000; ++i) {
+      StrongRef(refcount);
+      StrongUnref(refcount);
+    }
+  };
+  std::thread thread(churn);
+  churn();
+  thread.join();
+  EXPECT_TRUE(IsUniqueRef(refcount));
+  StrongUnref(refcount);
+  EXPECT_TRUE(destructed);
+}
+
+TEST(LocalReferenceCountScope, IgnoresControlBlocksNotAdopted) {
+  LocalReferenceCountScope scope;
+  // Not created by a factory, so released as soon as it is unreferenced rather
+  // than by the scope.
+  ReferenceCount* refcount = new ReferenceCounted();
+  StrongRef(refcount);
+  StrongUnref(refcount);
+  StrongUnref(refcount);
+}
+
+TEST(LocalReferenceCountScope, ForgetsControlBlocksDestroyedDirectly) {
+  {
+    LocalReferenceCountScope scope;
+    ReferenceCount* refcount = new ReferenceCounted();
+    LocalReferenceCountScope::Adopt(refcount);
+    delete refcount;
+  }
+  // The scope must not have touched the destroyed control block. Caught by the
+  // sanitizers.
+}
+
 class DataObject final : public Data {
  public:
   DataObject() noexcept : Data() {}
@@ -14,11 +14,13 @@
 
 #include "common/internal/shared_byte_string.h"
 
+#include <cstddef>
 #include <cstdint>
 #include <string>
 
 #include "absl/base/nullability.h"
 #include "absl/functional/overload.h"
+#include "absl/log/absl_check.h"
 #include "absl/strings/cord.h"
 #include "absl/strings/string_view.h"
 #include "common/allocator.h"
@@ -84,4 +86,16 @@ SharedByteString SharedByteString::Clone(Allocator<> allocator) const {
   return *this;
 }
 
+SharedByteString SharedByteString::Substring(size_t pos, size_t n) const {
+  if (header_.is_cord) {
+    ABSL_DCHECK_LE(pos + n, cord_ptr()->size());
+    return SharedByteString(cord_ptr()->Subcord(pos, n));
+  }
+  ABSL_DCHECK_LE(pos + n, static_cast<size_t>(header_.size));
+  SharedByteString result(*this);
+  result.header_.size = n;
+  result.content_.string.data += pos;
+  return result;
+}
+
 }  // namespace cel::common_internal
@@ -192,6 +192,12 @@ class SharedByteString final {
 
   SharedByteString Clone(Allocator<> allocator) const;
 
+  // Returns the `n` bytes starting at `pos` as a shared byte string which
+  // shares the underlying storage, and its ownership, with this one instead
+  // of copying it. Requires `pos + n` to not exceed the size of this byte
+  // string.
+  SharedByteString Substring(size_t pos, size_t n) const;
+
   template <typename Visitor>
   std::common_type_t<std::invoke_result_t<Visitor, absl::string_view>,
                      std::invoke_result_t<Visitor, const absl::Cord&>>
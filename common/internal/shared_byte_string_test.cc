@@ -93,6 +93,43 @@ TEST(SharedByteString, Cord) {
   EXPECT_THAT(byte_string.ToCord(), Eq("foo"));
 }
 
+TEST(SharedByteString, SubstringStringView) {
+  absl::string_view string_view = "foobarbaz";
+  SharedByteString byte_string(string_view);
+  SharedByteString substring = byte_string.Substring(3, 3);
+  std::string scratch;
+  EXPECT_THAT(substring.ToString(scratch), Eq("bar"));
+  EXPECT_THAT(substring.ToString(scratch).data(),
+              Eq(string_view.data() + 3));
+  EXPECT_THAT(byte_string.Substring(9, 0).ToString(scratch), IsEmpty());
+}
+
+TEST(SharedByteString, SubstringOwnedStringView) {
+  auto* const owner =
+      new OwningObject("----------------------------------------");
+  SharedByteString substring;
+  {
+    SharedByteString byte_string(owner, owner->owned_string());
+    substring = byte_string.Substring(10, 20);
+  }
+  // The substring keeps the owner alive after the original is gone.
+  std::string scratch;
+  EXPECT_THAT(substring.ToString(scratch),
+              Eq(owner->owned_string().substr(10, 20)));
+  EXPECT_THAT(substring.ToString(scratch).data(),
+              Eq(owner->owned_string().data() + 10));
+  substring = SharedByteString();
+  StrongUnref(owner);
+}
+
+TEST(SharedByteString, SubstringCord) {
+  SharedByteString byte_string(absl::Cord("foobarbaz"));
+  SharedByteString substring = byte_string.Substring(6, 3);
+  std::string scratch;
+  EXPECT_THAT(substring.ToString(scratch), Eq("baz"));
+  EXPECT_THAT(substring.ToCord(), Eq("baz"));
+}
+
 TEST(SharedByteString, CopyConstruct) {
   SharedByteString byte_string1(absl::string_view("foo"));
   SharedByteString byte_string2(std::string("bar"));
@@ -2770,6 +2770,13 @@ inline absl::StatusOr<int> ParsedStructValue::Qualify(
   return interface_->Qualify(value_manager, qualifiers, presence_test, result);
 }
 
+inline absl::Status StructValueBuilder::SetField(const MessageTypeField& field,
+                                                 Value value) {
+  return SetFieldByName(
+      field->is_extension() ? field->full_name() : field.name(),
+      std::move(value));
+}
+
 namespace common_internal {
 
 using MapFieldKeyAccessor = void (*)(Allocator<>, Borrower,
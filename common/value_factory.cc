@@ -43,6 +43,7 @@
 #include "common/type.h"
 #include "common/value.h"
 #include "common/value_manager.h"
+#include "common/values/parsed_json_text_value.h"
 #include "internal/status_macros.h"
 #include "internal/time.h"
 #include "internal/utf8.h"
@@ -313,6 +314,10 @@ MapValue ValueFactory::CreateMapValueFromJsonObject(JsonObject json) {
       GetMemoryManager().MakeShared<JsonMapValue>(std::move(json)));
 }
 
+absl::StatusOr<Value> ValueFactory::CreateValueFromJsonText(std::string text) {
+  return common_internal::ParsedJsonTextValue(*this, std::move(text));
+}
+
 ListValue ValueFactory::GetZeroDynListValue() { return ListValue(); }
 
 MapValue ValueFactory::GetZeroDynDynMapValue() { return MapValue(); }
@@ -328,7 +333,9 @@ namespace {
 class ReferenceCountedString final : public common_internal::ReferenceCounted {
  public:
   static const ReferenceCountedString* New(std::string&& string) {
-    return new ReferenceCountedString(std::move(string));
+    auto* refcount = new ReferenceCountedString(std::move(string));
+    common_internal::LocalReferenceCountScope::Adopt(refcount);
+    return refcount;
   }
 
   const char* data() const {
@@ -60,6 +60,11 @@ class ValueFactory : public virtual TypeFactory {
   ABSL_DEPRECATED("Use ParsedJsonMapValue instead")
   MapValue CreateMapValueFromJsonObject(JsonObject json);
 
+  // `CreateValueFromJsonText` parses the JSON document `text` into a `Value`.
+  // Arrays and objects are materialized lazily as they are accessed, and
+  // strings without escape sequences reference `text` instead of copying it.
+  absl::StatusOr<Value> CreateValueFromJsonText(std::string text);
+
   // `GetDynListType` gets a view of the `ListType` type `list(dyn)`.
   ListValue GetZeroDynListValue();
 
@@ -0,0 +1,230 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/value_json_text.h"
+
+#include <cstddef>
+#include <string>
+
+#include "absl/base/nullability.h"
+#include "absl/functional/overload.h"
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/variant.h"
+#include "common/json.h"
+#include "common/type.h"
+#include "common/value.h"
+#include "common/value_kind.h"
+#include "common/value_manager.h"
+#include "internal/json.h"
+#include "internal/json_writer.h"
+#include "internal/status_macros.h"
+#include "internal/time.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/message.h"
+
+namespace cel {
+
+namespace {
+
+using ::cel::internal::JsonWriter;
+
+void NativeJsonToJsonText(const Json& json, absl::Nonnull<JsonWriter*> writer) {
+  absl::visit(
+      absl::Overload(
+          [&](JsonNull) { writer->Null(); },
+          [&](JsonBool value) { writer->Bool(value); },
+          [&](JsonNumber value) { writer->Number(value); },
+          [&](const JsonString& value) { writer->String(value); },
+          [&](const JsonArray& value) {
+            writer->BeginArray();
+            for (const auto& element : value) {
+              NativeJsonToJsonText(element, writer);
+            }
+            writer->EndArray();
+          },
+          [&](const JsonObject& value) {
+            writer->BeginObject();
+            for (const auto& member : value) {
+              writer->Key(member.first);
+              NativeJsonToJsonText(member.second, writer);
+            }
+            writer->EndObject();
+          }),
+      json);
+}
+
+// Handles everything without a streaming representation by going through
+// `ConvertToJson()`. This also surfaces the errors for kinds which are not
+// convertible to JSON at all.
+absl::Status ConvertedValueToJsonText(ValueManager& value_manager,
+                                      const Value& value,
+                                      absl::Nonnull<JsonWriter*> writer) {
+  CEL_ASSIGN_OR_RETURN(auto json, value.ConvertToJson(value_manager));
+  NativeJsonToJsonText(json, writer);
+  return absl::OkStatus();
+}
+
+absl::Status MessageFieldToJsonText(
+    ValueManager& value_manager, const google::protobuf::Message& message,
+    absl::Nonnull<const google::protobuf::FieldDescriptor*> field,
+    absl::Nonnull<JsonWriter*> writer) {
+  const auto [descriptor_pool, message_factory] =
+      GetDescriptorPoolAndMessageFactory(value_manager, message);
+  return internal::MessageFieldToJsonText(message, field, descriptor_pool,
+                                          message_factory, writer);
+}
+
+absl::Status ListValueToJsonText(ValueManager& value_manager,
+                                 const Value& value,
+                                 absl::Nonnull<JsonWriter*> writer) {
+  if (auto json_list = value.AsParsedJsonList(); json_list) {
+    if (*json_list) {
+      internal::JsonListToJsonText(**json_list, writer);
+    } else {
+      writer->BeginArray();
+      writer->EndArray();
+    }
+    return absl::OkStatus();
+  }
+  if (auto repeated_field = value.AsParsedRepeatedField(); repeated_field) {
+    return MessageFieldToJsonText(value_manager, repeated_field->message(),
+                                  repeated_field->field(), writer);
+  }
+  writer->BeginArray();
+  CEL_RETURN_IF_ERROR(value.GetList().ForEach(
+      value_manager, [&](const Value& element) -> absl::StatusOr<bool> {
+        CEL_RETURN_IF_ERROR(ValueToJsonText(value_manager, element, writer));
+        return true;
+      }));
+  writer->EndArray();
+  return absl::OkStatus();
+}
+
+absl::Status MapValueToJsonText(ValueManager& value_manager,
+                                const Value& value,
+                                absl::Nonnull<JsonWriter*> writer) {
+  if (auto json_map = value.AsParsedJsonMap(); json_map) {
+    if (*json_map) {
+      internal::JsonMapToJsonText(**json_map, writer);
+    } else {
+      writer->BeginObject();
+      writer->EndObject();
+    }
+    return absl::OkStatus();
+  }
+  if (auto map_field = value.AsParsedMapField(); map_field) {
+    return MessageFieldToJsonText(value_manager, map_field->message(),
+                                  map_field->field(), writer);
+  }
+  writer->BeginObject();
+  CEL_RETURN_IF_ERROR(value.GetMap().ForEach(
+      value_manager,
+      [&](const Value& key, const Value& entry) -> absl::StatusOr<bool> {
+        if (!key.IsString()) {
+          return TypeConversionError(key.GetRuntimeType(), StringType())
+              .NativeValue();
+        }
+        key.GetString().NativeValue(
+            [&](const auto& string) -> void { writer->Key(string); });
+        CEL_RETURN_IF_ERROR(ValueToJsonText(value_manager, entry, writer));
+        return true;
+      }));
+  writer->EndObject();
+  return absl::OkStatus();
+}
+
+absl::Status StructValueToJsonText(ValueManager& value_manager,
+                                   const Value& value,
+                                   absl::Nonnull<JsonWriter*> writer) {
+  if (auto message = value.AsParsedMessage(); message) {
+    if (!*message) {
+      writer->BeginObject();
+      writer->EndObject();
+      return absl::OkStatus();
+    }
+    const auto [descriptor_pool, message_factory] =
+        GetDescriptorPoolAndMessageFactory(value_manager, **message);
+    return internal::MessageToJsonText(**message, descriptor_pool,
+                                       message_factory, writer);
+  }
+  return ConvertedValueToJsonText(value_manager, value, writer);
+}
+
+}  // namespace
+
+absl::Status ValueToJsonText(ValueManager& value_manager, const Value& value,
+                             absl::Nonnull<std::string*> output) {
+  const size_t previous_size = output->size();
+  JsonWriter writer(output);
+  absl::Status status = ValueToJsonText(value_manager, value, &writer);
+  if (!status.ok()) {
+    output->resize(previous_size);
+  }
+  return status;
+}
+
+absl::Status ValueToJsonText(ValueManager& value_manager, const Value& value,
+                             absl::Nonnull<internal::JsonWriter*> writer) {
+  switch (value.kind()) {
+    case ValueKind::kNull:
+      writer->Null();
+      return absl::OkStatus();
+    case ValueKind::kBool:
+      writer->Bool(value.GetBool().NativeValue());
+      return absl::OkStatus();
+    case ValueKind::kInt:
+      writer->Int(value.GetInt().NativeValue());
+      return absl::OkStatus();
+    case ValueKind::kUint:
+      writer->Uint(value.GetUint().NativeValue());
+      return absl::OkStatus();
+    case ValueKind::kDouble:
+      writer->Number(value.GetDouble().NativeValue());
+      return absl::OkStatus();
+    case ValueKind::kString:
+      value.GetString().NativeValue(
+          [&](const auto& string) -> void { writer->String(string); });
+      return absl::OkStatus();
+    case ValueKind::kBytes:
+      value.GetBytes().NativeValue(
+          [&](const auto& bytes) -> void { writer->Bytes(bytes); });
+      return absl::OkStatus();
+    case ValueKind::kDuration: {
+      CEL_ASSIGN_OR_RETURN(
+          auto json,
+          internal::EncodeDurationToJson(value.GetDuration().NativeValue()));
+      writer->String(json);
+      return absl::OkStatus();
+    }
+    case ValueKind::kTimestamp: {
+      CEL_ASSIGN_OR_RETURN(
+          auto json,
+          internal::EncodeTimestampToJson(value.GetTimestamp().NativeValue()));
+      writer->String(json);
+      return absl::OkStatus();
+    }
+    case ValueKind::kList:
+      return ListValueToJsonText(value_manager, value, writer);
+    case ValueKind::kMap:
+      return MapValueToJsonText(value_manager, value, writer);
+    case ValueKind::kStruct:
+      return StructValueToJsonText(value_manager, value, writer);
+    default:
+      return ConvertedValueToJsonText(value_manager, value, writer);
+  }
+}
+
+}  // namespace cel
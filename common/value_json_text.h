@@ -0,0 +1,47 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_COMMON_VALUE_JSON_TEXT_H_
+#define THIRD_PARTY_CEL_CPP_COMMON_VALUE_JSON_TEXT_H_
+
+#include <string>
+
+#include "absl/base/nullability.h"
+#include "absl/status/status.h"
+#include "common/value.h"
+#include "common/value_manager.h"
+#include "internal/json_writer.h"
+
+namespace cel {
+
+// `ValueToJsonText` serializes `value` as JSON text, appending it to `output`.
+// The result is equivalent to serializing `value.ConvertToJson(...)`, but
+// values are written as they are visited: lists, maps and messages do not
+// build an intermediate `cel::Json` or `google.protobuf.Value`, and messages
+// are read through reflection. On error `output` is restored to its previous
+// contents.
+//
+// Callers serializing many values can reuse `output` to amortize its
+// allocation.
+absl::Status ValueToJsonText(ValueManager& value_manager, const Value& value,
+                             absl::Nonnull<std::string*> output);
+
+// Same as above, but writes to an existing `internal::JsonWriter`. This allows
+// embedding `value` in a larger document.
+absl::Status ValueToJsonText(ValueManager& value_manager, const Value& value,
+                             absl::Nonnull<internal::JsonWriter*> writer);
+
+}  // namespace cel
+
+#endif  // THIRD_PARTY_CEL_CPP_COMMON_VALUE_JSON_TEXT_H_
@@ -0,0 +1,263 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/value_json_text.h"
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <utility>
+
+#include "absl/base/nullability.h"
+#include "absl/status/status.h"
+#include "absl/status/status_matchers.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/time.h"
+#include "absl/types/optional.h"
+#include "common/allocator.h"
+#include "common/json.h"
+#include "common/memory.h"
+#include "common/type.h"
+#include "common/type_reflector.h"
+#include "common/value.h"
+#include "common/value_manager.h"
+#include "internal/parse_text_proto.h"
+#include "internal/status_macros.h"
+#include "internal/testing.h"
+#include "internal/testing_descriptor_pool.h"
+#include "internal/testing_message_factory.h"
+#include "cel/expr/conformance/proto3/test_all_types.pb.h"
+#include "google/protobuf/arena.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/message.h"
+
+namespace cel {
+namespace {
+
+using ::absl_testing::IsOkAndHolds;
+using ::absl_testing::StatusIs;
+using ::cel::internal::DynamicParseTextProto;
+using ::cel::internal::GetTestingDescriptorPool;
+using ::cel::internal::GetTestingMessageFactory;
+using ::testing::PrintToStringParamName;
+using ::testing::TestWithParam;
+
+using TestAllTypesProto3 = ::cel::expr::conformance::proto3::TestAllTypes;
+
+class ValueJsonTextTest : public TestWithParam<AllocatorKind> {
+ public:
+  void SetUp() override {
+    switch (GetParam()) {
+      case AllocatorKind::kArena:
+        arena_.emplace();
+        value_manager_ = NewThreadCompatibleValueManager(
+            MemoryManager::Pooling(arena()),
+            NewThreadCompatibleTypeReflector(MemoryManager::Pooling(arena())));
+        break;
+      case AllocatorKind::kNewDelete:
+        value_manager_ = NewThreadCompatibleValueManager(
+            MemoryManager::ReferenceCounting(),
+            NewThreadCompatibleTypeReflector(
+                MemoryManager::ReferenceCounting()));
+        break;
+    }
+  }
+
+  void TearDown() override {
+    value_manager_.reset();
+    arena_.reset();
+  }
+
+  Allocator<> allocator() {
+    return arena_ ? Allocator(ArenaAllocator<>{&*arena_})
+                  : Allocator(NewDeleteAllocator<>{});
+  }
+
+  absl::Nullable<google::protobuf::Arena*> arena() { return allocator().arena(); }
+
+  absl::Nonnull<const google::protobuf::DescriptorPool*> descriptor_pool() {
+    return GetTestingDescriptorPool();
+  }
+
+  absl::Nonnull<google::protobuf::MessageFactory*> message_factory() {
+    return GetTestingMessageFactory();
+  }
+
+  ValueManager& value_manager() { return **value_manager_; }
+
+  template <typename T>
+  ParsedMessageValue MakeParsedMessage(absl::string_view text) {
+    return ParsedMessageValue(DynamicParseTextProto<T>(
+        allocator(), text, descriptor_pool(), message_factory()));
+  }
+
+  absl::StatusOr<std::string> ToJsonText(const Value& value) {
+    std::string output;
+    CEL_RETURN_IF_ERROR(ValueToJsonText(value_manager(), value, &output));
+    return output;
+  }
+
+  // Serializes `value` as JSON text, parses it back and converts the result
+  // to `cel::Json`, for comparison against `value.ConvertToJson()`.
+  absl::StatusOr<Json> RoundTrip(const Value& value) {
+    CEL_ASSIGN_OR_RETURN(auto text, ToJsonText(value));
+    CEL_ASSIGN_OR_RETURN(auto parsed,
+                         value_manager().CreateValueFromJsonText(text));
+    return parsed.ConvertToJson(value_manager());
+  }
+
+ private:
+  absl::optional<google::protobuf::Arena> arena_;
+  absl::optional<Shared<ValueManager>> value_manager_;
+};
+
+TEST_P(ValueJsonTextTest, Scalars) {
+  EXPECT_THAT(ToJsonText(NullValue()), IsOkAndHolds("null"));
+  EXPECT_THAT(ToJsonText(BoolValue(true)), IsOkAndHolds("true"));
+  EXPECT_THAT(ToJsonText(IntValue(-1)), IsOkAndHolds("-1"));
+  EXPECT_THAT(ToJsonText(IntValue(std::numeric_limits<int64_t>::max())),
+              IsOkAndHolds("\"9223372036854775807\""));
+  EXPECT_THAT(ToJsonText(UintValue(1)), IsOkAndHolds("1"));
+  EXPECT_THAT(ToJsonText(DoubleValue(0.5)), IsOkAndHolds("0.5"));
+  EXPECT_THAT(ToJsonText(DoubleValue(-0.0)), IsOkAndHolds("-0"));
+  EXPECT_THAT(ToJsonText(StringValue("a\"b")), IsOkAndHolds("\"a\\\"b\""));
+  EXPECT_THAT(ToJsonText(BytesValue("foo")), IsOkAndHolds("\"Zm9v\""));
+  EXPECT_THAT(ToJsonText(DurationValue(absl::Seconds(1))),
+              IsOkAndHolds("\"1s\""));
+  EXPECT_THAT(ToJsonText(TimestampValue(absl::UnixEpoch())),
+              IsOkAndHolds("\"1970-01-01T00:00:00Z\""));
+}
+
+TEST_P(ValueJsonTextTest, List) {
+  ASSERT_OK_AND_ASSIGN(auto builder,
+                       value_manager().NewListValueBuilder(ListType()));
+  ASSERT_OK(builder->Add(IntValue(1)));
+  ASSERT_OK(builder->Add(StringValue("two")));
+  ASSERT_OK(builder->Add(ListValue()));
+  auto value = std::move(*builder).Build();
+  EXPECT_THAT(ToJsonText(value), IsOkAndHolds("[1,\"two\",[]]"));
+}
+
+TEST_P(ValueJsonTextTest, Map) {
+  ASSERT_OK_AND_ASSIGN(auto builder,
+                       value_manager().NewMapValueBuilder(MapType()));
+  ASSERT_OK(builder->Put(StringValue("a"), IntValue(1)));
+  auto value = std::move(*builder).Build();
+  EXPECT_THAT(ToJsonText(value), IsOkAndHolds("{\"a\":1}"));
+
+  ASSERT_OK_AND_ASSIGN(builder, value_manager().NewMapValueBuilder(MapType()));
+  ASSERT_OK(builder->Put(IntValue(1), IntValue(1)));
+  value = std::move(*builder).Build();
+  EXPECT_THAT(ToJsonText(value), StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST_P(ValueJsonTextTest, Unsupported) {
+  EXPECT_THAT(ToJsonText(ErrorValue(absl::CancelledError())),
+              StatusIs(absl::StatusCode::kFailedPrecondition));
+}
+
+TEST_P(ValueJsonTextTest, RestoresOutputOnError) {
+  ASSERT_OK_AND_ASSIGN(auto builder,
+                       value_manager().NewListValueBuilder(ListType()));
+  ASSERT_OK(builder->Add(IntValue(1)));
+  ASSERT_OK(builder->Add(ErrorValue(absl::CancelledError())));
+  auto value = std::move(*builder).Build();
+
+  std::string output = "prefix";
+  EXPECT_THAT(ValueToJsonText(value_manager(), value, &output),
+              StatusIs(absl::StatusCode::kFailedPrecondition));
+  EXPECT_EQ(output, "prefix");
+}
+
+TEST_P(ValueJsonTextTest, Message) {
+  EXPECT_THAT(ToJsonText(MakeParsedMessage<TestAllTypesProto3>(R"pb()pb")),
+              IsOkAndHolds("{}"));
+  EXPECT_THAT(ToJsonText(MakeParsedMessage<TestAllTypesProto3>(
+                  R"pb(single_int64: 1)pb")),
+              IsOkAndHolds("{\"singleInt64\":1}"));
+  EXPECT_THAT(ToJsonText(MakeParsedMessage<TestAllTypesProto3>(
+                  R"pb(standalone_enum: BAR)pb")),
+              IsOkAndHolds("{\"standaloneEnum\":\"BAR\"}"));
+  EXPECT_THAT(ToJsonText(MakeParsedMessage<TestAllTypesProto3>(
+                  R"pb(single_duration { seconds: 1 })pb")),
+              IsOkAndHolds("{\"singleDuration\":\"1s\"}"));
+  EXPECT_THAT(
+      ToJsonText(MakeParsedMessage<TestAllTypesProto3>(
+          R"pb(single_any {
+                 [type.googleapis.com/google.protobuf.Int32Value] { value: 1 }
+               })pb")),
+      IsOkAndHolds("{\"singleAny\":{\"@type\":\"type.googleapis.com/"
+                   "google.protobuf.Int32Value\",\"value\":1}}"));
+}
+
+TEST_P(ValueJsonTextTest, MessageRoundTrip) {
+  auto value = MakeParsedMessage<TestAllTypesProto3>(R"pb(
+    single_int32: 1
+    single_uint64: 18446744073709551615
+    single_double: 1.25
+    single_string: "foo\n"
+    single_bytes: "bar"
+    single_bool: true
+    single_nested_message { bb: 2 }
+    repeated_int64: [ 1, 2 ]
+    repeated_string: [ "a", "b" ]
+    map_string_string { key: "a" value: "b" }
+    map_int64_int64 { key: 1 value: 2 }
+    single_value { string_value: "baz" }
+    list_value { values { number_value: 1 } values { null_value: NULL_VALUE } }
+    single_struct {
+      fields {
+        key: "x"
+        value { bool_value: true }
+      }
+    }
+    single_int64_wrapper { value: 3 }
+    single_timestamp { seconds: 1 }
+    standalone_enum: BAZ
+  )pb");
+  ASSERT_OK_AND_ASSIGN(auto expected, value.ConvertToJson(value_manager()));
+  EXPECT_THAT(RoundTrip(value), IsOkAndHolds(expected));
+}
+
+TEST_P(ValueJsonTextTest, MessageFields) {
+  auto value = MakeParsedMessage<TestAllTypesProto3>(R"pb(
+    repeated_int32: [ 1, 2 ]
+    map_string_string { key: "a" value: "b" }
+  )pb");
+  ASSERT_OK_AND_ASSIGN(auto list,
+                       value.GetFieldByName(value_manager(), "repeated_int32"));
+  EXPECT_THAT(ToJsonText(list), IsOkAndHolds("[1,2]"));
+  ASSERT_OK_AND_ASSIGN(
+      auto map, value.GetFieldByName(value_manager(), "map_string_string"));
+  EXPECT_THAT(ToJsonText(map), IsOkAndHolds("{\"a\":\"b\"}"));
+}
+
+TEST_P(ValueJsonTextTest, Json) {
+  ASSERT_OK_AND_ASSIGN(auto value,
+                       value_manager().CreateValueFromJsonText(
+                           R"json({"a": [1, "b", null, {"c": false}]})json"));
+  ASSERT_OK_AND_ASSIGN(auto expected, value.ConvertToJson(value_manager()));
+  EXPECT_THAT(RoundTrip(value), IsOkAndHolds(expected));
+  EXPECT_THAT(ToJsonText(value),
+              IsOkAndHolds(R"json({"a":[1,"b",null,{"c":false}]})json"));
+}
+
+INSTANTIATE_TEST_SUITE_P(ValueJsonTextTest, ValueJsonTextTest,
+                         ::testing::Values(AllocatorKind::kArena,
+                                           AllocatorKind::kNewDelete),
+                         PrintToStringParamName());
+
+}  // namespace
+}  // namespace cel
@@ -159,6 +159,11 @@ class BytesValue final {
 
   absl::Cord ToCord() const { return NativeCord(); }
 
+  template <typename H>
+  friend H AbslHashValue(H state, const BytesValue& bytes) {
+    return H::combine(std::move(state), bytes.value_);
+  }
+
  private:
   friend class common_internal::TrivialValue;
   friend const common_internal::SharedByteString&
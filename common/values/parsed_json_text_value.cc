@@ -0,0 +1,597 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/values/parsed_json_text_value.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/attributes.h"
+#include "absl/base/nullability.h"
+#include "absl/base/optimization.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/cord.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/optional.h"
+#include "absl/types/span.h"
+#include "common/allocator.h"
+#include "common/json.h"
+#include "common/memory.h"
+#include "common/native_type.h"
+#include "common/value.h"
+#include "common/value_factory.h"
+#include "common/value_manager.h"
+#include "internal/json_tape.h"
+#include "internal/status_macros.h"
+#include "google/protobuf/arena.h"
+
+namespace cel::common_internal {
+
+namespace {
+
+using ::cel::internal::JsonTape;
+
+// Objects with more members than this are indexed by key when materialized,
+// smaller ones are searched linearly.
+constexpr size_t kMaxLinearLookupMembers = 8;
+
+// Distinct keys of a JSON object. When a key occurs more than once, the last
+// occurrence wins. Built once per object and never moved, as `keys` may view
+// `escaped_keys`.
+struct JsonTextObjectIndex final {
+  // Returns the key node of the member whose key is `key`.
+  absl::optional<uint32_t> Find(absl::string_view key) const {
+    if (!keys_by_value.empty()) {
+      if (auto it = keys_by_value.find(key); it != keys_by_value.end()) {
+        return key_nodes[it->second];
+      }
+      return absl::nullopt;
+    }
+    for (size_t i = 0; i < keys.size(); ++i) {
+      if (keys[i] == key) {
+        return key_nodes[i];
+      }
+    }
+    return absl::nullopt;
+  }
+
+  std::string escaped_keys;
+  // Distinct keys in order of first occurrence, and the key node of the last
+  // occurrence of each. The value node follows its key node.
+  std::vector<absl::string_view> keys;
+  std::vector<uint32_t> key_nodes;
+  // Position of each key in `keys`, for objects with many members.
+  absl::flat_hash_map<absl::string_view, size_t> keys_by_value;
+};
+
+// Owns the text of a JSON document together with its tape.
+class JsonTextDocument final {
+ public:
+  JsonTextDocument(std::string text, JsonTape tape,
+                   absl::Nullable<google::protobuf::Arena*> arena)
+      : text_(std::move(text)), tape_(std::move(tape)), arena_(arena) {}
+
+  absl::string_view text() const { return text_; }
+
+  const JsonTape& tape() const { return tape_; }
+
+  const JsonTape::Node& node(uint32_t index) const {
+    return tape_.node(index);
+  }
+
+  // The arena that owns this document, or `nullptr` if it is reference
+  // counted.
+  absl::Nullable<google::protobuf::Arena*> arena() const { return arena_; }
+
+  // Returns the index of the members of object node `index`, which is built
+  // on first use and shared by every value for that object. Thread-safe.
+  const JsonTextObjectIndex& ObjectIndex(uint32_t index) const;
+
+ private:
+  const std::string text_;
+  const JsonTape tape_;
+  absl::Nullable<google::protobuf::Arena*> const arena_;
+  mutable absl::Mutex mutex_;
+  mutable absl::flat_hash_map<uint32_t,
+                              std::unique_ptr<const JsonTextObjectIndex>>
+      object_indices_ ABSL_GUARDED_BY(mutex_);
+};
+
+using JsonTextDocumentPtr = Shared<const JsonTextDocument>;
+
+JsonTextDocumentPtr NewJsonTextDocument(MemoryManagerRef memory_manager,
+                                        std::string text, JsonTape tape) {
+  return memory_manager.MakeShared<JsonTextDocument>(
+      std::move(text), std::move(tape), memory_manager.arena());
+}
+
+// Returns a borrower which keeps `document` alive, for strings that reference
+// its text.
+Borrower DocumentBorrower(const JsonTextDocumentPtr& document) {
+  if (const auto* refcount = GetReferenceCount(document); refcount != nullptr) {
+    return Borrower::ReferenceCount(refcount);
+  }
+  return Borrower::Arena(document->arena());
+}
+
+// Returns the value of string node `index`, borrowing from the document
+// unless it has to be unescaped.
+StringValue NodeToStringValue(ValueFactory& value_factory,
+                              const JsonTextDocumentPtr& document,
+                              uint32_t index) {
+  const auto& node = document->node(index);
+  if (!node.escaped) {
+    return StringValue(DocumentBorrower(document),
+                       JsonTape::RawString(document->text(), node));
+  }
+  std::string string;
+  JsonTape::AppendString(document->text(), node, string);
+  return value_factory.CreateUncheckedStringValue(std::move(string));
+}
+
+void NodeToValue(ValueFactory& value_factory,
+                 const JsonTextDocumentPtr& document, uint32_t index,
+                 Value& result);
+
+void NodeDebugString(const JsonTextDocument& document, uint32_t index,
+                     std::string& out);
+
+Json NodeToJson(const JsonTextDocument& document, uint32_t index);
+
+// Calls `callback` with the index of each element of array node `index`.
+template <typename Callback>
+void ForEachElement(const JsonTextDocument& document, uint32_t index,
+                    Callback callback) {
+  uint32_t element = index + 1;
+  for (uint32_t i = 0; i < document.node(index).size; ++i) {
+    callback(element);
+    element = document.node(element).next;
+  }
+}
+
+// Calls `callback` with the indices of the key and value of each member of
+// object node `index`.
+template <typename Callback>
+void ForEachMember(const JsonTextDocument& document, uint32_t index,
+                   Callback callback) {
+  uint32_t key = index + 1;
+  for (uint32_t i = 0; i < document.node(index).size; ++i) {
+    callback(key, key + 1);
+    key = document.node(key + 1).next;
+  }
+}
+
+std::unique_ptr<const JsonTextObjectIndex> BuildObjectIndex(
+    const JsonTextDocument& document, uint32_t index) {
+  auto object_index = std::make_unique<JsonTextObjectIndex>();
+  const auto& node = document.node(index);
+  const bool indexed = node.size > kMaxLinearLookupMembers;
+  // Unescape keys into `escaped_keys` first, so that views of it remain valid
+  // once it stops growing.
+  std::vector<std::pair<size_t, size_t>> escaped_key_ranges;
+  ForEachMember(document, index, [&](uint32_t key, uint32_t) {
+    if (document.node(key).escaped) {
+      const size_t offset = object_index->escaped_keys.size();
+      JsonTape::AppendString(document.text(), document.node(key),
+                             object_index->escaped_keys);
+      escaped_key_ranges.push_back(
+          {offset, object_index->escaped_keys.size() - offset});
+    }
+  });
+  size_t next_escaped_key = 0;
+  auto& keys = object_index->keys;
+  auto& key_nodes = object_index->key_nodes;
+  auto& keys_by_value = object_index->keys_by_value;
+  keys.reserve(node.size);
+  key_nodes.reserve(node.size);
+  if (indexed) {
+    keys_by_value.reserve(node.size);
+  }
+  ForEachMember(document, index, [&](uint32_t key_node, uint32_t) {
+    absl::string_view key;
+    if (document.node(key_node).escaped) {
+      const auto [offset, size] = escaped_key_ranges[next_escaped_key++];
+      key = absl::string_view(object_index->escaped_keys).substr(offset, size);
+    } else {
+      key = JsonTape::RawString(document.text(), document.node(key_node));
+    }
+    size_t position;
+    if (indexed) {
+      position = keys_by_value.try_emplace(key, keys.size()).first->second;
+    } else {
+      position = std::find(keys.begin(), keys.end(), key) - keys.begin();
+    }
+    if (position == keys.size()) {
+      keys.push_back(key);
+      key_nodes.push_back(key_node);
+    } else {
+      key_nodes[position] = key_node;
+    }
+  });
+  return object_index;
+}
+
+const JsonTextObjectIndex& JsonTextDocument::ObjectIndex(
+    uint32_t index) const {
+  {
+    absl::MutexLock lock(&mutex_);
+    if (auto it = object_indices_.find(index); it != object_indices_.end()) {
+      return *it->second;
+    }
+  }
+  // Build without holding the lock. If another thread indexed the same object
+  // in the meantime, its index wins.
+  auto object_index = BuildObjectIndex(*this, index);
+  absl::MutexLock lock(&mutex_);
+  return *object_indices_.try_emplace(index, std::move(object_index))
+              .first->second;
+}
+
+void ArrayDebugString(const JsonTextDocument& document, uint32_t index,
+                      std::string& out) {
+  out.push_back('[');
+  bool first = true;
+  ForEachElement(document, index, [&](uint32_t element) {
+    if (!first) {
+      out.append(", ");
+    }
+    first = false;
+    NodeDebugString(document, element, out);
+  });
+  out.push_back(']');
+}
+
+void ObjectDebugString(const JsonTextDocument& document, uint32_t index,
+                       std::string& out) {
+  // Prints the same members as the map value: the last occurrence of each key.
+  const JsonTextObjectIndex& object_index = document.ObjectIndex(index);
+  std::vector<size_t> order(object_index.keys.size());
+  for (size_t i = 0; i < order.size(); ++i) {
+    order[i] = i;
+  }
+  std::sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) {
+    return object_index.keys[lhs] < object_index.keys[rhs];
+  });
+  out.push_back('{');
+  bool first = true;
+  for (size_t i : order) {
+    if (!first) {
+      out.append(", ");
+    }
+    first = false;
+    out.append(StringValue(object_index.keys[i]).DebugString());
+    out.append(": ");
+    NodeDebugString(document, object_index.key_nodes[i] + 1, out);
+  }
+  out.push_back('}');
+}
+
+void NodeDebugString(const JsonTextDocument& document, uint32_t index,
+                     std::string& out) {
+  const auto& node = document.node(index);
+  switch (node.kind) {
+    case JsonTape::Kind::kNull:
+      out.append(NullValue().DebugString());
+      break;
+    case JsonTape::Kind::kFalse:
+      out.append(BoolValue(false).DebugString());
+      break;
+    case JsonTape::Kind::kTrue:
+      out.append(BoolValue(true).DebugString());
+      break;
+    case JsonTape::Kind::kNumber:
+      out.append(
+          DoubleValue(JsonTape::Number(document.text(), node)).DebugString());
+      break;
+    case JsonTape::Kind::kString: {
+      std::string string;
+      JsonTape::AppendString(document.text(), node, string);
+      out.append(StringValue(std::move(string)).DebugString());
+      break;
+    }
+    case JsonTape::Kind::kArray:
+      ArrayDebugString(document, index, out);
+      break;
+    case JsonTape::Kind::kObject:
+      ObjectDebugString(document, index, out);
+      break;
+  }
+}
+
+JsonArray ArrayToJson(const JsonTextDocument& document, uint32_t index) {
+  JsonArrayBuilder builder;
+  builder.reserve(document.node(index).size);
+  ForEachElement(document, index, [&](uint32_t element) {
+    builder.push_back(NodeToJson(document, element));
+  });
+  return std::move(builder).Build();
+}
+
+JsonObject ObjectToJson(const JsonTextDocument& document, uint32_t index) {
+  JsonObjectBuilder builder;
+  builder.reserve(document.node(index).size);
+  ForEachMember(document, index, [&](uint32_t key, uint32_t value) {
+    std::string key_string;
+    JsonTape::AppendString(document.text(), document.node(key), key_string);
+    builder.insert_or_assign(JsonString(std::move(key_string)),
+                             NodeToJson(document, value));
+  });
+  return std::move(builder).Build();
+}
+
+Json NodeToJson(const JsonTextDocument& document, uint32_t index) {
+  const auto& node = document.node(index);
+  switch (node.kind) {
+    case JsonTape::Kind::kNull:
+      return kJsonNull;
+    case JsonTape::Kind::kFalse:
+      return false;
+    case JsonTape::Kind::kTrue:
+      return true;
+    case JsonTape::Kind::kNumber:
+      return JsonTape::Number(document.text(), node);
+    case JsonTape::Kind::kString: {
+      std::string string;
+      JsonTape::AppendString(document.text(), node, string);
+      return JsonString(std::move(string));
+    }
+    case JsonTape::Kind::kArray:
+      return ArrayToJson(document, index);
+    case JsonTape::Kind::kObject:
+      return ObjectToJson(document, index);
+  }
+  ABSL_UNREACHABLE();
+}
+
+// List over nodes of a JSON document: the elements of an array, or the keys of
+// an object.
+class JsonTextListValue final : public ParsedListValueInterface {
+ public:
+  JsonTextListValue(JsonTextDocumentPtr document,
+                    std::vector<uint32_t> elements)
+      : document_(std::move(document)), elements_(std::move(elements)) {}
+
+  std::string DebugString() const override {
+    std::string out;
+    out.push_back('[');
+    for (size_t i = 0; i < elements_.size(); ++i) {
+      if (i != 0) {
+        out.append(", ");
+      }
+      NodeDebugString(*document_, elements_[i], out);
+    }
+    out.push_back(']');
+    return out;
+  }
+
+  bool IsEmpty() const override { return elements_.empty(); }
+
+  size_t Size() const override { return elements_.size(); }
+
+  absl::StatusOr<JsonArray> ConvertToJsonArray(
+      AnyToJsonConverter&) const override {
+    JsonArrayBuilder builder;
+    builder.reserve(elements_.size());
+    for (uint32_t element : elements_) {
+      builder.push_back(NodeToJson(*document_, element));
+    }
+    return std::move(builder).Build();
+  }
+
+  ParsedListValue Clone(ArenaAllocator<> allocator) const override {
+    auto memory_manager = MemoryManager::Pooling(allocator.arena());
+    return ParsedListValue(memory_manager.MakeShared<JsonTextListValue>(
+        NewJsonTextDocument(memory_manager, std::string(document_->text()),
+                            document_->tape()),
+        elements_));
+  }
+
+ private:
+  absl::Status GetImpl(ValueManager& value_manager, size_t index,
+                       Value& result) const override {
+    NodeToValue(value_manager, document_, elements_[index], result);
+    return absl::OkStatus();
+  }
+
+  NativeTypeId GetNativeTypeId() const override {
+    return NativeTypeId::For<JsonTextListValue>();
+  }
+
+  const JsonTextDocumentPtr document_;
+  const std::vector<uint32_t> elements_;
+};
+
+ParsedListValue NewJsonTextArrayValue(MemoryManagerRef memory_manager,
+                                      const JsonTextDocumentPtr& document,
+                                      uint32_t index) {
+  std::vector<uint32_t> elements;
+  elements.reserve(document->node(index).size);
+  ForEachElement(*document, index,
+                 [&elements](uint32_t element) { elements.push_back(element); });
+  return ParsedListValue(memory_manager.MakeShared<JsonTextListValue>(
+      document, std::move(elements)));
+}
+
+class JsonTextMapValueKeyIterator final : public ValueIterator {
+ public:
+  JsonTextMapValueKeyIterator(const JsonTextDocumentPtr& document
+                                  ABSL_ATTRIBUTE_LIFETIME_BOUND,
+                              absl::Span<const uint32_t> keys)
+      : document_(document), keys_(keys) {}
+
+  bool HasNext() override { return !keys_.empty(); }
+
+  absl::Status Next(ValueManager& value_manager, Value& result) override {
+    if (ABSL_PREDICT_FALSE(keys_.empty())) {
+      return absl::FailedPreconditionError(
+          "ValueIterator::Next() called when "
+          "ValueIterator::HasNext() returns false");
+    }
+    result = NodeToStringValue(value_manager, document_, keys_.front());
+    keys_.remove_prefix(1);
+    return absl::OkStatus();
+  }
+
+ private:
+  const JsonTextDocumentPtr& document_;
+  absl::Span<const uint32_t> keys_;
+};
+
+// Map over the members of a JSON object. When a key occurs more than once, the
+// last occurrence wins.
+class JsonTextMapValue final : public ParsedMapValueInterface {
+ public:
+  JsonTextMapValue(JsonTextDocumentPtr document, uint32_t index)
+      : document_(std::move(document)),
+        index_(index),
+        object_index_(document_->ObjectIndex(index_)) {}
+
+  JsonTextMapValue(const JsonTextMapValue&) = delete;
+  JsonTextMapValue& operator=(const JsonTextMapValue&) = delete;
+
+  std::string DebugString() const override {
+    std::string out;
+    ObjectDebugString(*document_, index_, out);
+    return out;
+  }
+
+  bool IsEmpty() const override { return object_index_.keys.empty(); }
+
+  size_t Size() const override { return object_index_.keys.size(); }
+
+  absl::Status ListKeys(ValueManager& value_manager,
+                        ListValue& result) const override {
+    result = ParsedListValue(
+        value_manager.GetMemoryManager().MakeShared<JsonTextListValue>(
+            document_, object_index_.key_nodes));
+    return absl::OkStatus();
+  }
+
+  absl::StatusOr<absl::Nonnull<ValueIteratorPtr>> NewIterator(
+      ValueManager&) const override {
+    return std::make_unique<JsonTextMapValueKeyIterator>(
+        document_, object_index_.key_nodes);
+  }
+
+  absl::StatusOr<JsonObject> ConvertToJsonObject(
+      AnyToJsonConverter&) const override {
+    return ObjectToJson(*document_, index_);
+  }
+
+  ParsedMapValue Clone(ArenaAllocator<> allocator) const override {
+    auto memory_manager = MemoryManager::Pooling(allocator.arena());
+    return ParsedMapValue(memory_manager.MakeShared<JsonTextMapValue>(
+        NewJsonTextDocument(memory_manager, std::string(document_->text()),
+                            document_->tape()),
+        index_));
+  }
+
+ private:
+  absl::StatusOr<bool> FindImpl(ValueManager& value_manager, const Value& key,
+                                Value& result) const override {
+    const auto key_node = Lookup(key);
+    if (!key_node.has_value()) {
+      return false;
+    }
+    NodeToValue(value_manager, document_, *key_node + 1, result);
+    return true;
+  }
+
+  absl::StatusOr<bool> HasImpl(ValueManager&, const Value& key) const override {
+    return Lookup(key).has_value();
+  }
+
+  NativeTypeId GetNativeTypeId() const override {
+    return NativeTypeId::For<JsonTextMapValue>();
+  }
+
+  // Returns the key node of the member whose key is `key`.
+  absl::optional<uint32_t> Lookup(const Value& key) const {
+    const auto string_key = key.AsString();
+    if (!string_key.has_value()) {
+      return absl::nullopt;
+    }
+    std::string scratch;
+    return object_index_.Find(string_key->NativeString(scratch));
+  }
+
+  const JsonTextDocumentPtr document_;
+  const uint32_t index_;
+  // Owned by `document_`.
+  const JsonTextObjectIndex& object_index_;
+};
+
+void NodeToValue(ValueFactory& value_factory,
+                 const JsonTextDocumentPtr& document, uint32_t index,
+                 Value& result) {
+  const auto& node = document->node(index);
+  switch (node.kind) {
+    case JsonTape::Kind::kNull:
+      result = NullValue();
+      break;
+    case JsonTape::Kind::kFalse:
+      result = BoolValue(false);
+      break;
+    case JsonTape::Kind::kTrue:
+      result = BoolValue(true);
+      break;
+    case JsonTape::Kind::kNumber:
+      result = DoubleValue(JsonTape::Number(document->text(), node));
+      break;
+    case JsonTape::Kind::kString:
+      result = NodeToStringValue(value_factory, document, index);
+      break;
+    case JsonTape::Kind::kArray:
+      if (node.size == 0) {
+        result = ListValue();
+      } else {
+        result = NewJsonTextArrayValue(value_factory.GetMemoryManager(),
+                                       document, index);
+      }
+      break;
+    case JsonTape::Kind::kObject:
+      if (node.size == 0) {
+        result = MapValue();
+      } else {
+        result = ParsedMapValue(
+            value_factory.GetMemoryManager().MakeShared<JsonTextMapValue>(
+                document, index));
+      }
+      break;
+  }
+}
+
+}  // namespace
+
+absl::StatusOr<Value> ParsedJsonTextValue(ValueFactory& value_factory,
+                                          std::string text) {
+  CEL_ASSIGN_OR_RETURN(auto tape, JsonTape::Parse(text));
+  Value result;
+  NodeToValue(value_factory,
+              NewJsonTextDocument(value_factory.GetMemoryManager(),
+                                  std::move(text), std::move(tape)),
+              0, result);
+  return result;
+}
+
+}  // namespace cel::common_internal
@@ -0,0 +1,44 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_COMMON_VALUES_PARSED_JSON_TEXT_VALUE_H_
+#define THIRD_PARTY_CEL_CPP_COMMON_VALUES_PARSED_JSON_TEXT_VALUE_H_
+
+#include <string>
+
+#include "absl/status/statusor.h"
+
+namespace cel {
+
+class Value;
+class ValueFactory;
+
+namespace common_internal {
+
+// Parses the JSON document `text` and adapts it to `cel::Value`, without going
+// through `google.protobuf.Value`.
+//
+// The whole document is validated up front, but arrays and objects are only
+// materialized as they are accessed: a lookup in an object does not convert
+// any of its other members. Strings without escape sequences reference `text`,
+// which is kept alive by the memory manager of `value_factory` for as long as
+// any value derived from it.
+absl::StatusOr<Value> ParsedJsonTextValue(ValueFactory& value_factory,
+                                          std::string text);
+
+}  // namespace common_internal
+
+}  // namespace cel
+
+#endif  // THIRD_PARTY_CEL_CPP_COMMON_VALUES_PARSED_JSON_TEXT_VALUE_H_
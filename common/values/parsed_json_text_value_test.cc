@@ -0,0 +1,181 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "common/values/parsed_json_text_value.h"
+
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/status_matchers.h"
+#include "absl/strings/str_cat.h"
+#include "common/casting.h"
+#include "common/json.h"
+#include "common/memory.h"
+#include "common/value.h"
+#include "common/value_testing.h"
+#include "internal/testing.h"
+
+namespace cel {
+namespace {
+
+using ::absl_testing::IsOkAndHolds;
+using ::absl_testing::StatusIs;
+using ::cel::test::BoolValueIs;
+using ::cel::test::DoubleValueIs;
+using ::cel::test::IsNullValue;
+using ::cel::test::StringValueIs;
+using ::testing::UnorderedElementsAre;
+
+using ParsedJsonTextValueTest = common_internal::ThreadCompatibleValueTest<>;
+
+TEST_P(ParsedJsonTextValueTest, Scalars) {
+  EXPECT_THAT(value_manager().CreateValueFromJsonText("null"),
+              IsOkAndHolds(IsNullValue()));
+  EXPECT_THAT(value_manager().CreateValueFromJsonText("true"),
+              IsOkAndHolds(BoolValueIs(true)));
+  EXPECT_THAT(value_manager().CreateValueFromJsonText("-1.5e1"),
+              IsOkAndHolds(DoubleValueIs(-15)));
+  EXPECT_THAT(value_manager().CreateValueFromJsonText(R"json("a\nb")json"),
+              IsOkAndHolds(StringValueIs("a\nb")));
+}
+
+TEST_P(ParsedJsonTextValueTest, Invalid) {
+  EXPECT_THAT(value_manager().CreateValueFromJsonText("[1, 2"),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(value_manager().CreateValueFromJsonText("{\"a\": }"),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST_P(ParsedJsonTextValueTest, List) {
+  ASSERT_OK_AND_ASSIGN(
+      auto value,
+      value_manager().CreateValueFromJsonText(R"json([1, "two", [true]])json"));
+  ASSERT_TRUE(InstanceOf<ListValue>(value));
+  auto list_value = Cast<ListValue>(value);
+  EXPECT_THAT(list_value.Size(), IsOkAndHolds(3));
+  EXPECT_THAT(list_value.Get(value_manager(), 0),
+              IsOkAndHolds(DoubleValueIs(1)));
+  EXPECT_THAT(list_value.Get(value_manager(), 1),
+              IsOkAndHolds(StringValueIs("two")));
+  ASSERT_OK_AND_ASSIGN(auto nested, list_value.Get(value_manager(), 2));
+  ASSERT_TRUE(InstanceOf<ListValue>(nested));
+  EXPECT_THAT(Cast<ListValue>(nested).Get(value_manager(), 0),
+              IsOkAndHolds(BoolValueIs(true)));
+  EXPECT_EQ(list_value.DebugString(), "[1.0, \"two\", [true]]");
+  EXPECT_THAT(list_value.ConvertToJson(value_manager()),
+              IsOkAndHolds(Json(MakeJsonArray(
+                  {1.0, JsonString("two"), MakeJsonArray({true})}))));
+}
+
+TEST_P(ParsedJsonTextValueTest, Map) {
+  ASSERT_OK_AND_ASSIGN(auto value,
+                       value_manager().CreateValueFromJsonText(
+                           R"json({"b": {"c": null}, "a": 1, "d": "e",
+                                   "a": 2})json"));
+  ASSERT_TRUE(InstanceOf<MapValue>(value));
+  auto map_value = Cast<MapValue>(value);
+  EXPECT_THAT(map_value.Size(), IsOkAndHolds(3));
+  EXPECT_THAT(map_value.Get(value_manager(), StringValue("a")),
+              IsOkAndHolds(DoubleValueIs(2)));
+  EXPECT_THAT(map_value.Get(value_manager(), StringValue("d")),
+              IsOkAndHolds(StringValueIs("e")));
+  EXPECT_THAT(map_value.Has(value_manager(), StringValue("z")),
+              IsOkAndHolds(BoolValueIs(false)));
+  EXPECT_THAT(map_value.Has(value_manager(), IntValue(1)),
+              IsOkAndHolds(BoolValueIs(false)));
+  ASSERT_OK_AND_ASSIGN(auto nested,
+                       map_value.Get(value_manager(), StringValue("b")));
+  ASSERT_TRUE(InstanceOf<MapValue>(nested));
+  EXPECT_THAT(Cast<MapValue>(nested).Get(value_manager(), StringValue("c")),
+              IsOkAndHolds(IsNullValue()));
+  EXPECT_EQ(map_value.DebugString(),
+            "{\"a\": 2.0, \"b\": {\"c\": null}, \"d\": \"e\"}");
+
+  ASSERT_OK_AND_ASSIGN(auto keys, map_value.ListKeys(value_manager()));
+  ASSERT_OK_AND_ASSIGN(auto iterator, keys.NewIterator(value_manager()));
+  std::vector<std::string> key_strings;
+  while (iterator->HasNext()) {
+    ASSERT_OK_AND_ASSIGN(auto key, iterator->Next(value_manager()));
+    ASSERT_TRUE(InstanceOf<StringValue>(key));
+    key_strings.push_back(Cast<StringValue>(key).NativeString());
+  }
+  EXPECT_THAT(key_strings, UnorderedElementsAre("a", "b", "d"));
+}
+
+TEST_P(ParsedJsonTextValueTest, NestedMapsAgreeOnDuplicateKeys) {
+  ASSERT_OK_AND_ASSIGN(auto value,
+                       value_manager().CreateValueFromJsonText(
+                           R"json({"a": {"b": {"c": 1, "c": 2},
+                                         "b": {"c": 3}}})json"));
+  ASSERT_TRUE(InstanceOf<MapValue>(value));
+  EXPECT_EQ(value.DebugString(), "{\"a\": {\"b\": {\"c\": 3.0}}}");
+  // Repeated lookups of the same members reuse the index of each object.
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_OK_AND_ASSIGN(
+        auto a, Cast<MapValue>(value).Get(value_manager(), StringValue("a")));
+    EXPECT_THAT(Cast<MapValue>(a).Size(), IsOkAndHolds(1));
+    EXPECT_EQ(a.DebugString(), "{\"b\": {\"c\": 3.0}}");
+    ASSERT_OK_AND_ASSIGN(
+        auto b, Cast<MapValue>(a).Get(value_manager(), StringValue("b")));
+    EXPECT_THAT(Cast<MapValue>(b).Get(value_manager(), StringValue("c")),
+                IsOkAndHolds(DoubleValueIs(3)));
+  }
+}
+
+TEST_P(ParsedJsonTextValueTest, LargeMap) {
+  std::string text = "{";
+  for (int i = 0; i < 64; ++i) {
+    absl::StrAppend(&text, i == 0 ? "" : ", ", "\"key", i, "\": ", i);
+  }
+  text.push_back('}');
+  ASSERT_OK_AND_ASSIGN(auto value,
+                       value_manager().CreateValueFromJsonText(text));
+  ASSERT_TRUE(InstanceOf<MapValue>(value));
+  auto map_value = Cast<MapValue>(value);
+  EXPECT_THAT(map_value.Size(), IsOkAndHolds(64));
+  for (int i = 0; i < 64; ++i) {
+    EXPECT_THAT(
+        map_value.Get(value_manager(), StringValue(absl::StrCat("key", i))),
+        IsOkAndHolds(DoubleValueIs(i)));
+  }
+  EXPECT_THAT(map_value.Has(value_manager(), StringValue("key64")),
+              IsOkAndHolds(BoolValueIs(false)));
+}
+
+TEST_P(ParsedJsonTextValueTest, OutlivesFactoryInput) {
+  Value element;
+  {
+    std::string text =
+        R"json({"list": ["a string long enough to not be inlined"]})json";
+    ASSERT_OK_AND_ASSIGN(auto value,
+                         value_manager().CreateValueFromJsonText(text));
+    ASSERT_OK_AND_ASSIGN(
+        auto list, Cast<MapValue>(value).Get(value_manager(),
+                                             StringValue("list")));
+    ASSERT_OK_AND_ASSIGN(element,
+                         Cast<ListValue>(list).Get(value_manager(), 0));
+  }
+  EXPECT_THAT(element,
+              StringValueIs("a string long enough to not be inlined"));
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    ParsedJsonTextValueTest, ParsedJsonTextValueTest,
+    ::testing::Values(MemoryManagement::kPooling,
+                      MemoryManagement::kReferenceCounting),
+    ParsedJsonTextValueTest::ToString);
+
+}  // namespace
+}  // namespace cel
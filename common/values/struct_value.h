@@ -473,6 +473,12 @@ class StructValueBuilder {
 
   virtual absl::Status SetFieldByNumber(int64_t number, Value value) = 0;
 
+  // Sets the field described by `field`, which was resolved ahead of time
+  // against the type being built, for example while planning an expression.
+  // Builders backed by protocol buffer reflection override this to use the
+  // field descriptor directly instead of looking it up again by name.
+  virtual absl::Status SetField(const MessageTypeField& field, Value value);
+
   virtual absl::StatusOr<StructValue> Build() && = 0;
 };
 
@@ -1055,6 +1055,13 @@ class StructValueBuilderImpl final : public StructValueBuilder {
     return SetField(field, std::move(value));
   }
 
+  absl::Status SetField(const MessageTypeField& field, Value value) override {
+    if (ABSL_PREDICT_FALSE(field->containing_type() != descriptor_)) {
+      return StructValueBuilder::SetField(field, std::move(value));
+    }
+    return SetField(&*field, std::move(value));
+  }
+
   absl::StatusOr<StructValue> Build() && override {
     return ParsedMessageValue(
         WrapShared(std::exchange(message_, nullptr), Allocator(arena_)));
@@ -1531,6 +1538,16 @@ absl::StatusOr<absl::Nonnull<cel::StructValueBuilderPtr>> NewStructValueBuilder(
     return absl::NotFoundError(
         absl::StrCat("unable to find descriptor for type: ", name));
   }
+  return NewStructValueBuilder(allocator, descriptor_pool, message_factory,
+                               descriptor);
+}
+
+absl::StatusOr<absl::Nonnull<cel::StructValueBuilderPtr>> NewStructValueBuilder(
+    Allocator<> allocator,
+    absl::Nonnull<const google::protobuf::DescriptorPool*> descriptor_pool,
+    absl::Nonnull<google::protobuf::MessageFactory*> message_factory,
+    absl::Nonnull<const google::protobuf::Descriptor*> descriptor) {
+  ABSL_DCHECK_EQ(descriptor->file()->pool(), descriptor_pool);
   const auto* prototype = message_factory->GetPrototype(descriptor);
   if (prototype == nullptr) {
     return absl::NotFoundError(absl::StrCat(
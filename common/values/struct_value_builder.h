@@ -35,6 +35,14 @@ absl::StatusOr<absl::Nonnull<cel::StructValueBuilderPtr>> NewStructValueBuilder(
     absl::Nonnull<google::protobuf::MessageFactory*> message_factory,
     absl::string_view name);
 
+// Same as above, but for a descriptor which was already looked up in
+// `descriptor_pool`.
+absl::StatusOr<absl::Nonnull<cel::StructValueBuilderPtr>> NewStructValueBuilder(
+    Allocator<> allocator,
+    absl::Nonnull<const google::protobuf::DescriptorPool*> descriptor_pool,
+    absl::Nonnull<google::protobuf::MessageFactory*> message_factory,
+    absl::Nonnull<const google::protobuf::Descriptor*> descriptor);
+
 }  // namespace common_internal
 
 }  // namespace cel
@@ -0,0 +1,131 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "compiler/batch_compiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT(build/c++11)
+#include <utility>
+#include <vector>
+
+#include "absl/base/nullability.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_join.h"
+#include "absl/types/span.h"
+#include "checker/type_check_issue.h"
+#include "checker/type_checker.h"
+#include "checker/validation_result.h"
+#include "common/ast.h"
+#include "common/source.h"
+#include "internal/status_macros.h"
+#include "parser/macro_registry.h"
+#include "parser/options.h"
+#include "parser/parser.h"
+#include "parser/standard_macros.h"
+#include "runtime/runtime.h"
+
+namespace cel {
+namespace {
+
+absl::StatusOr<std::unique_ptr<Program>> CompileOne(
+    const Runtime& runtime, absl::Nullable<const TypeChecker*> type_checker,
+    const MacroRegistry& registry, const ParserOptions& parser_options,
+    const std::string& expression) {
+  CEL_ASSIGN_OR_RETURN(auto source, NewSource(expression));
+  CEL_ASSIGN_OR_RETURN(std::unique_ptr<Ast> ast,
+                       google::api::expr::parser::ParseAst(*source, registry,
+                                                           parser_options));
+  if (type_checker != nullptr) {
+    CEL_ASSIGN_OR_RETURN(ValidationResult result,
+                         type_checker->Check(std::move(ast)));
+    if (!result.IsValid()) {
+      return absl::InvalidArgumentError(absl::StrJoin(
+          result.GetIssues(), "\n",
+          [&source](std::string* out, const TypeCheckIssue& issue) {
+            out->append(issue.ToDisplayString(*source));
+          }));
+    }
+    CEL_ASSIGN_OR_RETURN(ast, result.ReleaseAst());
+  }
+  return runtime.CreateProgram(std::move(ast));
+}
+
+size_t NumThreads(const BatchCompileOptions& options, size_t num_expressions) {
+  size_t num_threads = options.num_threads > 0
+                           ? static_cast<size_t>(options.num_threads)
+                           : std::thread::hardware_concurrency();
+  return std::clamp<size_t>(num_threads, 1,
+                            std::max<size_t>(num_expressions, 1));
+}
+
+}  // namespace
+
+std::vector<absl::StatusOr<std::unique_ptr<Program>>> CompileBatch(
+    const Runtime& runtime, absl::Nullable<const TypeChecker*> type_checker,
+    const MacroRegistry& registry, absl::Span<const std::string> expressions,
+    const BatchCompileOptions& options) {
+  std::vector<absl::StatusOr<std::unique_ptr<Program>>> results(
+      expressions.size());
+  // Expressions are handed out one at a time rather than in fixed slices, as
+  // their compile cost varies widely and a slice of expensive expressions would
+  // otherwise leave the remaining workers idle.
+  std::atomic<size_t> next{0};
+  auto work = [&]() {
+    for (size_t i = next.fetch_add(1, std::memory_order_relaxed);
+         i < expressions.size();
+         i = next.fetch_add(1, std::memory_order_relaxed)) {
+      results[i] = CompileOne(runtime, type_checker, registry,
+                              options.parser_options, expressions[i]);
+    }
+  };
+
+  std::vector<std::thread> workers;
+  size_t num_threads = NumThreads(options, expressions.size());
+  workers.reserve(num_threads - 1);
+  for (size_t i = 1; i < num_threads; ++i) {
+    workers.emplace_back(work);
+  }
+  work();
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  return results;
+}
+
+std::vector<absl::StatusOr<std::unique_ptr<Program>>> CompileBatch(
+    const Runtime& runtime, absl::Nullable<const TypeChecker*> type_checker,
+    absl::Span<const std::string> expressions,
+    const BatchCompileOptions& options) {
+  MacroRegistry registry;
+  if (!options.parser_options.disable_standard_macros) {
+    if (absl::Status status =
+            RegisterStandardMacros(registry, options.parser_options);
+        !status.ok()) {
+      std::vector<absl::StatusOr<std::unique_ptr<Program>>> results;
+      results.reserve(expressions.size());
+      for (size_t i = 0; i < expressions.size(); ++i) {
+        results.push_back(status);
+      }
+      return results;
+    }
+  }
+  return CompileBatch(runtime, type_checker, registry, expressions, options);
+}
+
+}  // namespace cel
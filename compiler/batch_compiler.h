@@ -0,0 +1,73 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_COMPILER_BATCH_COMPILER_H_
+#define THIRD_PARTY_CEL_CPP_COMPILER_BATCH_COMPILER_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/base/nullability.h"
+#include "absl/status/statusor.h"
+#include "absl/types/span.h"
+#include "checker/type_checker.h"
+#include "parser/macro_registry.h"
+#include "parser/options.h"
+#include "runtime/runtime.h"
+
+namespace cel {
+
+// Options for `CompileBatch`.
+struct BatchCompileOptions {
+  BatchCompileOptions() {
+    parser_options.enable_recursive_descent_parser = true;
+  }
+
+  // Number of threads compiling expressions, including the calling thread. A
+  // value of zero or less uses the number of hardware threads. No more threads
+  // than expressions are ever started.
+  int num_threads = 0;
+
+  // Options used when parsing each expression. The recursive descent parser is
+  // enabled by default, as the ANTLR runtime shares its prediction caches
+  // between all threads and serializes on them.
+  ParserOptions parser_options;
+};
+
+// Parses, optionally type checks, and plans each of `expressions` into a
+// program for `runtime`, spreading the work over a pool of worker threads.
+//
+// The result has one entry per expression, in the same order. Parse errors,
+// type check issues and planning errors are reported for the affected
+// expression only, type check issues as an `InvalidArgument` status holding
+// their display strings.
+//
+// `type_checker` may be null, in which case expressions are planned without
+// being type checked. `runtime`, `type_checker` and `registry` are shared by
+// all workers and must outlive the call.
+std::vector<absl::StatusOr<std::unique_ptr<Program>>> CompileBatch(
+    const Runtime& runtime, absl::Nullable<const TypeChecker*> type_checker,
+    const MacroRegistry& registry, absl::Span<const std::string> expressions,
+    const BatchCompileOptions& options = BatchCompileOptions());
+
+// Same as above, but with the macros enabled by `options.parser_options`.
+std::vector<absl::StatusOr<std::unique_ptr<Program>>> CompileBatch(
+    const Runtime& runtime, absl::Nullable<const TypeChecker*> type_checker,
+    absl::Span<const std::string> expressions,
+    const BatchCompileOptions& options = BatchCompileOptions());
+
+}  // namespace cel
+
+#endif  // THIRD_PARTY_CEL_CPP_COMPILER_BATCH_COMPILER_H_
@@ -0,0 +1,230 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "compiler/batch_compiler.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT(build/c++11)
+#include <utility>
+#include <vector>
+
+#include "absl/log/absl_check.h"
+#include "absl/status/status.h"
+#include "absl/status/status_matchers.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "checker/standard_library.h"
+#include "checker/type_checker.h"
+#include "checker/type_checker_builder.h"
+#include "common/decl.h"
+#include "common/memory.h"
+#include "common/type.h"
+#include "common/value.h"
+#include "internal/benchmark.h"
+#include "internal/testing.h"
+#include "internal/testing_descriptor_pool.h"
+#include "runtime/activation.h"
+#include "runtime/managed_value_factory.h"
+#include "runtime/runtime.h"
+#include "runtime/runtime_options.h"
+#include "runtime/standard_runtime_builder_factory.h"
+
+namespace cel {
+namespace {
+
+using ::absl_testing::IsOk;
+using ::absl_testing::StatusIs;
+using ::cel::internal::GetSharedTestingDescriptorPool;
+using ::cel::internal::GetTestingDescriptorPool;
+using ::testing::HasSubstr;
+using ::testing::SizeIs;
+
+std::unique_ptr<const Runtime> MakeRuntime() {
+  RuntimeOptions options;
+  auto builder =
+      CreateStandardRuntimeBuilder(GetTestingDescriptorPool(), options);
+  ABSL_CHECK_OK(builder.status());
+  auto runtime = std::move(builder).value().Build();
+  ABSL_CHECK_OK(runtime.status());
+  return std::move(runtime).value();
+}
+
+std::unique_ptr<TypeChecker> MakeTypeChecker() {
+  auto builder = CreateTypeCheckerBuilder(GetSharedTestingDescriptorPool());
+  ABSL_CHECK_OK(builder.status());
+  ABSL_CHECK_OK(builder->AddLibrary(StandardLibrary()));
+  ABSL_CHECK_OK(builder->AddVariable(MakeVariableDecl("x", IntType())));
+  auto checker = std::move(builder).value().Build();
+  ABSL_CHECK_OK(checker.status());
+  return std::move(checker).value();
+}
+
+// Distinct expressions of varying cost, so that the workers do not finish in
+// lock step.
+std::vector<std::string> MakeExpressions(int count) {
+  std::vector<std::string> expressions;
+  expressions.reserve(count);
+  for (int i = 0; i < count; ++i) {
+    switch (i % 4) {
+      case 0:
+        expressions.push_back(absl::StrCat("x + ", i));
+        break;
+      case 1:
+        expressions.push_back(absl::StrCat("[1, 2, 3].map(y, y * x)[0] + ", i));
+        break;
+      case 2:
+        expressions.push_back(
+            absl::StrCat("x > 0 && x < 100 || x == ", i, " ? x : ", i));
+        break;
+      default:
+        expressions.push_back(
+            absl::StrCat("{'a': x, 'b': ", i, "}.exists(k, k == 'a') ? ", i,
+                         " : x"));
+        break;
+    }
+  }
+  return expressions;
+}
+
+int64_t Evaluate(const Runtime& runtime, const Program& program, int64_t x) {
+  ManagedValueFactory value_factory(runtime.GetTypeProvider(),
+                                    MemoryManagerRef::ReferenceCounting());
+  Activation activation;
+  activation.InsertOrAssignValue("x", IntValue(x));
+  auto result = program.Evaluate(activation, value_factory.get());
+  ABSL_CHECK_OK(result.status());
+  return result->GetInt().NativeValue();
+}
+
+TEST(BatchCompilerTest, CompilesAllExpressions) {
+  auto runtime = MakeRuntime();
+  auto checker = MakeTypeChecker();
+  std::vector<std::string> expressions = MakeExpressions(64);
+
+  BatchCompileOptions options;
+  options.num_threads = 4;
+  auto results = CompileBatch(*runtime, checker.get(), expressions, options);
+
+  ASSERT_THAT(results, SizeIs(expressions.size()));
+  for (size_t i = 0; i < results.size(); ++i) {
+    ASSERT_THAT(results[i], IsOk()) << expressions[i];
+  }
+  EXPECT_EQ(Evaluate(*runtime, **results[0], 5), 5);
+  EXPECT_EQ(Evaluate(*runtime, **results[1], 5), 6);
+  EXPECT_EQ(Evaluate(*runtime, **results[2], 5), 5);
+  EXPECT_EQ(Evaluate(*runtime, **results[3], 5), 3);
+  EXPECT_EQ(Evaluate(*runtime, **results[63], 5), 63);
+}
+
+TEST(BatchCompilerTest, MatchesSequentialCompilation) {
+  auto runtime = MakeRuntime();
+  auto checker = MakeTypeChecker();
+  std::vector<std::string> expressions = MakeExpressions(32);
+
+  BatchCompileOptions sequential_options;
+  sequential_options.num_threads = 1;
+  auto sequential =
+      CompileBatch(*runtime, checker.get(), expressions, sequential_options);
+  BatchCompileOptions parallel_options;
+  parallel_options.num_threads = 8;
+  auto parallel =
+      CompileBatch(*runtime, checker.get(), expressions, parallel_options);
+
+  ASSERT_THAT(parallel, SizeIs(sequential.size()));
+  for (size_t i = 0; i < parallel.size(); ++i) {
+    ASSERT_THAT(sequential[i], IsOk()) << expressions[i];
+    ASSERT_THAT(parallel[i], IsOk()) << expressions[i];
+    for (int64_t x : {-1, 0, 7, 42}) {
+      EXPECT_EQ(Evaluate(*runtime, **parallel[i], x),
+                Evaluate(*runtime, **sequential[i], x))
+          << expressions[i] << " with x = " << x;
+    }
+  }
+}
+
+TEST(BatchCompilerTest, ReportsErrorsPerExpression) {
+  auto runtime = MakeRuntime();
+  auto checker = MakeTypeChecker();
+  std::vector<std::string> expressions = {"x + 1", "x +", "x + 'a'", "y"};
+
+  auto results = CompileBatch(*runtime, checker.get(), expressions);
+
+  ASSERT_THAT(results, SizeIs(4));
+  EXPECT_THAT(results[0], IsOk());
+  EXPECT_THAT(results[1], StatusIs(absl::StatusCode::kInvalidArgument,
+                                   HasSubstr("Syntax error")));
+  EXPECT_THAT(results[2], StatusIs(absl::StatusCode::kInvalidArgument,
+                                   HasSubstr("no matching overload")));
+  EXPECT_THAT(results[3], StatusIs(absl::StatusCode::kInvalidArgument,
+                                   HasSubstr("undeclared reference to 'y'")));
+}
+
+TEST(BatchCompilerTest, WithoutTypeChecker) {
+  auto runtime = MakeRuntime();
+  std::vector<std::string> expressions = {"x * 2", "[x].exists(y, y > 0)"};
+
+  auto results = CompileBatch(*runtime, nullptr, expressions);
+
+  ASSERT_THAT(results, SizeIs(2));
+  ASSERT_THAT(results[0], IsOk());
+  ASSERT_THAT(results[1], IsOk());
+  EXPECT_EQ(Evaluate(*runtime, **results[0], 21), 42);
+}
+
+TEST(BatchCompilerTest, DisableStandardMacros) {
+  auto runtime = MakeRuntime();
+  std::vector<std::string> expressions = {"[x].exists(y, y > 0)"};
+
+  BatchCompileOptions options;
+  options.parser_options.disable_standard_macros = true;
+  auto checker = MakeTypeChecker();
+  auto results = CompileBatch(*runtime, checker.get(), expressions, options);
+
+  ASSERT_THAT(results, SizeIs(1));
+  EXPECT_THAT(results[0], StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(BatchCompilerTest, Empty) {
+  auto runtime = MakeRuntime();
+
+  EXPECT_THAT(CompileBatch(*runtime, nullptr, std::vector<std::string>()),
+              SizeIs(0));
+}
+
+// Compiles a fixed set of expressions with 1..N threads. Ideal scaling keeps
+// the wall time per batch inversely proportional to the thread count.
+void BM_CompileBatch(benchmark::State& state) {
+  auto runtime = MakeRuntime();
+  auto checker = MakeTypeChecker();
+  std::vector<std::string> expressions = MakeExpressions(1024);
+  BatchCompileOptions options;
+  options.num_threads = static_cast<int>(state.range(0));
+
+  for (auto _ : state) {
+    auto results = CompileBatch(*runtime, checker.get(), expressions, options);
+    benchmark::DoNotOptimize(results);
+  }
+  state.SetItemsProcessed(state.iterations() * expressions.size());
+}
+
+BENCHMARK(BM_CompileBatch)
+    ->RangeMultiplier(2)
+    ->Range(1, std::thread::hardware_concurrency())
+    ->UseRealTime();
+
+}  // namespace
+}  // namespace cel
@@ -75,10 +75,11 @@
 #include "eval/eval/optional_or_step.h"
 #include "eval/eval/select_step.h"
 #include "eval/eval/shadowable_value_step.h"
+#include "eval/eval/step_arena.h"
 #include "eval/eval/ternary_step.h"
 #include "eval/eval/trace_step.h"
 #include "internal/status_macros.h"
-#include "runtime/internal/convert_constant.h"
+#include "runtime/internal/constant_pool.h"
 #include "runtime/internal/issue_collector.h"
 #include "runtime/runtime_issue.h"
 #include "runtime/runtime_options.h"
@@ -95,7 +96,6 @@ using ::cel::StringValue;
 using ::cel::Value;
 using ::cel::ValueManager;
 using ::cel::ast_internal::AstImpl;
-using ::cel::runtime_internal::ConvertConstant;
 using ::cel::runtime_internal::IssueCollector;
 
 constexpr absl::string_view kOptionalOrFn = "or";
@@ -525,7 +525,8 @@ class FlatExprVisitor : public cel::AstVisitor {
     }
 
     absl::StatusOr<cel::Value> converted_value =
-        ConvertConstant(const_expr, value_factory_);
+        extension_context_.constant_pool().InternConstant(const_expr,
+                                                          value_factory_);
 
     if (!converted_value.ok()) {
       SetProgressStatusError(converted_value.status());
@@ -1474,10 +1475,8 @@ class FlatExprVisitor : public cel::AstVisitor {
       SetProgressStatusError(status_or_resolved_fields.status());
       return;
     }
-    std::string resolved_name =
-        std::move(status_or_resolved_fields.value().first);
-    std::vector<std::string> fields =
-        std::move(status_or_resolved_fields.value().second);
+    ResolvedCreateStruct resolved =
+        std::move(status_or_resolved_fields).value();
 
     auto depth = RecursionEligible();
     if (depth.has_value()) {
@@ -1487,14 +1486,30 @@ class FlatExprVisitor : public cel::AstVisitor {
             "Unexpected number of plan elements for CreateStruct expr"));
         return;
       }
-      auto step = CreateDirectCreateStructStep(
-          std::move(resolved_name), std::move(fields), std::move(deps),
-          MakeOptionalIndicesSet(struct_expr), expr.id());
+      std::unique_ptr<DirectExpressionStep> step;
+      if (resolved.message_type) {
+        step = CreateDirectCreateStructStep(
+            resolved.message_type, std::move(resolved.field_names),
+            std::move(resolved.message_fields), std::move(deps),
+            MakeOptionalIndicesSet(struct_expr), expr.id());
+      } else {
+        step = CreateDirectCreateStructStep(
+            std::move(resolved.name), std::move(resolved.field_names),
+            std::move(deps), MakeOptionalIndicesSet(struct_expr), expr.id());
+      }
       SetRecursiveStep(std::move(step), *depth + 1);
       return;
     }
 
-    AddStep(CreateCreateStructStep(std::move(resolved_name), std::move(fields),
+    if (resolved.message_type) {
+      AddStep(CreateCreateStructStep(
+          resolved.message_type, std::move(resolved.field_names),
+          std::move(resolved.message_fields),
+          MakeOptionalIndicesSet(struct_expr), expr.id()));
+      return;
+    }
+    AddStep(CreateCreateStructStep(std::move(resolved.name),
+                                   std::move(resolved.field_names),
                                    MakeOptionalIndicesSet(struct_expr),
                                    expr.id()));
   }
@@ -1736,10 +1751,22 @@ class FlatExprVisitor : public cel::AstVisitor {
     return absl::OkStatus();
   }
 
+  // The message type being created and the set fields, as resolved by
+  // `ResolveCreateStructFields`.
+  struct ResolvedCreateStruct {
+    std::string name;
+    std::vector<std::string> field_names;
+    // Set when the type resolved to a protocol buffer message. The step then
+    // creates the builder for it directly, instead of by name.
+    cel::MessageType message_type;
+    // Parallel to `field_names` when `message_type` is set. Fields which the
+    // type provider did not resolve to a `cel::MessageTypeField` are empty.
+    std::vector<cel::MessageTypeField> message_fields;
+  };
+
   // Resolve the name of the message type being created and the names of set
   // fields.
-  absl::StatusOr<std::pair<std::string, std::vector<std::string>>>
-  ResolveCreateStructFields(
+  absl::StatusOr<ResolvedCreateStruct> ResolveCreateStructFields(
       const cel::ast_internal::CreateStruct& create_struct_expr,
       int64_t expr_id) {
     absl::string_view ast_name = create_struct_expr.name();
@@ -1752,9 +1779,15 @@ class FlatExprVisitor : public cel::AstVisitor {
           "Invalid struct creation: missing type info for '", ast_name, "'"));
     }
 
-    std::string resolved_name = std::move(type).value().first;
+    ResolvedCreateStruct resolved;
+    resolved.name = std::move(type->first);
+    if (auto message_type = type->second.AsMessage(); message_type) {
+      resolved.message_type = *message_type;
+      resolved.message_fields.reserve(create_struct_expr.fields().size());
+    }
+    const std::string& resolved_name = resolved.name;
 
-    std::vector<std::string> fields;
+    std::vector<std::string>& fields = resolved.field_names;
     fields.reserve(create_struct_expr.fields().size());
     for (const auto& entry : create_struct_expr.fields()) {
       if (entry.name().empty()) {
@@ -1772,9 +1805,13 @@ class FlatExprVisitor : public cel::AstVisitor {
                          "' not found in '", resolved_name, "'"));
       }
       fields.push_back(entry.name());
+      if (resolved.message_type) {
+        resolved.message_fields.push_back(
+            field->AsMessage().value_or(cel::MessageTypeField()));
+      }
     }
 
-    return std::make_pair(std::move(resolved_name), std::move(fields));
+    return resolved;
   }
 
   const Resolver& resolver_;
@@ -2129,6 +2166,11 @@ std::vector<ExecutionPathView> FlattenExpressionTable(
 
 absl::StatusOr<FlatExpression> FlatExprBuilder::CreateExpressionImpl(
     std::unique_ptr<Ast> ast, std::vector<RuntimeIssue>* issues) const {
+  // Allocate the steps of the program contiguously. Declared first so that any
+  // steps still held by the locals below are destroyed under the scope.
+  auto step_arena = std::make_unique<StepArena>();
+  StepArenaScope step_arena_scope(step_arena.get());
+
   RuntimeIssue::Severity max_severity = options_.fail_on_warnings
                                             ? RuntimeIssue::Severity::kWarning
                                             : RuntimeIssue::Severity::kError;
@@ -2198,7 +2240,7 @@ absl::StatusOr<FlatExpression> FlatExprBuilder::CreateExpressionImpl(
   return FlatExpression(std::move(execution_path), std::move(subexpressions),
                         visitor.slot_count(),
                         type_registry_.GetComposedTypeProvider(), options_,
-                        std::move(arena));
+                        std::move(arena), std::move(step_arena));
 }
 
 }  // namespace google::api::expr::runtime
@@ -48,6 +48,7 @@
 #include "eval/eval/evaluator_core.h"
 #include "eval/eval/trace_step.h"
 #include "internal/casts.h"
+#include "runtime/internal/constant_pool.h"
 #include "runtime/internal/issue_collector.h"
 #include "runtime/internal/runtime_env.h"
 #include "runtime/runtime_options.h"
@@ -424,6 +425,12 @@ class PlannerContext {
                                        : environment_->MutableMessageFactory();
   }
 
+  // Returns the pool interning constant data across the programs planned with
+  // the same runtime environment.
+  cel::runtime_internal::ConstantPool& constant_pool() const {
+    return environment_->constant_pool;
+  }
+
  private:
   const std::shared_ptr<const cel::runtime_internal::RuntimeEnv> environment_;
   const Resolver& resolver_;
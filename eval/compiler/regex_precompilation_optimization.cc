@@ -23,7 +23,10 @@
 
 #include "absl/base/nullability.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "absl/types/optional.h"
 #include "base/ast_internal/ast_impl.h"
@@ -34,11 +37,13 @@
 #include "common/value.h"
 #include "eval/compiler/flat_expr_builder_extensions.h"
 #include "eval/eval/compiler_constant_step.h"
+#include "eval/eval/const_value_step.h"
 #include "eval/eval/direct_expression_step.h"
 #include "eval/eval/evaluator_core.h"
 #include "eval/eval/regex_match_step.h"
 #include "internal/casts.h"
 #include "internal/status_macros.h"
+#include "runtime/internal/constant_pool.h"
 #include "re2/re2.h"
 
 namespace google::api::expr::runtime {
@@ -87,24 +92,44 @@ bool IsFunctionOverload(const Expr& expr, absl::string_view function,
   return false;
 }
 
-// Abstraction for deduplicating regular expressions over the course of a single
-// create expression call. Should not be used during evaluation. Uses
-// std::shared_ptr and std::weak_ptr.
+// Returns a key identifying a side-effect free subject expression (an
+// identifier or a chain of field selections on an identifier), or nullopt if
+// the expression is not eligible for sharing between `matches` calls.
+absl::optional<std::string> SubjectKey(const Expr& expr) {
+  if (expr.has_ident_expr()) {
+    return expr.ident_expr().name();
+  }
+  if (expr.has_select_expr() && !expr.select_expr().test_only() &&
+      expr.select_expr().has_operand()) {
+    absl::optional<std::string> operand_key =
+        SubjectKey(expr.select_expr().operand());
+    if (!operand_key.has_value()) {
+      return absl::nullopt;
+    }
+    return absl::StrCat(*operand_key, ".", expr.select_expr().field());
+  }
+  return absl::nullopt;
+}
+
+bool IsLogicalOr(const Expr& expr) {
+  return expr.has_call_expr() &&
+         expr.call_expr().function() == cel::builtin::kOr &&
+         !expr.call_expr().has_target() && expr.call_expr().args().size() == 2;
+}
+
+// Abstraction for building the regular expressions of a create expression
+// call. Programs are interned in the runtime's constant pool, so identical
+// patterns share one compiled program across all programs of the runtime.
+// Should not be used during evaluation.
 class RegexProgramBuilder final {
  public:
-  explicit RegexProgramBuilder(int max_program_size)
-      : max_program_size_(max_program_size) {}
+  RegexProgramBuilder(cel::runtime_internal::ConstantPool& constant_pool,
+                      int max_program_size)
+      : constant_pool_(constant_pool), max_program_size_(max_program_size) {}
 
   absl::StatusOr<std::shared_ptr<const RE2>> BuildRegexProgram(
-      std::string pattern) {
-    auto existing = programs_.find(pattern);
-    if (existing != programs_.end()) {
-      if (auto program = existing->second.lock(); program) {
-        return program;
-      }
-      programs_.erase(existing);
-    }
-    auto program = std::make_shared<RE2>(pattern);
+      absl::string_view pattern) {
+    std::shared_ptr<const RE2> program = constant_pool_.InternRegex(pattern);
     if (max_program_size_ > 0 && program->ProgramSize() > max_program_size_) {
       return absl::InvalidArgumentError("exceeded RE2 max program size");
     }
@@ -112,23 +137,27 @@ class RegexProgramBuilder final {
       return absl::InvalidArgumentError(
           "invalid_argument unsupported RE2 pattern for matches");
     }
-    programs_.insert({std::move(pattern), program});
     return program;
   }
 
  private:
+  cel::runtime_internal::ConstantPool& constant_pool_;
   const int max_program_size_;
-  absl::flat_hash_map<std::string, std::weak_ptr<const RE2>> programs_;
 };
 
 class RegexPrecompilationOptimization : public ProgramOptimizer {
  public:
-  explicit RegexPrecompilationOptimization(const ReferenceMap& reference_map,
-                                           int regex_max_program_size)
+  RegexPrecompilationOptimization(
+      const ReferenceMap& reference_map,
+      cel::runtime_internal::ConstantPool& constant_pool,
+      int regex_max_program_size)
       : reference_map_(reference_map),
-        regex_program_builder_(regex_max_program_size) {}
+        regex_program_builder_(constant_pool, regex_max_program_size) {}
 
   absl::Status OnPreVisit(PlannerContext& context, const Expr& node) override {
+    if (IsLogicalOr(node) && !visited_disjunctions_.contains(&node)) {
+      return PlanDisjunction(node);
+    }
     return absl::OkStatus();
   }
 
@@ -143,6 +172,15 @@ class RegexPrecompilationOptimization : public ProgramOptimizer {
     ProgramBuilder::Subexpression* subexpression =
         context.program_builder().GetSubexpression(&node);
 
+    if (auto it = disjunct_groups_.find(&node); it != disjunct_groups_.end()) {
+      CEL_ASSIGN_OR_RETURN(bool rewritten,
+                           RewriteDisjunct(context, subexpression, node,
+                                           *it->second));
+      if (rewritten) {
+        return absl::OkStatus();
+      }
+    }
+
     const Call& call_expr = node.call_expr();
     const Expr& pattern_expr = call_expr.args().back();
 
@@ -156,7 +194,7 @@ class RegexPrecompilationOptimization : public ProgramOptimizer {
 
     CEL_ASSIGN_OR_RETURN(
         std::shared_ptr<const RE2> regex_program,
-        regex_program_builder_.BuildRegexProgram(std::move(pattern).value()));
+        regex_program_builder_.BuildRegexProgram(*pattern));
 
     if (subexpression == nullptr || subexpression->IsFlattened()) {
       // Already modified, can't update further.
@@ -167,10 +205,160 @@ class RegexPrecompilationOptimization : public ProgramOptimizer {
         call_expr.has_target() ? call_expr.target() : call_expr.args().front();
 
     return RewritePlan(context, subexpression, node, subject_expr,
-                       std::move(regex_program));
+                       MatchProgram{std::move(regex_program), nullptr})
+        .status();
   }
 
  private:
+  // The compiled program replacing a `matches` call: either a single regex or
+  // a set of regexes that are checked in one scan.
+  struct MatchProgram {
+    std::shared_ptr<const RE2> re2;
+    std::shared_ptr<const RegexSetProgram> regex_set;
+  };
+
+  // A group of `matches` calls on the same subject with constant patterns that
+  // are disjuncts of the same `||` tree.
+  //
+  // The first call in the group (in planning order) is replaced with a single
+  // RE2::Set scan over all of the patterns and the remaining calls are
+  // replaced with `false`. Since CEL `||` is commutative, including for errors
+  // and unknowns, this preserves the result of the disjunction.
+  struct DisjunctGroup {
+    std::vector<const Expr*> calls;
+    std::vector<std::string> patterns;
+    enum class State { kPending, kRewritten, kAbandoned };
+    State state = State::kPending;
+  };
+
+  // Collects the disjuncts of the `||` tree rooted at `node` and groups the
+  // eligible `matches` calls by subject.
+  absl::Status PlanDisjunction(const Expr& node) {
+    std::vector<const Expr*> disjuncts;
+    std::vector<const Expr*> stack = {&node};
+    while (!stack.empty()) {
+      const Expr* expr = stack.back();
+      stack.pop_back();
+      if (IsLogicalOr(*expr)) {
+        visited_disjunctions_.insert(expr);
+        // Push right first so disjuncts are collected in planning order.
+        stack.push_back(&expr->call_expr().args()[1]);
+        stack.push_back(&expr->call_expr().args()[0]);
+        continue;
+      }
+      disjuncts.push_back(expr);
+    }
+
+    absl::flat_hash_map<std::string, std::shared_ptr<DisjunctGroup>> groups;
+    std::vector<std::shared_ptr<DisjunctGroup>> ordered_groups;
+    for (const Expr* disjunct : disjuncts) {
+      if (!IsFunctionOverload(*disjunct, cel::builtin::kRegexMatch,
+                              "matches_string", 2, reference_map_)) {
+        continue;
+      }
+      const Call& call_expr = disjunct->call_expr();
+      const Expr& pattern_expr = call_expr.args().back();
+      if (!pattern_expr.has_const_expr() ||
+          !pattern_expr.const_expr().has_string_value()) {
+        continue;
+      }
+      const Expr& subject_expr = call_expr.has_target()
+                                     ? call_expr.target()
+                                     : call_expr.args().front();
+      absl::optional<std::string> key = SubjectKey(subject_expr);
+      if (!key.has_value()) {
+        continue;
+      }
+      auto& group = groups[*key];
+      if (group == nullptr) {
+        group = std::make_shared<DisjunctGroup>();
+        ordered_groups.push_back(group);
+      }
+      group->calls.push_back(disjunct);
+      group->patterns.push_back(pattern_expr.const_expr().string_value());
+    }
+
+    for (const auto& group : ordered_groups) {
+      if (group->calls.size() < 2) {
+        continue;
+      }
+      for (const Expr* call : group->calls) {
+        disjunct_groups_[call] = group;
+      }
+    }
+    return absl::OkStatus();
+  }
+
+  absl::StatusOr<std::shared_ptr<const RegexSetProgram>> BuildRegexSet(
+      const DisjunctGroup& group) {
+    auto regex_set = std::make_shared<RegexSetProgram>();
+    for (const std::string& pattern : group.patterns) {
+      // Validates the pattern and enforces the program size limit in the same
+      // way as for a single precompiled regex.
+      CEL_ASSIGN_OR_RETURN(std::shared_ptr<const RE2> program,
+                           regex_program_builder_.BuildRegexProgram(pattern));
+      regex_set->programs.push_back(std::move(program));
+      if (regex_set->set.Add(pattern, /*error=*/nullptr) < 0) {
+        return nullptr;
+      }
+    }
+    if (!regex_set->set.Compile()) {
+      return nullptr;
+    }
+    return regex_set;
+  }
+
+  // Rewrites a `matches` call that is part of a disjunct group. Returns false
+  // if the call should be planned as a standalone `matches` call instead.
+  absl::StatusOr<bool> RewriteDisjunct(
+      PlannerContext& context,
+      absl::Nullable<ProgramBuilder::Subexpression*> subexpression,
+      const Expr& node, DisjunctGroup& group) {
+    using State = DisjunctGroup::State;
+    if (group.state == State::kAbandoned) {
+      return false;
+    }
+    if (subexpression == nullptr || subexpression->IsFlattened()) {
+      // Already modified. If this is the head of the group, give up on the
+      // group. Otherwise the call is redundant but still correct.
+      if (group.state == State::kPending) {
+        group.state = State::kAbandoned;
+      }
+      return false;
+    }
+
+    if (group.state == State::kRewritten) {
+      if (subexpression->IsRecursive()) {
+        subexpression->set_recursive_program(
+            CreateConstValueDirectStep(cel::BoolValue(false), node.id()),
+            /*depth=*/1);
+        return true;
+      }
+      ExecutionPath path;
+      CEL_ASSIGN_OR_RETURN(
+          path.emplace_back(),
+          CreateConstValueStep(cel::BoolValue(false), node.id()));
+      CEL_RETURN_IF_ERROR(context.ReplaceSubplan(node, std::move(path)));
+      return true;
+    }
+
+    CEL_ASSIGN_OR_RETURN(std::shared_ptr<const RegexSetProgram> regex_set,
+                         BuildRegexSet(group));
+    if (regex_set == nullptr) {
+      group.state = State::kAbandoned;
+      return false;
+    }
+    const Call& call_expr = node.call_expr();
+    const Expr& subject_expr =
+        call_expr.has_target() ? call_expr.target() : call_expr.args().front();
+    CEL_ASSIGN_OR_RETURN(
+        bool rewritten,
+        RewritePlan(context, subexpression, node, subject_expr,
+                    MatchProgram{nullptr, std::move(regex_set)}));
+    group.state = rewritten ? State::kRewritten : State::kAbandoned;
+    return rewritten;
+  }
+
   absl::optional<std::string> GetConstantString(
       PlannerContext& context,
       absl::Nullable<ProgramBuilder::Subexpression*> subexpression,
@@ -213,57 +401,73 @@ class RegexPrecompilationOptimization : public ProgramOptimizer {
     return absl::nullopt;
   }
 
-  absl::Status RewritePlan(
+  absl::StatusOr<bool> RewritePlan(
       PlannerContext& context,
       absl::Nonnull<ProgramBuilder::Subexpression*> subexpression,
-      const Expr& call, const Expr& subject,
-      std::shared_ptr<const RE2> regex_program) {
+      const Expr& call, const Expr& subject, MatchProgram program) {
     if (subexpression->IsRecursive()) {
       return RewriteRecursivePlan(subexpression, call, subject,
-                                  std::move(regex_program));
+                                  std::move(program));
     }
-    return RewriteStackMachinePlan(context, call, subject,
-                                   std::move(regex_program));
+    return RewriteStackMachinePlan(context, call, subject, std::move(program));
   }
 
-  absl::Status RewriteRecursivePlan(
+  bool RewriteRecursivePlan(
       absl::Nonnull<ProgramBuilder::Subexpression*> subexpression,
-      const Expr& call, const Expr& subject,
-      std::shared_ptr<const RE2> regex_program) {
+      const Expr& call, const Expr& subject, MatchProgram match_program) {
     auto program = subexpression->ExtractRecursiveProgram();
     auto deps = program.step->ExtractDependencies();
     if (!deps.has_value() || deps->size() != 2) {
       // Possibly already const-folded, put the plan back.
       subexpression->set_recursive_program(std::move(program.step),
                                            program.depth);
-      return absl::OkStatus();
+      return false;
+    }
+    if (match_program.regex_set != nullptr) {
+      subexpression->set_recursive_program(
+          CreateDirectRegexSetMatchStep(call.id(), std::move(deps->at(0)),
+                                        std::move(match_program.regex_set)),
+          program.depth);
+      return true;
     }
     subexpression->set_recursive_program(
         CreateDirectRegexMatchStep(call.id(), std::move(deps->at(0)),
-                                   std::move(regex_program)),
+                                   std::move(match_program.re2)),
         program.depth);
-    return absl::OkStatus();
+    return true;
   }
 
-  absl::Status RewriteStackMachinePlan(
-      PlannerContext& context, const Expr& call, const Expr& subject,
-      std::shared_ptr<const RE2> regex_program) {
+  absl::StatusOr<bool> RewriteStackMachinePlan(PlannerContext& context,
+                                               const Expr& call,
+                                               const Expr& subject,
+                                               MatchProgram match_program) {
     if (context.GetSubplan(subject).empty()) {
       // This subexpression was already optimized, nothing to do.
-      return absl::OkStatus();
+      return false;
     }
 
     CEL_ASSIGN_OR_RETURN(ExecutionPath new_plan,
                          context.ExtractSubplan(subject));
-    CEL_ASSIGN_OR_RETURN(
-        new_plan.emplace_back(),
-        CreateRegexMatchStep(std::move(regex_program), call.id()));
+    if (match_program.regex_set != nullptr) {
+      CEL_ASSIGN_OR_RETURN(
+          new_plan.emplace_back(),
+          CreateRegexSetMatchStep(std::move(match_program.regex_set),
+                                  call.id()));
+    } else {
+      CEL_ASSIGN_OR_RETURN(
+          new_plan.emplace_back(),
+          CreateRegexMatchStep(std::move(match_program.re2), call.id()));
+    }
 
-    return context.ReplaceSubplan(call, std::move(new_plan));
+    CEL_RETURN_IF_ERROR(context.ReplaceSubplan(call, std::move(new_plan)));
+    return true;
   }
 
   const ReferenceMap& reference_map_;
   RegexProgramBuilder regex_program_builder_;
+  absl::flat_hash_set<const Expr*> visited_disjunctions_;
+  absl::flat_hash_map<const Expr*, std::shared_ptr<DisjunctGroup>>
+      disjunct_groups_;
 };
 
 }  // namespace
@@ -272,7 +476,7 @@ ProgramOptimizerFactory CreateRegexPrecompilationExtension(
     int regex_max_program_size) {
   return [=](PlannerContext& context, const AstImpl& ast) {
     return std::make_unique<RegexPrecompilationOptimization>(
-        ast.reference_map(), regex_max_program_size);
+        ast.reference_map(), context.constant_pool(), regex_max_program_size);
   };
 }
 }  // namespace google::api::expr::runtime
@@ -214,6 +214,82 @@ TEST_P(RegexPrecompilationExtensionTest, DoesNotOptimizeCompoundExpr) {
   EXPECT_THAT(string_values_, ElementsAre("input123", "abc", "def", "abcdef"));
 }
 
+TEST_P(RegexPrecompilationExtensionTest, DisjunctionUsesSingleScan) {
+  builder_.flat_expr_builder().AddProgramOptimizer(
+      CreateRegexPrecompilationExtension(options_.regex_max_program_size));
+
+  ASSERT_OK_AND_ASSIGN(
+      exprpb::ParsedExpr expr,
+      Parse("input.matches('^a') || input.matches('^b') || "
+            "input.matches('[0-9]$')"));
+
+  ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<CelExpression> plan,
+      builder_.CreateExpression(&expr.expr(), &expr.source_info()));
+
+  Activation activation;
+  google::protobuf::Arena arena;
+  activation.InsertValue("input", CelValue::CreateStringView("input123"));
+
+  ASSERT_OK_AND_ASSIGN(CelValue result,
+                       plan->Trace(activation, &arena, RecordStringValues()));
+  EXPECT_THAT(string_values_, ElementsAre("input123"));
+  ASSERT_TRUE(result.IsBool());
+  EXPECT_TRUE(result.BoolOrDie());
+
+  string_values_.clear();
+  activation.RemoveValueEntry("input");
+  activation.InsertValue("input", CelValue::CreateStringView("cat"));
+  ASSERT_OK_AND_ASSIGN(result,
+                       plan->Trace(activation, &arena, RecordStringValues()));
+  EXPECT_THAT(string_values_, ElementsAre("cat"));
+  ASSERT_TRUE(result.IsBool());
+  EXPECT_FALSE(result.BoolOrDie());
+}
+
+TEST_P(RegexPrecompilationExtensionTest, DisjunctionGroupsBySubject) {
+  builder_.flat_expr_builder().AddProgramOptimizer(
+      CreateRegexPrecompilationExtension(options_.regex_max_program_size));
+
+  ASSERT_OK_AND_ASSIGN(
+      exprpb::ParsedExpr expr,
+      Parse("input.matches('^x') || other.matches('^y') || "
+            "input.matches('^z') || other.matches('^o')"));
+
+  ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<CelExpression> plan,
+      builder_.CreateExpression(&expr.expr(), &expr.source_info()));
+
+  Activation activation;
+  google::protobuf::Arena arena;
+  activation.InsertValue("input", CelValue::CreateStringView("input"));
+  activation.InsertValue("other", CelValue::CreateStringView("other"));
+
+  ASSERT_OK_AND_ASSIGN(CelValue result,
+                       plan->Trace(activation, &arena, RecordStringValues()));
+  EXPECT_THAT(string_values_, ElementsAre("input", "other"));
+  ASSERT_TRUE(result.IsBool());
+  EXPECT_TRUE(result.BoolOrDie());
+}
+
+TEST_P(RegexPrecompilationExtensionTest, DisjunctionPropagatesErrors) {
+  builder_.flat_expr_builder().AddProgramOptimizer(
+      CreateRegexPrecompilationExtension(options_.regex_max_program_size));
+
+  ASSERT_OK_AND_ASSIGN(exprpb::ParsedExpr expr,
+                       Parse("input.matches('^a') || input.matches('^b')"));
+
+  ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<CelExpression> plan,
+      builder_.CreateExpression(&expr.expr(), &expr.source_info()));
+
+  Activation activation;
+  google::protobuf::Arena arena;
+
+  ASSERT_OK_AND_ASSIGN(CelValue result, plan->Evaluate(activation, &arena));
+  EXPECT_TRUE(result.IsError());
+}
+
 class RegexConstFoldInteropTest : public RegexPrecompilationExtensionTest {
  public:
   RegexConstFoldInteropTest() : RegexPrecompilationExtensionTest() {
@@ -0,0 +1,145 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval/eval/attribute_pattern_index.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "absl/container/inlined_vector.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+#include "absl/types/span.h"
+#include "absl/types/variant.h"
+#include "base/attribute.h"
+
+namespace google::api::expr::runtime {
+
+namespace {
+
+using MatchType = ::cel::AttributePattern::MatchType;
+
+}  // namespace
+
+AttributePatternIndex::AttributePatternIndex(
+    absl::Span<const cel::AttributePattern> patterns) {
+  for (const auto& pattern : patterns) {
+    auto [root, inserted] = roots_.try_emplace(pattern.variable(), kNoNode);
+    if (inserted) {
+      root->second = AddNode();
+    }
+    size_t node = root->second;
+    for (const auto& qualifier_pattern : pattern.qualifier_path()) {
+      nodes_[node].has_descendants = true;
+      size_t next;
+      if (qualifier_pattern.IsWildcard()) {
+        next = nodes_[node].wildcard;
+        if (next == kNoNode) {
+          next = AddNode();
+          nodes_[node].wildcard = next;
+        }
+      } else {
+        auto key = KeyOf(*qualifier_pattern.qualifier());
+        if (!key.has_value()) {
+          // Never matches a qualifier, but the pattern may still partially
+          // match attributes that stop short of this point.
+          node = kNoNode;
+          break;
+        }
+        auto it = nodes_[node].children.find(*key);
+        if (it != nodes_[node].children.end()) {
+          next = it->second;
+        } else {
+          next = AddNode();
+          nodes_[node].children.insert({*key, next});
+        }
+      }
+      node = next;
+    }
+    if (node != kNoNode) {
+      nodes_[node].terminal = true;
+    }
+  }
+}
+
+// Returns the trie key for a qualifier, or nullopt if the qualifier can't be
+// matched by value (e.g. an unsupported key type).
+absl::optional<AttributePatternIndex::QualifierKey>
+AttributePatternIndex::KeyOf(const cel::AttributeQualifier& qualifier) {
+  if (auto key = qualifier.GetStringKey(); key.has_value()) {
+    return QualifierKey(absl::in_place_type<absl::string_view>, *key);
+  }
+  if (auto key = qualifier.GetInt64Key(); key.has_value()) {
+    return QualifierKey(absl::in_place_type<int64_t>, *key);
+  }
+  if (auto key = qualifier.GetUint64Key(); key.has_value()) {
+    return QualifierKey(absl::in_place_type<uint64_t>, *key);
+  }
+  if (auto key = qualifier.GetBoolKey(); key.has_value()) {
+    return QualifierKey(absl::in_place_type<bool>, *key);
+  }
+  return absl::nullopt;
+}
+
+size_t AttributePatternIndex::AddNode() {
+  nodes_.emplace_back();
+  return nodes_.size() - 1;
+}
+
+MatchType AttributePatternIndex::Match(const cel::Attribute& attribute) const {
+  auto root = roots_.find(attribute.variable_name());
+  if (root == roots_.end()) {
+    return MatchType::NONE;
+  }
+
+  absl::Span<const cel::AttributeQualifier> path = attribute.qualifier_path();
+  MatchType result = MatchType::NONE;
+  // Wildcards can make several paths through the trie match, so walk them
+  // depth first as (node, depth) pairs.
+  absl::InlinedVector<std::pair<size_t, size_t>, 8> pending;
+  pending.push_back({root->second, 0});
+  while (!pending.empty()) {
+    auto [index, depth] = pending.back();
+    pending.pop_back();
+    const Node& node = nodes_[index];
+    if (node.terminal) {
+      // A pattern that is no longer than the attribute and matched every one
+      // of its qualifiers.
+      return MatchType::FULL;
+    }
+    if (depth == path.size()) {
+      if (node.has_descendants) {
+        result = MatchType::PARTIAL;
+      }
+      continue;
+    }
+    if (node.wildcard != kNoNode) {
+      pending.push_back({node.wildcard, depth + 1});
+    }
+    if (node.children.empty()) {
+      continue;
+    }
+    auto key = KeyOf(path[depth]);
+    if (!key.has_value()) {
+      continue;
+    }
+    if (auto it = node.children.find(*key); it != node.children.end()) {
+      pending.push_back({it->second, depth + 1});
+    }
+  }
+  return result;
+}
+
+}  // namespace google::api::expr::runtime
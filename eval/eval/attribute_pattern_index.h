@@ -0,0 +1,81 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_EVAL_EVAL_ATTRIBUTE_PATTERN_INDEX_H_
+#define THIRD_PARTY_CEL_CPP_EVAL_EVAL_ATTRIBUTE_PATTERN_INDEX_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+#include "absl/types/span.h"
+#include "absl/types/variant.h"
+#include "base/attribute.h"
+
+namespace google::api::expr::runtime {
+
+// Trie over a list of attribute patterns, keyed by variable name and then by
+// qualifier, with a separate edge for wildcard qualifiers.
+//
+// Matching an attribute walks the trie along the attribute's qualifier path
+// instead of testing every pattern, which is what dominates unknown and
+// missing attribute checks when an activation declares many patterns.
+//
+// The index references the variable names and string qualifiers of the
+// patterns it was built from, which must outlive it.
+class AttributePatternIndex {
+ public:
+  explicit AttributePatternIndex(
+      absl::Span<const cel::AttributePattern> patterns);
+
+  AttributePatternIndex(const AttributePatternIndex&) = delete;
+  AttributePatternIndex& operator=(const AttributePatternIndex&) = delete;
+  AttributePatternIndex(AttributePatternIndex&&) = default;
+  AttributePatternIndex& operator=(AttributePatternIndex&&) = default;
+
+  // Returns the closest match of any indexed pattern against `attribute`.
+  // Equivalent to taking the best result of `AttributePattern::IsMatch` over
+  // every indexed pattern (FULL over PARTIAL over NONE).
+  cel::AttributePattern::MatchType Match(const cel::Attribute& attribute) const;
+
+ private:
+  using QualifierKey =
+      absl::variant<int64_t, uint64_t, absl::string_view, bool>;
+
+  static constexpr size_t kNoNode = static_cast<size_t>(-1);
+
+  struct Node {
+    // A pattern ends at this node.
+    bool terminal = false;
+    // A pattern continues past this node.
+    bool has_descendants = false;
+    size_t wildcard = kNoNode;
+    absl::flat_hash_map<QualifierKey, size_t> children;
+  };
+
+  static absl::optional<QualifierKey> KeyOf(
+      const cel::AttributeQualifier& qualifier);
+
+  size_t AddNode();
+
+  std::vector<Node> nodes_;
+  absl::flat_hash_map<absl::string_view, size_t> roots_;
+};
+
+}  // namespace google::api::expr::runtime
+
+#endif  // THIRD_PARTY_CEL_CPP_EVAL_EVAL_ATTRIBUTE_PATTERN_INDEX_H_
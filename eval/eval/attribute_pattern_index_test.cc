@@ -0,0 +1,187 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval/eval/attribute_pattern_index.h"
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "base/attribute.h"
+#include "internal/testing.h"
+
+namespace google::api::expr::runtime {
+namespace {
+
+using ::cel::Attribute;
+using ::cel::AttributePattern;
+using ::cel::AttributeQualifier;
+using ::cel::AttributeQualifierPattern;
+
+using MatchType = AttributePattern::MatchType;
+
+TEST(AttributePatternIndexTest, Empty) {
+  AttributePatternIndex index({});
+
+  EXPECT_EQ(index.Match(Attribute("a")), MatchType::NONE);
+}
+
+TEST(AttributePatternIndexTest, VariableOnly) {
+  std::vector<AttributePattern> patterns = {AttributePattern("a", {})};
+  AttributePatternIndex index(patterns);
+
+  EXPECT_EQ(index.Match(Attribute("a")), MatchType::FULL);
+  EXPECT_EQ(
+      index.Match(Attribute("a", {AttributeQualifier::OfString("field")})),
+      MatchType::FULL);
+  EXPECT_EQ(index.Match(Attribute("b")), MatchType::NONE);
+}
+
+TEST(AttributePatternIndexTest, Qualifiers) {
+  std::vector<AttributePattern> patterns = {
+      AttributePattern("a", {AttributeQualifierPattern::OfString("field"),
+                             AttributeQualifierPattern::OfInt(1)}),
+      AttributePattern("a", {AttributeQualifierPattern::OfUint(2)}),
+  };
+  AttributePatternIndex index(patterns);
+
+  EXPECT_EQ(index.Match(Attribute("a")), MatchType::PARTIAL);
+  EXPECT_EQ(
+      index.Match(Attribute("a", {AttributeQualifier::OfString("field")})),
+      MatchType::PARTIAL);
+  EXPECT_EQ(index.Match(Attribute("a", {AttributeQualifier::OfString("field"),
+                                        AttributeQualifier::OfInt(1)})),
+            MatchType::FULL);
+  EXPECT_EQ(index.Match(Attribute("a", {AttributeQualifier::OfString("field"),
+                                        AttributeQualifier::OfInt(1),
+                                        AttributeQualifier::OfBool(true)})),
+            MatchType::FULL);
+  EXPECT_EQ(index.Match(Attribute("a", {AttributeQualifier::OfUint(2)})),
+            MatchType::FULL);
+  // Qualifiers only match values of the same type.
+  EXPECT_EQ(index.Match(Attribute("a", {AttributeQualifier::OfInt(2)})),
+            MatchType::NONE);
+  EXPECT_EQ(index.Match(Attribute("a", {AttributeQualifier::OfString("field"),
+                                        AttributeQualifier::OfUint(1)})),
+            MatchType::NONE);
+}
+
+TEST(AttributePatternIndexTest, Wildcards) {
+  std::vector<AttributePattern> patterns = {
+      AttributePattern("a", {AttributeQualifierPattern::CreateWildcard(),
+                             AttributeQualifierPattern::OfString("x")}),
+      AttributePattern("a", {AttributeQualifierPattern::OfInt(1),
+                             AttributeQualifierPattern::OfString("y"),
+                             AttributeQualifierPattern::OfString("z")}),
+  };
+  AttributePatternIndex index(patterns);
+
+  EXPECT_EQ(index.Match(Attribute("a", {AttributeQualifier::OfBool(false),
+                                        AttributeQualifier::OfString("x")})),
+            MatchType::FULL);
+  // Both the wildcard and the exact edge have to be followed.
+  EXPECT_EQ(index.Match(Attribute("a", {AttributeQualifier::OfInt(1),
+                                        AttributeQualifier::OfString("x")})),
+            MatchType::FULL);
+  EXPECT_EQ(index.Match(Attribute("a", {AttributeQualifier::OfInt(1),
+                                        AttributeQualifier::OfString("y")})),
+            MatchType::PARTIAL);
+  EXPECT_EQ(index.Match(Attribute("a", {AttributeQualifier::OfInt(2),
+                                        AttributeQualifier::OfString("y")})),
+            MatchType::NONE);
+}
+
+TEST(AttributePatternIndexTest, UnsupportedQualifiers) {
+  std::vector<AttributePattern> patterns = {
+      AttributePattern("a",
+                       {AttributeQualifierPattern::OfString("field"),
+                        AttributeQualifierPattern(AttributeQualifier())}),
+  };
+  AttributePatternIndex index(patterns);
+
+  EXPECT_EQ(
+      index.Match(Attribute("a", {AttributeQualifier::OfString("field")})),
+      MatchType::PARTIAL);
+  EXPECT_EQ(index.Match(Attribute("a", {AttributeQualifier::OfString("field"),
+                                        AttributeQualifier()})),
+            MatchType::NONE);
+}
+
+// Returns every qualifier path of up to `max_length` elements from `alphabet`.
+template <typename T>
+std::vector<std::vector<T>> AllPaths(const std::vector<T>& alphabet,
+                                     int max_length) {
+  std::vector<std::vector<T>> paths = {{}};
+  for (size_t begin = 0, end = 1; max_length > 0; --max_length) {
+    for (size_t i = begin; i < end; ++i) {
+      for (const auto& element : alphabet) {
+        std::vector<T> path = paths[i];
+        path.push_back(element);
+        paths.push_back(std::move(path));
+      }
+    }
+    begin = end;
+    end = paths.size();
+  }
+  return paths;
+}
+
+MatchType LinearMatch(const std::vector<AttributePattern>& patterns,
+                      const Attribute& attribute) {
+  MatchType result = MatchType::NONE;
+  for (const auto& pattern : patterns) {
+    MatchType match = pattern.IsMatch(attribute);
+    if (match == MatchType::FULL) {
+      return match;
+    }
+    if (match == MatchType::PARTIAL) {
+      result = match;
+    }
+  }
+  return result;
+}
+
+TEST(AttributePatternIndexTest, AgreesWithLinearMatch) {
+  std::vector<std::vector<AttributeQualifierPattern>> pattern_paths =
+      AllPaths<AttributeQualifierPattern>(
+          {AttributeQualifierPattern::CreateWildcard(),
+           AttributeQualifierPattern::OfInt(1),
+           AttributeQualifierPattern::OfUint(1),
+           AttributeQualifierPattern::OfString("a")},
+          2);
+  std::vector<Attribute> attributes;
+  for (auto& path : AllPaths<AttributeQualifier>(
+           {AttributeQualifier::OfInt(1), AttributeQualifier::OfUint(1),
+            AttributeQualifier::OfString("a"), AttributeQualifier::OfString("b"),
+            AttributeQualifier::OfBool(true)},
+           3)) {
+    attributes.push_back(Attribute("x", std::move(path)));
+  }
+
+  // Every pair of patterns, which covers shared prefixes as well as exact and
+  // wildcard edges leaving the same node.
+  for (const auto& first : pattern_paths) {
+    for (const auto& second : pattern_paths) {
+      std::vector<AttributePattern> patterns = {AttributePattern("x", first),
+                                                AttributePattern("x", second)};
+      AttributePatternIndex index(patterns);
+      for (const auto& attribute : attributes) {
+        ASSERT_EQ(index.Match(attribute), LinearMatch(patterns, attribute));
+      }
+    }
+  }
+}
+
+}  // namespace
+}  // namespace google::api::expr::runtime
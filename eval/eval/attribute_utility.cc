@@ -1,5 +1,6 @@
 #include "eval/eval/attribute_utility.h"
 
+#include <cstddef>
 #include <cstdint>
 #include <string>
 #include <utility>
@@ -12,9 +13,9 @@
 #include "base/function_descriptor.h"
 #include "base/function_result.h"
 #include "base/function_result_set.h"
-#include "base/internal/unknown_set.h"
 #include "common/casting.h"
 #include "common/value.h"
+#include "eval/eval/attribute_pattern_index.h"
 #include "eval/eval/attribute_trail.h"
 #include "eval/internal/errors.h"
 #include "internal/status_macros.h"
@@ -29,26 +30,53 @@ using ::cel::FunctionResultSet;
 using ::cel::InstanceOf;
 using ::cel::UnknownValue;
 using ::cel::Value;
-using ::cel::base_internal::UnknownSet;
 
 using Accumulator = AttributeUtility::Accumulator;
 
+namespace {
+
+using MatchType = ::cel::AttributePattern::MatchType;
+
+// Below this many patterns a linear scan is cheaper than building an index.
+constexpr size_t kMinPatternsForIndex = 8;
+
+}  // namespace
+
+MatchType AttributeUtility::MatchPatterns(
+    absl::Span<const cel::AttributePattern> patterns,
+    absl::optional<AttributePatternIndex>& index, const AttributeTrail& trail,
+    bool use_partial) {
+  if (patterns.size() >= kMinPatternsForIndex) {
+    if (!index.has_value()) {
+      index.emplace(patterns);
+    }
+    return index->Match(trail.attribute());
+  }
+
+  MatchType result = MatchType::NONE;
+  for (const auto& pattern : patterns) {
+    auto current_match = pattern.IsMatch(trail.attribute());
+    if (current_match == MatchType::FULL) {
+      return current_match;
+    }
+    if (use_partial && current_match == MatchType::PARTIAL) {
+      result = current_match;
+    }
+  }
+  return result;
+}
+
 bool AttributeUtility::CheckForMissingAttribute(
     const AttributeTrail& trail) const {
   if (trail.empty()) {
     return false;
   }
 
-  for (const auto& pattern : missing_attribute_patterns_) {
-    // (b/161297249) Preserving existing behavior for now, will add a streamz
-    // for partial match, follow up with tightening up which fields are exposed
-    // to the condition (w/ ajay and jim)
-    if (pattern.IsMatch(trail.attribute()) ==
-        cel::AttributePattern::MatchType::FULL) {
-      return true;
-    }
-  }
-  return false;
+  // (b/161297249) Preserving existing behavior for now, will add a streamz
+  // for partial match, follow up with tightening up which fields are exposed
+  // to the condition (w/ ajay and jim)
+  return MatchPatterns(missing_attribute_patterns_, missing_pattern_index_,
+                       trail, /*use_partial=*/false) == MatchType::FULL;
 }
 
 // Checks whether particular corresponds to any patterns that define unknowns.
@@ -57,15 +85,10 @@ bool AttributeUtility::CheckForUnknown(const AttributeTrail& trail,
   if (trail.empty()) {
     return false;
   }
-  for (const auto& pattern : unknown_patterns_) {
-    auto current_match = pattern.IsMatch(trail.attribute());
-    if (current_match == cel::AttributePattern::MatchType::FULL ||
-        (use_partial &&
-         current_match == cel::AttributePattern::MatchType::PARTIAL)) {
-      return true;
-    }
-  }
-  return false;
+  auto match = MatchPatterns(unknown_patterns_, unknown_pattern_index_, trail,
+                             use_partial);
+  return match == MatchType::FULL ||
+         (use_partial && match == MatchType::PARTIAL);
 }
 
 // Creates merged UnknownAttributeSet.
@@ -76,26 +99,25 @@ absl::optional<UnknownValue> AttributeUtility::MergeUnknowns(
     absl::Span<const cel::Value> args) const {
   // Empty unknown value may be used as a sentinel in some tests so need to
   // distinguish unset (nullopt) and empty(engaged empty value).
-  absl::optional<UnknownSet> result_set;
+  bool unknown_present = false;
+  AttributeSet attributes;
+  FunctionResultSet function_results;
 
   for (const auto& value : args) {
     if (!value->Is<cel::UnknownValue>()) continue;
-    if (!result_set.has_value()) {
-      result_set.emplace();
-    }
+    unknown_present = true;
     const auto& current_set = value.GetUnknown();
-
-    cel::base_internal::UnknownSetAccess::Add(
-        *result_set, UnknownSet(current_set.attribute_set(),
-                                current_set.function_result_set()));
+    // Unions with empty sets or subsets share the existing storage.
+    attributes.Add(current_set.attribute_set());
+    function_results.Add(current_set.function_result_set());
   }
 
-  if (!result_set.has_value()) {
+  if (!unknown_present) {
     return absl::nullopt;
   }
 
-  return value_factory_.CreateUnknownValue(
-      result_set->unknown_attributes(), result_set->unknown_function_results());
+  return value_factory_.CreateUnknownValue(std::move(attributes),
+                                           std::move(function_results));
 }
 
 UnknownValue AttributeUtility::MergeUnknownValues(
@@ -140,31 +162,26 @@ AttributeSet AttributeUtility::CheckForUnknowns(
 absl::optional<UnknownValue> AttributeUtility::IdentifyAndMergeUnknowns(
     absl::Span<const cel::Value> args, absl::Span<const AttributeTrail> attrs,
     bool use_partial) const {
-  absl::optional<UnknownSet> result_set;
-
   // Identify new unknowns by attribute patterns.
   cel::AttributeSet attr_set = CheckForUnknowns(attrs, use_partial);
-  if (!attr_set.empty()) {
-    result_set.emplace(std::move(attr_set));
-  }
 
   // merge down existing unknown sets
   absl::optional<UnknownValue> arg_unknowns = MergeUnknowns(args);
 
-  if (!result_set.has_value()) {
+  if (attr_set.empty()) {
     // No new unknowns so no need to check for presence of existing unknowns --
     // just forward.
     return arg_unknowns;
   }
 
+  FunctionResultSet function_results;
   if (arg_unknowns.has_value()) {
-    cel::base_internal::UnknownSetAccess::Add(
-        *result_set, UnknownSet((*arg_unknowns).attribute_set(),
-                                (*arg_unknowns).function_result_set()));
+    attr_set.Add(arg_unknowns->attribute_set());
+    function_results.Add(arg_unknowns->function_result_set());
   }
 
-  return value_factory_.CreateUnknownValue(
-      result_set->unknown_attributes(), result_set->unknown_function_results());
+  return value_factory_.CreateUnknownValue(std::move(attr_set),
+                                           std::move(function_results));
 }
 
 UnknownValue AttributeUtility::CreateUnknownSet(cel::Attribute attr) const {
@@ -2,6 +2,7 @@
 #define THIRD_PARTY_CEL_CPP_EVAL_EVAL_UNKNOWNS_UTILITY_H_
 
 #include "absl/status/statusor.h"
+#include "absl/types/optional.h"
 #include "absl/types/span.h"
 #include "base/attribute.h"
 #include "base/attribute_set.h"
@@ -9,6 +10,7 @@
 #include "base/function_result_set.h"
 #include "common/value.h"
 #include "common/value_manager.h"
+#include "eval/eval/attribute_pattern_index.h"
 #include "eval/eval/attribute_trail.h"
 
 namespace google::api::expr::runtime {
@@ -128,12 +130,22 @@ class AttributeUtility {
  private:
   cel::ValueManager& value_manager() const { return value_factory_; }
 
+  // Returns the best match of `patterns` against `trail`, using `index` once
+  // there are enough patterns for building it to pay off.
+  static cel::AttributePattern::MatchType MatchPatterns(
+      absl::Span<const cel::AttributePattern> patterns,
+      absl::optional<AttributePatternIndex>& index, const AttributeTrail& trail,
+      bool use_partial);
+
   // Workaround friend visibility.
   void Add(Accumulator& a, const cel::UnknownValue& v) const;
   void Add(Accumulator& a, const AttributeTrail& attr) const;
 
   absl::Span<const cel::AttributePattern> unknown_patterns_;
   absl::Span<const cel::AttributePattern> missing_attribute_patterns_;
+  // Built on first use for large pattern lists.
+  mutable absl::optional<AttributePatternIndex> unknown_pattern_index_;
+  mutable absl::optional<AttributePatternIndex> missing_pattern_index_;
   cel::ValueManager& value_factory_;
 };
 
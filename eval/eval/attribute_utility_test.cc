@@ -1,5 +1,6 @@
 #include "eval/eval/attribute_utility.h"
 
+#include <cstdint>
 #include <vector>
 
 #include "base/attribute_set.h"
@@ -157,6 +158,48 @@ TEST_F(AttributeUtilityTest, UnknownsUtilityCheckForMissingAttributes) {
   EXPECT_TRUE(utility1.CheckForMissingAttribute(trail));
 }
 
+TEST_F(AttributeUtilityTest, UnknownsUtilityManyPatterns) {
+  // Enough patterns that matching goes through the pattern index.
+  std::vector<CelAttributePattern> unknown_patterns;
+  std::vector<CelAttributePattern> missing_attribute_patterns;
+  for (int64_t i = 0; i < 64; ++i) {
+    unknown_patterns.push_back(CelAttributePattern(
+        "unknown",
+        {CreateCelAttributeQualifierPattern(CelValue::CreateInt64(i)),
+         CelAttributeQualifierPattern::CreateWildcard()}));
+    missing_attribute_patterns.push_back(CelAttributePattern(
+        "missing",
+        {CreateCelAttributeQualifierPattern(CelValue::CreateInt64(i))}));
+  }
+
+  AttributeUtility utility(unknown_patterns, missing_attribute_patterns,
+                           value_factory_);
+
+  AttributeTrail unknown_trail("unknown");
+  EXPECT_FALSE(utility.CheckForUnknown(unknown_trail, false));
+  EXPECT_TRUE(utility.CheckForUnknown(unknown_trail, true));
+
+  AttributeTrail unknown_trail10 = unknown_trail.Step(
+      CreateCelAttributeQualifier(CelValue::CreateInt64(10)));
+  EXPECT_FALSE(utility.CheckForUnknown(unknown_trail10, false));
+  EXPECT_TRUE(utility.CheckForUnknown(unknown_trail10, true));
+  EXPECT_TRUE(utility.CheckForUnknown(
+      unknown_trail10.Step(
+          CreateCelAttributeQualifier(CelValue::CreateStringView("field"))),
+      false));
+  EXPECT_FALSE(utility.CheckForUnknown(
+      unknown_trail.Step(
+          CreateCelAttributeQualifier(CelValue::CreateInt64(100))),
+      true));
+
+  AttributeTrail missing_trail("missing");
+  EXPECT_FALSE(utility.CheckForMissingAttribute(missing_trail));
+  EXPECT_TRUE(utility.CheckForMissingAttribute(missing_trail.Step(
+      CreateCelAttributeQualifier(CelValue::CreateInt64(63)))));
+  EXPECT_FALSE(utility.CheckForMissingAttribute(missing_trail.Step(
+      CreateCelAttributeQualifier(CelValue::CreateInt64(64)))));
+}
+
 TEST_F(AttributeUtilityTest, CreateUnknownSet) {
   AttributeTrail trail("destination");
   trail =
@@ -45,6 +45,11 @@ class DirectCompilerConstantStep : public DirectExpressionStep {
 
   const cel::Value& value() const { return value_; }
 
+  void AccumulateMemoryUsage(cel::ProgramMemoryUsage& usage) const override {
+    usage.steps += sizeof(*this);
+    usage.constants += ValueHeapSize(value_);
+  }
+
  private:
   cel::Value value_;
 };
@@ -67,6 +72,11 @@ class CompilerConstantStep : public ExpressionStepBase {
 
   const cel::Value& value() const { return value_; }
 
+  void AccumulateMemoryUsage(cel::ProgramMemoryUsage& usage) const override {
+    usage.steps += sizeof(*this);
+    usage.constants += ValueHeapSize(value_);
+  }
+
  private:
   cel::Value value_;
 };
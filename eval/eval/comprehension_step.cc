@@ -146,6 +146,15 @@ class ComprehensionDirectStep : public DirectExpressionStep {
   absl::Status Evaluate(ExecutionFrameBase& frame, Value& result,
                         AttributeTrail& trail) const override;
 
+  void AccumulateMemoryUsage(cel::ProgramMemoryUsage& usage) const override {
+    usage.steps += sizeof(*this);
+    range_->AccumulateMemoryUsage(usage);
+    accu_init_->AccumulateMemoryUsage(usage);
+    loop_step_->AccumulateMemoryUsage(usage);
+    condition_->AccumulateMemoryUsage(usage);
+    result_step_->AccumulateMemoryUsage(usage);
+  }
+
  private:
   size_t iter_slot_;
   size_t accu_slot_;
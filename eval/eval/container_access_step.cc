@@ -322,6 +322,12 @@ class DirectContainerAccessStep : public DirectExpressionStep {
   absl::Status Evaluate(ExecutionFrameBase& frame, Value& result,
                         AttributeTrail& trail) const override;
 
+  void AccumulateMemoryUsage(cel::ProgramMemoryUsage& usage) const override {
+    usage.steps += sizeof(*this);
+    container_step_->AccumulateMemoryUsage(usage);
+    key_step_->AccumulateMemoryUsage(usage);
+  }
+
  private:
   std::unique_ptr<DirectExpressionStep> container_step_;
   std::unique_ptr<DirectExpressionStep> key_step_;
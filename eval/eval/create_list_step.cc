@@ -198,6 +198,13 @@ class CreateListDirectStep : public DirectExpressionStep {
     return absl::OkStatus();
   }
 
+  void AccumulateMemoryUsage(cel::ProgramMemoryUsage& usage) const override {
+    usage.steps += sizeof(*this);
+    for (const auto& step : elements_) {
+      step->AccumulateMemoryUsage(usage);
+    }
+  }
+
  private:
   std::vector<std::unique_ptr<DirectExpressionStep>> elements_;
   absl::flat_hash_set<int32_t> optional_indices_;
@@ -137,6 +137,13 @@ class DirectCreateMapStep : public DirectExpressionStep {
   absl::Status Evaluate(ExecutionFrameBase& frame, Value& result,
                         AttributeTrail& attribute_trail) const override;
 
+  void AccumulateMemoryUsage(cel::ProgramMemoryUsage& usage) const override {
+    usage.steps += sizeof(*this);
+    for (const auto& step : deps_) {
+      step->AccumulateMemoryUsage(usage);
+    }
+  }
+
  private:
   std::vector<std::unique_ptr<DirectExpressionStep>> deps_;
   absl::flat_hash_set<int32_t> optional_indices_;
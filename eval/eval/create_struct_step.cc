@@ -14,6 +14,7 @@
 
 #include "eval/eval/create_struct_step.h"
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -21,6 +22,7 @@
 #include <vector>
 
 #include "absl/container/flat_hash_set.h"
+#include "absl/log/absl_check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
@@ -28,6 +30,7 @@
 #include "absl/types/optional.h"
 #include "common/casting.h"
 #include "common/memory.h"
+#include "common/type.h"
 #include "common/value.h"
 #include "common/value_manager.h"
 #include "eval/eval/attribute_trail.h"
@@ -43,19 +46,125 @@ namespace {
 using ::cel::Cast;
 using ::cel::ErrorValue;
 using ::cel::InstanceOf;
-using ::cel::StructValueBuilderInterface;
+using ::cel::MessageType;
+using ::cel::MessageTypeField;
+using ::cel::StructValueBuilderPtr;
 using ::cel::UnknownValue;
 using ::cel::Value;
+using ::cel::ValueBuilderPtr;
+using ::cel::ValueManager;
+
+class StructCreationPlan;
+
+// Builds the value for a single evaluation of a struct creation expression.
+class StructCreation final {
+ public:
+  StructCreation(StructCreation&&) = default;
+  StructCreation& operator=(StructCreation&&) = default;
+
+  absl::Status SetField(size_t index, Value value);
+
+  Value Build() &&;
+
+ private:
+  friend class StructCreationPlan;
+
+  explicit StructCreation(const StructCreationPlan& plan) : plan_(&plan) {}
+
+  const StructCreationPlan* plan_;
+  // Exactly one of the builders is set, see `StructCreationPlan`.
+  ValueBuilderPtr value_builder_;
+  StructValueBuilderPtr struct_builder_;
+};
+
+// The type and fields of a struct creation expression, resolved once during
+// planning.
+//
+// When the type was resolved to a message, the builder is created for it
+// directly instead of looking it up by name, and fields which were resolved to
+// a `cel::MessageTypeField` are set through their field descriptors. Otherwise,
+// including for well known types which are built as other kinds of values, the
+// builder and fields are looked up by name on every evaluation.
+class StructCreationPlan final {
+ public:
+  StructCreationPlan(std::string name, std::vector<std::string> field_names)
+      : name_(std::move(name)), field_names_(std::move(field_names)) {}
+
+  StructCreationPlan(MessageType type, std::vector<std::string> field_names,
+                     std::vector<MessageTypeField> fields)
+      : name_(type.name()),
+        type_(type),
+        field_names_(std::move(field_names)),
+        fields_(std::move(fields)) {
+    ABSL_DCHECK_EQ(field_names_.size(), fields_.size());
+  }
+
+  size_t size() const { return field_names_.size(); }
+
+  absl::StatusOr<StructCreation> NewCreation(
+      ValueManager& value_manager) const {
+    StructCreation creation(*this);
+    if (type_) {
+      CEL_ASSIGN_OR_RETURN(creation.struct_builder_,
+                           value_manager.NewStructValueBuilder(type_));
+      if (creation.struct_builder_ == nullptr) {
+        return BuilderNotFoundError();
+      }
+    } else {
+      CEL_ASSIGN_OR_RETURN(creation.value_builder_,
+                           value_manager.NewValueBuilder(name_));
+      if (creation.value_builder_ == nullptr) {
+        return BuilderNotFoundError();
+      }
+    }
+    return creation;
+  }
+
+ private:
+  friend class StructCreation;
+
+  absl::Status BuilderNotFoundError() const {
+    return absl::NotFoundError(absl::StrCat("Unable to find builder: ", name_));
+  }
+
+  std::string name_;
+  MessageType type_;
+  std::vector<std::string> field_names_;
+  // Parallel to `field_names_` when `type_` is set, otherwise empty. Fields
+  // which could not be resolved are empty and are set by name.
+  std::vector<MessageTypeField> fields_;
+};
+
+absl::Status StructCreation::SetField(size_t index, Value value) {
+  if (struct_builder_ != nullptr) {
+    if (const auto& field = plan_->fields_[index]; field) {
+      return struct_builder_->SetField(field, std::move(value));
+    }
+    return struct_builder_->SetFieldByName(plan_->field_names_[index],
+                                           std::move(value));
+  }
+  return value_builder_->SetFieldByName(plan_->field_names_[index],
+                                        std::move(value));
+}
+
+Value StructCreation::Build() && {
+  if (struct_builder_ != nullptr) {
+    auto status_or_value = std::move(*struct_builder_).Build();
+    if (!status_or_value.ok()) {
+      return ErrorValue(std::move(status_or_value).status());
+    }
+    return std::move(status_or_value).value();
+  }
+  return std::move(*value_builder_).Build();
+}
 
 // `CreateStruct` implementation for message/struct.
 class CreateStructStepForStruct final : public ExpressionStepBase {
  public:
-  CreateStructStepForStruct(int64_t expr_id, std::string name,
-                            std::vector<std::string> entries,
+  CreateStructStepForStruct(int64_t expr_id, StructCreationPlan plan,
                             absl::flat_hash_set<int32_t> optional_indices)
       : ExpressionStepBase(expr_id),
-        name_(std::move(name)),
-        entries_(std::move(entries)),
+        plan_(std::move(plan)),
         optional_indices_(std::move(optional_indices)) {}
 
   absl::Status Evaluate(ExecutionFrame* frame) const override;
@@ -63,14 +172,13 @@ class CreateStructStepForStruct final : public ExpressionStepBase {
  private:
   absl::StatusOr<Value> DoEvaluate(ExecutionFrame* frame) const;
 
-  std::string name_;
-  std::vector<std::string> entries_;
+  StructCreationPlan plan_;
   absl::flat_hash_set<int32_t> optional_indices_;
 };
 
 absl::StatusOr<Value> CreateStructStepForStruct::DoEvaluate(
     ExecutionFrame* frame) const {
-  int entries_size = entries_.size();
+  int entries_size = plan_.size();
 
   auto args = frame->value_stack().GetSpan(entries_size);
 
@@ -84,36 +192,28 @@ absl::StatusOr<Value> CreateStructStepForStruct::DoEvaluate(
     }
   }
 
-  auto builder_or_status = frame->value_manager().NewValueBuilder(name_);
-  if (!builder_or_status.ok()) {
-    return builder_or_status.status();
-  }
-  auto builder = std::move(*builder_or_status);
-  if (builder == nullptr) {
-    return absl::NotFoundError(absl::StrCat("Unable to find builder: ", name_));
-  }
+  CEL_ASSIGN_OR_RETURN(auto creation,
+                       plan_.NewCreation(frame->value_manager()));
 
   for (int i = 0; i < entries_size; ++i) {
-    const auto& entry = entries_[i];
     auto& arg = args[i];
     if (optional_indices_.contains(static_cast<int32_t>(i))) {
       if (auto optional_arg = cel::As<cel::OptionalValue>(arg); optional_arg) {
         if (!optional_arg->HasValue()) {
           continue;
         }
-        CEL_RETURN_IF_ERROR(
-            builder->SetFieldByName(entry, optional_arg->Value()));
+        CEL_RETURN_IF_ERROR(creation.SetField(i, optional_arg->Value()));
       }
     } else {
-      CEL_RETURN_IF_ERROR(builder->SetFieldByName(entry, std::move(arg)));
+      CEL_RETURN_IF_ERROR(creation.SetField(i, std::move(arg)));
     }
   }
 
-  return std::move(*builder).Build();
+  return std::move(creation).Build();
 }
 
 absl::Status CreateStructStepForStruct::Evaluate(ExecutionFrame* frame) const {
-  if (frame->value_stack().size() < entries_.size()) {
+  if (frame->value_stack().size() < plan_.size()) {
     return absl::InternalError("CreateStructStepForStruct: stack underflow");
   }
 
@@ -124,7 +224,7 @@ absl::Status CreateStructStepForStruct::Evaluate(ExecutionFrame* frame) const {
   } else {
     result = frame->value_factory().CreateErrorValue(status_or_result.status());
   }
-  frame->value_stack().PopAndPush(entries_.size(), std::move(result));
+  frame->value_stack().PopAndPush(plan_.size(), std::move(result));
 
   return absl::OkStatus();
 }
@@ -132,21 +232,26 @@ absl::Status CreateStructStepForStruct::Evaluate(ExecutionFrame* frame) const {
 class DirectCreateStructStep : public DirectExpressionStep {
  public:
   DirectCreateStructStep(
-      int64_t expr_id, std::string name, std::vector<std::string> field_keys,
+      int64_t expr_id, StructCreationPlan plan,
       std::vector<std::unique_ptr<DirectExpressionStep>> deps,
       absl::flat_hash_set<int32_t> optional_indices)
       : DirectExpressionStep(expr_id),
-        name_(std::move(name)),
-        field_keys_(std::move(field_keys)),
+        plan_(std::move(plan)),
         deps_(std::move(deps)),
         optional_indices_(std::move(optional_indices)) {}
 
   absl::Status Evaluate(ExecutionFrameBase& frame, Value& result,
                         AttributeTrail& trail) const override;
 
+  void AccumulateMemoryUsage(cel::ProgramMemoryUsage& usage) const override {
+    usage.steps += sizeof(*this);
+    for (const auto& step : deps_) {
+      step->AccumulateMemoryUsage(usage);
+    }
+  }
+
  private:
-  std::string name_;
-  std::vector<std::string> field_keys_;
+  StructCreationPlan plan_;
   std::vector<std::unique_ptr<DirectExpressionStep>> deps_;
   absl::flat_hash_set<int32_t> optional_indices_;
 };
@@ -158,19 +263,15 @@ absl::Status DirectCreateStructStep::Evaluate(ExecutionFrameBase& frame,
   AttributeTrail field_attr;
   auto unknowns = frame.attribute_utility().CreateAccumulator();
 
-  auto builder_or_status = frame.value_manager().NewValueBuilder(name_);
-  if (!builder_or_status.ok()) {
-    result = frame.value_manager().CreateErrorValue(builder_or_status.status());
-    return absl::OkStatus();
-  }
-  auto builder = std::move(*builder_or_status);
-  if (builder == nullptr) {
-    result = frame.value_manager().CreateErrorValue(
-        absl::NotFoundError(absl::StrCat("Unable to find builder: ", name_)));
+  auto creation_or_status = plan_.NewCreation(frame.value_manager());
+  if (!creation_or_status.ok()) {
+    result =
+        frame.value_manager().CreateErrorValue(creation_or_status.status());
     return absl::OkStatus();
   }
+  auto creation = std::move(*creation_or_status);
 
-  for (int i = 0; i < field_keys_.size(); i++) {
+  for (int i = 0; i < plan_.size(); i++) {
     CEL_RETURN_IF_ERROR(deps_[i]->Evaluate(frame, field_value, field_attr));
 
     // TODO: if the value is an error, we should be able to return
@@ -200,8 +301,7 @@ absl::Status DirectCreateStructStep::Evaluate(ExecutionFrameBase& frame,
         if (!optional_arg->HasValue()) {
           continue;
         }
-        auto status =
-            builder->SetFieldByName(field_keys_[i], optional_arg->Value());
+        auto status = creation.SetField(i, optional_arg->Value());
         if (!status.ok()) {
           result = frame.value_manager().CreateErrorValue(std::move(status));
           return absl::OkStatus();
@@ -210,8 +310,7 @@ absl::Status DirectCreateStructStep::Evaluate(ExecutionFrameBase& frame,
       continue;
     }
 
-    auto status =
-        builder->SetFieldByName(field_keys_[i], std::move(field_value));
+    auto status = creation.SetField(i, std::move(field_value));
     if (!status.ok()) {
       result = frame.value_manager().CreateErrorValue(std::move(status));
       return absl::OkStatus();
@@ -223,7 +322,7 @@ absl::Status DirectCreateStructStep::Evaluate(ExecutionFrameBase& frame,
     return absl::OkStatus();
   }
 
-  result = std::move(*builder).Build();
+  result = std::move(creation).Build();
   return absl::OkStatus();
 }
 
@@ -234,8 +333,20 @@ std::unique_ptr<DirectExpressionStep> CreateDirectCreateStructStep(
     std::vector<std::unique_ptr<DirectExpressionStep>> deps,
     absl::flat_hash_set<int32_t> optional_indices, int64_t expr_id) {
   return std::make_unique<DirectCreateStructStep>(
-      expr_id, std::move(resolved_name), std::move(field_keys), std::move(deps),
-      std::move(optional_indices));
+      expr_id,
+      StructCreationPlan(std::move(resolved_name), std::move(field_keys)),
+      std::move(deps), std::move(optional_indices));
+}
+
+std::unique_ptr<DirectExpressionStep> CreateDirectCreateStructStep(
+    cel::MessageType type, std::vector<std::string> field_keys,
+    std::vector<cel::MessageTypeField> fields,
+    std::vector<std::unique_ptr<DirectExpressionStep>> deps,
+    absl::flat_hash_set<int32_t> optional_indices, int64_t expr_id) {
+  return std::make_unique<DirectCreateStructStep>(
+      expr_id,
+      StructCreationPlan(type, std::move(field_keys), std::move(fields)),
+      std::move(deps), std::move(optional_indices));
 }
 
 std::unique_ptr<ExpressionStep> CreateCreateStructStep(
@@ -243,7 +354,17 @@ std::unique_ptr<ExpressionStep> CreateCreateStructStep(
     absl::flat_hash_set<int32_t> optional_indices, int64_t expr_id) {
   // MakeOptionalIndicesSet(create_struct_expr)
   return std::make_unique<CreateStructStepForStruct>(
-      expr_id, std::move(name), std::move(field_keys),
+      expr_id, StructCreationPlan(std::move(name), std::move(field_keys)),
+      std::move(optional_indices));
+}
+
+std::unique_ptr<ExpressionStep> CreateCreateStructStep(
+    cel::MessageType type, std::vector<std::string> field_keys,
+    std::vector<cel::MessageTypeField> fields,
+    absl::flat_hash_set<int32_t> optional_indices, int64_t expr_id) {
+  return std::make_unique<CreateStructStepForStruct>(
+      expr_id,
+      StructCreationPlan(type, std::move(field_keys), std::move(fields)),
       std::move(optional_indices));
 }
 }  // namespace google::api::expr::runtime
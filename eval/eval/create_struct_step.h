@@ -21,6 +21,7 @@
 #include <vector>
 
 #include "absl/container/flat_hash_set.h"
+#include "common/type.h"
 #include "eval/eval/direct_expression_step.h"
 #include "eval/eval/evaluator_core.h"
 
@@ -33,12 +34,28 @@ std::unique_ptr<DirectExpressionStep> CreateDirectCreateStructStep(
     std::vector<std::unique_ptr<DirectExpressionStep>> deps,
     absl::flat_hash_set<int32_t> optional_indices, int64_t expr_id);
 
+// Same as above, but the message type and its fields were resolved during
+// planning, so they are not looked up by name on every evaluation. `fields` is
+// parallel to `field_keys`; empty entries are set by name.
+std::unique_ptr<DirectExpressionStep> CreateDirectCreateStructStep(
+    cel::MessageType type, std::vector<std::string> field_keys,
+    std::vector<cel::MessageTypeField> fields,
+    std::vector<std::unique_ptr<DirectExpressionStep>> deps,
+    absl::flat_hash_set<int32_t> optional_indices, int64_t expr_id);
+
 // Creates an `ExpressionStep` which performs `CreateStruct` for a
 // message/struct.
 std::unique_ptr<ExpressionStep> CreateCreateStructStep(
     std::string name, std::vector<std::string> field_keys,
     absl::flat_hash_set<int32_t> optional_indices, int64_t expr_id);
 
+// Same as above, but the message type and its fields were resolved during
+// planning, see `CreateDirectCreateStructStep`.
+std::unique_ptr<ExpressionStep> CreateCreateStructStep(
+    cel::MessageType type, std::vector<std::string> field_keys,
+    std::vector<cel::MessageTypeField> fields,
+    absl::flat_hash_set<int32_t> optional_indices, int64_t expr_id);
+
 }  // namespace google::api::expr::runtime
 
 #endif  // THIRD_PARTY_CEL_CPP_EVAL_EVAL_CREATE_STRUCT_STEP_H_
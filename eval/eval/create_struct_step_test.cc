@@ -28,6 +28,7 @@
 #include "absl/types/span.h"
 #include "base/ast_internal/expr.h"
 #include "base/type_provider.h"
+#include "common/type.h"
 #include "common/values/legacy_value_manager.h"
 #include "eval/eval/cel_expression_flat_impl.h"
 #include "eval/eval/direct_expression_step.h"
@@ -247,6 +248,70 @@ TEST_P(CreateCreateStructStepTest, TestEmptyMessageCreation) {
   ASSERT_EQ(msg->GetDescriptor(), TestMessage::descriptor());
 }
 
+TEST_P(CreateCreateStructStepTest, TestMessageCreationWithResolvedType) {
+  ExecutionPath path;
+  CelTypeRegistry type_registry;
+  type_registry.RegisterTypeProvider(
+      std::make_unique<ProtobufDescriptorProvider>(
+          google::protobuf::DescriptorPool::generated_pool(),
+          google::protobuf::MessageFactory::generated_factory()));
+  google::protobuf::Arena arena;
+
+  const auto* descriptor = TestMessage::descriptor();
+  cel::MessageType type(descriptor);
+  // The first field is resolved, the second is set by name.
+  std::vector<std::string> field_keys = {"int32_value", "string_value"};
+  std::vector<cel::MessageTypeField> fields = {
+      cel::MessageTypeField(descriptor->FindFieldByName("int32_value")),
+      cel::MessageTypeField()};
+
+  Expr expr0;
+  expr0.mutable_ident_expr().set_name("int_arg");
+  Expr expr1;
+  expr1.mutable_ident_expr().set_name("string_arg");
+  if (enable_recursive_planning()) {
+    std::vector<std::unique_ptr<DirectExpressionStep>> deps;
+    deps.push_back(CreateDirectIdentStep("int_arg", -1));
+    deps.push_back(CreateDirectIdentStep("string_arg", -1));
+    auto step = CreateDirectCreateStructStep(
+        type, std::move(field_keys), std::move(fields), std::move(deps),
+        /*optional_indices=*/{},
+        /*id=*/-1);
+    path.push_back(
+        std::make_unique<WrappedDirectStep>(std::move(step), /*id=*/-1));
+  } else {
+    ASSERT_OK_AND_ASSIGN(auto step0,
+                         CreateIdentStep(expr0.ident_expr(), expr0.id()));
+    ASSERT_OK_AND_ASSIGN(auto step1,
+                         CreateIdentStep(expr1.ident_expr(), expr1.id()));
+    path.push_back(std::move(step0));
+    path.push_back(std::move(step1));
+    path.push_back(CreateCreateStructStep(type, std::move(field_keys),
+                                          std::move(fields),
+                                          /*optional_indices=*/{},
+                                          /*id=*/-1));
+  }
+
+  cel::RuntimeOptions options;
+  if (enable_unknowns()) {
+    options.unknown_processing = cel::UnknownProcessingOptions::kAttributeOnly;
+  }
+  CelExpressionFlatImpl cel_expr(
+      FlatExpression(std::move(path), /*comprehension_slot_count=*/0,
+                     type_registry.GetTypeProvider(), options));
+  Activation activation;
+  activation.InsertValue("int_arg", CelValue::CreateInt64(1));
+  std::string string_arg = "foo";
+  activation.InsertValue("string_arg", CelValue::CreateString(&string_arg));
+
+  ASSERT_OK_AND_ASSIGN(CelValue result, cel_expr.Evaluate(activation, &arena));
+  ASSERT_TRUE(result.IsMessage()) << result.DebugString();
+  TestMessage test_msg;
+  test_msg.MergeFrom(*result.MessageOrDie());
+  EXPECT_EQ(test_msg.int32_value(), 1);
+  EXPECT_EQ(test_msg.string_value(), "foo");
+}
+
 // Test message creation if unknown argument is passed
 TEST(CreateCreateStructStepTest, TestMessageCreateWithUnknown) {
   Arena arena;
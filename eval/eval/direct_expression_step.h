@@ -14,6 +14,7 @@
 #ifndef THIRD_PARTY_CEL_CPP_EVAL_EVAL_DIRECT_EXPRESSION_STEP_H_
 #define THIRD_PARTY_CEL_CPP_EVAL_EVAL_DIRECT_EXPRESSION_STEP_H_
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <utility>
@@ -25,6 +26,7 @@
 #include "common/value.h"
 #include "eval/eval/attribute_trail.h"
 #include "eval/eval/evaluator_core.h"
+#include "eval/eval/step_arena.h"
 
 namespace google::api::expr::runtime {
 
@@ -43,6 +45,12 @@ class DirectExpressionStep {
 
   virtual ~DirectExpressionStep() = default;
 
+  // Allocated from the program's step arena while planning, see `StepArena`.
+  static void* operator new(size_t size) {
+    return StepArena::AllocateStep(size);
+  }
+  static void operator delete(void* ptr) { StepArena::DeallocateStep(ptr); }
+
   int64_t expr_id() const { return expr_id_; }
   bool comes_from_ast() const { return expr_id_ >= 0; }
 
@@ -72,6 +80,13 @@ class DirectExpressionStep {
     return absl::nullopt;
   };
 
+  // Adds an estimate of the memory held by this node to `usage`. See
+  // `ExpressionStep::AccumulateMemoryUsage`; implementations owning
+  // dependencies must include them.
+  virtual void AccumulateMemoryUsage(cel::ProgramMemoryUsage& usage) const {
+    usage.steps += sizeof(DirectExpressionStep);
+  }
+
  protected:
   int64_t expr_id_;
 };
@@ -90,6 +105,11 @@ class WrappedDirectStep : public ExpressionStep {
 
   const DirectExpressionStep* wrapped() const { return impl_.get(); }
 
+  void AccumulateMemoryUsage(cel::ProgramMemoryUsage& usage) const override {
+    usage.steps += sizeof(*this);
+    impl_->AccumulateMemoryUsage(usage);
+  }
+
  private:
   std::unique_ptr<DirectExpressionStep> impl_;
 };
@@ -31,6 +31,7 @@
 #include "common/memory.h"
 #include "common/value.h"
 #include "common/value_manager.h"
+#include "eval/eval/step_arena.h"
 #include "runtime/activation_interface.h"
 #include "runtime/managed_value_factory.h"
 
@@ -200,4 +201,41 @@ cel::ManagedValueFactory FlatExpression::MakeValueFactory(
   return cel::ManagedValueFactory(type_provider_, memory_manager);
 }
 
+FlatExpression::~FlatExpression() {
+  // Steps allocated from the step arena must be destroyed under its scope.
+  StepArenaScope scope(step_arena_.get());
+  path_.clear();
+}
+
+cel::ProgramMemoryUsage FlatExpression::ComputeMemoryUsage() const {
+  cel::ProgramMemoryUsage usage;
+  usage.steps += path_.capacity() * sizeof(ExecutionPath::value_type) +
+                 subexpressions_.capacity() * sizeof(ExecutionPathView);
+  cel::ProgramMemoryUsage step_usage;
+  for (const auto& step : path_) {
+    step->AccumulateMemoryUsage(step_usage);
+  }
+  if (step_arena_ != nullptr) {
+    // The step objects live in the step arena, whose blocks are their actual
+    // footprint. The estimates reported by the steps themselves miss the
+    // alignment padding and the unused tail of each block.
+    step_usage.steps = step_arena_->SpaceAllocated();
+  }
+  usage += step_usage;
+  if (arena_ != nullptr) {
+    usage.arena += static_cast<size_t>(arena_->SpaceAllocated());
+  }
+  return usage;
+}
+
+size_t ValueHeapSize(const cel::Value& value) {
+  if (auto string_value = value.AsString(); string_value.has_value()) {
+    return string_value->Size();
+  }
+  if (auto bytes_value = value.AsBytes(); bytes_value.has_value()) {
+    return bytes_value->Size();
+  }
+  return 0;
+}
+
 }  // namespace google::api::expr::runtime
@@ -39,6 +39,7 @@
 #include "eval/eval/attribute_utility.h"
 #include "eval/eval/comprehension_slots.h"
 #include "eval/eval/evaluator_stack.h"
+#include "eval/eval/step_arena.h"
 #include "runtime/activation_interface.h"
 #include "runtime/managed_value_factory.h"
 #include "runtime/runtime.h"
@@ -63,6 +64,13 @@ class ExpressionStep {
 
   virtual ~ExpressionStep() = default;
 
+  // Steps created while planning are allocated from the program's step arena,
+  // see `StepArena`.
+  static void* operator new(size_t size) {
+    return StepArena::AllocateStep(size);
+  }
+  static void operator delete(void* ptr) { StepArena::DeallocateStep(ptr); }
+
   // Performs actual evaluation.
   // Values are passed between Expression objects via EvaluatorStack, which is
   // supplied with context.
@@ -90,11 +98,25 @@ class ExpressionStep {
     return cel::NativeTypeId();
   }
 
+  // Adds an estimate of the memory held by this step to `usage`.
+  //
+  // The default only accounts for the base object. Steps that own child steps,
+  // constant values or compiled programs should override this, adding
+  // `sizeof(*this)` to `usage.steps` and accounting for what they own.
+  virtual void AccumulateMemoryUsage(cel::ProgramMemoryUsage& usage) const {
+    usage.steps += sizeof(ExpressionStep);
+  }
+
  private:
   const int64_t id_;
   const bool comes_from_ast_;
 };
 
+// Returns an estimate of the memory owned by `value` outside of the
+// `cel::Value` object itself, for use by `AccumulateMemoryUsage`
+// implementations. Only string and bytes payloads are accounted for.
+size_t ValueHeapSize(const cel::Value& value);
+
 using ExecutionPath = std::vector<std::unique_ptr<const ExpressionStep>>;
 using ExecutionPathView =
     absl::Span<const std::unique_ptr<const ExpressionStep>>;
@@ -383,8 +405,11 @@ class FlatExpression {
                  size_t comprehension_slots_size,
                  const cel::TypeProvider& type_provider,
                  const cel::RuntimeOptions& options,
-                 absl::Nullable<std::shared_ptr<google::protobuf::Arena>> arena = nullptr)
-      : path_(std::move(path)),
+                 absl::Nullable<std::shared_ptr<google::protobuf::Arena>> arena = nullptr,
+                 absl::Nullable<std::unique_ptr<StepArena>> step_arena =
+                     nullptr)
+      : step_arena_(std::move(step_arena)),
+        path_(std::move(path)),
         subexpressions_(std::move(subexpressions)),
         comprehension_slots_size_(comprehension_slots_size),
         type_provider_(type_provider),
@@ -395,6 +420,8 @@ class FlatExpression {
   FlatExpression(FlatExpression&&) = default;
   FlatExpression& operator=(FlatExpression&&) = delete;
 
+  ~FlatExpression();
+
   // Create new evaluator state instance with the configured options and type
   // provider.
   FlatExpressionEvaluatorState MakeEvaluatorState(
@@ -427,7 +454,14 @@ class FlatExpression {
 
   size_t comprehension_slots_size() const { return comprehension_slots_size_; }
 
+  // Returns an estimate of the memory held by the plan, see
+  // `cel::Program::GetMemoryUsage`. Walks the whole plan: callers should
+  // compute it once.
+  cel::ProgramMemoryUsage ComputeMemoryUsage() const;
+
  private:
+  // Owns the memory of the steps planned with it, so must outlive `path_`.
+  absl::Nullable<std::unique_ptr<StepArena>> step_arena_;
   ExecutionPath path_;
   std::vector<ExecutionPathView> subexpressions_;
   size_t comprehension_slots_size_;
@@ -466,6 +466,13 @@ class DirectFunctionStepImpl : public DirectExpressionStep {
     return std::move(arg_steps_);
   }
 
+  void AccumulateMemoryUsage(cel::ProgramMemoryUsage& usage) const override {
+    usage.steps += sizeof(*this);
+    for (const auto& step : arg_steps_) {
+      step->AccumulateMemoryUsage(usage);
+    }
+  }
+
  private:
   friend Resolver;
   std::string name_;
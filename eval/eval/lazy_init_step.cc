@@ -100,6 +100,11 @@ class BindStep : public DirectExpressionStep {
     return absl::OkStatus();
   }
 
+  void AccumulateMemoryUsage(cel::ProgramMemoryUsage& usage) const override {
+    usage.steps += sizeof(*this);
+    subexpression_->AccumulateMemoryUsage(usage);
+  }
+
  private:
   size_t slot_index_;
   std::unique_ptr<DirectExpressionStep> subexpression_;
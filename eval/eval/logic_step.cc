@@ -95,6 +95,12 @@ class ExhaustiveDirectLogicStep : public DirectExpressionStep {
   absl::Status Evaluate(ExecutionFrameBase& frame, cel::Value& result,
                         AttributeTrail& attribute_trail) const override;
 
+  void AccumulateMemoryUsage(cel::ProgramMemoryUsage& usage) const override {
+    usage.steps += sizeof(*this);
+    lhs_->AccumulateMemoryUsage(usage);
+    rhs_->AccumulateMemoryUsage(usage);
+  }
+
  private:
   std::unique_ptr<DirectExpressionStep> lhs_;
   std::unique_ptr<DirectExpressionStep> rhs_;
@@ -147,6 +153,12 @@ class DirectLogicStep : public DirectExpressionStep {
   absl::Status Evaluate(ExecutionFrameBase& frame, cel::Value& result,
                         AttributeTrail& attribute_trail) const override;
 
+  void AccumulateMemoryUsage(cel::ProgramMemoryUsage& usage) const override {
+    usage.steps += sizeof(*this);
+    lhs_->AccumulateMemoryUsage(usage);
+    rhs_->AccumulateMemoryUsage(usage);
+  }
+
  private:
   std::unique_ptr<DirectExpressionStep> lhs_;
   std::unique_ptr<DirectExpressionStep> rhs_;
@@ -194,6 +194,12 @@ class ExhaustiveDirectOptionalOrStep : public DirectExpressionStep {
   absl::Status Evaluate(ExecutionFrameBase& frame, Value& result,
                         AttributeTrail& attribute) const override;
 
+  void AccumulateMemoryUsage(cel::ProgramMemoryUsage& usage) const override {
+    usage.steps += sizeof(*this);
+    optional_->AccumulateMemoryUsage(usage);
+    alternative_->AccumulateMemoryUsage(usage);
+  }
+
  private:
   OptionalOrKind kind_;
   std::unique_ptr<DirectExpressionStep> optional_;
@@ -226,6 +232,12 @@ class DirectOptionalOrStep : public DirectExpressionStep {
   absl::Status Evaluate(ExecutionFrameBase& frame, Value& result,
                         AttributeTrail& attribute) const override;
 
+  void AccumulateMemoryUsage(cel::ProgramMemoryUsage& usage) const override {
+    usage.steps += sizeof(*this);
+    optional_->AccumulateMemoryUsage(usage);
+    alternative_->AccumulateMemoryUsage(usage);
+  }
+
  private:
   OptionalOrKind kind_;
   std::unique_ptr<DirectExpressionStep> optional_;
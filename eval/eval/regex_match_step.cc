@@ -14,6 +14,7 @@
 
 #include "eval/eval/regex_match_step.h"
 
+#include <cstddef>
 #include <cstdint>
 #include <cstdio>
 #include <memory>
@@ -47,6 +48,26 @@ using ::cel::Value;
 inline constexpr int kNumRegexMatchArguments = 1;
 inline constexpr size_t kRegexMatchStepSubject = 0;
 
+// RE2 does not report its memory usage. Estimate it from the number of
+// instructions of the compiled program, accounting for the instruction itself
+// and the per-instruction bookkeeping of the program and its matchers.
+inline constexpr size_t kRegexBytesPerInstruction = 16;
+
+size_t RegexMemoryUsage(const RE2& re2) {
+  return sizeof(RE2) + re2.pattern().size() +
+         static_cast<size_t>(re2.ProgramSize()) * kRegexBytesPerInstruction;
+}
+
+size_t RegexSetMemoryUsage(const RegexSetProgram& regex_set) {
+  // The set compiles its own program over the same patterns, which is assumed
+  // to be as large as the individual programs combined.
+  size_t usage = sizeof(RegexSetProgram);
+  for (const auto& program : regex_set.programs) {
+    usage += 2 * RegexMemoryUsage(*program);
+  }
+  return usage;
+}
+
 struct MatchesVisitor final {
   const RE2& re;
 
@@ -62,6 +83,35 @@ struct MatchesVisitor final {
   }
 };
 
+struct MatchesAnyVisitor final {
+  const RegexSetProgram& regex_set;
+
+  bool operator()(const absl::Cord& value) const {
+    if (auto flat = value.TryFlat(); flat.has_value()) {
+      return (*this)(*flat);
+    }
+    return (*this)(static_cast<std::string>(value));
+  }
+
+  bool operator()(absl::string_view value) const {
+    RE2::Set::ErrorInfo error_info{RE2::Set::kNoError};
+    if (regex_set.set.Match(value, nullptr, &error_info)) {
+      return true;
+    }
+    if (error_info.kind == RE2::Set::kNoError) {
+      return false;
+    }
+    // The DFA gave up (e.g. out of memory), fall back to matching the patterns
+    // one at a time.
+    for (const auto& program : regex_set.programs) {
+      if (RE2::PartialMatch(value, *program)) {
+        return true;
+      }
+    }
+    return false;
+  }
+};
+
 class RegexMatchStep final : public ExpressionStepBase {
  public:
   RegexMatchStep(int64_t expr_id, std::shared_ptr<const RE2> re2)
@@ -87,6 +137,11 @@ class RegexMatchStep final : public ExpressionStepBase {
     return absl::OkStatus();
   }
 
+  void AccumulateMemoryUsage(cel::ProgramMemoryUsage& usage) const override {
+    usage.steps += sizeof(*this);
+    usage.regex += RegexMemoryUsage(*re2_);
+  }
+
  private:
   const std::shared_ptr<const RE2> re2_;
 };
@@ -119,11 +174,96 @@ class RegexMatchDirectStep final : public DirectExpressionStep {
     return absl::OkStatus();
   }
 
+  void AccumulateMemoryUsage(cel::ProgramMemoryUsage& usage) const override {
+    usage.steps += sizeof(*this);
+    subject_->AccumulateMemoryUsage(usage);
+    usage.regex += RegexMemoryUsage(*re2_);
+  }
+
  private:
   std::unique_ptr<DirectExpressionStep> subject_;
   const std::shared_ptr<const RE2> re2_;
 };
 
+class RegexSetMatchStep final : public ExpressionStepBase {
+ public:
+  RegexSetMatchStep(int64_t expr_id,
+                    std::shared_ptr<const RegexSetProgram> regex_set)
+      : ExpressionStepBase(expr_id, /*comes_from_ast=*/true),
+        regex_set_(std::move(regex_set)) {}
+
+  absl::Status Evaluate(ExecutionFrame* frame) const override {
+    if (!frame->value_stack().HasEnough(kNumRegexMatchArguments)) {
+      return absl::Status(absl::StatusCode::kInternal,
+                          "Insufficient arguments supplied for regular "
+                          "expression match");
+    }
+    const auto& subject = frame->value_stack().Peek();
+    if (subject.IsError() || subject.IsUnknown()) {
+      // Propagate, same as the disjunction of the individual matches.
+      return absl::OkStatus();
+    }
+    if (!subject.IsString()) {
+      return absl::Status(absl::StatusCode::kInternal,
+                          "First argument for regular "
+                          "expression match must be a string");
+    }
+    bool match =
+        subject.GetString().NativeValue(MatchesAnyVisitor{*regex_set_});
+    frame->value_stack().PopAndPush(
+        frame->value_factory().CreateBoolValue(match));
+    return absl::OkStatus();
+  }
+
+  void AccumulateMemoryUsage(cel::ProgramMemoryUsage& usage) const override {
+    usage.steps += sizeof(*this);
+    usage.regex += RegexSetMemoryUsage(*regex_set_);
+  }
+
+ private:
+  const std::shared_ptr<const RegexSetProgram> regex_set_;
+};
+
+class RegexSetMatchDirectStep final : public DirectExpressionStep {
+ public:
+  RegexSetMatchDirectStep(int64_t expr_id,
+                          std::unique_ptr<DirectExpressionStep> subject,
+                          std::shared_ptr<const RegexSetProgram> regex_set)
+      : DirectExpressionStep(expr_id),
+        subject_(std::move(subject)),
+        regex_set_(std::move(regex_set)) {}
+
+  absl::Status Evaluate(ExecutionFrameBase& frame, Value& result,
+                        AttributeTrail& attribute) const override {
+    AttributeTrail subject_attr;
+    CEL_RETURN_IF_ERROR(subject_->Evaluate(frame, result, subject_attr));
+    if (InstanceOf<ErrorValue>(result) ||
+        cel::InstanceOf<UnknownValue>(result)) {
+      return absl::OkStatus();
+    }
+
+    if (!InstanceOf<StringValue>(result)) {
+      return absl::Status(absl::StatusCode::kInternal,
+                          "First argument for regular "
+                          "expression match must be a string");
+    }
+    bool match =
+        Cast<StringValue>(result).NativeValue(MatchesAnyVisitor{*regex_set_});
+    result = BoolValue(match);
+    return absl::OkStatus();
+  }
+
+  void AccumulateMemoryUsage(cel::ProgramMemoryUsage& usage) const override {
+    usage.steps += sizeof(*this);
+    subject_->AccumulateMemoryUsage(usage);
+    usage.regex += RegexSetMemoryUsage(*regex_set_);
+  }
+
+ private:
+  std::unique_ptr<DirectExpressionStep> subject_;
+  const std::shared_ptr<const RegexSetProgram> regex_set_;
+};
+
 }  // namespace
 
 std::unique_ptr<DirectExpressionStep> CreateDirectRegexMatchStep(
@@ -138,4 +278,16 @@ absl::StatusOr<std::unique_ptr<ExpressionStep>> CreateRegexMatchStep(
   return std::make_unique<RegexMatchStep>(expr_id, std::move(re2));
 }
 
+std::unique_ptr<DirectExpressionStep> CreateDirectRegexSetMatchStep(
+    int64_t expr_id, std::unique_ptr<DirectExpressionStep> subject,
+    std::shared_ptr<const RegexSetProgram> regex_set) {
+  return std::make_unique<RegexSetMatchDirectStep>(
+      expr_id, std::move(subject), std::move(regex_set));
+}
+
+absl::StatusOr<std::unique_ptr<ExpressionStep>> CreateRegexSetMatchStep(
+    std::shared_ptr<const RegexSetProgram> regex_set, int64_t expr_id) {
+  return std::make_unique<RegexSetMatchStep>(expr_id, std::move(regex_set));
+}
+
 }  // namespace google::api::expr::runtime
@@ -17,14 +17,26 @@
 
 #include <cstdint>
 #include <memory>
+#include <vector>
 
 #include "absl/status/statusor.h"
 #include "eval/eval/direct_expression_step.h"
 #include "eval/eval/evaluator_core.h"
 #include "re2/re2.h"
+#include "re2/set.h"
 
 namespace google::api::expr::runtime {
 
+// A disjunction of precompiled regular expressions that are matched against
+// the same subject in a single scan.
+struct RegexSetProgram {
+  // Compiled, unanchored set of all of the patterns.
+  RE2::Set set{RE2::DefaultOptions, RE2::UNANCHORED};
+  // The individual programs, used if the set's DFA exhausts its memory budget
+  // for a given input.
+  std::vector<std::shared_ptr<const RE2>> programs;
+};
+
 std::unique_ptr<DirectExpressionStep> CreateDirectRegexMatchStep(
     int64_t expr_id, std::unique_ptr<DirectExpressionStep> subject,
     std::shared_ptr<const RE2> re2);
@@ -32,6 +44,15 @@ std::unique_ptr<DirectExpressionStep> CreateDirectRegexMatchStep(
 absl::StatusOr<std::unique_ptr<ExpressionStep>> CreateRegexMatchStep(
     std::shared_ptr<const RE2> re2, int64_t expr_id);
 
+// Steps evaluating `matches` of the subject against any of the patterns in the
+// given set, equivalent to `s.matches(p1) || ... || s.matches(pN)`.
+std::unique_ptr<DirectExpressionStep> CreateDirectRegexSetMatchStep(
+    int64_t expr_id, std::unique_ptr<DirectExpressionStep> subject,
+    std::shared_ptr<const RegexSetProgram> regex_set);
+
+absl::StatusOr<std::unique_ptr<ExpressionStep>> CreateRegexSetMatchStep(
+    std::shared_ptr<const RegexSetProgram> regex_set, int64_t expr_id);
+
 }
 
 #endif  // THIRD_PARTY_CEL_CPP_EVAL_EVAL_REGEX_MATCH_STEP_H_
@@ -385,6 +385,11 @@ class DirectSelectStep : public DirectExpressionStep {
     return absl::OkStatus();
   }
 
+  void AccumulateMemoryUsage(cel::ProgramMemoryUsage& usage) const override {
+    usage.steps += sizeof(*this);
+    operand_->AccumulateMemoryUsage(usage);
+  }
+
  private:
   std::unique_ptr<DirectExpressionStep> operand_;
 
@@ -30,6 +30,11 @@ class ShadowableValueStep : public ExpressionStepBase {
 
   absl::Status Evaluate(ExecutionFrame* frame) const override;
 
+  void AccumulateMemoryUsage(cel::ProgramMemoryUsage& usage) const override {
+    usage.steps += sizeof(*this);
+    usage.constants += ValueHeapSize(value_);
+  }
+
  private:
   std::string identifier_;
   Value value_;
@@ -59,6 +64,11 @@ class DirectShadowableValueStep : public DirectExpressionStep {
   absl::Status Evaluate(ExecutionFrameBase& frame, Value& result,
                         AttributeTrail& attribute) const override;
 
+  void AccumulateMemoryUsage(cel::ProgramMemoryUsage& usage) const override {
+    usage.steps += sizeof(*this);
+    usage.constants += ValueHeapSize(value_);
+  }
+
  private:
   std::string identifier_;
   Value value_;
@@ -0,0 +1,108 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval/eval/step_arena.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+
+#include "absl/base/nullability.h"
+
+namespace google::api::expr::runtime {
+
+namespace {
+
+// Matches the alignment guaranteed by the global `operator new`.
+constexpr size_t kStepAlignment = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+// Most programs have a few dozen steps, so start small to avoid reserving
+// much more than is needed and grow geometrically for large programs.
+constexpr size_t kMinBlockSize = 1024;
+constexpr size_t kMaxBlockSize = 64 * 1024;
+
+thread_local StepArenaScope* current_scope = nullptr;
+
+size_t AlignUp(size_t size) {
+  return (size + kStepAlignment - 1) & ~(kStepAlignment - 1);
+}
+
+}  // namespace
+
+absl::Nonnull<void*> StepArena::Allocate(size_t size) {
+  size = AlignUp(size);
+  if (size > remaining_) {
+    size_t block_size =
+        blocks_.empty() ? kMinBlockSize
+                        : std::min(2 * blocks_.back().size, kMaxBlockSize);
+    block_size = std::max(block_size, size);
+    // `new char[]` only guarantees `kStepAlignment` for the start of the
+    // block, which is all that is needed as sizes are rounded up.
+    blocks_.push_back(Block{std::unique_ptr<char[]>(new char[block_size]),
+                            block_size});
+    next_ = blocks_.back().data.get();
+    remaining_ = block_size;
+    space_allocated_ += block_size;
+  }
+  void* ptr = next_;
+  next_ += size;
+  remaining_ -= size;
+  space_used_ += size;
+  return ptr;
+}
+
+bool StepArena::Contains(const void* ptr) const {
+  const char* p = static_cast<const char*>(ptr);
+  // Recent blocks are larger and hold most steps, so check them first.
+  for (auto it = blocks_.rbegin(); it != blocks_.rend(); ++it) {
+    const char* begin = it->data.get();
+    if (!std::less<const char*>()(p, begin) &&
+        std::less<const char*>()(p, begin + it->size)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+absl::Nonnull<void*> StepArena::AllocateStep(size_t size) {
+  if (current_scope != nullptr && current_scope->arena_ != nullptr) {
+    return current_scope->arena_->Allocate(size);
+  }
+  return ::operator new(size);
+}
+
+void StepArena::DeallocateStep(absl::Nullable<void*> ptr) {
+  if (ptr == nullptr) {
+    return;
+  }
+  for (const StepArenaScope* scope = current_scope; scope != nullptr;
+       scope = scope->previous_) {
+    if (scope->arena_ != nullptr && scope->arena_->Contains(ptr)) {
+      // Released with the arena.
+      return;
+    }
+  }
+  ::operator delete(ptr);
+}
+
+StepArenaScope::StepArenaScope(absl::Nullable<StepArena*> arena)
+    : arena_(arena), previous_(current_scope) {
+  current_scope = this;
+}
+
+StepArenaScope::~StepArenaScope() { current_scope = previous_; }
+
+}  // namespace google::api::expr::runtime
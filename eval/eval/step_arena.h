@@ -0,0 +1,95 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_EVAL_EVAL_STEP_ARENA_H_
+#define THIRD_PARTY_CEL_CPP_EVAL_EVAL_STEP_ARENA_H_
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "absl/base/nullability.h"
+
+namespace google::api::expr::runtime {
+
+// Bump allocator for the expression steps of a single program.
+//
+// While a `StepArenaScope` is active on a thread, expression steps created on
+// that thread are allocated contiguously from its arena instead of being
+// separate heap objects, so the steps of a program are laid out close to each
+// other in roughly the order they are evaluated.
+//
+// Individual steps are never freed: deleting a step allocated from an arena
+// only runs its destructor, and the memory is released with the arena. The
+// arena must therefore outlive its steps, and steps allocated from an arena
+// must be deleted while a scope for that arena is active on the deleting
+// thread. `FlatExpression` owns the arena its steps were planned with and
+// takes care of this.
+class StepArena final {
+ public:
+  StepArena() = default;
+
+  StepArena(const StepArena&) = delete;
+  StepArena& operator=(const StepArena&) = delete;
+
+  // Returns `size` bytes aligned for any expression step.
+  absl::Nonnull<void*> Allocate(size_t size);
+
+  // Returns whether `ptr` was allocated from this arena.
+  bool Contains(const void* ptr) const;
+
+  // Returns the number of bytes reserved by the arena.
+  size_t SpaceAllocated() const { return space_allocated_; }
+
+  // Returns the number of bytes handed out by the arena.
+  size_t SpaceUsed() const { return space_used_; }
+
+  // Allocation functions used by `ExpressionStep` and `DirectExpressionStep`.
+  // Uses the arena of the innermost active scope if any, the heap otherwise.
+  static absl::Nonnull<void*> AllocateStep(size_t size);
+  static void DeallocateStep(absl::Nullable<void*> ptr);
+
+ private:
+  struct Block {
+    std::unique_ptr<char[]> data;
+    size_t size;
+  };
+
+  std::vector<Block> blocks_;
+  char* next_ = nullptr;
+  size_t remaining_ = 0;
+  size_t space_allocated_ = 0;
+  size_t space_used_ = 0;
+};
+
+// Makes `arena` the allocator for expression steps created on the current
+// thread until the scope is destroyed. Scopes may be nested.
+class StepArenaScope final {
+ public:
+  explicit StepArenaScope(absl::Nullable<StepArena*> arena);
+  ~StepArenaScope();
+
+  StepArenaScope(const StepArenaScope&) = delete;
+  StepArenaScope& operator=(const StepArenaScope&) = delete;
+
+ private:
+  friend class StepArena;
+
+  absl::Nullable<StepArena*> const arena_;
+  absl::Nullable<StepArenaScope*> const previous_;
+};
+
+}  // namespace google::api::expr::runtime
+
+#endif  // THIRD_PARTY_CEL_CPP_EVAL_EVAL_STEP_ARENA_H_
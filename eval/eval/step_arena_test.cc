@@ -0,0 +1,103 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval/eval/step_arena.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include "internal/testing.h"
+
+namespace google::api::expr::runtime {
+namespace {
+
+TEST(StepArenaTest, AllocatesContiguously) {
+  StepArena arena;
+  char* first = static_cast<char*>(arena.Allocate(24));
+  char* second = static_cast<char*>(arena.Allocate(24));
+
+  EXPECT_EQ(second - first, 32);
+  EXPECT_TRUE(arena.Contains(first));
+  EXPECT_TRUE(arena.Contains(second));
+  EXPECT_EQ(arena.SpaceUsed(), 64);
+  EXPECT_GE(arena.SpaceAllocated(), arena.SpaceUsed());
+}
+
+TEST(StepArenaTest, AlignsAllocations) {
+  StepArena arena;
+  for (size_t size = 1; size < 100; ++size) {
+    void* ptr = arena.Allocate(size);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) %
+                  __STDCPP_DEFAULT_NEW_ALIGNMENT__,
+              0);
+  }
+}
+
+TEST(StepArenaTest, GrowsForLargeAllocations) {
+  StepArena arena;
+  void* small = arena.Allocate(16);
+  void* large = arena.Allocate(1024 * 1024);
+
+  EXPECT_TRUE(arena.Contains(small));
+  EXPECT_TRUE(arena.Contains(large));
+  EXPECT_GE(arena.SpaceAllocated(), 1024 * 1024);
+}
+
+TEST(StepArenaTest, DoesNotContainOtherPointers) {
+  StepArena arena;
+  arena.Allocate(16);
+  int local = 0;
+
+  EXPECT_FALSE(arena.Contains(&local));
+}
+
+TEST(StepArenaTest, AllocatesStepsFromInnermostScope) {
+  StepArena outer;
+  StepArena inner;
+  StepArenaScope outer_scope(&outer);
+  void* outer_step = StepArena::AllocateStep(16);
+  void* inner_step;
+  {
+    StepArenaScope inner_scope(&inner);
+    inner_step = StepArena::AllocateStep(16);
+    // Steps of enclosing scopes can still be released.
+    StepArena::DeallocateStep(outer_step);
+    StepArena::DeallocateStep(inner_step);
+  }
+
+  EXPECT_TRUE(outer.Contains(outer_step));
+  EXPECT_FALSE(inner.Contains(outer_step));
+  EXPECT_TRUE(inner.Contains(inner_step));
+}
+
+TEST(StepArenaTest, FallsBackToHeap) {
+  StepArena arena;
+  void* step = StepArena::AllocateStep(16);
+  {
+    StepArenaScope scope(&arena);
+    EXPECT_FALSE(arena.Contains(step));
+    // Heap allocated steps are freed even while a scope is active.
+    StepArena::DeallocateStep(step);
+  }
+
+  {
+    StepArenaScope scope(nullptr);
+    step = StepArena::AllocateStep(16);
+    StepArena::DeallocateStep(step);
+  }
+  EXPECT_EQ(arena.SpaceUsed(), 0);
+}
+
+}  // namespace
+}  // namespace google::api::expr::runtime
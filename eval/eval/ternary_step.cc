@@ -81,6 +81,13 @@ class ExhaustiveDirectTernaryStep : public DirectExpressionStep {
     return absl::OkStatus();
   }
 
+  void AccumulateMemoryUsage(cel::ProgramMemoryUsage& usage) const override {
+    usage.steps += sizeof(*this);
+    condition_->AccumulateMemoryUsage(usage);
+    left_->AccumulateMemoryUsage(usage);
+    right_->AccumulateMemoryUsage(usage);
+  }
+
  private:
   std::unique_ptr<DirectExpressionStep> condition_;
   std::unique_ptr<DirectExpressionStep> left_;
@@ -125,6 +132,13 @@ class ShortcircuitingDirectTernaryStep : public DirectExpressionStep {
     return right_->Evaluate(frame, result, attribute);
   }
 
+  void AccumulateMemoryUsage(cel::ProgramMemoryUsage& usage) const override {
+    usage.steps += sizeof(*this);
+    condition_->AccumulateMemoryUsage(usage);
+    left_->AccumulateMemoryUsage(usage);
+    right_->AccumulateMemoryUsage(usage);
+  }
+
  private:
   std::unique_ptr<DirectExpressionStep> condition_;
   std::unique_ptr<DirectExpressionStep> left_;
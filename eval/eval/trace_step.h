@@ -63,6 +63,13 @@ class TraceStep : public DirectExpressionStep {
     return dependencies;
   };
 
+  void AccumulateMemoryUsage(cel::ProgramMemoryUsage& usage) const override {
+    usage.steps += sizeof(*this);
+    if (expression_ != nullptr) {
+      expression_->AccumulateMemoryUsage(usage);
+    }
+  }
+
  private:
   std::unique_ptr<DirectExpressionStep> expression_;
 };
@@ -29,6 +29,7 @@ cel::RuntimeOptions ConvertToRuntimeOptions(const InterpreterOptions& options) {
                              options.enable_comprehension_list_append,
                              options.enable_regex,
                              options.regex_max_program_size,
+                             options.regex_cache,
                              options.enable_string_conversion,
                              options.enable_string_concat,
                              options.enable_list_concat,
@@ -40,7 +41,8 @@ cel::RuntimeOptions ConvertToRuntimeOptions(const InterpreterOptions& options) {
                              options.enable_lazy_bind_initialization,
                              options.max_recursion_depth,
                              options.enable_recursive_tracing,
-                             options.use_legacy_container_builders};
+                             options.use_legacy_container_builders,
+                             options.enable_local_reference_counting};
 }
 
 }  // namespace google::api::expr::runtime
@@ -17,6 +17,8 @@
 #ifndef THIRD_PARTY_CEL_CPP_EVAL_PUBLIC_CEL_OPTIONS_H_
 #define THIRD_PARTY_CEL_CPP_EVAL_PUBLIC_CEL_OPTIONS_H_
 
+#include <memory>
+
 #include "absl/base/attributes.h"
 #include "runtime/runtime_options.h"
 #include "google/protobuf/arena.h"
@@ -75,6 +77,12 @@ struct InterpreterOptions {
   // upper bound.
   int regex_max_program_size = 0;
 
+  // Optional cache of compiled RE2 programs used by the regex functions for
+  // patterns that are not constant at plan time (see runtime/regex_cache.h).
+  // The cache is thread-safe and may be shared between runtimes. If unset,
+  // non-constant patterns are compiled on every call.
+  std::shared_ptr<cel::RegexCache> regex_cache;
+
   // Enable string() overloads.
   bool enable_string_conversion = true;
 
@@ -192,6 +200,12 @@ struct InterpreterOptions {
   //
   // Default is true for the legacy options type.
   bool use_legacy_container_builders = true;
+
+  // Use thread-local reference counts for values created during an
+  // evaluation with a reference counting memory manager.
+  //
+  // Has no effect for the legacy API, which always evaluates with an arena.
+  bool enable_local_reference_counting = false;
 };
 // LINT.ThenChange(//depot/google3/runtime/runtime_options.h)
 
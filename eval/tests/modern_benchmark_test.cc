@@ -35,6 +35,7 @@
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/match.h"
+#include "absl/strings/string_view.h"
 #include "absl/types/optional.h"
 #include "common/allocator.h"
 #include "common/casting.h"
@@ -75,6 +76,7 @@ using ::cel::expr::Expr;
 using ::cel::expr::ParsedExpr;
 using ::cel::expr::SourceInfo;
 using ::google::api::expr::parser::Parse;
+using ::google::api::expr::parser::ParseAst;
 using ::google::api::expr::runtime::RequestContext;
 using ::google::rpc::context::AttributeContext;
 
@@ -1224,6 +1226,39 @@ void BM_ComprehensionCpp(benchmark::State& state) {
 
 BENCHMARK(BM_ComprehensionCpp)->Range(1, 1 << 20);
 
+constexpr absl::string_view kParseAndPlanExpr =
+    "has(request.auth.claims.group) && request.auth.claims.group == 'admin' "
+    "|| [1, 2, 3].exists(x, x > 2) && {'a': 1}.all(k, k.startsWith('a'))";
+
+// Parses and plans through the `ParsedExpr` proto, converting it back to the
+// native AST in the adapter.
+void BM_ParseAndPlan_Proto(benchmark::State& state) {
+  auto runtime = StandardRuntimeOrDie(GetOptions());
+
+  for (auto _ : state) {
+    ASSERT_OK_AND_ASSIGN(ParsedExpr parsed_expr, Parse(kParseAndPlanExpr));
+    ASSERT_OK_AND_ASSIGN(auto program, ProtobufRuntimeAdapter::CreateProgram(
+                                           *runtime, parsed_expr));
+    benchmark::DoNotOptimize(program);
+  }
+}
+
+BENCHMARK(BM_ParseAndPlan_Proto);
+
+// Parses directly into the native AST and plans it without a proto round
+// trip.
+void BM_ParseAndPlan_Ast(benchmark::State& state) {
+  auto runtime = StandardRuntimeOrDie(GetOptions());
+
+  for (auto _ : state) {
+    ASSERT_OK_AND_ASSIGN(auto ast, ParseAst(kParseAndPlanExpr));
+    ASSERT_OK_AND_ASSIGN(auto program, runtime->CreateProgram(std::move(ast)));
+    benchmark::DoNotOptimize(program);
+  }
+}
+
+BENCHMARK(BM_ParseAndPlan_Ast);
+
 }  // namespace
 
 }  // namespace cel
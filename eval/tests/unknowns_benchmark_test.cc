@@ -0,0 +1,138 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//       https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Benchmarks for unknown processing: evaluating expressions where most
+// attributes are unknown and the unknown sets are merged at every operator.
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cel/expr/syntax.pb.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/string_view.h"
+#include "eval/public/activation.h"
+#include "eval/public/builtin_func_registrar.h"
+#include "eval/public/cel_attribute.h"
+#include "eval/public/cel_expr_builder_factory.h"
+#include "eval/public/cel_expression.h"
+#include "eval/public/cel_options.h"
+#include "eval/public/cel_value.h"
+#include "internal/benchmark.h"
+#include "internal/testing.h"
+#include "parser/parser.h"
+#include "google/protobuf/arena.h"
+
+namespace google::api::expr::runtime {
+namespace {
+
+using ::cel::expr::ParsedExpr;
+using ::google::api::expr::parser::Parse;
+
+// Returns `var0 > 0 <op> var1 > 0 <op> ... var{n-1} > 0`.
+std::string WideLogicExpr(int n, absl::string_view op) {
+  std::vector<std::string> terms;
+  terms.reserve(n);
+  for (int i = 0; i < n; ++i) {
+    terms.push_back(absl::StrCat("var", i, " > 0"));
+  }
+  return absl::StrJoin(terms, absl::StrCat(" ", op, " "));
+}
+
+// Evaluates a wide logic expression where every variable is unknown, so each
+// operator merges the unknown sets of its operands.
+void BenchmarkWideUnknownLogic(benchmark::State& state, absl::string_view op,
+                               bool enable_recursive_planning) {
+  int n = state.range(0);
+  InterpreterOptions options;
+  options.unknown_processing = UnknownProcessingOptions::kAttributeOnly;
+  if (enable_recursive_planning) {
+    options.max_recursion_depth = -1;
+  }
+  auto builder = CreateCelExpressionBuilder(options);
+  ASSERT_OK(RegisterBuiltinFunctions(builder->GetRegistry(), options));
+
+  ASSERT_OK_AND_ASSIGN(ParsedExpr parsed_expr, Parse(WideLogicExpr(n, op)));
+  ASSERT_OK_AND_ASSIGN(auto cel_expr,
+                       builder->CreateExpression(&parsed_expr.expr(),
+                                                 &parsed_expr.source_info()));
+
+  Activation activation;
+  std::vector<CelAttributePattern> patterns;
+  patterns.reserve(n);
+  for (int i = 0; i < n; ++i) {
+    patterns.push_back(CelAttributePattern(absl::StrCat("var", i), {}));
+  }
+  activation.set_unknown_attribute_patterns(std::move(patterns));
+
+  for (auto _ : state) {
+    google::protobuf::Arena arena;
+    ASSERT_OK_AND_ASSIGN(CelValue result,
+                         cel_expr->Evaluate(activation, &arena));
+    ASSERT_TRUE(result.IsUnknownSet());
+    ASSERT_EQ(result.UnknownSetOrDie()->unknown_attributes().size(), n);
+  }
+}
+
+void BM_WideUnknownOr(benchmark::State& state) {
+  BenchmarkWideUnknownLogic(state, "||", /*enable_recursive_planning=*/false);
+}
+BENCHMARK(BM_WideUnknownOr)->Range(1, 1 << 8);
+
+void BM_WideUnknownAnd(benchmark::State& state) {
+  BenchmarkWideUnknownLogic(state, "&&", /*enable_recursive_planning=*/false);
+}
+BENCHMARK(BM_WideUnknownAnd)->Range(1, 1 << 8);
+
+void BM_WideUnknownOrRecursive(benchmark::State& state) {
+  BenchmarkWideUnknownLogic(state, "||", /*enable_recursive_planning=*/true);
+}
+BENCHMARK(BM_WideUnknownOrRecursive)->Range(1, 1 << 8);
+
+// Evaluates `var > 0 || var > 1 || ...` with a single unknown variable, so
+// every merge sees the same attribute and can share the existing set.
+void BM_RepeatedUnknownOr(benchmark::State& state) {
+  int n = state.range(0);
+  InterpreterOptions options;
+  options.unknown_processing = UnknownProcessingOptions::kAttributeOnly;
+  auto builder = CreateCelExpressionBuilder(options);
+  ASSERT_OK(RegisterBuiltinFunctions(builder->GetRegistry(), options));
+
+  std::vector<std::string> terms;
+  terms.reserve(n);
+  for (int i = 0; i < n; ++i) {
+    terms.push_back(absl::StrCat("var > ", i));
+  }
+  ASSERT_OK_AND_ASSIGN(ParsedExpr parsed_expr,
+                       Parse(absl::StrJoin(terms, " || ")));
+  ASSERT_OK_AND_ASSIGN(auto cel_expr,
+                       builder->CreateExpression(&parsed_expr.expr(),
+                                                 &parsed_expr.source_info()));
+
+  Activation activation;
+  activation.set_unknown_attribute_patterns({CelAttributePattern("var", {})});
+
+  for (auto _ : state) {
+    google::protobuf::Arena arena;
+    ASSERT_OK_AND_ASSIGN(CelValue result,
+                         cel_expr->Evaluate(activation, &arena));
+    ASSERT_TRUE(result.IsUnknownSet());
+    ASSERT_EQ(result.UnknownSetOrDie()->unknown_attributes().size(), 1);
+  }
+}
+BENCHMARK(BM_RepeatedUnknownOr)->Range(1, 1 << 8);
+
+}  // namespace
+}  // namespace google::api::expr::runtime
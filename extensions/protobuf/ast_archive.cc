@@ -0,0 +1,242 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "extensions/protobuf/ast_archive.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cel/expr/checked.pb.h"
+#include "cel/expr/syntax.pb.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "base/ast.h"
+#include "extensions/protobuf/ast_converters.h"
+#include "internal/status_macros.h"
+#include "runtime/runtime.h"
+
+namespace cel::extensions {
+namespace {
+
+constexpr absl::string_view kMagic = "CELA";
+constexpr uint32_t kVersion = 1;
+
+enum class EntryKind : uint8_t {
+  kParsed = 0,
+  kChecked = 1,
+};
+
+void AppendU32(std::string& out, uint32_t value) {
+  for (int i = 0; i < 4; ++i) {
+    out.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+  }
+}
+
+absl::Status AppendBytes(std::string& out, absl::string_view bytes) {
+  if (bytes.size() > std::numeric_limits<uint32_t>::max()) {
+    return absl::InvalidArgumentError(
+        "AST archive entry exceeds 4GiB limit");
+  }
+  AppendU32(out, static_cast<uint32_t>(bytes.size()));
+  out.append(bytes);
+  return absl::OkStatus();
+}
+
+// Consumes the archive from the front, without copying.
+class ArchiveReader final {
+ public:
+  explicit ArchiveReader(absl::string_view data) : data_(data) {}
+
+  bool ReadU8(uint8_t& value) {
+    if (data_.empty()) {
+      return false;
+    }
+    value = static_cast<uint8_t>(data_.front());
+    data_.remove_prefix(1);
+    return true;
+  }
+
+  bool ReadU32(uint32_t& value) {
+    if (data_.size() < 4) {
+      return false;
+    }
+    value = 0;
+    for (int i = 0; i < 4; ++i) {
+      value |= static_cast<uint32_t>(static_cast<uint8_t>(data_[i])) << (8 * i);
+    }
+    data_.remove_prefix(4);
+    return true;
+  }
+
+  bool ReadBytes(size_t size, absl::string_view& bytes) {
+    if (data_.size() < size) {
+      return false;
+    }
+    bytes = data_.substr(0, size);
+    data_.remove_prefix(size);
+    return true;
+  }
+
+  bool ReadSizedBytes(absl::string_view& bytes) {
+    uint32_t size;
+    return ReadU32(size) && ReadBytes(size, bytes);
+  }
+
+  bool AtEnd() const { return data_.empty(); }
+
+ private:
+  absl::string_view data_;
+};
+
+absl::Status Truncated() {
+  return absl::InvalidArgumentError("AST archive is truncated");
+}
+
+}  // namespace
+
+absl::Status AstArchiveBuilder::Add(absl::string_view name,
+                                        const Ast& ast) {
+  if (index_.contains(name)) {
+    return absl::AlreadyExistsError(
+        absl::StrCat("AST archive already contains '", name, "'"));
+  }
+  Entry entry{std::string(name), ast.IsChecked(), std::string()};
+  bool serialized;
+  if (entry.checked) {
+    CEL_ASSIGN_OR_RETURN(auto checked_expr, CreateCheckedExprFromAst(ast));
+    serialized = checked_expr.SerializeToString(&entry.payload);
+  } else {
+    CEL_ASSIGN_OR_RETURN(auto parsed_expr, CreateParsedExprFromAst(ast));
+    serialized = parsed_expr.SerializeToString(&entry.payload);
+  }
+  if (!serialized) {
+    return absl::InternalError(
+        absl::StrCat("failed to serialize '", name, "'"));
+  }
+  index_.insert({entry.name, entries_.size()});
+  entries_.push_back(std::move(entry));
+  return absl::OkStatus();
+}
+
+absl::StatusOr<std::string> AstArchiveBuilder::Build() const {
+  std::string out(kMagic);
+  AppendU32(out, kVersion);
+  AppendU32(out, static_cast<uint32_t>(entries_.size()));
+  for (const auto& entry : entries_) {
+    out.push_back(static_cast<char>(entry.checked ? EntryKind::kChecked
+                                                  : EntryKind::kParsed));
+    CEL_RETURN_IF_ERROR(AppendBytes(out, entry.name));
+    CEL_RETURN_IF_ERROR(AppendBytes(out, entry.payload));
+  }
+  return out;
+}
+
+absl::StatusOr<AstArchive> AstArchive::Open(absl::string_view data) {
+  ArchiveReader reader(data);
+  absl::string_view magic;
+  if (!reader.ReadBytes(kMagic.size(), magic) || magic != kMagic) {
+    return absl::InvalidArgumentError("not an AST archive");
+  }
+  uint32_t version;
+  uint32_t count;
+  if (!reader.ReadU32(version) || !reader.ReadU32(count)) {
+    return Truncated();
+  }
+  if (version != kVersion) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("unsupported AST archive version ", version));
+  }
+
+  AstArchive archive;
+  for (uint32_t i = 0; i < count; ++i) {
+    uint8_t kind;
+    absl::string_view name;
+    Entry entry;
+    if (!reader.ReadU8(kind) || !reader.ReadSizedBytes(name) ||
+        !reader.ReadSizedBytes(entry.payload)) {
+      return Truncated();
+    }
+    if (kind != static_cast<uint8_t>(EntryKind::kParsed) &&
+        kind != static_cast<uint8_t>(EntryKind::kChecked)) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("unknown AST archive entry kind ",
+                       static_cast<int>(kind), " for '", name, "'"));
+    }
+    entry.order = i;
+    entry.checked = kind == static_cast<uint8_t>(EntryKind::kChecked);
+    if (!archive.entries_.insert({name, entry}).second) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("AST archive contains '", name, "' twice"));
+    }
+  }
+  if (!reader.AtEnd()) {
+    return absl::InvalidArgumentError(
+        "AST archive has trailing bytes after the last entry");
+  }
+  return archive;
+}
+
+std::vector<absl::string_view> AstArchive::names() const {
+  std::vector<absl::string_view> names(entries_.size());
+  for (const auto& [name, entry] : entries_) {
+    names[entry.order] = name;
+  }
+  return names;
+}
+
+absl::StatusOr<std::unique_ptr<Ast>> AstArchive::LoadAst(
+    absl::string_view name) const {
+  auto it = entries_.find(name);
+  if (it == entries_.end()) {
+    return absl::NotFoundError(
+        absl::StrCat("AST archive does not contain '", name, "'"));
+  }
+  const Entry& entry = it->second;
+  if (entry.payload.size() >
+      static_cast<size_t>(std::numeric_limits<int>::max())) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("AST archive entry '", name, "' is too large"));
+  }
+  const int size = static_cast<int>(entry.payload.size());
+  if (entry.checked) {
+    cel::expr::CheckedExpr checked_expr;
+    if (!checked_expr.ParseFromArray(entry.payload.data(), size)) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("malformed AST archive entry '", name, "'"));
+    }
+    return CreateAstFromCheckedExpr(checked_expr);
+  }
+  cel::expr::ParsedExpr parsed_expr;
+  if (!parsed_expr.ParseFromArray(entry.payload.data(), size)) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("malformed AST archive entry '", name, "'"));
+  }
+  return CreateAstFromParsedExpr(parsed_expr);
+}
+
+absl::StatusOr<std::unique_ptr<TraceableProgram>> AstArchive::CreateProgram(
+    const Runtime& runtime, absl::string_view name,
+    const Runtime::CreateProgramOptions& options) const {
+  CEL_ASSIGN_OR_RETURN(std::unique_ptr<Ast> ast, LoadAst(name));
+  return runtime.CreateTraceableProgram(std::move(ast), options);
+}
+
+}  // namespace cel::extensions
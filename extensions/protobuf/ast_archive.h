@@ -0,0 +1,134 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// A binary container for the ASTs of CEL expressions, so that a process can
+// create its programs at startup without parsing and type checking them again.
+//
+// Each entry holds the AST of one expression, checked or parsed, serialized as
+// a `cel.expr.CheckedExpr` or `cel.expr.ParsedExpr` message. These are the
+// stable interchange format of CEL: functions are referenced by overload id
+// and types by name, so the archive is independent of the process which wrote
+// it and every reference is bound to the live function and type registries of
+// the `Runtime` when the program is created.
+//
+// The archive holds no planner output. Planned steps point into the function
+// registry and type provider of one runtime, so every program created from an
+// entry is planned again, the same as one created from a freshly checked AST.
+// Loading an entry skips parsing and checking only. BM_CreateProgram in
+// ast_archive_test.cc measures the remaining cost of decoding and planning,
+// and BM_CompileAndCreateProgram the cost this replaces.
+//
+// Layout, with all integers little endian:
+//
+//   "CELA" | u32 version | u32 entry count
+//   entry count times: u8 kind | u32 name size | name | u32 size | payload
+//
+// Example:
+//
+//   AstArchiveBuilder builder;
+//   CEL_RETURN_IF_ERROR(builder.Add("allow_admin", *checked_ast));
+//   CEL_ASSIGN_OR_RETURN(std::string bytes, builder.Build());
+//   ...
+//   // `mapped` views a memory mapped file and must outlive the archive.
+//   CEL_ASSIGN_OR_RETURN(AstArchive archive, AstArchive::Open(mapped));
+//   CEL_ASSIGN_OR_RETURN(auto program,
+//                        archive.CreateProgram(*runtime, "allow_admin"));
+
+#ifndef THIRD_PARTY_CEL_CPP_EXTENSIONS_PROTOBUF_AST_ARCHIVE_H_
+#define THIRD_PARTY_CEL_CPP_EXTENSIONS_PROTOBUF_AST_ARCHIVE_H_
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "base/ast.h"
+#include "runtime/runtime.h"
+
+namespace cel::extensions {
+
+// Accumulates ASTs and serializes them into an archive.
+class AstArchiveBuilder final {
+ public:
+  // Adds `ast` under `name`, which must be unique within the archive.
+  absl::Status Add(absl::string_view name, const Ast& ast);
+
+  // Returns the serialized archive.
+  absl::StatusOr<std::string> Build() const;
+
+ private:
+  struct Entry {
+    std::string name;
+    bool checked;
+    std::string payload;
+  };
+
+  std::vector<Entry> entries_;
+  absl::flat_hash_map<std::string, size_t> index_;
+};
+
+// Read only view of a serialized archive.
+//
+// Opening an archive only indexes its entries: nothing is copied and an
+// entry's payload is decoded when its program is created, so opening a large
+// memory mapped archive is cheap and entries which are never used cost
+// nothing. Instances are thread-safe.
+class AstArchive final {
+ public:
+  // Indexes the archive in `data`, which must outlive the returned instance.
+  static absl::StatusOr<AstArchive> Open(absl::string_view data);
+
+  AstArchive(AstArchive&&) = default;
+  AstArchive& operator=(AstArchive&&) = default;
+
+  size_t size() const { return entries_.size(); }
+
+  bool Contains(absl::string_view name) const {
+    return entries_.contains(name);
+  }
+
+  // Returns the names of the entries, in the order they were added.
+  std::vector<absl::string_view> names() const;
+
+  // Decodes the AST of the entry `name`.
+  absl::StatusOr<std::unique_ptr<Ast>> LoadAst(absl::string_view name) const;
+
+  // Decodes the entry `name` and plans it with `runtime`, on every call, so
+  // callers creating the same program repeatedly should keep it. Function
+  // overloads and types are resolved against `runtime` as for any other AST,
+  // so an entry referencing an overload `runtime` does not provide is rejected
+  // unless `RuntimeOptions::fail_on_warnings` is disabled.
+  absl::StatusOr<std::unique_ptr<TraceableProgram>> CreateProgram(
+      const Runtime& runtime, absl::string_view name,
+      const Runtime::CreateProgramOptions& options = {}) const;
+
+ private:
+  struct Entry {
+    size_t order;
+    bool checked;
+    absl::string_view payload;
+  };
+
+  AstArchive() = default;
+
+  absl::flat_hash_map<absl::string_view, Entry> entries_;
+};
+
+}  // namespace cel::extensions
+
+#endif  // THIRD_PARTY_CEL_CPP_EXTENSIONS_PROTOBUF_AST_ARCHIVE_H_
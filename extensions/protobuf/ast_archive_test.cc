@@ -0,0 +1,284 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "extensions/protobuf/ast_archive.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/log/absl_check.h"
+#include "absl/status/status.h"
+#include "absl/status/status_matchers.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "base/ast.h"
+#include "checker/standard_library.h"
+#include "checker/type_checker.h"
+#include "checker/type_checker_builder.h"
+#include "checker/validation_result.h"
+#include "common/decl.h"
+#include "common/memory.h"
+#include "common/type.h"
+#include "common/value.h"
+#include "common/value_testing.h"
+#include "internal/benchmark.h"
+#include "internal/status_macros.h"
+#include "internal/testing.h"
+#include "internal/testing_descriptor_pool.h"
+#include "parser/parser.h"
+#include "runtime/activation.h"
+#include "runtime/managed_value_factory.h"
+#include "runtime/runtime.h"
+#include "runtime/runtime_options.h"
+#include "runtime/standard_runtime_builder_factory.h"
+
+namespace cel::extensions {
+namespace {
+
+using ::absl_testing::IsOk;
+using ::absl_testing::IsOkAndHolds;
+using ::absl_testing::StatusIs;
+using ::cel::internal::GetSharedTestingDescriptorPool;
+using ::cel::internal::GetTestingDescriptorPool;
+using ::cel::test::BoolValueIs;
+using ::cel::test::IntValueIs;
+using ::google::api::expr::parser::ParseAst;
+using ::testing::ElementsAre;
+using ::testing::HasSubstr;
+using ::testing::Not;
+
+absl::StatusOr<std::unique_ptr<TypeChecker>> MakeTypeChecker() {
+  CEL_ASSIGN_OR_RETURN(
+      auto builder, CreateTypeCheckerBuilder(GetSharedTestingDescriptorPool()));
+  CEL_RETURN_IF_ERROR(builder.AddLibrary(StandardLibrary()));
+  CEL_RETURN_IF_ERROR(builder.AddVariable(MakeVariableDecl("x", IntType())));
+  CEL_ASSIGN_OR_RETURN(
+      auto twice,
+      MakeFunctionDecl("twice",
+                       MakeOverloadDecl("twice_int", IntType(), IntType())));
+  CEL_RETURN_IF_ERROR(builder.AddFunction(twice));
+  return std::move(builder).Build();
+}
+
+absl::StatusOr<std::unique_ptr<Ast>> Check(const TypeChecker& checker,
+                                           absl::string_view expr) {
+  CEL_ASSIGN_OR_RETURN(auto ast, ParseAst(expr));
+  CEL_ASSIGN_OR_RETURN(ValidationResult result, checker.Check(std::move(ast)));
+  return result.ReleaseAst();
+}
+
+absl::StatusOr<std::unique_ptr<Ast>> ParseAndCheck(absl::string_view expr) {
+  CEL_ASSIGN_OR_RETURN(auto checker, MakeTypeChecker());
+  return Check(*checker, expr);
+}
+
+class AstArchiveTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_OK_AND_ASSIGN(auto builder,
+                         CreateStandardRuntimeBuilder(
+                             GetTestingDescriptorPool(), RuntimeOptions()));
+    ASSERT_OK_AND_ASSIGN(runtime_, std::move(builder).Build());
+  }
+
+  absl::StatusOr<Value> Evaluate(const Program& program, int64_t x) {
+    ManagedValueFactory value_factory(runtime_->GetTypeProvider(),
+                                      MemoryManagerRef::ReferenceCounting());
+    Activation activation;
+    activation.InsertOrAssignValue("x", IntValue(x));
+    return program.Evaluate(activation, value_factory.get());
+  }
+
+  std::unique_ptr<const Runtime> runtime_;
+};
+
+TEST_F(AstArchiveTest, RoundTrip) {
+  ASSERT_OK_AND_ASSIGN(auto checked, ParseAndCheck("x * 2 + 1"));
+  ASSERT_OK_AND_ASSIGN(auto parsed, ParseAst("[1, 2, 3].exists(y, y == x)"));
+  AstArchiveBuilder builder;
+  ASSERT_THAT(builder.Add("checked", *checked), IsOk());
+  ASSERT_THAT(builder.Add("parsed", *parsed), IsOk());
+  ASSERT_OK_AND_ASSIGN(std::string bytes, builder.Build());
+
+  ASSERT_OK_AND_ASSIGN(AstArchive archive, AstArchive::Open(bytes));
+  EXPECT_EQ(archive.size(), 2);
+  EXPECT_TRUE(archive.Contains("checked"));
+  EXPECT_FALSE(archive.Contains("missing"));
+  EXPECT_THAT(archive.names(), ElementsAre("checked", "parsed"));
+
+  ASSERT_OK_AND_ASSIGN(auto checked_program,
+                       archive.CreateProgram(*runtime_, "checked"));
+  EXPECT_THAT(Evaluate(*checked_program, 20), IsOkAndHolds(IntValueIs(41)));
+  ASSERT_OK_AND_ASSIGN(auto parsed_program,
+                       archive.CreateProgram(*runtime_, "parsed"));
+  EXPECT_THAT(Evaluate(*parsed_program, 2), IsOkAndHolds(BoolValueIs(true)));
+  EXPECT_THAT(Evaluate(*parsed_program, 4), IsOkAndHolds(BoolValueIs(false)));
+}
+
+TEST_F(AstArchiveTest, PreservesCheckedState) {
+  ASSERT_OK_AND_ASSIGN(auto checked, ParseAndCheck("x + 1"));
+  AstArchiveBuilder builder;
+  ASSERT_THAT(builder.Add("checked", *checked), IsOk());
+  ASSERT_OK_AND_ASSIGN(std::string bytes, builder.Build());
+  ASSERT_OK_AND_ASSIGN(AstArchive archive, AstArchive::Open(bytes));
+
+  ASSERT_OK_AND_ASSIGN(auto ast, archive.LoadAst("checked"));
+  EXPECT_TRUE(ast->IsChecked());
+}
+
+TEST_F(AstArchiveTest, OverloadsResolvedAgainstRuntime) {
+  ASSERT_OK_AND_ASSIGN(auto checked, ParseAndCheck("twice(x)"));
+  AstArchiveBuilder builder;
+  ASSERT_THAT(builder.Add("twice", *checked), IsOk());
+  ASSERT_OK_AND_ASSIGN(std::string bytes, builder.Build());
+  ASSERT_OK_AND_ASSIGN(AstArchive archive, AstArchive::Open(bytes));
+
+  // The standard runtime does not provide `twice_int`.
+  EXPECT_THAT(archive.CreateProgram(*runtime_, "twice"), Not(IsOk()));
+}
+
+TEST_F(AstArchiveTest, DuplicateName) {
+  ASSERT_OK_AND_ASSIGN(auto ast, ParseAst("1"));
+  AstArchiveBuilder builder;
+  ASSERT_THAT(builder.Add("one", *ast), IsOk());
+  EXPECT_THAT(builder.Add("one", *ast),
+              StatusIs(absl::StatusCode::kAlreadyExists));
+}
+
+TEST_F(AstArchiveTest, MissingEntry) {
+  AstArchiveBuilder builder;
+  ASSERT_OK_AND_ASSIGN(std::string bytes, builder.Build());
+  ASSERT_OK_AND_ASSIGN(AstArchive archive, AstArchive::Open(bytes));
+
+  EXPECT_EQ(archive.size(), 0);
+  EXPECT_THAT(archive.CreateProgram(*runtime_, "missing"),
+              StatusIs(absl::StatusCode::kNotFound));
+}
+
+TEST_F(AstArchiveTest, RejectsMalformedArchives) {
+  ASSERT_OK_AND_ASSIGN(auto ast, ParseAst("x + 1"));
+  AstArchiveBuilder builder;
+  ASSERT_THAT(builder.Add("entry", *ast), IsOk());
+  ASSERT_OK_AND_ASSIGN(std::string bytes, builder.Build());
+
+  EXPECT_THAT(AstArchive::Open(""),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("not an AST archive")));
+  EXPECT_THAT(AstArchive::Open("CELB00000000"),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("not an AST archive")));
+
+  std::string future_version = bytes;
+  future_version[4] = 2;
+  EXPECT_THAT(AstArchive::Open(future_version),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("unsupported AST archive version 2")));
+
+  absl::string_view truncated = bytes;
+  truncated.remove_suffix(1);
+  EXPECT_THAT(
+      AstArchive::Open(truncated),
+      StatusIs(absl::StatusCode::kInvalidArgument, HasSubstr("truncated")));
+  EXPECT_THAT(AstArchive::Open(bytes + "x"),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("trailing bytes")));
+}
+
+TEST_F(AstArchiveTest, RejectsMalformedPayload) {
+  ASSERT_OK_AND_ASSIGN(auto ast, ParseAst("1"));
+  AstArchiveBuilder builder;
+  ASSERT_THAT(builder.Add("entry", *ast), IsOk());
+  ASSERT_OK_AND_ASSIGN(std::string bytes, builder.Build());
+  // Replace the payload with an invalid wire format tag of the same size.
+  const size_t payload_size = bytes.size() - (12 + 1 + 4 + 5 + 4);
+  for (size_t i = bytes.size() - payload_size; i < bytes.size(); ++i) {
+    bytes[i] = '\xff';
+  }
+  ASSERT_OK_AND_ASSIGN(AstArchive archive, AstArchive::Open(bytes));
+
+  EXPECT_THAT(archive.LoadAst("entry"),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("malformed AST archive entry 'entry'")));
+}
+
+// Large enough that planning is not dominated by fixed per-program costs.
+constexpr absl::string_view kBenchmarkExpression =
+    "x > 0 && [1, 2, 3].exists(y, y == x) && x * 2 + 1 < 100 && "
+    "(x % 2 == 0 ? 'even' : 'odd').size() == 4";
+
+std::unique_ptr<const Runtime> MakeBenchmarkRuntime() {
+  auto builder = CreateStandardRuntimeBuilder(GetTestingDescriptorPool(),
+                                              RuntimeOptions());
+  ABSL_CHECK_OK(builder.status());
+  auto runtime = std::move(builder).value().Build();
+  ABSL_CHECK_OK(runtime.status());
+  return std::move(runtime).value();
+}
+
+std::string MakeBenchmarkArchive() {
+  auto ast = ParseAndCheck(kBenchmarkExpression);
+  ABSL_CHECK_OK(ast.status());
+  AstArchiveBuilder builder;
+  ABSL_CHECK_OK(builder.Add("entry", **ast));
+  auto bytes = builder.Build();
+  ABSL_CHECK_OK(bytes.status());
+  return std::move(bytes).value();
+}
+
+// Decoding an entry only.
+void BM_LoadAst(benchmark::State& state) {
+  const std::string bytes = MakeBenchmarkArchive();
+  auto archive = AstArchive::Open(bytes);
+  ABSL_CHECK_OK(archive.status());
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(archive->LoadAst("entry"));
+  }
+}
+
+BENCHMARK(BM_LoadAst);
+
+// Decoding and planning an entry, the cost of creating a program from the
+// archive.
+void BM_CreateProgram(benchmark::State& state) {
+  auto runtime = MakeBenchmarkRuntime();
+  const std::string bytes = MakeBenchmarkArchive();
+  auto archive = AstArchive::Open(bytes);
+  ABSL_CHECK_OK(archive.status());
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(archive->CreateProgram(*runtime, "entry"));
+  }
+}
+
+BENCHMARK(BM_CreateProgram);
+
+// Parsing, checking and planning the same expression, the cost the archive
+// replaces.
+void BM_CompileAndCreateProgram(benchmark::State& state) {
+  auto runtime = MakeBenchmarkRuntime();
+  auto checker = MakeTypeChecker();
+  ABSL_CHECK_OK(checker.status());
+  for (auto _ : state) {
+    auto ast = Check(**checker, kBenchmarkExpression);
+    ABSL_CHECK_OK(ast.status());
+    benchmark::DoNotOptimize(runtime->CreateTraceableProgram(*std::move(ast)));
+  }
+}
+
+BENCHMARK(BM_CompileAndCreateProgram);
+
+}  // namespace
+}  // namespace cel::extensions
@@ -35,9 +35,19 @@ namespace cel::extensions {
 absl::StatusOr<absl::Nullable<StructValueBuilderPtr>>
 ProtoTypeReflector::NewStructValueBuilder(ValueFactory& value_factory,
                                           const StructType& type) const {
-  auto status_or_builder = common_internal::NewStructValueBuilder(
-      value_factory.GetMemoryManager().arena(), descriptor_pool(),
-      message_factory(), type.name());
+  absl::StatusOr<absl::Nonnull<StructValueBuilderPtr>> status_or_builder;
+  if (type.IsMessage() &&
+      type.GetMessage()->file()->pool() == descriptor_pool()) {
+    // The type was resolved against our descriptor pool, for example while
+    // planning, so there is no need to look it up again.
+    status_or_builder = common_internal::NewStructValueBuilder(
+        value_factory.GetMemoryManager().arena(), descriptor_pool(),
+        message_factory(), &*type.GetMessage());
+  } else {
+    status_or_builder = common_internal::NewStructValueBuilder(
+        value_factory.GetMemoryManager().arena(), descriptor_pool(),
+        message_factory(), type.name());
+  }
   if (!status_or_builder.ok() && absl::IsNotFound(status_or_builder.status())) {
     return nullptr;
   }
@@ -20,12 +20,14 @@
 #include <vector>
 
 #include "absl/status/status.h"
+#include "absl/strings/string_view.h"
 #include "absl/types/span.h"
 #include "eval/public/cel_function.h"
 #include "eval/public/cel_options.h"
 #include "eval/public/cel_value.h"
 #include "eval/public/containers/container_backed_map_impl.h"
 #include "eval/public/portable_cel_function_adapter.h"
+#include "runtime/regex_cache.h"
 #include "re2/re2.h"
 
 namespace cel::extensions {
@@ -40,12 +42,23 @@ using ::google::api::expr::runtime::PortableBinaryFunctionAdapter;
 using ::google::api::expr::runtime::PortableFunctionAdapter;
 using ::google::protobuf::Arena;
 
+// Compiles `regex`, consulting `cache` first if one was configured.
+std::shared_ptr<const RE2> CompileRegex(RegexCache* cache,
+                                        absl::string_view regex) {
+  if (cache != nullptr) {
+    return cache->GetOrCompile(regex);
+  }
+  return std::make_shared<const RE2>(regex);
+}
+
 // Extract matched group values from the given target string and rewrite the
 // string
-CelValue ExtractString(Arena* arena, CelValue::StringHolder target,
+CelValue ExtractString(Arena* arena, RegexCache* cache,
+                       CelValue::StringHolder target,
                        CelValue::StringHolder regex,
                        CelValue::StringHolder rewrite) {
-  RE2 re2(regex.value());
+  std::shared_ptr<const RE2> program = CompileRegex(cache, regex.value());
+  const RE2& re2 = *program;
   if (!re2.ok()) {
     return CreateErrorValue(
         arena, absl::InvalidArgumentError("Given Regex is Invalid"));
@@ -63,9 +76,11 @@ CelValue ExtractString(Arena* arena, CelValue::StringHolder target,
 
 // Captures the first unnamed/named group value
 // NOTE: For capturing all the groups, use CaptureStringN instead
-CelValue CaptureString(Arena* arena, CelValue::StringHolder target,
+CelValue CaptureString(Arena* arena, RegexCache* cache,
+                       CelValue::StringHolder target,
                        CelValue::StringHolder regex) {
-  RE2 re2(regex.value());
+  std::shared_ptr<const RE2> program = CompileRegex(cache, regex.value());
+  const RE2& re2 = *program;
   if (!re2.ok()) {
     return CreateErrorValue(
         arena, absl::InvalidArgumentError("Given Regex is Invalid"));
@@ -87,9 +102,11 @@ CelValue CaptureString(Arena* arena, CelValue::StringHolder target,
 // value> pairs as follows:
 //   a. For a named group - <named_group_name, captured_string>
 //   b. For an unnamed group - <group_index, captured_string>
-CelValue CaptureStringN(Arena* arena, CelValue::StringHolder target,
+CelValue CaptureStringN(Arena* arena, RegexCache* cache,
+                        CelValue::StringHolder target,
                         CelValue::StringHolder regex) {
-  RE2 re2(regex.value());
+  std::shared_ptr<const RE2> program = CompileRegex(cache, regex.value());
+  const RE2& re2 = *program;
   if (!re2.ok()) {
     return CreateErrorValue(
         arena, absl::InvalidArgumentError("Given Regex is Invalid"));
@@ -136,17 +153,19 @@ CelValue CaptureStringN(Arena* arena, CelValue::StringHolder target,
   return CelValue::CreateMap(cel_map);
 }
 
-absl::Status RegisterRegexFunctions(CelFunctionRegistry* registry) {
+absl::Status RegisterRegexFunctions(CelFunctionRegistry* registry,
+                                    std::shared_ptr<RegexCache> cache) {
   // Register Regex Extract Function
   CEL_RETURN_IF_ERROR(
       (PortableFunctionAdapter<CelValue, CelValue::StringHolder,
                                CelValue::StringHolder, CelValue::StringHolder>::
            CreateAndRegister(
                kRegexExtract, /*receiver_type=*/false,
-               [](Arena* arena, CelValue::StringHolder target,
-                  CelValue::StringHolder regex,
-                  CelValue::StringHolder rewrite) -> CelValue {
-                 return ExtractString(arena, target, regex, rewrite);
+               [cache](Arena* arena, CelValue::StringHolder target,
+                       CelValue::StringHolder regex,
+                       CelValue::StringHolder rewrite) -> CelValue {
+                 return ExtractString(arena, cache.get(), target, regex,
+                                      rewrite);
                },
                registry)));
 
@@ -155,9 +174,9 @@ absl::Status RegisterRegexFunctions(CelFunctionRegistry* registry) {
       PortableBinaryFunctionAdapter<CelValue, CelValue::StringHolder,
                                     CelValue::StringHolder>::
           Create(kRegexCapture, /*receiver_style=*/false,
-                 [](Arena* arena, CelValue::StringHolder target,
-                    CelValue::StringHolder regex) -> CelValue {
-                   return CaptureString(arena, target, regex);
+                 [cache](Arena* arena, CelValue::StringHolder target,
+                         CelValue::StringHolder regex) -> CelValue {
+                   return CaptureString(arena, cache.get(), target, regex);
                  })));
 
   // Register Regex CaptureN Function
@@ -165,9 +184,9 @@ absl::Status RegisterRegexFunctions(CelFunctionRegistry* registry) {
       PortableBinaryFunctionAdapter<CelValue, CelValue::StringHolder,
                                     CelValue::StringHolder>::
           Create(kRegexCaptureN, /*receiver_style=*/false,
-                 [](Arena* arena, CelValue::StringHolder target,
-                    CelValue::StringHolder regex) -> CelValue {
-                   return CaptureStringN(arena, target, regex);
+                 [cache](Arena* arena, CelValue::StringHolder target,
+                         CelValue::StringHolder regex) -> CelValue {
+                   return CaptureStringN(arena, cache.get(), target, regex);
                  }));
 }
 
@@ -176,7 +195,7 @@ absl::Status RegisterRegexFunctions(CelFunctionRegistry* registry) {
 absl::Status RegisterRegexFunctions(CelFunctionRegistry* registry,
                                     const InterpreterOptions& options) {
   if (options.enable_regex) {
-    CEL_RETURN_IF_ERROR(RegisterRegexFunctions(registry));
+    CEL_RETURN_IF_ERROR(RegisterRegexFunctions(registry, options.regex_cache));
   }
   return absl::OkStatus();
 }
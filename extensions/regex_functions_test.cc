@@ -31,6 +31,7 @@
 #include "eval/public/testing/matchers.h"
 #include "internal/testing.h"
 #include "parser/parser.h"
+#include "runtime/regex_cache.h"
 
 namespace cel::extensions {
 
@@ -192,6 +193,18 @@ TEST_F(RegexFunctionsTest, CaptureStringWithUnnamedGroups) {
   EXPECT_THAT(status, IsOkAndHolds(IsCelString("o")));
 }
 
+// Capture String: Repeated patterns are served from the regex cache
+TEST_F(RegexFunctionsTest, CaptureStringUsesRegexCache) {
+  options_.regex_cache = RegexCache::Create(4);
+  auto status = TestCaptureStringInclusion(
+      (R"(re.capture('foo', 'fo(o)') + re.capture('boo', '.o(o)'))"
+       R"( + re.capture('zoo', '.o(o)'))"));
+  EXPECT_THAT(status, IsOkAndHolds(IsCelString("ooo")));
+  RegexCache::Stats stats = options_.regex_cache->stats();
+  EXPECT_EQ(stats.misses, 2);
+  EXPECT_EQ(stats.hits, 1);
+}
+
 std::vector<TestCase> createParams() {
   return {
       {// Extract String: Fails for mismatched regex
@@ -14,12 +14,15 @@
 
 #include "extensions/sets_functions.h"
 
+#include <cstddef>
+
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "base/function_adapter.h"
 #include "common/value.h"
 #include "common/value_manager.h"
 #include "internal/status_macros.h"
+#include "runtime/internal/value_hash.h"
 #include "runtime/function_registry.h"
 #include "runtime/runtime_options.h"
 
@@ -27,9 +30,32 @@ namespace cel::extensions {
 
 namespace {
 
-absl::StatusOr<Value> SetsContains(ValueManager& value_factory,
-                                   const ListValue& list,
-                                   const ListValue& sublist) {
+// Below this many element comparisons the linear scan through
+// `ListValue::Contains` is cheaper than building a transient hash set.
+constexpr size_t kHashSetThreshold = 64;
+
+bool ShouldUseHashSet(size_t list_size, size_t other_size) {
+  return list_size > 1 && other_size > 1 &&
+         list_size * other_size > kHashSetThreshold;
+}
+
+// Membership test against `set`, falling back to `list` for values that
+// cannot be hashed. Non-hashable values never compare equal to hashable
+// ones, but the fallback keeps the semantics identical to `Contains`.
+absl::StatusOr<bool> HashSetContains(ValueManager& value_factory,
+                                     const runtime_internal::ValueHashSet& set,
+                                     const ListValue& list,
+                                     const Value& element) {
+  if (runtime_internal::IsHashableValue(element)) {
+    return set.Contains(element);
+  }
+  CEL_ASSIGN_OR_RETURN(auto contains, list.Contains(value_factory, element));
+  return contains.IsTrue();
+}
+
+absl::StatusOr<Value> SetsContainsLinear(ValueManager& value_factory,
+                                         const ListValue& list,
+                                         const ListValue& sublist) {
   bool any_missing = false;
   CEL_RETURN_IF_ERROR(sublist.ForEach(
       value_factory,
@@ -47,9 +73,35 @@ absl::StatusOr<Value> SetsContains(ValueManager& value_factory,
   return value_factory.CreateBoolValue(!any_missing);
 }
 
-absl::StatusOr<Value> SetsIntersects(ValueManager& value_factory,
-                                     const ListValue& list,
-                                     const ListValue& sublist) {
+absl::StatusOr<Value> SetsContains(ValueManager& value_factory,
+                                   const ListValue& list,
+                                   const ListValue& sublist) {
+  CEL_ASSIGN_OR_RETURN(size_t list_size, list.Size());
+  CEL_ASSIGN_OR_RETURN(size_t sublist_size, sublist.Size());
+  if (!ShouldUseHashSet(list_size, sublist_size)) {
+    return SetsContainsLinear(value_factory, list, sublist);
+  }
+  CEL_ASSIGN_OR_RETURN(
+      auto set, runtime_internal::ValueHashSet::FromList(value_factory, list));
+  if (!set.has_value()) {
+    return SetsContainsLinear(value_factory, list, sublist);
+  }
+  bool any_missing = false;
+  CEL_RETURN_IF_ERROR(sublist.ForEach(
+      value_factory,
+      [&](const Value& sublist_element) -> absl::StatusOr<bool> {
+        CEL_ASSIGN_OR_RETURN(
+            bool contains,
+            HashSetContains(value_factory, *set, list, sublist_element));
+        any_missing = !contains;
+        return !any_missing;
+      }));
+  return value_factory.CreateBoolValue(!any_missing);
+}
+
+absl::StatusOr<Value> SetsIntersectsLinear(ValueManager& value_factory,
+                                           const ListValue& list,
+                                           const ListValue& sublist) {
   bool exists = false;
   CEL_RETURN_IF_ERROR(list.ForEach(
       value_factory,
@@ -66,6 +118,33 @@ absl::StatusOr<Value> SetsIntersects(ValueManager& value_factory,
   return value_factory.CreateBoolValue(exists);
 }
 
+absl::StatusOr<Value> SetsIntersects(ValueManager& value_factory,
+                                     const ListValue& list,
+                                     const ListValue& sublist) {
+  CEL_ASSIGN_OR_RETURN(size_t list_size, list.Size());
+  CEL_ASSIGN_OR_RETURN(size_t sublist_size, sublist.Size());
+  if (!ShouldUseHashSet(list_size, sublist_size)) {
+    return SetsIntersectsLinear(value_factory, list, sublist);
+  }
+  // Intersection is symmetric, so index the smaller operand and probe with
+  // the larger one.
+  const ListValue& indexed = list_size <= sublist_size ? list : sublist;
+  const ListValue& probe = list_size <= sublist_size ? sublist : list;
+  CEL_ASSIGN_OR_RETURN(auto set, runtime_internal::ValueHashSet::FromList(
+                                     value_factory, indexed));
+  if (!set.has_value()) {
+    return SetsIntersectsLinear(value_factory, list, sublist);
+  }
+  bool exists = false;
+  CEL_RETURN_IF_ERROR(probe.ForEach(
+      value_factory, [&](const Value& element) -> absl::StatusOr<bool> {
+        CEL_ASSIGN_OR_RETURN(
+            exists, HashSetContains(value_factory, *set, indexed, element));
+        return !exists;
+      }));
+  return value_factory.CreateBoolValue(exists);
+}
+
 absl::StatusOr<Value> SetsEquivalent(ValueManager& value_factory,
                                      const ListValue& list,
                                      const ListValue& sublist) {
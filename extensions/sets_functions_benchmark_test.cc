@@ -336,6 +336,19 @@ void BenchArgs(Benchmark* bench) {
   }
 }
 
+// Large inputs where the hash set backed implementations of the sets
+// functions are expected to scale linearly while the comprehension
+// equivalents scale quadratically.
+template <typename Benchmark>
+void LargeBenchArgs(Benchmark* bench) {
+  for (ListImpl impl :
+       {ListImpl::kLegacy, ListImpl::kWrappedModern, ListImpl::kRhsConstant}) {
+    for (int size : {1024, 4096}) {
+      bench->ArgPair(ToNumber(impl), size);
+    }
+  }
+}
+
 BENCHMARK(BM_SetsIntersectsComprehensionTrue)->Apply(BenchArgs);
 BENCHMARK(BM_SetsIntersectsComprehensionFalse)->Apply(BenchArgs);
 BENCHMARK(BM_SetsIntersectsTrue)->Apply(BenchArgs);
@@ -346,5 +359,15 @@ BENCHMARK(BM_SetsEquivalentComprehensionFalse)->Apply(BenchArgs);
 BENCHMARK(BM_SetsEquivalentTrue)->Apply(BenchArgs);
 BENCHMARK(BM_SetsEquivalentFalse)->Apply(BenchArgs);
 
+BENCHMARK(BM_SetsIntersectsComprehensionTrue)->Apply(LargeBenchArgs);
+BENCHMARK(BM_SetsIntersectsComprehensionFalse)->Apply(LargeBenchArgs);
+BENCHMARK(BM_SetsIntersectsTrue)->Apply(LargeBenchArgs);
+BENCHMARK(BM_SetsIntersectsFalse)->Apply(LargeBenchArgs);
+
+BENCHMARK(BM_SetsEquivalentComprehensionTrue)->Apply(LargeBenchArgs);
+BENCHMARK(BM_SetsEquivalentComprehensionFalse)->Apply(LargeBenchArgs);
+BENCHMARK(BM_SetsEquivalentTrue)->Apply(LargeBenchArgs);
+BENCHMARK(BM_SetsEquivalentFalse)->Apply(LargeBenchArgs);
+
 }  // namespace
 }  // namespace cel::extensions
@@ -159,6 +159,24 @@ INSTANTIATE_TEST_SUITE_P(
 
         {"sets.equivalent([{'foo': true, 'bar': false}], [{'bar': false, "
          "'foo': true}])"},
+
+        // Large enough to use the hash set backed implementation.
+        {"sets.contains([1, 2, 3, 4, 5, 6, 7, 8, 9, 10], "
+         "[10u, 9.0, 8, 7, 6, 5, 4, 3, 2, 1])"},
+        {"!sets.contains([1, 2, 3, 4, 5, 6, 7, 8, 9, 10], "
+         "[10u, 9.0, 8, 7, 6, 5, 4, 3, 2, 11])"},
+        {"sets.contains(['a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j'], "
+         "['j', 'i', 'h', 'g', 'f', 'e', 'd', 'c', 'b', 'a'])"},
+        {"sets.intersects([1, 2, 3, 4, 5, 6, 7, 8, 9, 10], "
+         "[11, 12, 13, 14, 15, 16, 17, 18, 19, 10.0])"},
+        {"!sets.intersects([1, 2, 3, 4, 5, 6, 7, 8, 9, 10], "
+         "[11, 12, 13, 14, 15, 16, 17, 18, 19, 10.5])"},
+        {"sets.equivalent([1, 2, 3, 4, 5, 6, 7, 8, 9, 10], "
+         "[10u, 9u, 8u, 7u, 6u, 5u, 4u, 3u, 2u, 1u])"},
+        {"sets.contains([1, 2, 3, 4, 5, 6, 7, 8, 9, [10]], "
+         "[[10], 9, 8, 7, 6, 5, 4, 3, 2, 1])"},
+        {"!sets.intersects([[1], 2, 3, 4, 5, 6, 7, 8, 9, 10], "
+         "[[2], 12, 13, 14, 15, 16, 17, 18, 19, 20])"},
     }));
 
 }  // namespace
@@ -27,12 +27,14 @@
 #include "absl/strings/cord.h"
 #include "absl/strings/string_view.h"
 #include "common/casting.h"
+#include "common/internal/shared_byte_string.h"
 #include "common/type.h"
 #include "common/value.h"
 #include "common/value_manager.h"
 #include "eval/public/cel_function_registry.h"
 #include "eval/public/cel_options.h"
 #include "internal/status_macros.h"
+#include "internal/unicode.h"
 #include "internal/utf8.h"
 #include "runtime/function_adapter.h"
 #include "runtime/function_registry.h"
@@ -53,33 +55,103 @@ struct AppendToStringVisitor {
   }
 };
 
+size_t ByteSize(const StringValue& string) {
+  return string.NativeValue(
+      [](const auto& value) -> size_t { return value.size(); });
+}
+
+// Returns the `n` bytes of `string` starting at `pos`. The result shares the
+// underlying storage of `string` instead of copying it.
+StringValue Substring(const StringValue& string, size_t pos, size_t n) {
+  return StringValue(
+      common_internal::AsSharedByteString(string).Substring(pos, n));
+}
+
+// Returns true if `string` contains an ASCII upper case letter. The bulk of
+// the string is scanned in fixed size blocks without branches so that the
+// compiler can vectorize the loop.
+bool HasAsciiUpper(absl::string_view string) {
+  constexpr size_t kBlockSize = 32;
+  const char* data = string.data();
+  size_t size = string.size();
+  while (size >= kBlockSize) {
+    unsigned char found = 0;
+    for (size_t i = 0; i < kBlockSize; ++i) {
+      found |= static_cast<unsigned char>(
+          static_cast<unsigned char>(static_cast<unsigned char>(data[i]) -
+                                     'A') < 26);
+    }
+    if (found != 0) {
+      return true;
+    }
+    data += kBlockSize;
+    size -= kBlockSize;
+  }
+  for (size_t i = 0; i < size; ++i) {
+    if (absl::ascii_isupper(static_cast<unsigned char>(data[i]))) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Branch free ASCII lower casing, which the compiler vectorizes.
+void AsciiToLowerInPlace(std::string& string) {
+  for (char& c : string) {
+    const unsigned char u = static_cast<unsigned char>(c);
+    c = static_cast<char>(
+        u | (static_cast<unsigned char>(static_cast<unsigned char>(u - 'A') <
+                                        26)
+             << 5));
+  }
+}
+
+// Single byte delimiters are the common case and are searched for with
+// `memchr`, which the C library implements with SIMD.
+size_t FindDelimiter(absl::string_view string, absl::string_view delimiter,
+                     size_t pos) {
+  if (delimiter.size() == 1) {
+    return string.find(delimiter.front(), pos);
+  }
+  return string.find(delimiter, pos);
+}
+
 absl::StatusOr<Value> Join2(ValueManager& value_manager, const ListValue& value,
                             const StringValue& separator) {
-  std::string result;
-  CEL_ASSIGN_OR_RETURN(auto iterator, value.NewIterator(value_manager));
+  std::string separator_scratch;
+  absl::string_view separator_view = separator.NativeString(separator_scratch);
+  // Compute the size of the result up front so that it is allocated once.
+  size_t result_size = 0;
+  size_t element_count = 0;
   Value element;
-  if (iterator->HasNext()) {
-    CEL_RETURN_IF_ERROR(iterator->Next(value_manager, element));
-    if (auto string_element = As<StringValue>(element); string_element) {
-      string_element->NativeValue(AppendToStringVisitor{result});
-    } else {
-      return ErrorValue{
-          runtime_internal::CreateNoMatchingOverloadError("join")};
+  {
+    CEL_ASSIGN_OR_RETURN(auto iterator, value.NewIterator(value_manager));
+    while (iterator->HasNext()) {
+      CEL_RETURN_IF_ERROR(iterator->Next(value_manager, element));
+      if (auto string_element = As<StringValue>(element); string_element) {
+        result_size += ByteSize(*string_element);
+        ++element_count;
+      } else {
+        return ErrorValue{
+            runtime_internal::CreateNoMatchingOverloadError("join")};
+      }
     }
   }
-  std::string separator_scratch;
-  absl::string_view separator_view = separator.NativeString(separator_scratch);
+  if (element_count > 1) {
+    result_size += separator_view.size() * (element_count - 1);
+  }
+  std::string result;
+  result.reserve(result_size);
+  CEL_ASSIGN_OR_RETURN(auto iterator, value.NewIterator(value_manager));
+  bool first = true;
   while (iterator->HasNext()) {
-    result.append(separator_view);
     CEL_RETURN_IF_ERROR(iterator->Next(value_manager, element));
-    if (auto string_element = As<StringValue>(element); string_element) {
-      string_element->NativeValue(AppendToStringVisitor{result});
-    } else {
-      return ErrorValue{
-          runtime_internal::CreateNoMatchingOverloadError("join")};
+    if (!first) {
+      result.append(separator_view);
     }
+    first = false;
+    Cast<StringValue>(element).NativeValue(AppendToStringVisitor{result});
   }
-  result.shrink_to_fit();
   // We assume the original string was well-formed.
   return value_manager.CreateUncheckedStringValue(std::move(result));
 }
@@ -91,6 +163,7 @@ absl::StatusOr<Value> Join1(ValueManager& value_manager,
 
 struct SplitWithEmptyDelimiter {
   ValueManager& value_manager;
+  const StringValue& source;
   int64_t& limit;
   ListValueBuilder& builder;
 
@@ -99,18 +172,24 @@ struct SplitWithEmptyDelimiter {
     size_t count;
     std::string buffer;
     buffer.reserve(4);
-    while (!string.empty() && limit > 1) {
-      std::tie(rune, count) = internal::Utf8Decode(string);
-      buffer.clear();
-      internal::Utf8Encode(buffer, rune);
-      CEL_RETURN_IF_ERROR(builder.Add(
-          value_manager.CreateUncheckedStringValue(absl::string_view(buffer))));
+    size_t pos = 0;
+    while (pos < string.size() && limit > 1) {
+      std::tie(rune, count) = internal::Utf8Decode(string.substr(pos));
+      if (rune == internal::kUnicodeReplacementCharacter && count == 1) {
+        // Malformed sequence, which is replaced by U+FFFD.
+        buffer.clear();
+        internal::Utf8Encode(buffer, rune);
+        CEL_RETURN_IF_ERROR(builder.Add(value_manager.CreateUncheckedStringValue(
+            absl::string_view(buffer))));
+      } else {
+        CEL_RETURN_IF_ERROR(builder.Add(Substring(source, pos, count)));
+      }
       --limit;
-      string.remove_prefix(count);
+      pos += count;
     }
-    if (!string.empty()) {
+    if (pos < string.size()) {
       CEL_RETURN_IF_ERROR(
-          builder.Add(value_manager.CreateUncheckedStringValue(string)));
+          builder.Add(Substring(source, pos, string.size() - pos)));
     }
     return std::move(builder).Build();
   }
@@ -168,7 +247,7 @@ absl::StatusOr<Value> Split3(ValueManager& value_manager,
   if (delimiter.IsEmpty()) {
     // If the delimiter is empty, we split between every code point.
     return string.NativeValue(
-        SplitWithEmptyDelimiter{value_manager, limit, *builder});
+        SplitWithEmptyDelimiter{value_manager, string, limit, *builder});
   }
   // At this point we know the string is not empty and the delimiter is not
   // empty.
@@ -176,29 +255,32 @@ absl::StatusOr<Value> Split3(ValueManager& value_manager,
   absl::string_view delimiter_view = delimiter.NativeString(delimiter_scratch);
   std::string content_scratch;
   absl::string_view content_view = string.NativeString(content_scratch);
-  while (limit > 1 && !content_view.empty()) {
-    auto pos = content_view.find(delimiter_view);
+  // Count the pieces first so that the list is allocated once.
+  int64_t pieces = 1;
+  for (size_t pos = FindDelimiter(content_view, delimiter_view, 0);
+       pos != absl::string_view::npos && pieces < limit;
+       pos = FindDelimiter(content_view, delimiter_view,
+                           pos + delimiter_view.size())) {
+    ++pieces;
+  }
+  builder->Reserve(static_cast<size_t>(pieces));
+  // The pieces reference the storage of `string` rather than copying it. We
+  // assume the original string was well-formed.
+  size_t start = 0;
+  while (limit > 1) {
+    size_t pos = FindDelimiter(content_view, delimiter_view, start);
     if (pos == absl::string_view::npos) {
       break;
     }
-    // We assume the original string was well-formed.
-    CEL_RETURN_IF_ERROR(builder->Add(
-        value_manager.CreateUncheckedStringValue(content_view.substr(0, pos))));
+    CEL_RETURN_IF_ERROR(builder->Add(Substring(string, start, pos - start)));
     --limit;
-    content_view.remove_prefix(pos + delimiter_view.size());
-    if (content_view.empty()) {
-      // We found the delimiter at the end of the string. Add an empty string
-      // to the end of the list.
-      CEL_RETURN_IF_ERROR(builder->Add(StringValue{}));
-      return std::move(*builder).Build();
-    }
+    start = pos + delimiter_view.size();
   }
   // We have one left in the limit or do not have any more matches. Add
-  // whatever is left as the remaining entry.
-  //
-  // We assume the original string was well-formed.
-  CEL_RETURN_IF_ERROR(
-      builder->Add(value_manager.CreateUncheckedStringValue(content_view)));
+  // whatever is left as the remaining entry, which is empty if the delimiter
+  // was found at the end of the string.
+  CEL_RETURN_IF_ERROR(builder->Add(
+      Substring(string, start, content_view.size() - start)));
   return std::move(*builder).Build();
 }
 
@@ -210,8 +292,16 @@ absl::StatusOr<Value> Split2(ValueManager& value_manager,
 
 absl::StatusOr<Value> LowerAscii(ValueManager& value_manager,
                                  const StringValue& string) {
-  std::string content = string.NativeString();
-  absl::AsciiStrToLower(&content);
+  std::string scratch;
+  absl::string_view content_view = string.NativeString(scratch);
+  if (!HasAsciiUpper(content_view)) {
+    // Nothing to convert, return the original string without copying it.
+    return string;
+  }
+  std::string content = content_view.data() == scratch.data()
+                            ? std::move(scratch)
+                            : std::string(content_view);
+  AsciiToLowerInPlace(content);
   // We assume the original string was well-formed.
   return value_manager.CreateUncheckedStringValue(std::move(content));
 }
@@ -229,15 +319,20 @@ absl::StatusOr<Value> Replace2(ValueManager& value_manager,
     limit = std::numeric_limits<int64_t>::max();
   }
 
-  std::string result;
   std::string old_sub_scratch;
   absl::string_view old_sub_view = old_sub.NativeString(old_sub_scratch);
-  std::string new_sub_scratch;
-  absl::string_view new_sub_view = new_sub.NativeString(new_sub_scratch);
   std::string content_scratch;
   absl::string_view content_view = string.NativeString(content_scratch);
+  auto pos = content_view.find(old_sub_view);
+  if (pos == absl::string_view::npos) {
+    // Nothing to replace, return the original string without copying it.
+    return string;
+  }
+  std::string new_sub_scratch;
+  absl::string_view new_sub_view = new_sub.NativeString(new_sub_scratch);
+  std::string result;
+  result.reserve(content_view.size());
   while (limit > 0 && !content_view.empty()) {
-    auto pos = content_view.find(old_sub_view);
     if (pos == absl::string_view::npos) {
       break;
     }
@@ -245,6 +340,7 @@ absl::StatusOr<Value> Replace2(ValueManager& value_manager,
     result.append(new_sub_view);
     --limit;
     content_view.remove_prefix(pos + old_sub_view.size());
+    pos = content_view.find(old_sub_view);
   }
   // Add the remainder of the string.
   if (!content_view.empty()) {
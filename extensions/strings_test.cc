@@ -15,11 +15,15 @@
 #include "extensions/strings.h"
 
 #include <memory>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "cel/expr/syntax.pb.h"
 #include "absl/status/status_matchers.h"
 #include "absl/strings/cord.h"
+#include "absl/strings/cord_test_helpers.h"
+#include "absl/strings/string_view.h"
 #include "common/memory.h"
 #include "common/value.h"
 #include "common/values/legacy_value_manager.h"
@@ -194,5 +198,85 @@ TEST(Strings, ReplaceWithZeroLimit) {
   EXPECT_TRUE(result.GetBool().NativeValue());
 }
 
+struct StringsTestCase {
+  std::string expression;
+  bool cord_input;
+};
+
+class StringsKernelsTest : public testing::TestWithParam<StringsTestCase> {};
+
+// `foo` is bound to a string longer than the block size of the vectorized
+// scans, either flat or as a fragmented cord.
+TEST_P(StringsKernelsTest, EvaluatesToTrue) {
+  const StringsTestCase& test_case = GetParam();
+  MemoryManagerRef memory_manager = MemoryManagerRef::ReferenceCounting();
+  const auto options = RuntimeOptions{};
+  ASSERT_OK_AND_ASSIGN(auto builder,
+                       CreateStandardRuntimeBuilder(
+                           internal::GetTestingDescriptorPool(), options));
+  EXPECT_THAT(RegisterStringsFunctions(builder.function_registry(), options),
+              IsOk());
+
+  ASSERT_OK_AND_ASSIGN(auto runtime, std::move(builder).Build());
+
+  ASSERT_OK_AND_ASSIGN(
+      ParsedExpr expr,
+      Parse(test_case.expression, "<input>", ParserOptions{}));
+
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<Program> program,
+                       ProtobufRuntimeAdapter::CreateProgram(*runtime, expr));
+
+  common_internal::LegacyValueManager value_factory(memory_manager,
+                                                    runtime->GetTypeProvider());
+
+  constexpr absl::string_view kInput =
+      "GET /Index.html,200,Mozilla/5.0 (X11; Linux x86_64),ok,";
+  Activation activation;
+  if (test_case.cord_input) {
+    absl::Cord cord = absl::MakeFragmentedCord(
+        {kInput.substr(0, 10), kInput.substr(10, 20), kInput.substr(30)});
+    activation.InsertOrAssignValue("foo", StringValue{std::move(cord)});
+  } else {
+    activation.InsertOrAssignValue(
+        "foo", value_factory.CreateUncheckedStringValue(std::string(kInput)));
+  }
+
+  ASSERT_OK_AND_ASSIGN(Value result,
+                       program->Evaluate(activation, value_factory));
+  ASSERT_TRUE(result.Is<BoolValue>()) << result.DebugString();
+  EXPECT_TRUE(result.GetBool().NativeValue()) << test_case.expression;
+}
+
+std::vector<StringsTestCase> StringsKernelsTestCases() {
+  std::vector<std::string> expressions = {
+      "foo.split(',') == ['GET /Index.html', '200', "
+      "'Mozilla/5.0 (X11; Linux x86_64)', 'ok', '']",
+      "foo.split(',', 2) == ['GET /Index.html', "
+      "'200,Mozilla/5.0 (X11; Linux x86_64),ok,']",
+      "foo.split(', ') == [foo]",
+      "foo.split('; ') == ['GET /Index.html,200,Mozilla/5.0 (X11', "
+      "'Linux x86_64),ok,']",
+      "foo.split(',').join(',') == foo",
+      "foo.split(',').join() == "
+      "'GET /Index.html200Mozilla/5.0 (X11; Linux x86_64)ok'",
+      "foo.split('')[4] == '/'",
+      "foo.lowerAscii() == "
+      "'get /index.html,200,mozilla/5.0 (x11; linux x86_64),ok,'",
+      "foo.lowerAscii().lowerAscii() == foo.lowerAscii()",
+      "foo.replace('missing', 'x') == foo",
+      "foo.replace(',', ';', 2) == "
+      "'GET /Index.html;200;Mozilla/5.0 (X11; Linux x86_64),ok,'",
+  };
+  std::vector<StringsTestCase> test_cases;
+  for (const auto& expression : expressions) {
+    test_cases.push_back({expression, /*cord_input=*/false});
+    test_cases.push_back({expression, /*cord_input=*/true});
+  }
+  return test_cases;
+}
+
+INSTANTIATE_TEST_SUITE_P(StringsKernelsTest, StringsKernelsTest,
+                         testing::ValuesIn(StringsKernelsTestCases()));
+
 }  // namespace
 }  // namespace cel::extensions
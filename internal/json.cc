@@ -44,6 +44,7 @@
 #include "absl/types/variant.h"
 #include "common/json.h"
 #include "extensions/protobuf/internal/map_reflection.h"
+#include "internal/json_writer.h"
 #include "internal/status_macros.h"
 #include "internal/strings.h"
 #include "internal/well_known_types.h"
@@ -1737,6 +1738,607 @@ std::string JsonMapDebugString(const google::protobuf::Message& message) {
 
 namespace {
 
+void StringValueToJsonText(const well_known_types::StringValue& value,
+                           absl::Nonnull<JsonWriter*> writer) {
+  absl::visit(
+      absl::Overload(
+          [&](absl::string_view string) -> void { writer->String(string); },
+          [&](const absl::Cord& cord) -> void { writer->String(cord); }),
+      AsVariant(value));
+}
+
+void BytesValueToJsonText(const well_known_types::BytesValue& value,
+                          absl::Nonnull<JsonWriter*> writer) {
+  absl::visit(
+      absl::Overload(
+          [&](absl::string_view string) -> void { writer->Bytes(string); },
+          [&](const absl::Cord& cord) -> void { writer->Bytes(cord); }),
+      AsVariant(value));
+}
+
+class JsonToJsonTextState final {
+ public:
+  JsonToJsonTextState(absl::Nonnull<const JsonAccessor*> accessor,
+                      absl::Nonnull<JsonWriter*> writer)
+      : accessor_(accessor), writer_(writer) {}
+
+  void ValueToJsonText(const google::protobuf::MessageLite& message) {
+    const auto kind_case = accessor_->GetKindCase(message);
+    switch (kind_case) {
+      case google::protobuf::Value::kBoolValue:
+        writer_->Bool(accessor_->GetBoolValue(message));
+        break;
+      case google::protobuf::Value::kNumberValue:
+        writer_->Number(accessor_->GetNumberValue(message));
+        break;
+      case google::protobuf::Value::kStringValue:
+        StringValueToJsonText(accessor_->GetStringValue(message, scratch_),
+                              writer_);
+        break;
+      case google::protobuf::Value::kListValue:
+        ListValueToJsonText(accessor_->GetListValue(message));
+        break;
+      case google::protobuf::Value::kStructValue:
+        StructToJsonText(accessor_->GetStructValue(message));
+        break;
+      default:
+        // Unset values are treated as `null`, as are any kinds added to
+        // `google.protobuf.Value` in the future.
+        writer_->Null();
+        break;
+    }
+  }
+
+  void ListValueToJsonText(const google::protobuf::MessageLite& message) {
+    const int size = accessor_->ValuesSize(message);
+    writer_->BeginArray();
+    for (int i = 0; i < size; ++i) {
+      ValueToJsonText(accessor_->Values(message, i));
+    }
+    writer_->EndArray();
+  }
+
+  void StructToJsonText(const google::protobuf::MessageLite& message) {
+    const int size = accessor_->FieldsSize(message);
+    std::string key_scratch;
+    well_known_types::StringValue key;
+    absl::Nonnull<const google::protobuf::MessageLite*> value;
+    auto iterator = accessor_->IterateFields(message);
+    writer_->BeginObject();
+    for (int i = 0; i < size; ++i) {
+      std::tie(key, value) = iterator.Next(key_scratch);
+      absl::visit(
+          absl::Overload(
+              [&](absl::string_view string) -> void { writer_->Key(string); },
+              [&](const absl::Cord& cord) -> void { writer_->Key(cord); }),
+          AsVariant(key));
+      ValueToJsonText(*value);
+    }
+    writer_->EndObject();
+  }
+
+ private:
+  const absl::Nonnull<const JsonAccessor*> accessor_;
+  const absl::Nonnull<JsonWriter*> writer_;
+  std::string scratch_;
+};
+
+// Streaming counterpart of `MessageToJsonState`. The mapping is identical, but
+// each value is written to `JsonWriter` as it is visited instead of being
+// accumulated in a `google.protobuf.Value`.
+class MessageToJsonTextState final {
+ public:
+  MessageToJsonTextState(
+      absl::Nonnull<const google::protobuf::DescriptorPool*> descriptor_pool,
+      absl::Nonnull<google::protobuf::MessageFactory*> message_factory,
+      absl::Nonnull<JsonWriter*> writer)
+      : descriptor_pool_(descriptor_pool),
+        message_factory_(message_factory),
+        writer_(writer) {}
+
+  absl::Status ToJson(const google::protobuf::Message& message) {
+    const auto* descriptor = message.GetDescriptor();
+    switch (descriptor->well_known_type()) {
+      case Descriptor::WELLKNOWNTYPE_DOUBLEVALUE: {
+        CEL_RETURN_IF_ERROR(reflection_.DoubleValue().Initialize(descriptor));
+        writer_->Number(reflection_.DoubleValue().GetValue(message));
+      } break;
+      case Descriptor::WELLKNOWNTYPE_FLOATVALUE: {
+        CEL_RETURN_IF_ERROR(reflection_.FloatValue().Initialize(descriptor));
+        writer_->Number(reflection_.FloatValue().GetValue(message));
+      } break;
+      case Descriptor::WELLKNOWNTYPE_INT64VALUE: {
+        CEL_RETURN_IF_ERROR(reflection_.Int64Value().Initialize(descriptor));
+        writer_->Int(reflection_.Int64Value().GetValue(message));
+      } break;
+      case Descriptor::WELLKNOWNTYPE_UINT64VALUE: {
+        CEL_RETURN_IF_ERROR(reflection_.UInt64Value().Initialize(descriptor));
+        writer_->Uint(reflection_.UInt64Value().GetValue(message));
+      } break;
+      case Descriptor::WELLKNOWNTYPE_INT32VALUE: {
+        CEL_RETURN_IF_ERROR(reflection_.Int32Value().Initialize(descriptor));
+        writer_->Int(reflection_.Int32Value().GetValue(message));
+      } break;
+      case Descriptor::WELLKNOWNTYPE_UINT32VALUE: {
+        CEL_RETURN_IF_ERROR(reflection_.UInt32Value().Initialize(descriptor));
+        writer_->Uint(reflection_.UInt32Value().GetValue(message));
+      } break;
+      case Descriptor::WELLKNOWNTYPE_STRINGVALUE: {
+        CEL_RETURN_IF_ERROR(reflection_.StringValue().Initialize(descriptor));
+        StringValueToJsonText(
+            reflection_.StringValue().GetValue(message, scratch_), writer_);
+      } break;
+      case Descriptor::WELLKNOWNTYPE_BYTESVALUE: {
+        CEL_RETURN_IF_ERROR(reflection_.BytesValue().Initialize(descriptor));
+        BytesValueToJsonText(
+            reflection_.BytesValue().GetValue(message, scratch_), writer_);
+      } break;
+      case Descriptor::WELLKNOWNTYPE_BOOLVALUE: {
+        CEL_RETURN_IF_ERROR(reflection_.BoolValue().Initialize(descriptor));
+        writer_->Bool(reflection_.BoolValue().GetValue(message));
+      } break;
+      case Descriptor::WELLKNOWNTYPE_ANY: {
+        CEL_ASSIGN_OR_RETURN(
+            auto unpacked,
+            well_known_types::UnpackAnyFrom(/*arena=*/nullptr,
+                                            reflection_.Any(), message,
+                                            descriptor_pool_, message_factory_));
+        const auto* unpacked_descriptor = unpacked->GetDescriptor();
+        writer_->BeginObject();
+        writer_->Key("@type");
+        writer_->String(absl::StrCat("type.googleapis.com/",
+                                     unpacked_descriptor->full_name()));
+        switch (unpacked_descriptor->well_known_type()) {
+          case Descriptor::WELLKNOWNTYPE_DOUBLEVALUE:
+            ABSL_FALLTHROUGH_INTENDED;
+          case Descriptor::WELLKNOWNTYPE_FLOATVALUE:
+            ABSL_FALLTHROUGH_INTENDED;
+          case Descriptor::WELLKNOWNTYPE_INT64VALUE:
+            ABSL_FALLTHROUGH_INTENDED;
+          case Descriptor::WELLKNOWNTYPE_UINT64VALUE:
+            ABSL_FALLTHROUGH_INTENDED;
+          case Descriptor::WELLKNOWNTYPE_INT32VALUE:
+            ABSL_FALLTHROUGH_INTENDED;
+          case Descriptor::WELLKNOWNTYPE_UINT32VALUE:
+            ABSL_FALLTHROUGH_INTENDED;
+          case Descriptor::WELLKNOWNTYPE_STRINGVALUE:
+            ABSL_FALLTHROUGH_INTENDED;
+          case Descriptor::WELLKNOWNTYPE_BYTESVALUE:
+            ABSL_FALLTHROUGH_INTENDED;
+          case Descriptor::WELLKNOWNTYPE_BOOLVALUE:
+            ABSL_FALLTHROUGH_INTENDED;
+          case Descriptor::WELLKNOWNTYPE_FIELDMASK:
+            ABSL_FALLTHROUGH_INTENDED;
+          case Descriptor::WELLKNOWNTYPE_DURATION:
+            ABSL_FALLTHROUGH_INTENDED;
+          case Descriptor::WELLKNOWNTYPE_TIMESTAMP:
+            ABSL_FALLTHROUGH_INTENDED;
+          case Descriptor::WELLKNOWNTYPE_VALUE:
+            ABSL_FALLTHROUGH_INTENDED;
+          case Descriptor::WELLKNOWNTYPE_LISTVALUE:
+            ABSL_FALLTHROUGH_INTENDED;
+          case Descriptor::WELLKNOWNTYPE_STRUCT:
+            writer_->Key("value");
+            CEL_RETURN_IF_ERROR(ToJson(*unpacked));
+            break;
+          default:
+            if (unpacked_descriptor->full_name() == "google.protobuf.Empty") {
+              writer_->Key("value");
+              writer_->BeginObject();
+              writer_->EndObject();
+            } else {
+              CEL_RETURN_IF_ERROR(MessageFieldsToJson(*unpacked));
+            }
+            break;
+        }
+        writer_->EndObject();
+      } break;
+      case Descriptor::WELLKNOWNTYPE_FIELDMASK: {
+        CEL_RETURN_IF_ERROR(reflection_.FieldMask().Initialize(descriptor));
+        std::string paths;
+        std::string path;
+        const int paths_size = reflection_.FieldMask().PathsSize(message);
+        for (int i = 0; i < paths_size; ++i) {
+          CEL_RETURN_IF_ERROR(SnakeCaseToCamelCase(
+              reflection_.FieldMask().Paths(message, i, scratch_), &path));
+          if (i > 0) {
+            paths.push_back(',');
+          }
+          paths.append(path);
+        }
+        writer_->String(paths);
+      } break;
+      case Descriptor::WELLKNOWNTYPE_DURATION: {
+        CEL_RETURN_IF_ERROR(reflection_.Duration().Initialize(descriptor));
+        google::protobuf::Duration duration;
+        duration.set_seconds(reflection_.Duration().GetSeconds(message));
+        duration.set_nanos(reflection_.Duration().GetNanos(message));
+        writer_->String(TimeUtil::ToString(duration));
+      } break;
+      case Descriptor::WELLKNOWNTYPE_TIMESTAMP: {
+        CEL_RETURN_IF_ERROR(reflection_.Timestamp().Initialize(descriptor));
+        google::protobuf::Timestamp timestamp;
+        timestamp.set_seconds(reflection_.Timestamp().GetSeconds(message));
+        timestamp.set_nanos(reflection_.Timestamp().GetNanos(message));
+        writer_->String(TimeUtil::ToString(timestamp));
+      } break;
+      case Descriptor::WELLKNOWNTYPE_VALUE:
+        JsonToJsonText(message, writer_);
+        break;
+      case Descriptor::WELLKNOWNTYPE_LISTVALUE:
+        JsonListToJsonText(message, writer_);
+        break;
+      case Descriptor::WELLKNOWNTYPE_STRUCT:
+        JsonMapToJsonText(message, writer_);
+        break;
+      default:
+        writer_->BeginObject();
+        CEL_RETURN_IF_ERROR(MessageFieldsToJson(message));
+        writer_->EndObject();
+        break;
+    }
+    return absl::OkStatus();
+  }
+
+  absl::Status MessageFieldToJson(
+      const google::protobuf::Message& message,
+      absl::Nonnull<const google::protobuf::FieldDescriptor*> field) {
+    if (field->is_map()) {
+      return MessageMapFieldToJson(message, field);
+    }
+    if (field->is_repeated()) {
+      return MessageRepeatedFieldToJson(message, field);
+    }
+    const auto* reflection = message.GetReflection();
+    switch (field->type()) {
+      case FieldDescriptor::TYPE_DOUBLE:
+        writer_->Number(reflection->GetDouble(message, field));
+        break;
+      case FieldDescriptor::TYPE_FLOAT:
+        writer_->Number(reflection->GetFloat(message, field));
+        break;
+      case FieldDescriptor::TYPE_FIXED64:
+        ABSL_FALLTHROUGH_INTENDED;
+      case FieldDescriptor::TYPE_UINT64:
+        writer_->Uint(reflection->GetUInt64(message, field));
+        break;
+      case FieldDescriptor::TYPE_BOOL:
+        writer_->Bool(reflection->GetBool(message, field));
+        break;
+      case FieldDescriptor::TYPE_STRING:
+        StringValueToJsonText(
+            well_known_types::GetStringField(message, field, scratch_),
+            writer_);
+        break;
+      case FieldDescriptor::TYPE_GROUP:
+        ABSL_FALLTHROUGH_INTENDED;
+      case FieldDescriptor::TYPE_MESSAGE:
+        return ToJson(reflection->GetMessage(message, field));
+      case FieldDescriptor::TYPE_BYTES:
+        BytesValueToJsonText(
+            well_known_types::GetBytesField(message, field, scratch_),
+            writer_);
+        break;
+      case FieldDescriptor::TYPE_FIXED32:
+        ABSL_FALLTHROUGH_INTENDED;
+      case FieldDescriptor::TYPE_UINT32:
+        writer_->Uint(reflection->GetUInt32(message, field));
+        break;
+      case FieldDescriptor::TYPE_ENUM:
+        if (field->enum_type()->full_name() == "google.protobuf.NullValue") {
+          writer_->Null();
+        } else if (const auto* value = reflection->GetEnum(message, field);
+                   value != nullptr) {
+          writer_->String(value->name());
+        } else {
+          writer_->Int(reflection->GetEnumValue(message, field));
+        }
+        break;
+      case FieldDescriptor::TYPE_SFIXED32:
+        ABSL_FALLTHROUGH_INTENDED;
+      case FieldDescriptor::TYPE_SINT32:
+        ABSL_FALLTHROUGH_INTENDED;
+      case FieldDescriptor::TYPE_INT32:
+        writer_->Int(reflection->GetInt32(message, field));
+        break;
+      case FieldDescriptor::TYPE_SFIXED64:
+        ABSL_FALLTHROUGH_INTENDED;
+      case FieldDescriptor::TYPE_SINT64:
+        ABSL_FALLTHROUGH_INTENDED;
+      case FieldDescriptor::TYPE_INT64:
+        writer_->Int(reflection->GetInt64(message, field));
+        break;
+      default:
+        return absl::InvalidArgumentError(absl::StrCat(
+            "unexpected message field type: ", field->type_name()));
+    }
+    return absl::OkStatus();
+  }
+
+ private:
+  absl::Status MessageFieldsToJson(const google::protobuf::Message& message) {
+    std::vector<const google::protobuf::FieldDescriptor*> fields;
+    const auto* reflection = message.GetReflection();
+    reflection->ListFields(message, &fields);
+    for (const auto* field : fields) {
+      writer_->Key(field->json_name());
+      CEL_RETURN_IF_ERROR(MessageFieldToJson(message, field));
+    }
+    return absl::OkStatus();
+  }
+
+  absl::Status MessageMapFieldToJson(
+      const google::protobuf::Message& message,
+      absl::Nonnull<const google::protobuf::FieldDescriptor*> field) {
+    const auto* reflection = message.GetReflection();
+    writer_->BeginObject();
+    if (reflection->FieldSize(message, field) != 0) {
+      const auto* key_descriptor = field->message_type()->map_key();
+      const auto key_to_string = GetMapFieldKeyToString(key_descriptor);
+      const auto* value_descriptor = field->message_type()->map_value();
+      auto begin =
+          extensions::protobuf_internal::MapBegin(*reflection, message, *field);
+      const auto end =
+          extensions::protobuf_internal::MapEnd(*reflection, message, *field);
+      for (; begin != end; ++begin) {
+        if (key_descriptor->cpp_type() == FieldDescriptor::CPPTYPE_STRING) {
+          writer_->Key(begin.GetKey().GetStringValue());
+        } else {
+          writer_->Key((*key_to_string)(begin.GetKey()));
+        }
+        CEL_RETURN_IF_ERROR(
+            MapFieldValueToJson(begin.GetValueRef(), value_descriptor));
+      }
+    }
+    writer_->EndObject();
+    return absl::OkStatus();
+  }
+
+  absl::Status MapFieldValueToJson(
+      const google::protobuf::MapValueConstRef& value,
+      absl::Nonnull<const google::protobuf::FieldDescriptor*> field) {
+    ABSL_DCHECK_EQ(value.type(), field->cpp_type());
+    switch (field->type()) {
+      case FieldDescriptor::TYPE_DOUBLE:
+        writer_->Number(value.GetDoubleValue());
+        break;
+      case FieldDescriptor::TYPE_FLOAT:
+        writer_->Number(value.GetFloatValue());
+        break;
+      case FieldDescriptor::TYPE_FIXED64:
+        ABSL_FALLTHROUGH_INTENDED;
+      case FieldDescriptor::TYPE_UINT64:
+        writer_->Uint(value.GetUInt64Value());
+        break;
+      case FieldDescriptor::TYPE_BOOL:
+        writer_->Bool(value.GetBoolValue());
+        break;
+      case FieldDescriptor::TYPE_STRING:
+        writer_->String(value.GetStringValue());
+        break;
+      case FieldDescriptor::TYPE_GROUP:
+        ABSL_FALLTHROUGH_INTENDED;
+      case FieldDescriptor::TYPE_MESSAGE:
+        return ToJson(value.GetMessageValue());
+      case FieldDescriptor::TYPE_BYTES:
+        writer_->Bytes(value.GetStringValue());
+        break;
+      case FieldDescriptor::TYPE_FIXED32:
+        ABSL_FALLTHROUGH_INTENDED;
+      case FieldDescriptor::TYPE_UINT32:
+        writer_->Uint(value.GetUInt32Value());
+        break;
+      case FieldDescriptor::TYPE_ENUM:
+        if (field->enum_type()->full_name() == "google.protobuf.NullValue") {
+          writer_->Null();
+        } else if (const auto* value_descriptor =
+                       field->enum_type()->FindValueByNumber(
+                           value.GetEnumValue());
+                   value_descriptor != nullptr) {
+          writer_->String(value_descriptor->name());
+        } else {
+          writer_->Int(value.GetEnumValue());
+        }
+        break;
+      case FieldDescriptor::TYPE_SFIXED32:
+        ABSL_FALLTHROUGH_INTENDED;
+      case FieldDescriptor::TYPE_SINT32:
+        ABSL_FALLTHROUGH_INTENDED;
+      case FieldDescriptor::TYPE_INT32:
+        writer_->Int(value.GetInt32Value());
+        break;
+      case FieldDescriptor::TYPE_SFIXED64:
+        ABSL_FALLTHROUGH_INTENDED;
+      case FieldDescriptor::TYPE_SINT64:
+        ABSL_FALLTHROUGH_INTENDED;
+      case FieldDescriptor::TYPE_INT64:
+        writer_->Int(value.GetInt64Value());
+        break;
+      default:
+        return absl::InvalidArgumentError(absl::StrCat(
+            "unexpected message field type: ", field->type_name()));
+    }
+    return absl::OkStatus();
+  }
+
+  absl::Status MessageRepeatedFieldToJson(
+      const google::protobuf::Message& message,
+      absl::Nonnull<const google::protobuf::FieldDescriptor*> field) {
+    const auto* reflection = message.GetReflection();
+    const int size = reflection->FieldSize(message, field);
+    writer_->BeginArray();
+    for (int index = 0; index < size; ++index) {
+      CEL_RETURN_IF_ERROR(
+          RepeatedFieldValueToJson(reflection, message, field, index));
+    }
+    writer_->EndArray();
+    return absl::OkStatus();
+  }
+
+  absl::Status RepeatedFieldValueToJson(
+      absl::Nonnull<const google::protobuf::Reflection*> reflection,
+      const google::protobuf::Message& message,
+      absl::Nonnull<const google::protobuf::FieldDescriptor*> field, int index) {
+    switch (field->type()) {
+      case FieldDescriptor::TYPE_DOUBLE:
+        writer_->Number(reflection->GetRepeatedDouble(message, field, index));
+        break;
+      case FieldDescriptor::TYPE_FLOAT:
+        writer_->Number(reflection->GetRepeatedFloat(message, field, index));
+        break;
+      case FieldDescriptor::TYPE_FIXED64:
+        ABSL_FALLTHROUGH_INTENDED;
+      case FieldDescriptor::TYPE_UINT64:
+        writer_->Uint(reflection->GetRepeatedUInt64(message, field, index));
+        break;
+      case FieldDescriptor::TYPE_BOOL:
+        writer_->Bool(reflection->GetRepeatedBool(message, field, index));
+        break;
+      case FieldDescriptor::TYPE_STRING:
+        StringValueToJsonText(GetRepeatedStringField(reflection, message,
+                                                     field, index, scratch_),
+                              writer_);
+        break;
+      case FieldDescriptor::TYPE_GROUP:
+        ABSL_FALLTHROUGH_INTENDED;
+      case FieldDescriptor::TYPE_MESSAGE:
+        return ToJson(reflection->GetRepeatedMessage(message, field, index));
+      case FieldDescriptor::TYPE_BYTES:
+        BytesValueToJsonText(GetRepeatedBytesField(reflection, message, field,
+                                                   index, scratch_),
+                             writer_);
+        break;
+      case FieldDescriptor::TYPE_FIXED32:
+        ABSL_FALLTHROUGH_INTENDED;
+      case FieldDescriptor::TYPE_UINT32:
+        writer_->Uint(reflection->GetRepeatedUInt32(message, field, index));
+        break;
+      case FieldDescriptor::TYPE_ENUM:
+        if (field->enum_type()->full_name() == "google.protobuf.NullValue") {
+          writer_->Null();
+        } else if (const auto* value =
+                       reflection->GetRepeatedEnum(message, field, index);
+                   value != nullptr) {
+          writer_->String(value->name());
+        } else {
+          writer_->Int(reflection->GetRepeatedEnumValue(message, field, index));
+        }
+        break;
+      case FieldDescriptor::TYPE_SFIXED32:
+        ABSL_FALLTHROUGH_INTENDED;
+      case FieldDescriptor::TYPE_SINT32:
+        ABSL_FALLTHROUGH_INTENDED;
+      case FieldDescriptor::TYPE_INT32:
+        writer_->Int(reflection->GetRepeatedInt32(message, field, index));
+        break;
+      case FieldDescriptor::TYPE_SFIXED64:
+        ABSL_FALLTHROUGH_INTENDED;
+      case FieldDescriptor::TYPE_SINT64:
+        ABSL_FALLTHROUGH_INTENDED;
+      case FieldDescriptor::TYPE_INT64:
+        writer_->Int(reflection->GetRepeatedInt64(message, field, index));
+        break;
+      default:
+        return absl::InvalidArgumentError(absl::StrCat(
+            "unexpected message field type: ", field->type_name()));
+    }
+    return absl::OkStatus();
+  }
+
+  absl::Nonnull<const google::protobuf::DescriptorPool*> const descriptor_pool_;
+  absl::Nonnull<google::protobuf::MessageFactory*> const message_factory_;
+  const absl::Nonnull<JsonWriter*> writer_;
+  std::string scratch_;
+  Reflection reflection_;
+};
+
+}  // namespace
+
+absl::Status MessageToJsonText(
+    const google::protobuf::Message& message,
+    absl::Nonnull<const google::protobuf::DescriptorPool*> descriptor_pool,
+    absl::Nonnull<google::protobuf::MessageFactory*> message_factory,
+    absl::Nonnull<JsonWriter*> writer) {
+  ABSL_DCHECK(descriptor_pool != nullptr);
+  ABSL_DCHECK(message_factory != nullptr);
+  ABSL_DCHECK(writer != nullptr);
+  return MessageToJsonTextState(descriptor_pool, message_factory, writer)
+      .ToJson(message);
+}
+
+absl::Status MessageFieldToJsonText(
+    const google::protobuf::Message& message,
+    absl::Nonnull<const google::protobuf::FieldDescriptor*> field,
+    absl::Nonnull<const google::protobuf::DescriptorPool*> descriptor_pool,
+    absl::Nonnull<google::protobuf::MessageFactory*> message_factory,
+    absl::Nonnull<JsonWriter*> writer) {
+  ABSL_DCHECK_EQ(field->containing_type(), message.GetDescriptor());
+  ABSL_DCHECK(descriptor_pool != nullptr);
+  ABSL_DCHECK(message_factory != nullptr);
+  ABSL_DCHECK(writer != nullptr);
+  return MessageToJsonTextState(descriptor_pool, message_factory, writer)
+      .MessageFieldToJson(message, field);
+}
+
+void JsonToJsonText(const google::protobuf::Value& message,
+                    absl::Nonnull<JsonWriter*> writer) {
+  JsonToJsonTextState(GeneratedJsonAccessor::Singleton(), writer)
+      .ValueToJsonText(message);
+}
+
+void JsonToJsonText(const google::protobuf::Message& message,
+                    absl::Nonnull<JsonWriter*> writer) {
+  if (const auto* generated_message =
+          google::protobuf::DynamicCastMessage<google::protobuf::Value>(&message);
+      generated_message) {
+    JsonToJsonText(*generated_message, writer);
+    return;
+  }
+  DynamicJsonAccessor accessor;
+  accessor.InitializeValue(message);
+  JsonToJsonTextState(&accessor, writer).ValueToJsonText(message);
+}
+
+void JsonListToJsonText(const google::protobuf::ListValue& message,
+                        absl::Nonnull<JsonWriter*> writer) {
+  JsonToJsonTextState(GeneratedJsonAccessor::Singleton(), writer)
+      .ListValueToJsonText(message);
+}
+
+void JsonListToJsonText(const google::protobuf::Message& message,
+                        absl::Nonnull<JsonWriter*> writer) {
+  if (const auto* generated_message =
+          google::protobuf::DynamicCastMessage<google::protobuf::ListValue>(&message);
+      generated_message) {
+    JsonListToJsonText(*generated_message, writer);
+    return;
+  }
+  DynamicJsonAccessor accessor;
+  accessor.InitializeListValue(message);
+  JsonToJsonTextState(&accessor, writer).ListValueToJsonText(message);
+}
+
+void JsonMapToJsonText(const google::protobuf::Struct& message,
+                       absl::Nonnull<JsonWriter*> writer) {
+  JsonToJsonTextState(GeneratedJsonAccessor::Singleton(), writer)
+      .StructToJsonText(message);
+}
+
+void JsonMapToJsonText(const google::protobuf::Message& message,
+                       absl::Nonnull<JsonWriter*> writer) {
+  if (const auto* generated_message =
+          google::protobuf::DynamicCastMessage<google::protobuf::Struct>(&message);
+      generated_message) {
+    JsonMapToJsonText(*generated_message, writer);
+    return;
+  }
+  DynamicJsonAccessor accessor;
+  accessor.InitializeStruct(message);
+  JsonToJsonTextState(&accessor, writer).StructToJsonText(message);
+}
+
+namespace {
+
 class JsonEqualsState final {
  public:
   explicit JsonEqualsState(absl::Nonnull<const JsonAccessor*> lhs_accessor,
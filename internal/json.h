@@ -22,6 +22,7 @@
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "common/json.h"
+#include "internal/json_writer.h"
 #include "google/protobuf/descriptor.h"
 #include "google/protobuf/message.h"
 
@@ -57,6 +58,46 @@ absl::Status MessageFieldToJson(
     absl::Nonnull<google::protobuf::MessageFactory*> message_factory,
     absl::Nonnull<google::protobuf::Message*> result);
 
+// Writes the given message as JSON text using `writer`. The result is the
+// serialization of what `MessageToJson()` produces, but no intermediate
+// `google.protobuf.Value` is built.
+absl::Status MessageToJsonText(
+    const google::protobuf::Message& message,
+    absl::Nonnull<const google::protobuf::DescriptorPool*> descriptor_pool,
+    absl::Nonnull<google::protobuf::MessageFactory*> message_factory,
+    absl::Nonnull<JsonWriter*> writer);
+
+// Writes the given message field as JSON text using `writer`. The result is
+// the serialization of what `MessageFieldToJson()` produces, but no
+// intermediate `google.protobuf.Value` is built.
+absl::Status MessageFieldToJsonText(
+    const google::protobuf::Message& message,
+    absl::Nonnull<const google::protobuf::FieldDescriptor*> field,
+    absl::Nonnull<const google::protobuf::DescriptorPool*> descriptor_pool,
+    absl::Nonnull<google::protobuf::MessageFactory*> message_factory,
+    absl::Nonnull<JsonWriter*> writer);
+
+// Writes the given instance of `google.protobuf.Value` as JSON text using
+// `writer`.
+void JsonToJsonText(const google::protobuf::Value& message,
+                    absl::Nonnull<JsonWriter*> writer);
+void JsonToJsonText(const google::protobuf::Message& message,
+                    absl::Nonnull<JsonWriter*> writer);
+
+// Writes the given instance of `google.protobuf.ListValue` as JSON text using
+// `writer`.
+void JsonListToJsonText(const google::protobuf::ListValue& message,
+                        absl::Nonnull<JsonWriter*> writer);
+void JsonListToJsonText(const google::protobuf::Message& message,
+                        absl::Nonnull<JsonWriter*> writer);
+
+// Writes the given instance of `google.protobuf.Struct` as JSON text using
+// `writer`.
+void JsonMapToJsonText(const google::protobuf::Struct& message,
+                       absl::Nonnull<JsonWriter*> writer);
+void JsonMapToJsonText(const google::protobuf::Message& message,
+                       absl::Nonnull<JsonWriter*> writer);
+
 // Checks that the instance of `google.protobuf.Value` has a descriptor which is
 // well formed.
 inline absl::Status CheckJson(const google::protobuf::Value&) {
@@ -0,0 +1,416 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "internal/json_tape.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/optimization.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/ascii.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "internal/status_macros.h"
+#include "internal/utf8.h"
+
+namespace cel::internal {
+
+namespace {
+
+// Bounds the nesting of arrays and objects, so that consumers which recurse
+// over the document do not exhaust the stack.
+constexpr size_t kMaxDepth = 1000;
+
+inline bool IsJsonWhitespace(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+// Parses the four hex digits of a `\u` escape. The digits must have been
+// validated already.
+inline char32_t ParseHex4(absl::string_view digits) {
+  char32_t value = 0;
+  for (char c : digits.substr(0, 4)) {
+    value <<= 4;
+    if (c >= '0' && c <= '9') {
+      value |= static_cast<char32_t>(c - '0');
+    } else {
+      value |= static_cast<char32_t>(absl::ascii_tolower(c) - 'a' + 10);
+    }
+  }
+  return value;
+}
+
+inline bool IsHighSurrogate(char32_t c) { return c >= 0xd800 && c <= 0xdbff; }
+
+inline bool IsLowSurrogate(char32_t c) { return c >= 0xdc00 && c <= 0xdfff; }
+
+}  // namespace
+
+class JsonTape::Parser final {
+ public:
+  Parser(absl::string_view text, std::vector<Node>& nodes)
+      : text_(text), nodes_(nodes) {}
+
+  absl::Status Parse() {
+    if (ABSL_PREDICT_FALSE(text_.size() >=
+                           std::numeric_limits<uint32_t>::max())) {
+      return absl::InvalidArgumentError("JSON document is too large");
+    }
+    // Open arrays and objects, innermost last.
+    std::vector<uint32_t> containers;
+    SkipWhitespace();
+    while (true) {
+      // Parse a value. Scalars fall through to the code after the switch,
+      // containers either continue with their first element or close
+      // immediately when empty.
+      if (ABSL_PREDICT_FALSE(pos_ == text_.size())) {
+        return Error("expected value");
+      }
+      switch (text_[pos_]) {
+        case '[':
+        case '{': {
+          const bool is_object = text_[pos_] == '{';
+          if (ABSL_PREDICT_FALSE(containers.size() == kMaxDepth)) {
+            return Error("nesting is too deep");
+          }
+          containers.push_back(AddNode(is_object ? Kind::kObject : Kind::kArray,
+                                       pos_, 0));
+          ++pos_;
+          SkipWhitespace();
+          if (pos_ < text_.size() && text_[pos_] == (is_object ? '}' : ']')) {
+            ++pos_;
+            CloseContainer(containers);
+            break;
+          }
+          if (is_object) {
+            CEL_RETURN_IF_ERROR(ParseKey());
+          }
+          continue;
+        }
+        case '"':
+          CEL_RETURN_IF_ERROR(ParseString());
+          break;
+        case 't':
+          CEL_RETURN_IF_ERROR(ParseLiteral("true", Kind::kTrue));
+          break;
+        case 'f':
+          CEL_RETURN_IF_ERROR(ParseLiteral("false", Kind::kFalse));
+          break;
+        case 'n':
+          CEL_RETURN_IF_ERROR(ParseLiteral("null", Kind::kNull));
+          break;
+        default:
+          CEL_RETURN_IF_ERROR(ParseNumber());
+          break;
+      }
+      // A value was completed. Continue with the next element or member of
+      // the innermost container, closing containers as they end.
+      while (true) {
+        SkipWhitespace();
+        if (containers.empty()) {
+          if (pos_ != text_.size()) {
+            return Error("unexpected trailing characters");
+          }
+          return absl::OkStatus();
+        }
+        Node& container = nodes_[containers.back()];
+        ++container.size;
+        const bool is_object = container.kind == Kind::kObject;
+        if (pos_ < text_.size() && text_[pos_] == ',') {
+          ++pos_;
+          SkipWhitespace();
+          if (is_object) {
+            CEL_RETURN_IF_ERROR(ParseKey());
+          }
+          break;
+        }
+        if (pos_ < text_.size() && text_[pos_] == (is_object ? '}' : ']')) {
+          ++pos_;
+          CloseContainer(containers);
+          continue;
+        }
+        return Error(is_object ? "expected ',' or '}'" : "expected ',' or ']'");
+      }
+    }
+  }
+
+ private:
+  uint32_t AddNode(Kind kind, size_t offset, size_t length) {
+    const auto index = static_cast<uint32_t>(nodes_.size());
+    nodes_.push_back(Node{kind, /*escaped=*/false, /*size=*/0,
+                          static_cast<uint32_t>(offset),
+                          static_cast<uint32_t>(length),
+                          /*next=*/index + 1});
+    return index;
+  }
+
+  void CloseContainer(std::vector<uint32_t>& containers) {
+    nodes_[containers.back()].next = static_cast<uint32_t>(nodes_.size());
+    containers.pop_back();
+  }
+
+  void SkipWhitespace() {
+    while (pos_ < text_.size() && IsJsonWhitespace(text_[pos_])) {
+      ++pos_;
+    }
+  }
+
+  absl::Status Error(absl::string_view message) const {
+    return absl::InvalidArgumentError(
+        absl::StrCat("invalid JSON at offset ", pos_, ": ", message));
+  }
+
+  // Parses an object key and the following colon.
+  absl::Status ParseKey() {
+    if (ABSL_PREDICT_FALSE(pos_ == text_.size() || text_[pos_] != '"')) {
+      return Error("expected string");
+    }
+    CEL_RETURN_IF_ERROR(ParseString());
+    SkipWhitespace();
+    if (ABSL_PREDICT_FALSE(pos_ == text_.size() || text_[pos_] != ':')) {
+      return Error("expected ':'");
+    }
+    ++pos_;
+    SkipWhitespace();
+    return absl::OkStatus();
+  }
+
+  absl::Status ParseLiteral(absl::string_view literal, Kind kind) {
+    if (ABSL_PREDICT_FALSE(text_.substr(pos_, literal.size()) != literal)) {
+      return Error("unexpected character");
+    }
+    AddNode(kind, pos_, literal.size());
+    pos_ += literal.size();
+    return absl::OkStatus();
+  }
+
+  absl::Status ParseNumber() {
+    const size_t begin = pos_;
+    auto is_digit = [this](size_t pos) {
+      return pos < text_.size() && absl::ascii_isdigit(text_[pos]);
+    };
+    auto skip_digits = [this, &is_digit]() {
+      while (is_digit(pos_)) {
+        ++pos_;
+      }
+    };
+    if (text_[pos_] == '-') {
+      ++pos_;
+    }
+    if (!is_digit(pos_)) {
+      return Error(begin == pos_ ? "unexpected character" : "expected digit");
+    }
+    if (text_[pos_] == '0') {
+      ++pos_;
+    } else {
+      skip_digits();
+    }
+    if (pos_ < text_.size() && text_[pos_] == '.') {
+      ++pos_;
+      if (!is_digit(pos_)) {
+        return Error("expected digit");
+      }
+      skip_digits();
+    }
+    if (pos_ < text_.size() && (text_[pos_] == 'e' || text_[pos_] == 'E')) {
+      ++pos_;
+      if (pos_ < text_.size() && (text_[pos_] == '+' || text_[pos_] == '-')) {
+        ++pos_;
+      }
+      if (!is_digit(pos_)) {
+        return Error("expected digit");
+      }
+      skip_digits();
+    }
+    AddNode(Kind::kNumber, begin, pos_ - begin);
+    return absl::OkStatus();
+  }
+
+  absl::Status ParseString() {
+    // Skip the opening quote.
+    const size_t begin = ++pos_;
+    bool escaped = false;
+    bool ascii = true;
+    while (true) {
+      // Skip eight plain ASCII characters at a time, which is the common case
+      // for keys and most values.
+      pos_ = json_tape_internal::SkipPlainStringBytes(text_, pos_);
+      if (ABSL_PREDICT_FALSE(pos_ == text_.size())) {
+        return Error("unterminated string");
+      }
+      const auto c = static_cast<unsigned char>(text_[pos_]);
+      if (c == '"') {
+        break;
+      }
+      if (c == '\\') {
+        escaped = true;
+        CEL_RETURN_IF_ERROR(ParseEscape());
+        continue;
+      }
+      if (ABSL_PREDICT_FALSE(c < 0x20)) {
+        return Error("unescaped control character in string");
+      }
+      if (c >= 0x80) {
+        ascii = false;
+      }
+      ++pos_;
+    }
+    const absl::string_view raw = text_.substr(begin, pos_ - begin);
+    // Escape sequences are ASCII, so validating the raw text validates every
+    // character that was not escaped.
+    if (!ascii && ABSL_PREDICT_FALSE(!Utf8IsValid(raw))) {
+      return Error("invalid UTF-8 in string");
+    }
+    const uint32_t index = AddNode(Kind::kString, begin, raw.size());
+    nodes_[index].escaped = escaped;
+    // Skip the closing quote.
+    ++pos_;
+    return absl::OkStatus();
+  }
+
+  // Validates the escape sequence at `pos_` and skips past it.
+  absl::Status ParseEscape() {
+    if (ABSL_PREDICT_FALSE(pos_ + 1 == text_.size())) {
+      return Error("unterminated string");
+    }
+    switch (text_[pos_ + 1]) {
+      case '"':
+      case '\\':
+      case '/':
+      case 'b':
+      case 'f':
+      case 'n':
+      case 'r':
+      case 't':
+        pos_ += 2;
+        return absl::OkStatus();
+      case 'u':
+        break;
+      default:
+        return Error("invalid escape sequence");
+    }
+    CEL_ASSIGN_OR_RETURN(char32_t code_unit, ParseUnicodeEscape());
+    if (IsLowSurrogate(code_unit)) {
+      return Error("unpaired surrogate");
+    }
+    if (IsHighSurrogate(code_unit)) {
+      if (text_.substr(pos_, 2) != "\\u") {
+        return Error("unpaired surrogate");
+      }
+      CEL_ASSIGN_OR_RETURN(code_unit, ParseUnicodeEscape());
+      if (!IsLowSurrogate(code_unit)) {
+        return Error("unpaired surrogate");
+      }
+    }
+    return absl::OkStatus();
+  }
+
+  // Parses a `\uXXXX` escape at `pos_` and skips past it.
+  absl::StatusOr<char32_t> ParseUnicodeEscape() {
+    const absl::string_view digits = text_.substr(pos_ + 2, 4);
+    if (digits.size() != 4) {
+      return Error("invalid escape sequence");
+    }
+    for (char c : digits) {
+      if (!absl::ascii_isxdigit(c)) {
+        return Error("invalid escape sequence");
+      }
+    }
+    pos_ += 6;
+    return ParseHex4(digits);
+  }
+
+  const absl::string_view text_;
+  std::vector<Node>& nodes_;
+  size_t pos_ = 0;
+};
+
+absl::StatusOr<JsonTape> JsonTape::Parse(absl::string_view text) {
+  JsonTape tape;
+  CEL_RETURN_IF_ERROR(Parser(text, tape.nodes_).Parse());
+  return tape;
+}
+
+void JsonTape::AppendString(absl::string_view text, const Node& node,
+                            std::string& out) {
+  absl::string_view raw = RawString(text, node);
+  if (!node.escaped) {
+    out.append(raw.data(), raw.size());
+    return;
+  }
+  out.reserve(out.size() + raw.size());
+  while (!raw.empty()) {
+    const size_t backslash = raw.find('\\');
+    if (backslash == absl::string_view::npos) {
+      out.append(raw.data(), raw.size());
+      break;
+    }
+    out.append(raw.data(), backslash);
+    raw.remove_prefix(backslash);
+    switch (raw[1]) {
+      case 'b':
+        out.push_back('\b');
+        break;
+      case 'f':
+        out.push_back('\f');
+        break;
+      case 'n':
+        out.push_back('\n');
+        break;
+      case 'r':
+        out.push_back('\r');
+        break;
+      case 't':
+        out.push_back('\t');
+        break;
+      case 'u': {
+        char32_t code_point = ParseHex4(raw.substr(2));
+        raw.remove_prefix(6);
+        if (IsHighSurrogate(code_point)) {
+          // Validated by the parser to be followed by a low surrogate.
+          code_point = 0x10000 + ((code_point - 0xd800) << 10) +
+                       (ParseHex4(raw.substr(2)) - 0xdc00);
+          raw.remove_prefix(6);
+        }
+        Utf8Encode(out, code_point);
+        continue;
+      }
+      default:
+        // '"', '\\' and '/' stand for themselves.
+        out.push_back(raw[1]);
+        break;
+    }
+    raw.remove_prefix(2);
+  }
+}
+
+double JsonTape::Number(absl::string_view text, const Node& node) {
+  double value;
+  if (!absl::SimpleAtod(text.substr(node.offset, node.length), &value)) {
+    // The grammar was validated by the parser, so this can only be a number
+    // whose magnitude is out of range.
+    value = text[node.offset] == '-' ? -std::numeric_limits<double>::infinity()
+                                     : std::numeric_limits<double>::infinity();
+  }
+  return value;
+}
+
+}  // namespace cel::internal
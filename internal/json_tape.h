@@ -0,0 +1,139 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_INTERNAL_JSON_TAPE_H_
+#define THIRD_PARTY_CEL_CPP_INTERNAL_JSON_TAPE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+
+namespace cel::internal {
+
+// Structural index over a JSON document (RFC 8259).
+//
+// Parsing validates the whole document but only records where each value
+// starts and how far its subtree extends, so that consumers can skip over
+// arrays and objects they do not need and convert strings and numbers only
+// when they are read. Nodes refer to the text by offset; the text itself is
+// not retained and must be passed back to the accessors.
+//
+// Nodes are stored in document order. An array node is followed by its
+// elements, and an object node by alternating key and value nodes. The `next`
+// field of every node is the index one past the end of its subtree, which is
+// the index of its next sibling if there is one.
+class JsonTape final {
+ public:
+  enum class Kind : uint8_t {
+    kNull,
+    kFalse,
+    kTrue,
+    kNumber,
+    kString,
+    kArray,
+    kObject,
+  };
+
+  struct Node {
+    Kind kind;
+    // Strings only: the string contains escape sequences, so its raw text
+    // differs from its value.
+    bool escaped;
+    // Arrays and objects only: the number of elements or members.
+    uint32_t size;
+    // Strings: the offset and length of the text between the quotes.
+    // Numbers: the offset and length of the number.
+    uint32_t offset;
+    uint32_t length;
+    uint32_t next;
+  };
+
+  // Parses `text`. Returns `InvalidArgumentError` if `text` is not a single
+  // valid JSON value, or if any string is not valid UTF-8 or contains an
+  // unpaired surrogate escape.
+  static absl::StatusOr<JsonTape> Parse(absl::string_view text);
+
+  JsonTape(const JsonTape&) = default;
+  JsonTape(JsonTape&&) = default;
+  JsonTape& operator=(const JsonTape&) = default;
+  JsonTape& operator=(JsonTape&&) = default;
+
+  absl::Span<const Node> nodes() const { return nodes_; }
+
+  const Node& node(size_t index) const { return nodes_[index]; }
+
+  // Returns the text between the quotes of string `node`. This is the value of
+  // the string unless `node.escaped` is true.
+  static absl::string_view RawString(absl::string_view text, const Node& node) {
+    return text.substr(node.offset, node.length);
+  }
+
+  // Appends the value of string `node` to `out`, decoding escape sequences.
+  static void AppendString(absl::string_view text, const Node& node,
+                           std::string& out);
+
+  // Returns the value of number `node`.
+  static double Number(absl::string_view text, const Node& node);
+
+ private:
+  class Parser;
+
+  JsonTape() = default;
+
+  std::vector<Node> nodes_;
+};
+
+namespace json_tape_internal {
+
+inline constexpr uint64_t kOnes = 0x0101010101010101;
+inline constexpr uint64_t kHighBits = 0x8080808080808080;
+
+// Returns a non-zero value if any of the eight bytes in `word` needs attention
+// while scanning a string: a quote, a backslash, a control character or the
+// start of a multi-byte UTF-8 sequence. May report bytes after the first such
+// byte spuriously, which is fine as the caller rescans the word bytewise.
+constexpr uint64_t StringSpecialBytes(uint64_t word) {
+  const uint64_t quote = word ^ (kOnes * '"');
+  const uint64_t backslash = word ^ (kOnes * '\\');
+  return ((quote - kOnes) & ~quote & kHighBits) |
+         ((backslash - kOnes) & ~backslash & kHighBits) |
+         ((word - kOnes * 0x20) & ~word & kHighBits) | (word & kHighBits);
+}
+
+// Returns the position of the first word at or after `pos` in `text` that
+// contains a byte reported by `StringSpecialBytes`, or of the last partial
+// word. Skips eight plain ASCII characters at a time.
+inline size_t SkipPlainStringBytes(absl::string_view text, size_t pos) {
+  while (text.size() - pos >= sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, text.data() + pos, sizeof(word));
+    if (StringSpecialBytes(word) != 0) {
+      break;
+    }
+    pos += sizeof(word);
+  }
+  return pos;
+}
+
+}  // namespace json_tape_internal
+
+}  // namespace cel::internal
+
+#endif  // THIRD_PARTY_CEL_CPP_INTERNAL_JSON_TAPE_H_
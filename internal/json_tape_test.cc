@@ -0,0 +1,230 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "internal/json_tape.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+
+#include "absl/status/status.h"
+#include "absl/strings/escaping.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "internal/testing.h"
+
+namespace cel::internal {
+namespace {
+
+using ::absl_testing::StatusIs;
+using ::testing::DoubleEq;
+using ::testing::HasSubstr;
+using ::testing::SizeIs;
+
+using ::cel::internal::json_tape_internal::SkipPlainStringBytes;
+using ::cel::internal::json_tape_internal::StringSpecialBytes;
+
+using Kind = JsonTape::Kind;
+
+uint64_t Word(absl::string_view bytes) {
+  uint64_t word = 0;
+  std::memcpy(&word, bytes.data(), sizeof(word));
+  return word;
+}
+
+std::string StringAt(absl::string_view text, const JsonTape& tape,
+                     size_t index) {
+  std::string out;
+  JsonTape::AppendString(text, tape.node(index), out);
+  return out;
+}
+
+TEST(JsonTape, Scalars) {
+  ASSERT_OK_AND_ASSIGN(auto tape, JsonTape::Parse(" null "));
+  ASSERT_THAT(tape.nodes(), SizeIs(1));
+  EXPECT_EQ(tape.node(0).kind, Kind::kNull);
+
+  ASSERT_OK_AND_ASSIGN(tape, JsonTape::Parse("true"));
+  EXPECT_EQ(tape.node(0).kind, Kind::kTrue);
+
+  ASSERT_OK_AND_ASSIGN(tape, JsonTape::Parse("false"));
+  EXPECT_EQ(tape.node(0).kind, Kind::kFalse);
+
+  ASSERT_OK_AND_ASSIGN(tape, JsonTape::Parse("\"hello\""));
+  EXPECT_EQ(tape.node(0).kind, Kind::kString);
+  EXPECT_FALSE(tape.node(0).escaped);
+  EXPECT_EQ(JsonTape::RawString("\"hello\"", tape.node(0)), "hello");
+}
+
+TEST(JsonTape, Numbers) {
+  for (absl::string_view text :
+       {"0", "-0", "1", "-12", "1.5", "-0.25", "1e3", "1E+3", "25e-2"}) {
+    ASSERT_OK_AND_ASSIGN(auto tape, JsonTape::Parse(text));
+    ASSERT_EQ(tape.node(0).kind, Kind::kNumber) << text;
+  }
+  ASSERT_OK_AND_ASSIGN(auto tape, JsonTape::Parse("-12.5e1"));
+  EXPECT_THAT(JsonTape::Number("-12.5e1", tape.node(0)), DoubleEq(-125));
+  ASSERT_OK_AND_ASSIGN(tape, JsonTape::Parse("1e400"));
+  EXPECT_EQ(JsonTape::Number("1e400", tape.node(0)),
+            std::numeric_limits<double>::infinity());
+
+  for (absl::string_view text :
+       {"01", "-", "+1", "1.", ".5", "1e", "1e+", "0x1", "NaN", "Infinity"}) {
+    EXPECT_THAT(JsonTape::Parse(text),
+                StatusIs(absl::StatusCode::kInvalidArgument))
+        << text;
+  }
+}
+
+TEST(JsonTape, Strings) {
+  constexpr absl::string_view kText =
+      R"json(["a\"b\\c\/d\b\f\n\r\t", "\u00e9\u4e2d\ud83d\ude00", "caf)json"
+      "\xc3\xa9"
+      R"json(", "a long string without any escapes at all"])json";
+  ASSERT_OK_AND_ASSIGN(auto tape, JsonTape::Parse(kText));
+  ASSERT_THAT(tape.nodes(), SizeIs(5));
+  EXPECT_TRUE(tape.node(1).escaped);
+  EXPECT_EQ(StringAt(kText, tape, 1), "a\"b\\c/d\b\f\n\r\t");
+  EXPECT_TRUE(tape.node(2).escaped);
+  EXPECT_EQ(StringAt(kText, tape, 2),
+            "\xc3\xa9\xe4\xb8\xad\xf0\x9f\x98\x80");
+  EXPECT_FALSE(tape.node(3).escaped);
+  EXPECT_EQ(JsonTape::RawString(kText, tape.node(3)), "caf\xc3\xa9");
+  EXPECT_FALSE(tape.node(4).escaped);
+  EXPECT_EQ(JsonTape::RawString(kText, tape.node(4)),
+            "a long string without any escapes at all");
+}
+
+TEST(JsonTape, InvalidStrings) {
+  for (absl::string_view text : {
+           "\"abc",
+           "\"abcdefghijklmnop",
+           "\"a\\\"",
+           "\"\\x\"",
+           "\"\\u12\"",
+           "\"\\u12g4\"",
+           "\"\\ud83d\"",
+           "\"\\ude00\"",
+           "\"\\ud83d\\u0041\"",
+           "\"tab\there\"",
+           "\"\xc3\"",
+           "\"0123456789\xff\"",
+       }) {
+    EXPECT_THAT(JsonTape::Parse(text),
+                StatusIs(absl::StatusCode::kInvalidArgument))
+        << text;
+  }
+}
+
+TEST(JsonTape, Containers) {
+  constexpr absl::string_view kText =
+      R"json({"a": [1, {}, []], "b": {"c": null}, "d": "e"})json";
+  ASSERT_OK_AND_ASSIGN(auto tape, JsonTape::Parse(kText));
+  // {, "a", [, 1, {}, [], "b", {, "c", null, "d", "e"
+  ASSERT_THAT(tape.nodes(), SizeIs(12));
+
+  EXPECT_EQ(tape.node(0).kind, Kind::kObject);
+  EXPECT_EQ(tape.node(0).size, 3);
+  EXPECT_EQ(tape.node(0).next, 12);
+
+  EXPECT_EQ(StringAt(kText, tape, 1), "a");
+  EXPECT_EQ(tape.node(2).kind, Kind::kArray);
+  EXPECT_EQ(tape.node(2).size, 3);
+  EXPECT_EQ(tape.node(2).next, 6);
+  EXPECT_EQ(tape.node(3).kind, Kind::kNumber);
+  EXPECT_EQ(tape.node(4).kind, Kind::kObject);
+  EXPECT_EQ(tape.node(4).size, 0);
+  EXPECT_EQ(tape.node(4).next, 5);
+  EXPECT_EQ(tape.node(5).kind, Kind::kArray);
+  EXPECT_EQ(tape.node(5).size, 0);
+  EXPECT_EQ(tape.node(5).next, 6);
+
+  EXPECT_EQ(StringAt(kText, tape, 6), "b");
+  EXPECT_EQ(tape.node(7).kind, Kind::kObject);
+  EXPECT_EQ(tape.node(7).size, 1);
+  EXPECT_EQ(tape.node(7).next, 10);
+
+  EXPECT_EQ(StringAt(kText, tape, 10), "d");
+  EXPECT_EQ(StringAt(kText, tape, 11), "e");
+}
+
+TEST(JsonTape, InvalidDocuments) {
+  for (absl::string_view text : {
+           "",
+           " ",
+           "[",
+           "[1,]",
+           "[1 2]",
+           "{",
+           "{\"a\"}",
+           "{\"a\":}",
+           "{\"a\":1,}",
+           "{1:2}",
+           "[1]]",
+           "nul",
+           "truex",
+           "1 2",
+           "{\"a\":1]",
+       }) {
+    EXPECT_THAT(JsonTape::Parse(text),
+                StatusIs(absl::StatusCode::kInvalidArgument))
+        << text;
+  }
+}
+
+TEST(JsonTape, NestingLimit) {
+  std::string text = absl::StrCat(std::string(1000, '['), "1",
+                                  std::string(1000, ']'));
+  EXPECT_OK(JsonTape::Parse(text));
+
+  text = absl::StrCat(std::string(1001, '['), std::string(1001, ']'));
+  EXPECT_THAT(JsonTape::Parse(text),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("nesting is too deep")));
+}
+
+TEST(JsonTape, StringSpecialBytesIgnoresPlainAscii) {
+  for (absl::string_view bytes :
+       {"abcdefgh", "ffffffff", "01234567", "        ", "{}[]:,!#", "~~~~~~~~",
+        "ABC xyz!", "a/b#c$d%"}) {
+    EXPECT_EQ(StringSpecialBytes(Word(bytes)), 0) << bytes;
+  }
+}
+
+TEST(JsonTape, StringSpecialBytesReportsSpecialBytes) {
+  for (absl::string_view bytes :
+       {"\"abcdefg", "abcdefg\"", "abc\"defg", "\\abcdefg", "abcdefg\\",
+        "abc\\defg", "abcdefg\x1f", "abc\ndefg", "abcdefg\x01",
+        "abc\xc3\xa9" "xyz", "abcdefg\x80",
+        "\xff\xff\xff\xff\xff\xff\xff\xff"}) {
+    EXPECT_NE(StringSpecialBytes(Word(bytes)), 0) << absl::CEscape(bytes);
+  }
+  EXPECT_NE(StringSpecialBytes(Word(absl::string_view("\0abcdefg", 8))), 0);
+}
+
+TEST(JsonTape, SkipsPlainAsciiWordAtATime) {
+  const std::string text =
+      absl::StrCat(std::string(1000, 'f'), "\"", std::string(100, 'a'));
+  const size_t pos = SkipPlainStringBytes(text, 0);
+  EXPECT_LE(pos, 1000);
+  EXPECT_GT(pos + sizeof(uint64_t), 1000);
+
+  // Stops at the last partial word.
+  EXPECT_EQ(SkipPlainStringBytes(std::string(13, 'a'), 0), 8);
+}
+
+}  // namespace
+}  // namespace cel::internal
@@ -0,0 +1,227 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "internal/json_writer.h"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "absl/strings/cord.h"
+#include "absl/strings/escaping.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/string_view.h"
+#include "common/json.h"
+
+namespace cel::internal {
+
+namespace {
+
+// Largest magnitude for which every integral double has an exact int64_t
+// representation that round trips through text.
+constexpr double kMaxExactIntegralDouble = 9007199254740992.0;  // 2^53
+
+bool NeedsEscape(char c) {
+  return static_cast<unsigned char>(c) < 0x20 || c == '"' || c == '\\';
+}
+
+}  // namespace
+
+void JsonWriter::BeginValue() {
+  if (after_key_) {
+    after_key_ = false;
+  } else if (needs_comma_) {
+    output_->push_back(',');
+  }
+  needs_comma_ = true;
+}
+
+void JsonWriter::Null() {
+  BeginValue();
+  output_->append("null");
+}
+
+void JsonWriter::Bool(bool value) {
+  BeginValue();
+  output_->append(value ? "true" : "false");
+}
+
+void JsonWriter::Number(double value) {
+  if (std::isnan(value)) {
+    String("NaN");
+    return;
+  }
+  if (std::isinf(value)) {
+    String(value > 0 ? "Infinity" : "-Infinity");
+    return;
+  }
+  BeginValue();
+  // Negative zero is not integral as far as JSON is concerned: it takes the
+  // path below to keep its sign, like `ConvertToJson` does.
+  if (std::trunc(value) == value &&
+      std::abs(value) <= kMaxExactIntegralDouble &&
+      !(value == 0 && std::signbit(value))) {
+    absl::StrAppend(output_, static_cast<int64_t>(value));
+    return;
+  }
+  // Use the shortest of the two precisions that round trips, like
+  // `google::protobuf::io::SimpleDtoa()`.
+  char buffer[32];
+  int length = absl::SNPrintF(buffer, sizeof(buffer), "%.15g", value);
+  double parsed;
+  if (!absl::SimpleAtod(absl::string_view(buffer, length), &parsed) ||
+      parsed != value) {
+    length = absl::SNPrintF(buffer, sizeof(buffer), "%.17g", value);
+  }
+  output_->append(buffer, static_cast<size_t>(length));
+}
+
+void JsonWriter::Int(int64_t value) {
+  BeginValue();
+  if (value < kJsonMinInt || value > kJsonMaxInt) {
+    output_->push_back('"');
+    absl::StrAppend(output_, value);
+    output_->push_back('"');
+    return;
+  }
+  absl::StrAppend(output_, value);
+}
+
+void JsonWriter::Uint(uint64_t value) {
+  BeginValue();
+  if (value > kJsonMaxUint) {
+    output_->push_back('"');
+    absl::StrAppend(output_, value);
+    output_->push_back('"');
+    return;
+  }
+  absl::StrAppend(output_, value);
+}
+
+void JsonWriter::String(absl::string_view value) {
+  BeginValue();
+  output_->push_back('"');
+  AppendEscaped(value);
+  output_->push_back('"');
+}
+
+void JsonWriter::String(const absl::Cord& value) {
+  BeginValue();
+  output_->push_back('"');
+  for (absl::string_view chunk : value.Chunks()) {
+    AppendEscaped(chunk);
+  }
+  output_->push_back('"');
+}
+
+void JsonWriter::Bytes(absl::string_view value) {
+  BeginValue();
+  output_->push_back('"');
+  output_->append(absl::Base64Escape(value));
+  output_->push_back('"');
+}
+
+void JsonWriter::Bytes(const absl::Cord& value) {
+  if (auto flat = value.TryFlat(); flat) {
+    Bytes(*flat);
+    return;
+  }
+  Bytes(static_cast<std::string>(value));
+}
+
+void JsonWriter::BeginArray() {
+  BeginValue();
+  output_->push_back('[');
+  needs_comma_ = false;
+}
+
+void JsonWriter::EndArray() {
+  output_->push_back(']');
+  needs_comma_ = true;
+}
+
+void JsonWriter::BeginObject() {
+  BeginValue();
+  output_->push_back('{');
+  needs_comma_ = false;
+}
+
+void JsonWriter::Key(absl::string_view name) {
+  String(name);
+  output_->push_back(':');
+  after_key_ = true;
+}
+
+void JsonWriter::Key(const absl::Cord& name) {
+  String(name);
+  output_->push_back(':');
+  after_key_ = true;
+}
+
+void JsonWriter::EndObject() {
+  output_->push_back('}');
+  needs_comma_ = true;
+}
+
+void JsonWriter::AppendEscaped(absl::string_view value) {
+  static constexpr char kHexDigits[] = "0123456789abcdef";
+  size_t begin = 0;
+  for (size_t i = 0; i < value.size(); ++i) {
+    const char c = value[i];
+    if (!NeedsEscape(c)) {
+      continue;
+    }
+    output_->append(value.data() + begin, i - begin);
+    begin = i + 1;
+    switch (c) {
+      case '"':
+        output_->append("\\\"");
+        break;
+      case '\\':
+        output_->append("\\\\");
+        break;
+      case '\b':
+        output_->append("\\b");
+        break;
+      case '\f':
+        output_->append("\\f");
+        break;
+      case '\n':
+        output_->append("\\n");
+        break;
+      case '\r':
+        output_->append("\\r");
+        break;
+      case '\t':
+        output_->append("\\t");
+        break;
+      default: {
+        const auto byte = static_cast<unsigned char>(c);
+        const char escape[] = {'\\',
+                               'u',
+                               '0',
+                               '0',
+                               kHexDigits[byte >> 4],
+                               kHexDigits[byte & 0xf]};
+        output_->append(escape, sizeof(escape));
+      } break;
+    }
+  }
+  output_->append(value.data() + begin, value.size() - begin);
+}
+
+}  // namespace cel::internal
@@ -0,0 +1,85 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_INTERNAL_JSON_WRITER_H_
+#define THIRD_PARTY_CEL_CPP_INTERNAL_JSON_WRITER_H_
+
+#include <cstdint>
+#include <string>
+
+#include "absl/base/nullability.h"
+#include "absl/strings/cord.h"
+#include "absl/strings/string_view.h"
+
+namespace cel::internal {
+
+// Appends compact JSON text (RFC 8259) to a caller owned string.
+//
+// Values are written in document order: arrays and objects are opened, their
+// contents written and then closed, with `Key()` preceding each object member.
+// The writer only tracks what is needed to place separators, so it does not
+// validate that calls are well nested.
+//
+// Numbers follow the `google.protobuf.Value` conventions used elsewhere:
+// integers outside of [-(2^53-1), 2^53-1] are written as strings, as are
+// non-finite doubles ("NaN", "Infinity" and "-Infinity").
+class JsonWriter final {
+ public:
+  explicit JsonWriter(absl::Nonnull<std::string*> output) : output_(output) {}
+
+  JsonWriter(const JsonWriter&) = delete;
+  JsonWriter& operator=(const JsonWriter&) = delete;
+
+  void Null();
+
+  void Bool(bool value);
+
+  void Number(double value);
+
+  void Int(int64_t value);
+
+  void Uint(uint64_t value);
+
+  void String(absl::string_view value);
+  void String(const absl::Cord& value);
+
+  // Writes `value` as a base64 encoded string.
+  void Bytes(absl::string_view value);
+  void Bytes(const absl::Cord& value);
+
+  void BeginArray();
+  void EndArray();
+
+  void BeginObject();
+  void Key(absl::string_view name);
+  void Key(const absl::Cord& name);
+  void EndObject();
+
+  absl::Nonnull<std::string*> output() const { return output_; }
+
+ private:
+  void BeginValue();
+
+  void AppendEscaped(absl::string_view value);
+
+  const absl::Nonnull<std::string*> output_;
+  // Whether the next value or key needs a preceding comma.
+  bool needs_comma_ = false;
+  // Whether the next value is the value of an object member.
+  bool after_key_ = false;
+};
+
+}  // namespace cel::internal
+
+#endif  // THIRD_PARTY_CEL_CPP_INTERNAL_JSON_WRITER_H_
@@ -0,0 +1,121 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "internal/json_writer.h"
+
+#include <cstdint>
+#include <limits>
+#include <string>
+
+#include "absl/strings/cord.h"
+#include "absl/strings/cord_test_helpers.h"
+#include "absl/strings/string_view.h"
+#include "internal/testing.h"
+
+namespace cel::internal {
+namespace {
+
+TEST(JsonWriter, Scalars) {
+  std::string output;
+  JsonWriter writer(&output);
+  writer.BeginArray();
+  writer.Null();
+  writer.Bool(true);
+  writer.Bool(false);
+  writer.EndArray();
+  EXPECT_EQ(output, "[null,true,false]");
+}
+
+TEST(JsonWriter, Numbers) {
+  std::string output;
+  JsonWriter writer(&output);
+  writer.BeginArray();
+  writer.Number(0);
+  writer.Number(-0.0);
+  writer.Number(-3);
+  writer.Number(1.5);
+  writer.Number(0.1);
+  writer.Number(1e300);
+  writer.Number(1.0 / 3.0);
+  writer.Number(std::numeric_limits<double>::quiet_NaN());
+  writer.Number(std::numeric_limits<double>::infinity());
+  writer.Number(-std::numeric_limits<double>::infinity());
+  writer.EndArray();
+  EXPECT_EQ(output,
+            "[0,-0,-3,1.5,0.1,1e+300,0.33333333333333331,\"NaN\",\"Infinity\","
+            "\"-Infinity\"]");
+}
+
+TEST(JsonWriter, Integers) {
+  std::string output;
+  JsonWriter writer(&output);
+  writer.BeginArray();
+  writer.Int(-42);
+  writer.Int(int64_t{1} << 53);
+  writer.Int(std::numeric_limits<int64_t>::min());
+  writer.Uint(42);
+  writer.Uint(std::numeric_limits<uint64_t>::max());
+  writer.EndArray();
+  EXPECT_EQ(output,
+            "[-42,\"9007199254740992\",\"-9223372036854775808\",42,"
+            "\"18446744073709551615\"]");
+}
+
+TEST(JsonWriter, Strings) {
+  std::string output;
+  JsonWriter writer(&output);
+  writer.BeginArray();
+  writer.String("plain");
+  writer.String(absl::string_view("q\"b\\n\n\t\x01\x1f\xc3\xa9", 11));
+  writer.String(absl::MakeFragmentedCord({"fragm", "ented\n"}));
+  writer.Bytes("foo");
+  writer.Bytes(absl::MakeFragmentedCord({"f", "oo"}));
+  writer.EndArray();
+  EXPECT_EQ(output,
+            "[\"plain\",\"q\\\"b\\\\n\\n\\t\\u0001\\u001f\xc3\xa9\","
+            "\"fragmented\\n\",\"Zm9v\",\"Zm9v\"]");
+}
+
+TEST(JsonWriter, Containers) {
+  std::string output;
+  JsonWriter writer(&output);
+  writer.BeginObject();
+  writer.Key("a");
+  writer.BeginArray();
+  writer.BeginArray();
+  writer.EndArray();
+  writer.BeginObject();
+  writer.EndObject();
+  writer.Int(1);
+  writer.EndArray();
+  writer.Key(absl::Cord("b"));
+  writer.BeginObject();
+  writer.Key("c");
+  writer.Null();
+  writer.Key("d");
+  writer.String("e");
+  writer.EndObject();
+  writer.EndObject();
+  EXPECT_EQ(output, R"json({"a":[[],{},1],"b":{"c":null,"d":"e"}})json");
+}
+
+TEST(JsonWriter, Appends) {
+  std::string output = "prefix ";
+  JsonWriter writer(&output);
+  writer.Int(1);
+  EXPECT_EQ(output, "prefix 1");
+}
+
+}  // namespace
+}  // namespace cel::internal
@@ -14,6 +14,7 @@
 
 #include "internal/message_equality.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <functional>
@@ -21,16 +22,21 @@
 #include <memory>
 #include <string>
 #include <type_traits>
+#include <vector>
 
 #include "absl/base/attributes.h"
+#include "absl/base/no_destructor.h"
 #include "absl/base/nullability.h"
 #include "absl/base/optimization.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/functional/overload.h"
 #include "absl/log/absl_check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/time/time.h"
 #include "absl/types/variant.h"
 #include "common/memory.h"
@@ -57,6 +63,7 @@ using ::google::protobuf::DescriptorPool;
 using ::google::protobuf::FieldDescriptor;
 using ::google::protobuf::Message;
 using ::google::protobuf::MessageFactory;
+using ::google::protobuf::Reflection;
 using ::google::protobuf::util::MessageDifferencer;
 
 class EquatableListValue final
@@ -269,10 +276,423 @@ struct AnyEqualer {
   }
 };
 
+// `MessageEqualityPlan` is the precompiled form of `MessageDifferencer::Equals`
+// for a single message type. It is used to compare messages which are not well
+// known types, which is the common case when policies compare nested messages
+// with `==`. Field descriptors, map value fields and nested plans are resolved
+// once per type, rather than on every comparison, and fields are ordered so
+// that the cheapest comparisons happen first.
+//
+// The comparison is equivalent to the default `MessageDifferencer`: singular
+// fields must agree on presence, floating point values are compared exactly,
+// repeated fields are compared in order, and map fields are compared by key.
+// Messages which cannot be handled by the plan (`google.protobuf.Any`, types
+// with extensions, and messages with unknown fields) are delegated to
+// `MessageDifferencer`.
+struct MessageEqualityPlan;
+
+enum class FieldEqualityKind {
+  kInt32,
+  kInt64,
+  kUint32,
+  kUint64,
+  kDouble,
+  kFloat,
+  kBool,
+  kEnum,
+  kString,
+  kMessage,
+};
+
+struct FieldEqualityPlan final {
+  absl::Nonnull<const FieldDescriptor*> field;
+  // For map fields this is the kind of the entry value.
+  FieldEqualityKind kind;
+  // For map fields, the value field of the entry.
+  absl::Nullable<const FieldDescriptor*> map_value_field = nullptr;
+  // For message fields, or map fields with message values, the plan for the
+  // message type.
+  absl::Nullable<const MessageEqualityPlan*> message_plan = nullptr;
+};
+
+struct MessageEqualityPlan final {
+  // If true, `MessageDifferencer` is used instead of `fields`.
+  bool use_differencer = false;
+  std::vector<FieldEqualityPlan> fields;
+};
+
+FieldEqualityKind GetFieldEqualityKind(
+    absl::Nonnull<const FieldDescriptor*> field) {
+  switch (field->cpp_type()) {
+    case FieldDescriptor::CPPTYPE_INT32:
+      return FieldEqualityKind::kInt32;
+    case FieldDescriptor::CPPTYPE_INT64:
+      return FieldEqualityKind::kInt64;
+    case FieldDescriptor::CPPTYPE_UINT32:
+      return FieldEqualityKind::kUint32;
+    case FieldDescriptor::CPPTYPE_UINT64:
+      return FieldEqualityKind::kUint64;
+    case FieldDescriptor::CPPTYPE_DOUBLE:
+      return FieldEqualityKind::kDouble;
+    case FieldDescriptor::CPPTYPE_FLOAT:
+      return FieldEqualityKind::kFloat;
+    case FieldDescriptor::CPPTYPE_BOOL:
+      return FieldEqualityKind::kBool;
+    case FieldDescriptor::CPPTYPE_ENUM:
+      return FieldEqualityKind::kEnum;
+    case FieldDescriptor::CPPTYPE_STRING:
+      return FieldEqualityKind::kString;
+    case FieldDescriptor::CPPTYPE_MESSAGE:
+      return FieldEqualityKind::kMessage;
+    default:
+      ABSL_UNREACHABLE();
+  }
+}
+
+// Relative cost of comparing a field, used to order the fields of a plan so
+// that fixed width scalars are compared before strings, which are compared
+// before repeated fields and nested messages.
+int GetFieldEqualityCost(const FieldEqualityPlan& field_plan) {
+  if (field_plan.field->is_map()) {
+    return 4;
+  }
+  const int cost = field_plan.kind == FieldEqualityKind::kMessage  ? 2
+                   : field_plan.kind == FieldEqualityKind::kString ? 1
+                                                                   : 0;
+  return field_plan.field->is_repeated() ? cost + 2 : cost;
+}
+
+// Thread-safe cache of `MessageEqualityPlan`, keyed by descriptor. Plans are
+// never evicted, so the descriptors must outlive the cache.
+class MessageEqualityPlanCache final {
+ public:
+  // Returns the cache for descriptors from the generated descriptor pool, which
+  // lives for the duration of the program.
+  static MessageEqualityPlanCache& Generated() {
+    static absl::NoDestructor<MessageEqualityPlanCache> cache;
+    return *cache;
+  }
+
+  absl::Nonnull<const MessageEqualityPlan*> Get(
+      absl::Nonnull<const Descriptor*> descriptor)
+      ABSL_LOCKS_EXCLUDED(mutex_) {
+    {
+      absl::ReaderMutexLock lock(&mutex_);
+      if (auto it = plans_.find(descriptor); it != plans_.end()) {
+        return it->second.get();
+      }
+    }
+    absl::MutexLock lock(&mutex_);
+    return GetOrCompile(descriptor);
+  }
+
+ private:
+  // Compiles the plan for `descriptor` along with the plans for every message
+  // type reachable from it. The plan is inserted before its fields are
+  // compiled, so that recursive message types refer to themselves. Readers
+  // never observe a partially compiled plan, as the whole graph is compiled
+  // under the writer lock.
+  absl::Nonnull<const MessageEqualityPlan*> GetOrCompile(
+      absl::Nonnull<const Descriptor*> descriptor)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    auto& plan = plans_[descriptor];
+    if (plan != nullptr) {
+      return plan.get();
+    }
+    plan = std::make_unique<MessageEqualityPlan>();
+    // `plan` may be invalidated by the recursive insertions below.
+    auto* compiled = plan.get();
+    if (descriptor->well_known_type() == Descriptor::WELLKNOWNTYPE_ANY ||
+        descriptor->extension_range_count() != 0) {
+      compiled->use_differencer = true;
+      return compiled;
+    }
+    const int field_count = descriptor->field_count();
+    compiled->fields.reserve(static_cast<size_t>(field_count));
+    for (int i = 0; i < field_count; ++i) {
+      const auto* field = descriptor->field(i);
+      FieldEqualityPlan field_plan{field, GetFieldEqualityKind(field)};
+      if (field->is_map()) {
+        field_plan.map_value_field = field->message_type()->map_value();
+        field_plan.kind = GetFieldEqualityKind(field_plan.map_value_field);
+        if (field_plan.kind == FieldEqualityKind::kMessage) {
+          field_plan.message_plan =
+              GetOrCompile(field_plan.map_value_field->message_type());
+        }
+      } else if (field_plan.kind == FieldEqualityKind::kMessage) {
+        field_plan.message_plan = GetOrCompile(field->message_type());
+      }
+      compiled->fields.push_back(field_plan);
+    }
+    std::stable_sort(compiled->fields.begin(), compiled->fields.end(),
+                     [](const FieldEqualityPlan& lhs,
+                        const FieldEqualityPlan& rhs) {
+                       return GetFieldEqualityCost(lhs) <
+                              GetFieldEqualityCost(rhs);
+                     });
+    return compiled;
+  }
+
+  absl::Mutex mutex_;
+  absl::flat_hash_map<absl::Nonnull<const Descriptor*>,
+                      std::unique_ptr<MessageEqualityPlan>>
+      plans_ ABSL_GUARDED_BY(mutex_);
+};
+
+bool PlannedMessageEquals(const MessageEqualityPlan& plan, const Message& lhs,
+                          const Message& rhs);
+
+bool PlannedSingularFieldEquals(
+    const FieldEqualityPlan& field_plan, const Message& lhs,
+    absl::Nonnull<const Reflection*> lhs_reflection, const Message& rhs,
+    absl::Nonnull<const Reflection*> rhs_reflection) {
+  const auto* field = field_plan.field;
+  switch (field_plan.kind) {
+    case FieldEqualityKind::kInt32:
+      return lhs_reflection->GetInt32(lhs, field) ==
+             rhs_reflection->GetInt32(rhs, field);
+    case FieldEqualityKind::kInt64:
+      return lhs_reflection->GetInt64(lhs, field) ==
+             rhs_reflection->GetInt64(rhs, field);
+    case FieldEqualityKind::kUint32:
+      return lhs_reflection->GetUInt32(lhs, field) ==
+             rhs_reflection->GetUInt32(rhs, field);
+    case FieldEqualityKind::kUint64:
+      return lhs_reflection->GetUInt64(lhs, field) ==
+             rhs_reflection->GetUInt64(rhs, field);
+    case FieldEqualityKind::kDouble:
+      return lhs_reflection->GetDouble(lhs, field) ==
+             rhs_reflection->GetDouble(rhs, field);
+    case FieldEqualityKind::kFloat:
+      return lhs_reflection->GetFloat(lhs, field) ==
+             rhs_reflection->GetFloat(rhs, field);
+    case FieldEqualityKind::kBool:
+      return lhs_reflection->GetBool(lhs, field) ==
+             rhs_reflection->GetBool(rhs, field);
+    case FieldEqualityKind::kEnum:
+      return lhs_reflection->GetEnumValue(lhs, field) ==
+             rhs_reflection->GetEnumValue(rhs, field);
+    case FieldEqualityKind::kString: {
+      std::string lhs_scratch;
+      std::string rhs_scratch;
+      return lhs_reflection->GetStringReference(lhs, field, &lhs_scratch) ==
+             rhs_reflection->GetStringReference(rhs, field, &rhs_scratch);
+    }
+    case FieldEqualityKind::kMessage:
+      return PlannedMessageEquals(*field_plan.message_plan,
+                                  lhs_reflection->GetMessage(lhs, field),
+                                  rhs_reflection->GetMessage(rhs, field));
+  }
+  ABSL_UNREACHABLE();
+}
+
+bool PlannedRepeatedFieldEquals(
+    const FieldEqualityPlan& field_plan, const Message& lhs,
+    absl::Nonnull<const Reflection*> lhs_reflection, const Message& rhs,
+    absl::Nonnull<const Reflection*> rhs_reflection, int size) {
+  const auto* field = field_plan.field;
+  switch (field_plan.kind) {
+    case FieldEqualityKind::kInt32:
+      for (int i = 0; i < size; ++i) {
+        if (lhs_reflection->GetRepeatedInt32(lhs, field, i) !=
+            rhs_reflection->GetRepeatedInt32(rhs, field, i)) {
+          return false;
+        }
+      }
+      return true;
+    case FieldEqualityKind::kInt64:
+      for (int i = 0; i < size; ++i) {
+        if (lhs_reflection->GetRepeatedInt64(lhs, field, i) !=
+            rhs_reflection->GetRepeatedInt64(rhs, field, i)) {
+          return false;
+        }
+      }
+      return true;
+    case FieldEqualityKind::kUint32:
+      for (int i = 0; i < size; ++i) {
+        if (lhs_reflection->GetRepeatedUInt32(lhs, field, i) !=
+            rhs_reflection->GetRepeatedUInt32(rhs, field, i)) {
+          return false;
+        }
+      }
+      return true;
+    case FieldEqualityKind::kUint64:
+      for (int i = 0; i < size; ++i) {
+        if (lhs_reflection->GetRepeatedUInt64(lhs, field, i) !=
+            rhs_reflection->GetRepeatedUInt64(rhs, field, i)) {
+          return false;
+        }
+      }
+      return true;
+    case FieldEqualityKind::kDouble:
+      for (int i = 0; i < size; ++i) {
+        if (lhs_reflection->GetRepeatedDouble(lhs, field, i) !=
+            rhs_reflection->GetRepeatedDouble(rhs, field, i)) {
+          return false;
+        }
+      }
+      return true;
+    case FieldEqualityKind::kFloat:
+      for (int i = 0; i < size; ++i) {
+        if (lhs_reflection->GetRepeatedFloat(lhs, field, i) !=
+            rhs_reflection->GetRepeatedFloat(rhs, field, i)) {
+          return false;
+        }
+      }
+      return true;
+    case FieldEqualityKind::kBool:
+      for (int i = 0; i < size; ++i) {
+        if (lhs_reflection->GetRepeatedBool(lhs, field, i) !=
+            rhs_reflection->GetRepeatedBool(rhs, field, i)) {
+          return false;
+        }
+      }
+      return true;
+    case FieldEqualityKind::kEnum:
+      for (int i = 0; i < size; ++i) {
+        if (lhs_reflection->GetRepeatedEnumValue(lhs, field, i) !=
+            rhs_reflection->GetRepeatedEnumValue(rhs, field, i)) {
+          return false;
+        }
+      }
+      return true;
+    case FieldEqualityKind::kString: {
+      std::string lhs_scratch;
+      std::string rhs_scratch;
+      for (int i = 0; i < size; ++i) {
+        if (lhs_reflection->GetRepeatedStringReference(lhs, field, i,
+                                                       &lhs_scratch) !=
+            rhs_reflection->GetRepeatedStringReference(rhs, field, i,
+                                                       &rhs_scratch)) {
+          return false;
+        }
+      }
+      return true;
+    }
+    case FieldEqualityKind::kMessage:
+      for (int i = 0; i < size; ++i) {
+        if (!PlannedMessageEquals(
+                *field_plan.message_plan,
+                lhs_reflection->GetRepeatedMessage(lhs, field, i),
+                rhs_reflection->GetRepeatedMessage(rhs, field, i))) {
+          return false;
+        }
+      }
+      return true;
+  }
+  ABSL_UNREACHABLE();
+}
+
+bool PlannedMapValueEquals(const FieldEqualityPlan& field_plan,
+                           const google::protobuf::MapValueConstRef& lhs,
+                           const google::protobuf::MapValueConstRef& rhs) {
+  switch (field_plan.kind) {
+    case FieldEqualityKind::kInt32:
+      return lhs.GetInt32Value() == rhs.GetInt32Value();
+    case FieldEqualityKind::kInt64:
+      return lhs.GetInt64Value() == rhs.GetInt64Value();
+    case FieldEqualityKind::kUint32:
+      return lhs.GetUInt32Value() == rhs.GetUInt32Value();
+    case FieldEqualityKind::kUint64:
+      return lhs.GetUInt64Value() == rhs.GetUInt64Value();
+    case FieldEqualityKind::kDouble:
+      return lhs.GetDoubleValue() == rhs.GetDoubleValue();
+    case FieldEqualityKind::kFloat:
+      return lhs.GetFloatValue() == rhs.GetFloatValue();
+    case FieldEqualityKind::kBool:
+      return lhs.GetBoolValue() == rhs.GetBoolValue();
+    case FieldEqualityKind::kEnum:
+      return lhs.GetEnumValue() == rhs.GetEnumValue();
+    case FieldEqualityKind::kString:
+      return lhs.GetStringValue() == rhs.GetStringValue();
+    case FieldEqualityKind::kMessage:
+      return PlannedMessageEquals(*field_plan.message_plan,
+                                  lhs.GetMessageValue(), rhs.GetMessageValue());
+  }
+  ABSL_UNREACHABLE();
+}
+
+bool PlannedMapFieldEquals(const FieldEqualityPlan& field_plan,
+                           const Message& lhs, const Reflection& lhs_reflection,
+                           const Message& rhs,
+                           const Reflection& rhs_reflection) {
+  const auto& field = *field_plan.field;
+  if (MapSize(lhs_reflection, lhs, field) !=
+      MapSize(rhs_reflection, rhs, field)) {
+    return false;
+  }
+  auto lhs_begin = MapBegin(lhs_reflection, lhs, field);
+  const auto lhs_end = MapEnd(lhs_reflection, lhs, field);
+  google::protobuf::MapValueConstRef rhs_value;
+  for (; lhs_begin != lhs_end; ++lhs_begin) {
+    if (!LookupMapValue(rhs_reflection, rhs, field, lhs_begin.GetKey(),
+                        &rhs_value) ||
+        !PlannedMapValueEquals(field_plan, lhs_begin.GetValueRef(),
+                               rhs_value)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool PlannedMessageEquals(const MessageEqualityPlan& plan, const Message& lhs,
+                          const Message& rhs) {
+  if (&lhs == &rhs) {
+    return true;
+  }
+  const auto* lhs_reflection = lhs.GetReflection();
+  const auto* rhs_reflection = rhs.GetReflection();
+  if (plan.use_differencer ||
+      !lhs_reflection->GetUnknownFields(lhs).empty() ||
+      !rhs_reflection->GetUnknownFields(rhs).empty()) {
+    return MessageDifferencer::Equals(lhs, rhs);
+  }
+  for (const auto& field_plan : plan.fields) {
+    const auto* field = field_plan.field;
+    if (field->is_map()) {
+      if (!PlannedMapFieldEquals(field_plan, lhs, *lhs_reflection, rhs,
+                                 *rhs_reflection)) {
+        return false;
+      }
+    } else if (field->is_repeated()) {
+      const int size = lhs_reflection->FieldSize(lhs, field);
+      if (size != rhs_reflection->FieldSize(rhs, field) ||
+          !PlannedRepeatedFieldEquals(field_plan, lhs, lhs_reflection, rhs,
+                                      rhs_reflection, size)) {
+        return false;
+      }
+    } else {
+      const bool has_field = lhs_reflection->HasField(lhs, field);
+      if (has_field != rhs_reflection->HasField(rhs, field)) {
+        return false;
+      }
+      if (has_field && !PlannedSingularFieldEquals(field_plan, lhs,
+                                                   lhs_reflection, rhs,
+                                                   rhs_reflection)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// Equality between two messages of the same type which are not well known
+// types. Only plans for the generated descriptor pool are cached, as a process
+// wide cache keyed by descriptor cannot tell when a dynamic pool is destroyed.
+bool OrdinaryMessageEquals(const Message& lhs, const Message& rhs) {
+  const auto* descriptor = lhs.GetDescriptor();
+  ABSL_DCHECK_EQ(descriptor, rhs.GetDescriptor());
+  if (descriptor->file()->pool() != DescriptorPool::generated_pool()) {
+    return MessageDifferencer::Equals(lhs, rhs);
+  }
+  return PlannedMessageEquals(
+      *MessageEqualityPlanCache::Generated().Get(descriptor), lhs, rhs);
+}
+
 struct MessageEqualer {
   bool operator()(EquatableMessage lhs, EquatableMessage rhs) const {
     return lhs.get().GetDescriptor() == rhs.get().GetDescriptor() &&
-           MessageDifferencer::Equals(lhs.get(), rhs.get());
+           OrdinaryMessageEquals(lhs.get(), rhs.get());
   }
 
   template <typename T>
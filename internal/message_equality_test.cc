@@ -43,6 +43,7 @@
 #include "google/protobuf/arena.h"
 #include "google/protobuf/descriptor.h"
 #include "google/protobuf/message.h"
+#include "google/protobuf/unknown_field_set.h"
 
 namespace cel::internal {
 namespace {
@@ -1037,5 +1038,121 @@ TEST(MessageFieldEquals, AnyFallback) {
               IsOkAndHolds(IsFalse()));
 }
 
+
+struct OrdinaryMessageEqualsTestCase {
+  std::string lhs;
+  std::string rhs;
+  bool equal;
+};
+
+// Messages which are not well known types are compared like
+// `MessageDifferencer::Equals`. Generated messages use the cached equality
+// plans, dynamic messages do not, and both must agree.
+TEST(MessageEquals, OrdinaryMessages) {
+  const auto* pool = GetTestingDescriptorPool();
+  auto* factory = GetTestingMessageFactory();
+  const std::vector<OrdinaryMessageEqualsTestCase> test_cases = {
+      {"", "", true},
+      {"single_int64: 1", "single_int64: 1", true},
+      {"single_int64: 1", "single_int64: 2", false},
+      {"single_int64: 1", "", false},
+      {"single_string: 'foo'", "single_string: 'foo'", true},
+      {"single_string: 'foo'", "single_string: 'bar'", false},
+      {"single_double: nan", "single_double: nan", false},
+      {"standalone_enum: BAR", "standalone_enum: BAR", true},
+      {"standalone_enum: BAR", "standalone_enum: BAZ", false},
+      {"single_int64_wrapper {}", "single_int64_wrapper {}", true},
+      {"single_int64_wrapper {}", "", false},
+      {"single_nested_message { bb: 1 }", "single_nested_message { bb: 1 }",
+       true},
+      {"single_nested_message { bb: 1 }", "single_nested_message { bb: 2 }",
+       false},
+      {"single_nested_message {}", "", false},
+      {"repeated_int32: [ 1, 2 ]", "repeated_int32: [ 1, 2 ]", true},
+      {"repeated_int32: [ 1, 2 ]", "repeated_int32: [ 2, 1 ]", false},
+      {"repeated_int32: [ 1, 2 ]", "repeated_int32: [ 1 ]", false},
+      {"repeated_nested_message { bb: 1 }", "repeated_nested_message { bb: 1 }",
+       true},
+      {"repeated_nested_message { bb: 1 }", "repeated_nested_message { bb: 2 }",
+       false},
+      {R"pb(map_string_string { key: "a" value: "b" }
+            map_string_string { key: "c" value: "d" })pb",
+       R"pb(map_string_string { key: "c" value: "d" }
+            map_string_string { key: "a" value: "b" })pb",
+       true},
+      {R"pb(map_string_string { key: "a" value: "b" })pb",
+       R"pb(map_string_string { key: "a" value: "c" })pb", false},
+      {R"pb(map_string_string { key: "a" value: "b" })pb",
+       R"pb(map_string_string { key: "b" value: "b" })pb", false},
+      {R"pb(map_string_message {
+              key: "a"
+              value { bb: 1 }
+            })pb",
+       R"pb(map_string_message {
+              key: "a"
+              value { bb: 1 }
+            })pb",
+       true},
+      {R"pb(map_string_message {
+              key: "a"
+              value { bb: 1 }
+            })pb",
+       R"pb(map_string_message {
+              key: "a"
+              value { bb: 2 }
+            })pb",
+       false},
+      {R"pb(single_any {
+              [type.googleapis.com/google.protobuf.Int32Value] { value: 1 }
+            })pb",
+       R"pb(single_any {
+              [type.googleapis.com/google.protobuf.Int32Value] { value: 1 }
+            })pb",
+       true},
+      {R"pb(single_any {
+              [type.googleapis.com/google.protobuf.Int32Value] { value: 1 }
+            })pb",
+       R"pb(single_any {
+              [type.googleapis.com/google.protobuf.Int32Value] { value: 2 }
+            })pb",
+       false},
+  };
+  google::protobuf::Arena arena;
+  for (const auto& test_case : test_cases) {
+    SCOPED_TRACE(absl::StrCat(test_case.lhs, " == ", test_case.rhs));
+    auto generated_lhs =
+        GeneratedParseTextProto<TestAllTypesProto3>(&arena, test_case.lhs);
+    auto generated_rhs =
+        GeneratedParseTextProto<TestAllTypesProto3>(&arena, test_case.rhs);
+    EXPECT_THAT(MessageEquals(*generated_lhs, *generated_rhs, pool, factory),
+                IsOkAndHolds(test_case.equal));
+    EXPECT_THAT(MessageEquals(*generated_rhs, *generated_lhs, pool, factory),
+                IsOkAndHolds(test_case.equal));
+    auto dynamic_lhs = DynamicParseTextProto<TestAllTypesProto3>(
+        &arena, test_case.lhs, pool, factory);
+    auto dynamic_rhs = DynamicParseTextProto<TestAllTypesProto3>(
+        &arena, test_case.rhs, pool, factory);
+    EXPECT_THAT(MessageEquals(*dynamic_lhs, *dynamic_rhs, pool, factory),
+                IsOkAndHolds(test_case.equal));
+    EXPECT_THAT(MessageEquals(*dynamic_rhs, *dynamic_lhs, pool, factory),
+                IsOkAndHolds(test_case.equal));
+  }
+}
+
+TEST(MessageEquals, OrdinaryMessagesWithUnknownFields) {
+  const auto* pool = GetTestingDescriptorPool();
+  auto* factory = GetTestingMessageFactory();
+  TestAllTypesProto3 lhs;
+  lhs.mutable_single_nested_message()->set_bb(1);
+  TestAllTypesProto3 rhs = lhs;
+  EXPECT_THAT(MessageEquals(lhs, rhs, pool, factory), IsOkAndHolds(IsTrue()));
+  rhs.mutable_single_nested_message()->mutable_unknown_fields()->AddVarint(
+      1000, 1);
+  EXPECT_THAT(MessageEquals(lhs, rhs, pool, factory), IsOkAndHolds(IsFalse()));
+  lhs.mutable_single_nested_message()->mutable_unknown_fields()->AddVarint(
+      1000, 1);
+  EXPECT_THAT(MessageEquals(lhs, rhs, pool, factory), IsOkAndHolds(IsTrue()));
+}
+
 }  // namespace
 }  // namespace cel::internal
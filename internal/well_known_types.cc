@@ -507,6 +507,10 @@ void BoolValueReflection::SetValue(absl::Nonnull<google::protobuf::Message*> mes
 
 absl::StatusOr<BoolValueReflection> GetBoolValueReflection(
     absl::Nonnull<const Descriptor*> descriptor) {
+  if (const auto& generated = GetGeneratedReflection().BoolValue();
+      descriptor == generated.GetDescriptor()) {
+    return generated;
+  }
   BoolValueReflection reflection;
   CEL_RETURN_IF_ERROR(reflection.Initialize(descriptor));
   return reflection;
@@ -550,6 +554,10 @@ void Int32ValueReflection::SetValue(absl::Nonnull<google::protobuf::Message*> me
 
 absl::StatusOr<Int32ValueReflection> GetInt32ValueReflection(
     absl::Nonnull<const Descriptor*> descriptor) {
+  if (const auto& generated = GetGeneratedReflection().Int32Value();
+      descriptor == generated.GetDescriptor()) {
+    return generated;
+  }
   Int32ValueReflection reflection;
   CEL_RETURN_IF_ERROR(reflection.Initialize(descriptor));
   return reflection;
@@ -593,6 +601,10 @@ void Int64ValueReflection::SetValue(absl::Nonnull<google::protobuf::Message*> me
 
 absl::StatusOr<Int64ValueReflection> GetInt64ValueReflection(
     absl::Nonnull<const Descriptor*> descriptor) {
+  if (const auto& generated = GetGeneratedReflection().Int64Value();
+      descriptor == generated.GetDescriptor()) {
+    return generated;
+  }
   Int64ValueReflection reflection;
   CEL_RETURN_IF_ERROR(reflection.Initialize(descriptor));
   return reflection;
@@ -636,6 +648,10 @@ void UInt32ValueReflection::SetValue(absl::Nonnull<google::protobuf::Message*> m
 
 absl::StatusOr<UInt32ValueReflection> GetUInt32ValueReflection(
     absl::Nonnull<const Descriptor*> descriptor) {
+  if (const auto& generated = GetGeneratedReflection().UInt32Value();
+      descriptor == generated.GetDescriptor()) {
+    return generated;
+  }
   UInt32ValueReflection reflection;
   CEL_RETURN_IF_ERROR(reflection.Initialize(descriptor));
   return reflection;
@@ -679,6 +695,10 @@ void UInt64ValueReflection::SetValue(absl::Nonnull<google::protobuf::Message*> m
 
 absl::StatusOr<UInt64ValueReflection> GetUInt64ValueReflection(
     absl::Nonnull<const Descriptor*> descriptor) {
+  if (const auto& generated = GetGeneratedReflection().UInt64Value();
+      descriptor == generated.GetDescriptor()) {
+    return generated;
+  }
   UInt64ValueReflection reflection;
   CEL_RETURN_IF_ERROR(reflection.Initialize(descriptor));
   return reflection;
@@ -722,6 +742,10 @@ void FloatValueReflection::SetValue(absl::Nonnull<google::protobuf::Message*> me
 
 absl::StatusOr<FloatValueReflection> GetFloatValueReflection(
     absl::Nonnull<const Descriptor*> descriptor) {
+  if (const auto& generated = GetGeneratedReflection().FloatValue();
+      descriptor == generated.GetDescriptor()) {
+    return generated;
+  }
   FloatValueReflection reflection;
   CEL_RETURN_IF_ERROR(reflection.Initialize(descriptor));
   return reflection;
@@ -765,6 +789,10 @@ void DoubleValueReflection::SetValue(absl::Nonnull<google::protobuf::Message*> m
 
 absl::StatusOr<DoubleValueReflection> GetDoubleValueReflection(
     absl::Nonnull<const Descriptor*> descriptor) {
+  if (const auto& generated = GetGeneratedReflection().DoubleValue();
+      descriptor == generated.GetDescriptor()) {
+    return generated;
+  }
   DoubleValueReflection reflection;
   CEL_RETURN_IF_ERROR(reflection.Initialize(descriptor));
   return reflection;
@@ -819,6 +847,10 @@ void BytesValueReflection::SetValue(absl::Nonnull<google::protobuf::Message*> me
 
 absl::StatusOr<BytesValueReflection> GetBytesValueReflection(
     absl::Nonnull<const Descriptor*> descriptor) {
+  if (const auto& generated = GetGeneratedReflection().BytesValue();
+      descriptor == generated.GetDescriptor()) {
+    return generated;
+  }
   BytesValueReflection reflection;
   CEL_RETURN_IF_ERROR(reflection.Initialize(descriptor));
   return reflection;
@@ -873,6 +905,10 @@ void StringValueReflection::SetValue(absl::Nonnull<google::protobuf::Message*> m
 
 absl::StatusOr<StringValueReflection> GetStringValueReflection(
     absl::Nonnull<const Descriptor*> descriptor) {
+  if (const auto& generated = GetGeneratedReflection().StringValue();
+      descriptor == generated.GetDescriptor()) {
+    return generated;
+  }
   StringValueReflection reflection;
   CEL_RETURN_IF_ERROR(reflection.Initialize(descriptor));
   return reflection;
@@ -940,6 +976,10 @@ BytesValue AnyReflection::GetValue(const google::protobuf::Message& message,
 
 absl::StatusOr<AnyReflection> GetAnyReflection(
     absl::Nonnull<const Descriptor*> descriptor) {
+  if (const auto& generated = GetGeneratedReflection().Any();
+      descriptor == generated.GetDescriptor()) {
+    return generated;
+  }
   AnyReflection reflection;
   CEL_RETURN_IF_ERROR(reflection.Initialize(descriptor));
   return reflection;
@@ -947,6 +987,10 @@ absl::StatusOr<AnyReflection> GetAnyReflection(
 
 AnyReflection GetAnyReflectionOrDie(
     absl::Nonnull<const google::protobuf::Descriptor*> descriptor) {
+  if (const auto& generated = GetGeneratedReflection().Any();
+      descriptor == generated.GetDescriptor()) {
+    return generated;
+  }
   AnyReflection reflection;
   ABSL_CHECK_OK(reflection.Initialize(descriptor));  // Crash OK
   return reflection;
@@ -1076,6 +1120,10 @@ absl::Duration DurationReflection::UnsafeToAbslDuration(
 
 absl::StatusOr<DurationReflection> GetDurationReflection(
     absl::Nonnull<const Descriptor*> descriptor) {
+  if (const auto& generated = GetGeneratedReflection().Duration();
+      descriptor == generated.GetDescriptor()) {
+    return generated;
+  }
   DurationReflection reflection;
   CEL_RETURN_IF_ERROR(reflection.Initialize(descriptor));
   return reflection;
@@ -1189,6 +1237,10 @@ absl::Time TimestampReflection::UnsafeToAbslTime(
 
 absl::StatusOr<TimestampReflection> GetTimestampReflection(
     absl::Nonnull<const Descriptor*> descriptor) {
+  if (const auto& generated = GetGeneratedReflection().Timestamp();
+      descriptor == generated.GetDescriptor()) {
+    return generated;
+  }
   TimestampReflection reflection;
   CEL_RETURN_IF_ERROR(reflection.Initialize(descriptor));
   return reflection;
@@ -1460,12 +1512,20 @@ Unique<google::protobuf::Message> ValueReflection::ReleaseStructValue(
 
 absl::StatusOr<ValueReflection> GetValueReflection(
     absl::Nonnull<const Descriptor*> descriptor) {
+  if (const auto& generated = GetGeneratedReflection().Value();
+      descriptor == generated.GetDescriptor()) {
+    return generated;
+  }
   ValueReflection reflection;
   CEL_RETURN_IF_ERROR(reflection.Initialize(descriptor));
   return reflection;
 }
 ValueReflection GetValueReflectionOrDie(
     absl::Nonnull<const google::protobuf::Descriptor*> descriptor) {
+  if (const auto& generated = GetGeneratedReflection().Value();
+      descriptor == generated.GetDescriptor()) {
+    return generated;
+  }
   ValueReflection reflection;
   ABSL_CHECK_OK(reflection.Initialize(descriptor));  // Crash OK;
   return reflection;
@@ -1545,6 +1605,10 @@ void ListValueReflection::ReserveValues(absl::Nonnull<google::protobuf::Message*
 
 absl::StatusOr<ListValueReflection> GetListValueReflection(
     absl::Nonnull<const Descriptor*> descriptor) {
+  if (const auto& generated = GetGeneratedReflection().ListValue();
+      descriptor == generated.GetDescriptor()) {
+    return generated;
+  }
   ListValueReflection reflection;
   CEL_RETURN_IF_ERROR(reflection.Initialize(descriptor));
   return reflection;
@@ -1552,6 +1616,10 @@ absl::StatusOr<ListValueReflection> GetListValueReflection(
 
 ListValueReflection GetListValueReflectionOrDie(
     absl::Nonnull<const google::protobuf::Descriptor*> descriptor) {
+  if (const auto& generated = GetGeneratedReflection().ListValue();
+      descriptor == generated.GetDescriptor()) {
+    return generated;
+  }
   ListValueReflection reflection;
   ABSL_CHECK_OK(reflection.Initialize(descriptor));  // Crash OK
   return reflection;
@@ -1683,6 +1751,10 @@ bool StructReflection::DeleteField(absl::Nonnull<google::protobuf::Message*> mes
 
 absl::StatusOr<StructReflection> GetStructReflection(
     absl::Nonnull<const Descriptor*> descriptor) {
+  if (const auto& generated = GetGeneratedReflection().Struct();
+      descriptor == generated.GetDescriptor()) {
+    return generated;
+  }
   StructReflection reflection;
   CEL_RETURN_IF_ERROR(reflection.Initialize(descriptor));
   return reflection;
@@ -1690,6 +1762,10 @@ absl::StatusOr<StructReflection> GetStructReflection(
 
 StructReflection GetStructReflectionOrDie(
     absl::Nonnull<const google::protobuf::Descriptor*> descriptor) {
+  if (const auto& generated = GetGeneratedReflection().Struct();
+      descriptor == generated.GetDescriptor()) {
+    return generated;
+  }
   StructReflection reflection;
   ABSL_CHECK_OK(reflection.Initialize(descriptor));  // Crash OK
   return reflection;
@@ -1732,6 +1808,10 @@ StringValue FieldMaskReflection::Paths(const google::protobuf::Message& message,
 
 absl::StatusOr<FieldMaskReflection> GetFieldMaskReflection(
     absl::Nonnull<const google::protobuf::Descriptor*> descriptor) {
+  if (const auto& generated = GetGeneratedReflection().FieldMask();
+      descriptor == generated.GetDescriptor()) {
+    return generated;
+  }
   FieldMaskReflection reflection;
   CEL_RETURN_IF_ERROR(reflection.Initialize(descriptor));
   return reflection;
@@ -1764,6 +1844,15 @@ void LinkWellKnownMessageReflection() {
 }  // namespace
 
 absl::Status Reflection::Initialize(absl::Nonnull<const DescriptorPool*> pool) {
+  if (pool == DescriptorPool::generated_pool()) {
+    *this = GetGeneratedReflection();
+    return absl::OkStatus();
+  }
+  return InitializeUncached(pool);
+}
+
+absl::Status Reflection::InitializeUncached(
+    absl::Nonnull<const DescriptorPool*> pool) {
   if (pool == DescriptorPool::generated_pool()) {
     absl::call_once(link_well_known_message_reflection,
                     &LinkWellKnownMessageReflection);
@@ -1794,6 +1883,16 @@ absl::Status Reflection::Initialize(absl::Nonnull<const DescriptorPool*> pool) {
   return absl::OkStatus();
 }
 
+const Reflection& GetGeneratedReflection() {
+  static const absl::NoDestructor<Reflection> reflection([]() {
+    Reflection reflection;
+    ABSL_CHECK_OK(  // Crash OK
+        reflection.InitializeUncached(DescriptorPool::generated_pool()));
+    return reflection;
+  }());
+  return *reflection;
+}
+
 bool Reflection::IsInitialized() const {
   // Check that everything is initialized except field mask, which is optional.
   return NullValue().IsInitialized() && BoolValue().IsInitialized() &&
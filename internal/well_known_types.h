@@ -1393,9 +1393,8 @@ class Reflection final {
 
   bool IsInitialized() const;
 
-  // At the moment we only use this class for verifying well known types in
-  // descriptor pools. We could eagerly initialize it and cache it somewhere to
-  // make things faster.
+  // Initializing against the generated descriptor pool copies from
+  // `GetGeneratedReflection()`, which is only resolved once per process.
 
   BoolValueReflection& BoolValue() ABSL_ATTRIBUTE_LIFETIME_BOUND {
     return bool_value_;
@@ -1524,6 +1523,11 @@ class Reflection final {
   }
 
  private:
+  friend const Reflection& GetGeneratedReflection();
+
+  absl::Status InitializeUncached(
+      absl::Nonnull<const google::protobuf::DescriptorPool*> pool);
+
   NullValueReflection& NullValue() ABSL_ATTRIBUTE_LIFETIME_BOUND {
     return null_value_;
   }
@@ -1551,6 +1555,13 @@ class Reflection final {
   FieldMaskReflection field_mask_;
 };
 
+// Returns `Reflection` initialized against the generated descriptor pool,
+// `google::protobuf::DescriptorPool::generated_pool()`. It is resolved once, on
+// first use, and is safe to share between threads. The `Get*Reflection` functions above
+// return copies of its members when given a descriptor from the generated pool,
+// instead of looking up and checking fields again.
+const Reflection& GetGeneratedReflection();
+
 }  // namespace cel::well_known_types
 
 #endif  // THIRD_PARTY_CEL_CPP_INTERNAL_WELL_KNOWN_TYPES_H_
@@ -111,6 +111,41 @@ TEST_F(ReflectionTest, TestingDescriptorPool) {
   EXPECT_THAT(Reflection().Initialize(GetTestingDescriptorPool()), IsOk());
 }
 
+TEST_F(ReflectionTest, GeneratedDescriptorPool) {
+  Reflection reflection;
+  EXPECT_THAT(
+      reflection.Initialize(google::protobuf::DescriptorPool::generated_pool()),
+      IsOk());
+  EXPECT_TRUE(reflection.IsInitialized());
+  EXPECT_EQ(reflection.Duration().GetDescriptor(),
+            google::protobuf::Duration::descriptor());
+  EXPECT_EQ(reflection.FieldMask().GetDescriptor(),
+            google::protobuf::FieldMask::descriptor());
+}
+
+TEST_F(ReflectionTest, GeneratedReflection) {
+  const Reflection& reflection = GetGeneratedReflection();
+  EXPECT_TRUE(reflection.IsInitialized());
+  EXPECT_EQ(&reflection, &GetGeneratedReflection());
+  EXPECT_EQ(reflection.Struct().GetDescriptor(),
+            google::protobuf::Struct::descriptor());
+
+  ASSERT_OK_AND_ASSIGN(
+      auto duration,
+      GetDurationReflection(google::protobuf::Duration::descriptor()));
+  EXPECT_EQ(duration.GetDescriptor(), google::protobuf::Duration::descriptor());
+  absl::Nonnull<google::protobuf::Message*> message =
+      MakeGenerated<google::protobuf::Duration>();
+  duration.SetSeconds(message, 1);
+  EXPECT_EQ(duration.GetSeconds(*message), 1);
+
+  // Descriptors from other pools are resolved as before.
+  const auto* dynamic_descriptor = ABSL_DIE_IF_NULL(
+      descriptor_pool()->FindMessageTypeByName("google.protobuf.Duration"));
+  ASSERT_OK_AND_ASSIGN(duration, GetDurationReflection(dynamic_descriptor));
+  EXPECT_EQ(duration.GetDescriptor(), dynamic_descriptor);
+}
+
 TEST_F(ReflectionTest, BoolValue_Generated) {
   auto* value = MakeGenerated<google::protobuf::BoolValue>();
   EXPECT_EQ(BoolValueReflection::GetValue(*value), false);
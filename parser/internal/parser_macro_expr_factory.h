@@ -0,0 +1,273 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// AST construction shared by the parser implementations. Both the ANTLR based
+// parser and the recursive descent parser build their result through these
+// helpers, which is what keeps expression ids, source positions, macro
+// expansions and semantic error messages identical between them.
+
+#ifndef THIRD_PARTY_CEL_CPP_PARSER_INTERNAL_PARSER_MACRO_EXPR_FACTORY_H_
+#define THIRD_PARTY_CEL_CPP_PARSER_INTERNAL_PARSER_MACRO_EXPR_FACTORY_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/btree_map.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+#include "base/ast_internal/expr.h"
+#include "common/expr.h"
+#include "common/source.h"
+#include "parser/macro_expr_factory.h"
+#include "parser/macro_registry.h"
+#include "parser/source_factory.h"
+
+namespace cel_parser_internal {
+
+struct ParserError {
+  std::string message;
+  cel::SourceRange range;
+};
+
+}  // namespace cel_parser_internal
+
+namespace cel {
+
+class ParserMacroExprFactory final : public MacroExprFactory {
+ public:
+  explicit ParserMacroExprFactory(const cel::Source& source)
+      : MacroExprFactory(), source_(source) {}
+
+  void BeginMacro(SourceRange macro_position) {
+    macro_position_ = macro_position;
+  }
+
+  void EndMacro() { macro_position_ = SourceRange{}; }
+
+  Expr ReportError(absl::string_view message) override {
+    return ReportError(macro_position_, message);
+  }
+
+  Expr ReportError(int64_t expr_id, absl::string_view message) {
+    return ReportError(GetSourceRange(expr_id), message);
+  }
+
+  Expr ReportError(SourceRange range, absl::string_view message);
+
+  Expr ReportErrorAt(const Expr& expr, absl::string_view message) override {
+    return ReportError(GetSourceRange(expr.id()), message);
+  }
+
+  SourceRange GetSourceRange(int64_t id) const {
+    if (auto it = positions_.find(id); it != positions_.end()) {
+      return it->second;
+    }
+    return SourceRange{};
+  }
+
+  int64_t NextId(const SourceRange& range) {
+    auto id = expr_id_++;
+    if (range.begin != -1 || range.end != -1) {
+      positions_.insert(std::pair{id, range});
+    }
+    return id;
+  }
+
+  // Records the source range of an id which was handed out by `NextId` before
+  // its range was known, as the ids must follow the order of the ANTLR
+  // visitor rather than the order in which tokens are consumed.
+  void SetSourceRange(int64_t id, const SourceRange& range) {
+    if (range.begin != -1 || range.end != -1) {
+      positions_.insert_or_assign(id, range);
+    }
+  }
+
+  bool HasErrors() const { return error_count_ != 0; }
+
+  std::string ErrorMessage();
+
+  void AddMacroCall(int64_t macro_id, absl::string_view function,
+                    absl::optional<Expr> target, std::vector<Expr> arguments) {
+    macro_calls_.insert(
+        {macro_id, target.has_value()
+                       ? NewMemberCall(0, function, std::move(*target),
+                                       std::move(arguments))
+                       : NewCall(0, function, std::move(arguments))});
+  }
+
+  Expr BuildMacroCallArg(const Expr& expr);
+
+  using ExprFactory::NewBoolConst;
+  using ExprFactory::NewBytesConst;
+  using ExprFactory::NewCall;
+  using ExprFactory::NewComprehension;
+  using ExprFactory::NewConst;
+  using ExprFactory::NewDoubleConst;
+  using ExprFactory::NewIdent;
+  using ExprFactory::NewIntConst;
+  using ExprFactory::NewList;
+  using ExprFactory::NewListElement;
+  using ExprFactory::NewMap;
+  using ExprFactory::NewMapEntry;
+  using ExprFactory::NewMemberCall;
+  using ExprFactory::NewNullConst;
+  using ExprFactory::NewPresenceTest;
+  using ExprFactory::NewSelect;
+  using ExprFactory::NewStringConst;
+  using ExprFactory::NewStruct;
+  using ExprFactory::NewStructField;
+  using ExprFactory::NewUintConst;
+  using ExprFactory::NewUnspecified;
+
+  const absl::btree_map<int64_t, SourceRange>& positions() const {
+    return positions_;
+  }
+
+  const absl::flat_hash_map<int64_t, Expr>& macro_calls() const {
+    return macro_calls_;
+  }
+
+  absl::flat_hash_map<int64_t, Expr> release_macro_calls() {
+    using std::swap;
+    absl::flat_hash_map<int64_t, Expr> result;
+    swap(result, macro_calls_);
+    return result;
+  }
+
+  void EraseId(ExprId id) {
+    positions_.erase(id);
+    if (expr_id_ == id + 1) {
+      --expr_id_;
+    }
+  }
+
+ protected:
+  int64_t NextId() override { return NextId(macro_position_); }
+
+  int64_t CopyId(int64_t id) override {
+    if (id == 0) {
+      return 0;
+    }
+    return NextId(GetSourceRange(id));
+  }
+
+ private:
+  int64_t expr_id_ = 1;
+  absl::btree_map<int64_t, SourceRange> positions_;
+  absl::flat_hash_map<int64_t, Expr> macro_calls_;
+  std::vector<::cel_parser_internal::ParserError> errors_;
+  size_t error_count_ = 0;
+  const Source& source_;
+  SourceRange macro_position_;
+};
+
+}  // namespace cel
+
+namespace cel_parser_internal {
+
+// The output of parsing, before it is wrapped into an AST or converted to a
+// `ParsedExpr`.
+struct ParseResult {
+  cel::Expr expr;
+  cel::ast_internal::SourceInfo source_info;
+  google::api::expr::parser::EnrichedSourceInfo enriched_source_info;
+};
+
+// Builds the source info of a finished parse. This releases the recorded
+// macro calls from `factory`.
+cel::ast_internal::SourceInfo BuildSourceInfo(
+    const cel::Source& source, cel::ParserMacroExprFactory& factory);
+
+google::api::expr::parser::EnrichedSourceInfo BuildEnrichedSourceInfo(
+    const cel::ParserMacroExprFactory& factory);
+
+// balancer performs tree balancing on operators whose arguments are of equal
+// precedence.
+//
+// The purpose of the balancer is to ensure a compact serialization format for
+// the logical &&, || operators which have a tendency to create long DAGs which
+// are skewed in one direction. Since the operators are commutative re-ordering
+// the terms *must not* affect the evaluation result.
+//
+// Based on code from //third_party/cel/go/parser/helper.go
+class ExpressionBalancer final {
+ public:
+  ExpressionBalancer(cel::ParserMacroExprFactory& factory, std::string function,
+                     cel::Expr expr);
+
+  // addTerm adds an operation identifier and term to the set of terms to be
+  // balanced.
+  void AddTerm(int64_t op, cel::Expr term);
+
+  // balance creates a balanced tree from the sub-terms and returns the final
+  // Expr value.
+  cel::Expr Balance();
+
+ private:
+  // balancedTree recursively balances the terms provided to a commutative
+  // operator.
+  cel::Expr BalancedTree(int lo, int hi);
+
+ private:
+  cel::ParserMacroExprFactory& factory_;
+  std::string function_;
+  std::vector<cel::Expr> terms_;
+  std::vector<int64_t> ops_;
+};
+
+// Expands the global call `function(args...)` using the matching macro from
+// `registry`, if any, falling back to a plain call with id `expr_id`.
+cel::Expr GlobalCallOrMacro(cel::ParserMacroExprFactory& factory,
+                            const cel::MacroRegistry& registry,
+                            bool add_macro_calls, int64_t expr_id,
+                            absl::string_view function,
+                            std::vector<cel::Expr> args);
+
+// Expands the receiver call `target.function(args...)` using the matching
+// macro from `registry`, if any, falling back to a plain call with id
+// `expr_id`.
+cel::Expr ReceiverCallOrMacro(cel::ParserMacroExprFactory& factory,
+                              const cel::MacroRegistry& registry,
+                              bool add_macro_calls, int64_t expr_id,
+                              absl::string_view function, cel::Expr target,
+                              std::vector<cel::Expr> args);
+
+// Literal constructors. Each takes the token text as written in the source
+// and reports an error to `factory` when it cannot be represented.
+cel::Expr NewIntLiteral(cel::ParserMacroExprFactory& factory,
+                        const cel::SourceRange& range, absl::string_view sign,
+                        absl::string_view text);
+
+cel::Expr NewUintLiteral(cel::ParserMacroExprFactory& factory,
+                         const cel::SourceRange& range, absl::string_view text);
+
+cel::Expr NewDoubleLiteral(cel::ParserMacroExprFactory& factory,
+                           const cel::SourceRange& range,
+                           absl::string_view sign, absl::string_view text);
+
+cel::Expr NewStringLiteral(cel::ParserMacroExprFactory& factory,
+                           const cel::SourceRange& range,
+                           absl::string_view text);
+
+cel::Expr NewBytesLiteral(cel::ParserMacroExprFactory& factory,
+                          const cel::SourceRange& range,
+                          absl::string_view text);
+
+}  // namespace cel_parser_internal
+
+#endif  // THIRD_PARTY_CEL_CPP_PARSER_INTERNAL_PARSER_MACRO_EXPR_FACTORY_H_
@@ -0,0 +1,1466 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "parser/internal/recursive_descent_parser.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/algorithm/container.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/str_replace.h"
+#include "absl/strings/string_view.h"
+#include "common/expr.h"
+#include "common/operators.h"
+#include "common/source.h"
+#include "internal/lexis.h"
+#include "parser/internal/parser_macro_expr_factory.h"
+#include "parser/macro_registry.h"
+#include "parser/options.h"
+
+namespace cel_parser_internal {
+
+namespace {
+
+using ::cel::Expr;
+using ::cel::ListExprElement;
+using ::cel::MapExprEntry;
+using ::cel::SourceContentView;
+using ::cel::SourcePosition;
+using ::cel::SourceRange;
+using ::cel::StructExprField;
+using ::google::api::expr::common::CelOperator;
+
+// Token kinds, mirroring the lexer rules of `Cel.g4`.
+enum class TokenKind {
+  kEof,
+  // An input which matches no lexer rule. Always the last token.
+  kError,
+  kEquals,
+  kNotEquals,
+  kIn,
+  kLess,
+  kLessEquals,
+  kGreaterEquals,
+  kGreater,
+  kLogicalAnd,
+  kLogicalOr,
+  kLBracket,
+  kRBracket,
+  kLBrace,
+  kRBrace,
+  kLParen,
+  kRParen,
+  kDot,
+  kComma,
+  kMinus,
+  kExclam,
+  kQuestionMark,
+  kColon,
+  kPlus,
+  kStar,
+  kSlash,
+  kPercent,
+  kTrue,
+  kFalse,
+  kNull,
+  kNumFloat,
+  kNumInt,
+  kNumUint,
+  kString,
+  kBytes,
+  kIdentifier,
+};
+
+struct Token {
+  TokenKind kind = TokenKind::kEof;
+  // Code point offsets of the token within the source, `end` is exclusive.
+  SourcePosition begin = 0;
+  SourcePosition end = 0;
+};
+
+SourceRange TokenRange(const Token& token) {
+  return SourceRange{token.begin, token.end};
+}
+
+// The tokens which may start an expression.
+constexpr std::array<TokenKind, 15> kExpressionStart = {
+    TokenKind::kLBracket, TokenKind::kLBrace,   TokenKind::kLParen,
+    TokenKind::kDot,      TokenKind::kMinus,    TokenKind::kExclam,
+    TokenKind::kTrue,     TokenKind::kFalse,    TokenKind::kNull,
+    TokenKind::kNumFloat, TokenKind::kNumInt,   TokenKind::kNumUint,
+    TokenKind::kString,   TokenKind::kBytes,    TokenKind::kIdentifier,
+};
+
+bool IsExpressionStart(TokenKind kind) {
+  return absl::c_linear_search(kExpressionStart, kind);
+}
+
+// Returns the display name of a token kind in the ANTLR vocabulary.
+absl::string_view TokenKindName(TokenKind kind) {
+  switch (kind) {
+    case TokenKind::kEof:
+      return "<EOF>";
+    case TokenKind::kError:
+      return "<INVALID>";
+    case TokenKind::kEquals:
+      return "'=='";
+    case TokenKind::kNotEquals:
+      return "'!='";
+    case TokenKind::kIn:
+      return "'in'";
+    case TokenKind::kLess:
+      return "'<'";
+    case TokenKind::kLessEquals:
+      return "'<='";
+    case TokenKind::kGreaterEquals:
+      return "'>='";
+    case TokenKind::kGreater:
+      return "'>'";
+    case TokenKind::kLogicalAnd:
+      return "'&&'";
+    case TokenKind::kLogicalOr:
+      return "'||'";
+    case TokenKind::kLBracket:
+      return "'['";
+    case TokenKind::kRBracket:
+      return "']'";
+    case TokenKind::kLBrace:
+      return "'{'";
+    case TokenKind::kRBrace:
+      return "'}'";
+    case TokenKind::kLParen:
+      return "'('";
+    case TokenKind::kRParen:
+      return "')'";
+    case TokenKind::kDot:
+      return "'.'";
+    case TokenKind::kComma:
+      return "','";
+    case TokenKind::kMinus:
+      return "'-'";
+    case TokenKind::kExclam:
+      return "'!'";
+    case TokenKind::kQuestionMark:
+      // The generated vocabulary escapes '?' to avoid trigraphs.
+      return "'\\u003F'";
+    case TokenKind::kColon:
+      return "':'";
+    case TokenKind::kPlus:
+      return "'+'";
+    case TokenKind::kStar:
+      return "'*'";
+    case TokenKind::kSlash:
+      return "'/'";
+    case TokenKind::kPercent:
+      return "'%'";
+    case TokenKind::kTrue:
+      return "'true'";
+    case TokenKind::kFalse:
+      return "'false'";
+    case TokenKind::kNull:
+      return "'null'";
+    case TokenKind::kNumFloat:
+      return "NUM_FLOAT";
+    case TokenKind::kNumInt:
+      return "NUM_INT";
+    case TokenKind::kNumUint:
+      return "NUM_UINT";
+    case TokenKind::kString:
+      return "STRING";
+    case TokenKind::kBytes:
+      return "BYTES";
+    case TokenKind::kIdentifier:
+      return "IDENTIFIER";
+  }
+  return "<INVALID>";
+}
+
+// Formats a set of expected tokens as ANTLR does, ordered by token type.
+std::string DisplayExpected(std::vector<TokenKind> expected) {
+  absl::c_sort(expected);
+  if (expected.size() == 1) {
+    return std::string(TokenKindName(expected.front()));
+  }
+  return absl::StrCat(
+      "{",
+      absl::StrJoin(expected, ", ",
+                    [](std::string* out, TokenKind kind) {
+                      absl::StrAppend(out, TokenKindName(kind));
+                    }),
+      "}");
+}
+
+// The tokens expected at the start of an initializer list closed by `close`.
+// Message field initializers start with an identifier rather than an
+// expression.
+std::vector<TokenKind> InitializerStart(TokenKind close, bool fields,
+                                        bool first) {
+  std::vector<TokenKind> expected = {close, TokenKind::kQuestionMark};
+  if (first) {
+    expected.push_back(TokenKind::kComma);
+  }
+  if (fields) {
+    expected.push_back(TokenKind::kIdentifier);
+  } else {
+    expected.insert(expected.end(), kExpressionStart.begin(),
+                    kExpressionStart.end());
+  }
+  return expected;
+}
+
+// Replacements for absl::StrReplaceAll for escaping standard whitespace
+// characters, matching the ANTLR error display.
+constexpr std::array<std::pair<absl::string_view, absl::string_view>, 3>
+    kStandardReplacements = {
+        std::make_pair("\n", "\\n"),
+        std::make_pair("\r", "\\r"),
+        std::make_pair("\t", "\\t"),
+    };
+
+constexpr char32_t kEndOfInput = static_cast<char32_t>(-1);
+
+bool IsDigit(char32_t c) { return c >= '0' && c <= '9'; }
+
+bool IsOctalDigit(char32_t c) { return c >= '0' && c <= '7'; }
+
+bool IsHexDigit(char32_t c) {
+  return IsDigit(c) || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+bool IsLetter(char32_t c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+bool IsIdentifierStart(char32_t c) { return IsLetter(c) || c == '_'; }
+
+bool IsIdentifierPart(char32_t c) { return IsIdentifierStart(c) || IsDigit(c); }
+
+bool IsQuote(char32_t c) { return c == '"' || c == '\''; }
+
+// Splits the source into tokens following the lexer rules of `Cel.g4`,
+// skipping whitespace and comments. Like the ANTLR lexer it always produces
+// the longest match. An input which matches no rule ends the token stream with
+// a `kError` token, the message for which is available from `error()`.
+class Lexer final {
+ public:
+  explicit Lexer(SourceContentView content)
+      : content_(content), size_(content.size()) {}
+
+  std::vector<Token> Tokenize() {
+    std::vector<Token> tokens;
+    tokens.reserve(size_ / 2 + 1);
+    while (true) {
+      tokens.push_back(Next());
+      if (tokens.back().kind == TokenKind::kEof ||
+          tokens.back().kind == TokenKind::kError) {
+        break;
+      }
+    }
+    return tokens;
+  }
+
+  const std::string& error() const { return error_; }
+
+ private:
+  char32_t At(SourcePosition position) const {
+    return position < size_ ? content_.at(position) : kEndOfInput;
+  }
+
+  char32_t Peek(SourcePosition offset = 0) const {
+    return At(position_ + offset);
+  }
+
+  Token Make(TokenKind kind, SourcePosition begin) const {
+    return Token{kind, begin, position_};
+  }
+
+  Token Single(TokenKind kind) {
+    ++position_;
+    return Make(kind, position_ - 1);
+  }
+
+  // Consumes one or two characters, depending on whether the second one is
+  // `second`.
+  Token OneOrTwo(char32_t second, TokenKind two, TokenKind one) {
+    SourcePosition begin = position_;
+    if (Peek(1) == second) {
+      position_ += 2;
+      return Make(two, begin);
+    }
+    ++position_;
+    return Make(one, begin);
+  }
+
+  // Reports that no rule matches the input starting at `begin`, the first
+  // character not matching being at `failed`.
+  Token Fail(SourcePosition begin, SourcePosition failed) {
+    SourcePosition end = std::min(failed + 1, size_);
+    error_ = absl::StrCat(
+        "token recognition error at: '",
+        absl::StrReplaceAll(content_.ToString(begin, end),
+                            kStandardReplacements),
+        "'");
+    position_ = end;
+    return Token{TokenKind::kError, begin, end};
+  }
+
+  void SkipWhitespaceAndComments() {
+    while (true) {
+      char32_t c = Peek();
+      if (c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\f') {
+        ++position_;
+      } else if (c == '/' && Peek(1) == '/') {
+        position_ += 2;
+        while (position_ < size_ && Peek() != '\n') {
+          ++position_;
+        }
+      } else {
+        return;
+      }
+    }
+  }
+
+  Token Next() {
+    SkipWhitespaceAndComments();
+    SourcePosition begin = position_;
+    char32_t c = Peek();
+    switch (c) {
+      case kEndOfInput:
+        return Make(TokenKind::kEof, begin);
+      case '=':
+        if (Peek(1) == '=') {
+          position_ += 2;
+          return Make(TokenKind::kEquals, begin);
+        }
+        return Fail(begin, begin + 1);
+      case '!':
+        return OneOrTwo('=', TokenKind::kNotEquals, TokenKind::kExclam);
+      case '<':
+        return OneOrTwo('=', TokenKind::kLessEquals, TokenKind::kLess);
+      case '>':
+        return OneOrTwo('=', TokenKind::kGreaterEquals, TokenKind::kGreater);
+      case '&':
+        if (Peek(1) == '&') {
+          position_ += 2;
+          return Make(TokenKind::kLogicalAnd, begin);
+        }
+        return Fail(begin, begin + 1);
+      case '|':
+        if (Peek(1) == '|') {
+          position_ += 2;
+          return Make(TokenKind::kLogicalOr, begin);
+        }
+        return Fail(begin, begin + 1);
+      case '[':
+        return Single(TokenKind::kLBracket);
+      case ']':
+        return Single(TokenKind::kRBracket);
+      case '{':
+        return Single(TokenKind::kLBrace);
+      case '}':
+        return Single(TokenKind::kRBrace);
+      case '(':
+        return Single(TokenKind::kLParen);
+      case ')':
+        return Single(TokenKind::kRParen);
+      case ',':
+        return Single(TokenKind::kComma);
+      case '-':
+        return Single(TokenKind::kMinus);
+      case '?':
+        return Single(TokenKind::kQuestionMark);
+      case ':':
+        return Single(TokenKind::kColon);
+      case '+':
+        return Single(TokenKind::kPlus);
+      case '*':
+        return Single(TokenKind::kStar);
+      case '/':
+        return Single(TokenKind::kSlash);
+      case '%':
+        return Single(TokenKind::kPercent);
+      case '.':
+        if (IsDigit(Peek(1))) {
+          return Number(begin);
+        }
+        return Single(TokenKind::kDot);
+      case '"':
+      case '\'':
+        return String(begin, TokenKind::kString, /*raw=*/false);
+      default:
+        break;
+    }
+    if (IsDigit(c)) {
+      return Number(begin);
+    }
+    if (IsIdentifierStart(c)) {
+      // String and bytes literals with a prefix take precedence over the
+      // identifier formed by the prefix, if they are well formed.
+      if ((c == 'r' || c == 'R') && IsQuote(Peek(1))) {
+        ++position_;
+        return String(begin, TokenKind::kString, /*raw=*/true);
+      }
+      if (c == 'b' || c == 'B') {
+        if (IsQuote(Peek(1))) {
+          ++position_;
+          return String(begin, TokenKind::kBytes, /*raw=*/false);
+        }
+        if ((Peek(1) == 'r' || Peek(1) == 'R') && IsQuote(Peek(2))) {
+          position_ += 2;
+          return String(begin, TokenKind::kBytes, /*raw=*/true);
+        }
+      }
+      return Identifier(begin);
+    }
+    return Fail(begin, begin);
+  }
+
+  bool Matches(SourcePosition begin, absl::string_view text) const {
+    if (position_ - begin != static_cast<SourcePosition>(text.size())) {
+      return false;
+    }
+    for (size_t i = 0; i < text.size(); ++i) {
+      if (At(begin + static_cast<SourcePosition>(i)) !=
+          static_cast<char32_t>(text[i])) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  Token Identifier(SourcePosition begin) {
+    position_ = begin + 1;
+    while (IsIdentifierPart(Peek())) {
+      ++position_;
+    }
+    TokenKind kind = TokenKind::kIdentifier;
+    if (Matches(begin, "in")) {
+      kind = TokenKind::kIn;
+    } else if (Matches(begin, "true")) {
+      kind = TokenKind::kTrue;
+    } else if (Matches(begin, "false")) {
+      kind = TokenKind::kFalse;
+    } else if (Matches(begin, "null")) {
+      kind = TokenKind::kNull;
+    }
+    return Make(kind, begin);
+  }
+
+  // Returns the length of the exponent starting at `position`, or 0.
+  SourcePosition Exponent(SourcePosition position) const {
+    if (At(position) != 'e' && At(position) != 'E') {
+      return 0;
+    }
+    SourcePosition length = 1;
+    if (At(position + length) == '+' || At(position + length) == '-') {
+      ++length;
+    }
+    if (!IsDigit(At(position + length))) {
+      return 0;
+    }
+    while (IsDigit(At(position + length))) {
+      ++length;
+    }
+    return length;
+  }
+
+  void SkipDigits() {
+    while (IsDigit(Peek())) {
+      ++position_;
+    }
+  }
+
+  Token Number(SourcePosition begin) {
+    if (Peek() == '.') {
+      ++position_;
+      SkipDigits();
+      position_ += Exponent(position_);
+      return Make(TokenKind::kNumFloat, begin);
+    }
+    if (Peek() == '0' && Peek(1) == 'x' && IsHexDigit(Peek(2))) {
+      position_ += 2;
+      while (IsHexDigit(Peek())) {
+        ++position_;
+      }
+      if (Peek() == 'u' || Peek() == 'U') {
+        ++position_;
+        return Make(TokenKind::kNumUint, begin);
+      }
+      return Make(TokenKind::kNumInt, begin);
+    }
+    SkipDigits();
+    if (Peek() == '.' && IsDigit(Peek(1))) {
+      ++position_;
+      SkipDigits();
+      position_ += Exponent(position_);
+      return Make(TokenKind::kNumFloat, begin);
+    }
+    if (SourcePosition exponent = Exponent(position_); exponent != 0) {
+      position_ += exponent;
+      return Make(TokenKind::kNumFloat, begin);
+    }
+    if (Peek() == 'u' || Peek() == 'U') {
+      ++position_;
+      return Make(TokenKind::kNumUint, begin);
+    }
+    return Make(TokenKind::kNumInt, begin);
+  }
+
+  // Matches the escape sequence starting with the backslash at `position`.
+  // Returns its length, or 0 after setting `failed` to the position of the
+  // first character which does not match.
+  SourcePosition Escape(SourcePosition position, SourcePosition& failed) const {
+    auto digits = [&](SourcePosition offset, int count,
+                      bool (*predicate)(char32_t)) -> SourcePosition {
+      for (int i = 0; i < count; ++i) {
+        if (!predicate(At(position + offset + i))) {
+          failed = position + offset + i;
+          return 0;
+        }
+      }
+      return offset + count;
+    };
+    switch (At(position + 1)) {
+      case 'a':
+      case 'b':
+      case 'f':
+      case 'n':
+      case 'r':
+      case 't':
+      case 'v':
+      case '"':
+      case '\'':
+      case '\\':
+      case '?':
+      case '`':
+        return 2;
+      case '0':
+      case '1':
+      case '2':
+      case '3':
+        return digits(2, 2, IsOctalDigit);
+      case 'x':
+      case 'X':
+        return digits(2, 2, IsHexDigit);
+      case 'u':
+        return digits(2, 4, IsHexDigit);
+      case 'U':
+        return digits(2, 8, IsHexDigit);
+      default:
+        failed = position + 1;
+        return 0;
+    }
+  }
+
+  // Lexes a string or bytes literal whose quote is at the current position,
+  // `begin` being the start of its prefix.
+  Token String(SourcePosition begin, TokenKind kind, bool raw) {
+    const char32_t quote = Peek();
+    if (Peek(1) == quote && Peek(2) == quote) {
+      SourcePosition position = position_ + 3;
+      SourcePosition failed;
+      while (position < size_) {
+        char32_t c = At(position);
+        if (c == quote && At(position + 1) == quote &&
+            At(position + 2) == quote) {
+          position_ = position + 3;
+          return Make(kind, begin);
+        }
+        if (!raw && c == '\\') {
+          SourcePosition length = Escape(position, failed);
+          if (length == 0) {
+            break;
+          }
+          position += length;
+        } else {
+          ++position;
+        }
+      }
+      // Not a well formed triple quoted literal, the longest match is then
+      // the empty literal formed by the first two quotes.
+      position_ += 2;
+      return Make(kind, begin);
+    }
+    SourcePosition position = position_ + 1;
+    while (true) {
+      char32_t c = At(position);
+      if (c == quote) {
+        position_ = position + 1;
+        return Make(kind, begin);
+      }
+      if (c == kEndOfInput || c == '\n' || c == '\r') {
+        break;
+      }
+      if (!raw && c == '\\') {
+        SourcePosition length = Escape(position, position);
+        if (length == 0) {
+          break;
+        }
+        position += length;
+      } else {
+        ++position;
+      }
+    }
+    if (position_ != begin) {
+      // The prefix alone is a valid identifier, which is the longest match.
+      return Identifier(begin);
+    }
+    return Fail(begin, position);
+  }
+
+  const SourceContentView content_;
+  const SourcePosition size_;
+  SourcePosition position_ = 0;
+  std::string error_;
+};
+
+// Scoped helper for incrementing the parse recursion count.
+// Increments on creation, decrements on destruction (stack unwind).
+class ScopedIncrement final {
+ public:
+  explicit ScopedIncrement(int& recursion_depth)
+      : recursion_depth_(recursion_depth) {
+    ++recursion_depth_;
+  }
+
+  ~ScopedIncrement() { --recursion_depth_; }
+
+ private:
+  int& recursion_depth_;
+};
+
+int BinaryPrecedence(TokenKind kind) {
+  switch (kind) {
+    case TokenKind::kEquals:
+    case TokenKind::kNotEquals:
+    case TokenKind::kIn:
+    case TokenKind::kLess:
+    case TokenKind::kLessEquals:
+    case TokenKind::kGreaterEquals:
+    case TokenKind::kGreater:
+      return 1;
+    case TokenKind::kPlus:
+    case TokenKind::kMinus:
+      return 2;
+    case TokenKind::kStar:
+    case TokenKind::kSlash:
+    case TokenKind::kPercent:
+      return 3;
+    default:
+      return 0;
+  }
+}
+
+absl::string_view BinaryOperator(TokenKind kind) {
+  switch (kind) {
+    case TokenKind::kEquals:
+      return CelOperator::EQUALS;
+    case TokenKind::kNotEquals:
+      return CelOperator::NOT_EQUALS;
+    case TokenKind::kIn:
+      return CelOperator::IN;
+    case TokenKind::kLess:
+      return CelOperator::LESS;
+    case TokenKind::kLessEquals:
+      return CelOperator::LESS_EQUALS;
+    case TokenKind::kGreaterEquals:
+      return CelOperator::GREATER_EQUALS;
+    case TokenKind::kGreater:
+      return CelOperator::GREATER;
+    case TokenKind::kPlus:
+      return CelOperator::ADD;
+    case TokenKind::kMinus:
+      return CelOperator::SUBTRACT;
+    case TokenKind::kStar:
+      return CelOperator::MULTIPLY;
+    case TokenKind::kSlash:
+      return CelOperator::DIVIDE;
+    case TokenKind::kPercent:
+      return CelOperator::MODULO;
+    default:
+      return "";
+  }
+}
+
+// Recursive descent parser over the grammar of `Cel.g4`, with precedence
+// climbing for the binary operators.
+//
+// Expression ids are allocated in exactly the order the ANTLR visitor in
+// `parser.cc` allocates them, and every node records the same source range.
+// The height of each parsed term, as the visitor would count its recursion,
+// is tracked to enforce `max_recursion_depth` identically.
+class RecursiveDescentParser final {
+ public:
+  RecursiveDescentParser(const cel::Source& source,
+                         const cel::MacroRegistry& registry,
+                         const cel::ParserOptions& options)
+      : source_(source),
+        content_(source.content()),
+        factory_(source),
+        registry_(registry),
+        options_(options) {}
+
+  absl::StatusOr<ParseResult> Parse() {
+    const SourcePosition size = content_.size();
+    if (size > options_.expression_size_codepoint_limit) {
+      return absl::InvalidArgumentError(absl::StrCat(
+          "expression size exceeds codepoint limit.", " input size: ", size,
+          ", limit: ", options_.expression_size_codepoint_limit));
+    }
+    Lexer lexer(content_);
+    tokens_ = lexer.Tokenize();
+    lexer_error_ = lexer.error();
+
+    Term term = ParseExpr();
+    if (!halted_ && Peek().kind != TokenKind::kEof) {
+      ReportUnexpected({TokenKind::kEof});
+    }
+    if (!cancellation_.empty()) {
+      // The ANTLR parser cancels before the visitor runs, so only syntax
+      // errors may have been reported.
+      if (factory_.HasErrors()) {
+        return absl::InvalidArgumentError(factory_.ErrorMessage());
+      }
+      return absl::CancelledError(cancellation_);
+    }
+    if (recursion_exceeded_) {
+      factory_.ReportError(
+          SourceRange{},
+          absl::StrFormat("Exceeded max recursion depth of %d when parsing.",
+                          options_.max_recursion_depth));
+    }
+    if (factory_.HasErrors()) {
+      return absl::InvalidArgumentError(factory_.ErrorMessage());
+    }
+    return ParseResult{
+        .expr = std::move(term.expr),
+        .source_info = BuildSourceInfo(source_, factory_),
+        .enriched_source_info = BuildEnrichedSourceInfo(factory_)};
+  }
+
+ private:
+  // An expression and its height in the parse tree, as counted by the
+  // recursion of the ANTLR visitor.
+  struct Term {
+    Expr expr;
+    int height = 0;
+  };
+
+  const Token& Peek(size_t offset = 0) const {
+    size_t index = std::min(index_ + offset, tokens_.size() - 1);
+    return tokens_[index];
+  }
+
+  Token Consume() {
+    const Token& token = tokens_[index_];
+    if (index_ + 1 < tokens_.size()) {
+      ++index_;
+    }
+    previous_end_ = token.end;
+    return token;
+  }
+
+  std::string Text(const Token& token) const {
+    return content_.ToString(token.begin, token.end);
+  }
+
+  std::string Display(const Token& token) const {
+    if (token.kind == TokenKind::kEof) {
+      return "'<EOF>'";
+    }
+    return absl::StrCat(
+        "'", absl::StrReplaceAll(Text(token), kStandardReplacements), "'");
+  }
+
+  void SyntaxError(const Token& token, absl::string_view message) {
+    SourceRange range;
+    range.begin = token.begin;
+    if (token.kind == TokenKind::kError) {
+      message = lexer_error_;
+    }
+    factory_.ReportError(range, absl::StrCat("Syntax error: ", message));
+    halted_ = true;
+  }
+
+  // Reports that the current token is not one of `expected`. When the token
+  // after it would have been, the current one is reported as extraneous.
+  void ReportUnexpected(std::vector<TokenKind> expected) {
+    const Token& token = Peek();
+    const bool extraneous = token.kind != TokenKind::kEof &&
+                            absl::c_linear_search(expected, Peek(1).kind);
+    SyntaxError(token,
+                absl::StrCat(extraneous ? "extraneous" : "mismatched",
+                             " input ", Display(token), " expecting ",
+                             DisplayExpected(std::move(expected))));
+  }
+
+  bool Expect(TokenKind kind, Token* token = nullptr) {
+    if (Peek().kind != kind) {
+      ReportUnexpected({kind});
+      return false;
+    }
+    Token consumed = Consume();
+    if (token != nullptr) {
+      *token = consumed;
+    }
+    return true;
+  }
+
+  // Completes a term, checking the limit on the recursion of the ANTLR
+  // visitor. Exceeding it is reported once the parse is complete, as the
+  // visitor only runs over a successful parse.
+  Term MakeTerm(Expr expr, int height) {
+    if (height > options_.max_recursion_depth) {
+      recursion_exceeded_ = true;
+    }
+    return Term{std::move(expr), height};
+  }
+
+  // expr: conditionalOr ('?' conditionalOr ':' expr)?
+  //
+  // `counted` is false where the visitor handles the rule without recursing,
+  // which makes a conditional transparent to the recursion limit.
+  Term ParseExpr(bool counted = true) {
+    // Mirrors the listener limiting the recursion of the ANTLR parser, which
+    // cancels the parse instead of reporting an error.
+    if (expr_depth_ > options_.max_recursion_depth) {
+      cancellation_ =
+          absl::StrFormat("Expression recursion limit exceeded. limit: %d",
+                          options_.max_recursion_depth);
+      halted_ = true;
+      return {};
+    }
+    ScopedIncrement increment(expr_depth_);
+    Term condition = ParseConditionalOr();
+    if (halted_ || Peek().kind != TokenKind::kQuestionMark) {
+      return condition;
+    }
+    int64_t op_id = factory_.NextId(TokenRange(Consume()));
+    Term if_true = ParseConditionalOr();
+    if (halted_ || !Expect(TokenKind::kColon)) {
+      return {};
+    }
+    Term if_false = ParseExpr();
+    if (halted_) {
+      return {};
+    }
+    int height =
+        std::max({condition.height, if_true.height, if_false.height}) +
+        (counted ? 1 : 0);
+    std::vector<Expr> arguments;
+    arguments.reserve(3);
+    arguments.push_back(std::move(condition.expr));
+    arguments.push_back(std::move(if_true.expr));
+    arguments.push_back(std::move(if_false.expr));
+    return MakeTerm(factory_.NewCall(op_id, CelOperator::CONDITIONAL,
+                                     std::move(arguments)),
+                    height);
+  }
+
+  // conditionalOr: conditionalAnd ('||' conditionalAnd)*
+  // conditionalAnd: relation ('&&' relation)*
+  Term ParseLogical(TokenKind op_kind) {
+    const bool is_or = op_kind == TokenKind::kLogicalOr;
+    Term first = is_or ? ParseLogical(TokenKind::kLogicalAnd) : ParseBinary(1);
+    if (halted_ || Peek().kind != op_kind) {
+      return first;
+    }
+    int height = first.height;
+    ExpressionBalancer balancer(
+        factory_, is_or ? CelOperator::LOGICAL_OR : CelOperator::LOGICAL_AND,
+        std::move(first.expr));
+    while (Peek().kind == op_kind) {
+      Token op = Consume();
+      Term next = is_or ? ParseLogical(TokenKind::kLogicalAnd) : ParseBinary(1);
+      if (halted_) {
+        return {};
+      }
+      // The visitor allocates the operator id after visiting the term.
+      balancer.AddTerm(factory_.NextId(TokenRange(op)), std::move(next.expr));
+      height = std::max(height, next.height);
+    }
+    return MakeTerm(balancer.Balance(), height + 1);
+  }
+
+  Term ParseConditionalOr() { return ParseLogical(TokenKind::kLogicalOr); }
+
+  // relation: calc | relation op relation
+  // calc: unary | calc ('*'|'/'|'%') calc | calc ('+'|'-') calc
+  Term ParseBinary(int min_precedence) {
+    Term lhs = ParseUnary();
+    while (!halted_) {
+      TokenKind kind = Peek().kind;
+      int precedence = BinaryPrecedence(kind);
+      if (precedence == 0 || precedence < min_precedence) {
+        break;
+      }
+      int64_t op_id = factory_.NextId(TokenRange(Consume()));
+      Term rhs = ParseBinary(precedence + 1);
+      if (halted_) {
+        return {};
+      }
+      int height = std::max(lhs.height, rhs.height) + 1;
+      std::vector<Expr> arguments;
+      arguments.reserve(2);
+      arguments.push_back(std::move(lhs.expr));
+      arguments.push_back(std::move(rhs.expr));
+      lhs = MakeTerm(GlobalCallOrMacro(factory_, registry_,
+                                       options_.add_macro_calls, op_id,
+                                       BinaryOperator(kind),
+                                       std::move(arguments)),
+                     height);
+    }
+    return lhs;
+  }
+
+  // unary: member | '!'+ member | '-'+ member
+  Term ParseUnary() {
+    TokenKind kind = Peek().kind;
+    if (kind != TokenKind::kExclam && kind != TokenKind::kMinus) {
+      return ParseMember();
+    }
+    if (kind == TokenKind::kMinus && (Peek(1).kind == TokenKind::kNumInt ||
+                                      Peek(1).kind == TokenKind::kNumFloat)) {
+      // A negative literal, which ANTLR prefers over negation.
+      return ParseMember();
+    }
+    Token first = Peek();
+    int count = 0;
+    while (Peek().kind == kind) {
+      Consume();
+      ++count;
+    }
+    if (count % 2 == 0) {
+      Term member = ParseMember();
+      return MakeTerm(std::move(member.expr), member.height + 1);
+    }
+    int64_t op_id = factory_.NextId(TokenRange(first));
+    Term member = ParseMember();
+    if (halted_) {
+      return {};
+    }
+    std::vector<Expr> arguments;
+    arguments.push_back(std::move(member.expr));
+    return MakeTerm(
+        GlobalCallOrMacro(
+            factory_, registry_, options_.add_macro_calls, op_id,
+            kind == TokenKind::kExclam ? CelOperator::LOGICAL_NOT
+                                       : CelOperator::NEGATE,
+            std::move(arguments)),
+        member.height + 1);
+  }
+
+  // member: primary
+  //       | member '.' '?'? IDENTIFIER
+  //       | member '.' IDENTIFIER '(' exprList? ')'
+  //       | member '[' '?'? expr ']'
+  Term ParseMember() {
+    const SourcePosition begin = Peek().begin;
+    Term operand = ParsePrimary();
+    while (!halted_) {
+      if (Peek().kind == TokenKind::kDot) {
+        Token op = Consume();
+        const bool optional = ConsumeIf(TokenKind::kQuestionMark);
+        if (optional && Peek().kind != TokenKind::kIdentifier) {
+          ReportUnexpected({TokenKind::kIdentifier});
+          return {};
+        }
+        if (Peek().kind != TokenKind::kIdentifier) {
+          const Token& token = Peek();
+          SyntaxError(token,
+                      absl::StrCat("no viable alternative at input '.",
+                                   token.kind == TokenKind::kEof ? ""
+                                                                 : Text(token),
+                                   "'"));
+          return {};
+        }
+        Token id = Consume();
+        if (!optional && Peek().kind == TokenKind::kLParen) {
+          int64_t op_id = factory_.NextId(TokenRange(Consume()));
+          int height = operand.height;
+          std::vector<Expr> arguments = ParseExprList(height);
+          if (halted_) {
+            return {};
+          }
+          operand = MakeTerm(
+              ReceiverCallOrMacro(factory_, registry_,
+                                  options_.add_macro_calls, op_id, Text(id),
+                                  std::move(operand.expr),
+                                  std::move(arguments)),
+              height + 1);
+          continue;
+        }
+        SourceRange range{begin, id.end};
+        if (!optional) {
+          operand = MakeTerm(
+              factory_.NewSelect(factory_.NextId(TokenRange(op)),
+                                 std::move(operand.expr), Text(id)),
+              operand.height + 1);
+        } else if (!options_.enable_optional_syntax) {
+          operand = MakeTerm(
+              factory_.ReportError(range, "unsupported syntax '.?'"),
+              operand.height + 1);
+        } else {
+          int64_t op_id = factory_.NextId(TokenRange(op));
+          std::vector<Expr> arguments;
+          arguments.reserve(2);
+          arguments.push_back(std::move(operand.expr));
+          arguments.push_back(
+              factory_.NewStringConst(factory_.NextId(range), Text(id)));
+          operand = MakeTerm(factory_.NewCall(op_id, CelOperator::OPT_SELECT,
+                                              std::move(arguments)),
+                             operand.height + 1);
+        }
+      } else if (Peek().kind == TokenKind::kLBracket) {
+        Token op = Consume();
+        const bool optional = ConsumeIf(TokenKind::kQuestionMark);
+        int64_t op_id = factory_.NextId(TokenRange(op));
+        Term index = ParseExpr();
+        if (halted_ || !Expect(TokenKind::kRBracket)) {
+          return {};
+        }
+        int height = std::max(operand.height, index.height) + 1;
+        if (optional && !options_.enable_optional_syntax) {
+          operand = MakeTerm(
+              factory_.ReportError(SourceRange{begin, previous_end_},
+                                   "unsupported syntax '.?'"),
+              height);
+          continue;
+        }
+        std::vector<Expr> arguments;
+        arguments.reserve(2);
+        arguments.push_back(std::move(operand.expr));
+        arguments.push_back(std::move(index.expr));
+        operand = MakeTerm(
+            GlobalCallOrMacro(
+                factory_, registry_, options_.add_macro_calls, op_id,
+                optional ? CelOperator::OPT_INDEX : CelOperator::INDEX,
+                std::move(arguments)),
+            height);
+      } else {
+        break;
+      }
+    }
+    return operand;
+  }
+
+  // Whether the tokens ahead are `'.'? IDENTIFIER ('.' IDENTIFIER)* '{'`,
+  // which begin a message creation rather than an identifier.
+  bool AtCreateMessage() const {
+    size_t offset = Peek().kind == TokenKind::kDot ? 1 : 0;
+    if (Peek(offset).kind != TokenKind::kIdentifier) {
+      return false;
+    }
+    ++offset;
+    while (Peek(offset).kind == TokenKind::kDot &&
+           Peek(offset + 1).kind == TokenKind::kIdentifier) {
+      offset += 2;
+    }
+    return Peek(offset).kind == TokenKind::kLBrace;
+  }
+
+  Term ParsePrimary() {
+    switch (Peek().kind) {
+      case TokenKind::kDot:
+      case TokenKind::kIdentifier:
+        if (AtCreateMessage()) {
+          return ParseCreateMessage();
+        }
+        return ParseIdentOrGlobalCall();
+      case TokenKind::kLParen: {
+        Consume();
+        Term nested = ParseExpr();
+        if (halted_ || !Expect(TokenKind::kRParen)) {
+          return {};
+        }
+        return nested;
+      }
+      case TokenKind::kLBracket:
+        return ParseCreateList();
+      case TokenKind::kLBrace:
+        return ParseCreateMap();
+      case TokenKind::kMinus:
+        if (Peek(1).kind == TokenKind::kNumInt ||
+            Peek(1).kind == TokenKind::kNumFloat) {
+          return ParseLiteral();
+        }
+        break;
+      case TokenKind::kNumFloat:
+      case TokenKind::kNumInt:
+      case TokenKind::kNumUint:
+      case TokenKind::kString:
+      case TokenKind::kBytes:
+      case TokenKind::kTrue:
+      case TokenKind::kFalse:
+      case TokenKind::kNull:
+        return ParseLiteral();
+      default:
+        break;
+    }
+    ReportUnexpected(std::vector<TokenKind>(kExpressionStart.begin(),
+                                            kExpressionStart.end()));
+    return {};
+  }
+
+  // exprList: expr (',' expr)*, followed by the closing ')'. Raises `height`
+  // to that of the tallest argument.
+  std::vector<Expr> ParseExprList(int& height) {
+    std::vector<Expr> arguments;
+    if (ConsumeIf(TokenKind::kRParen)) {
+      return arguments;
+    }
+    if (!IsExpressionStart(Peek().kind)) {
+      std::vector<TokenKind> expected(kExpressionStart.begin(),
+                                      kExpressionStart.end());
+      expected.push_back(TokenKind::kRParen);
+      ReportUnexpected(std::move(expected));
+      return arguments;
+    }
+    while (true) {
+      Term argument = ParseExpr(/*counted=*/false);
+      if (halted_) {
+        return arguments;
+      }
+      height = std::max(height, argument.height);
+      arguments.push_back(std::move(argument.expr));
+      if (Peek().kind != TokenKind::kComma) {
+        break;
+      }
+      Consume();
+    }
+    if (!ConsumeIf(TokenKind::kRParen)) {
+      ReportUnexpected({TokenKind::kComma, TokenKind::kRParen});
+    }
+    return arguments;
+  }
+
+  // '.'? IDENTIFIER ('(' exprList? ')')?
+  Term ParseIdentOrGlobalCall() {
+    const SourcePosition begin = Peek().begin;
+    std::string name;
+    if (Peek().kind == TokenKind::kDot) {
+      Consume();
+      name = ".";
+    }
+    if (Peek().kind != TokenKind::kIdentifier) {
+      ReportUnexpected({TokenKind::kIdentifier});
+      return {};
+    }
+    Token id = Consume();
+    std::string id_text = Text(id);
+    if (cel::internal::LexisIsReserved(id_text)) {
+      if (Peek().kind == TokenKind::kLParen) {
+        Consume();
+        int height = 0;
+        ParseExprList(height);
+        if (halted_) {
+          return {};
+        }
+      }
+      return MakeTerm(
+          factory_.ReportError(
+              SourceRange{begin, previous_end_},
+              absl::StrFormat("reserved identifier: %s", id_text)),
+          1);
+    }
+    name += id_text;
+    if (Peek().kind != TokenKind::kLParen) {
+      return MakeTerm(
+          factory_.NewIdent(factory_.NextId(TokenRange(id)), std::move(name)),
+          1);
+    }
+    int64_t op_id = factory_.NextId(TokenRange(Consume()));
+    int height = 0;
+    std::vector<Expr> arguments = ParseExprList(height);
+    if (halted_) {
+      return {};
+    }
+    return MakeTerm(GlobalCallOrMacro(factory_, registry_,
+                                      options_.add_macro_calls, op_id, name,
+                                      std::move(arguments)),
+                    height + 1);
+  }
+
+  // '.'? IDENTIFIER ('.' IDENTIFIER)* '{' fieldInitializerList? ','? '}'
+  Term ParseCreateMessage() {
+    std::string name;
+    if (Peek().kind == TokenKind::kDot) {
+      Consume();
+      name = ".";
+    }
+    name += Text(Consume());
+    while (Peek().kind == TokenKind::kDot) {
+      Consume();
+      absl::StrAppend(&name, ".", Text(Consume()));
+    }
+    int64_t obj_id = factory_.NextId(TokenRange(Consume()));
+    std::vector<StructExprField> fields;
+    int height = 0;
+    if (!AtEndOfInitializerList(TokenKind::kRBrace)) {
+      const SourcePosition begin = Peek().begin;
+      int unsupported = 0;
+      int count = 0;
+      do {
+        if (!ExpectInitializer(TokenKind::kRBrace, /*fields=*/true,
+                               count++ == 0)) {
+          return {};
+        }
+        bool optional = ConsumeIf(TokenKind::kQuestionMark);
+        Token id;
+        Token colon;
+        if (!Expect(TokenKind::kIdentifier, &id) ||
+            !Expect(TokenKind::kColon, &colon)) {
+          return {};
+        }
+        int64_t init_id = factory_.NextId(TokenRange(colon));
+        Term value = ParseExpr();
+        if (halted_) {
+          return {};
+        }
+        if (optional && !options_.enable_optional_syntax) {
+          ++unsupported;
+          continue;
+        }
+        height = std::max(height, value.height);
+        fields.push_back(factory_.NewStructField(
+            init_id, Text(id), std::move(value.expr), optional));
+      } while (NextInitializer(TokenKind::kRBrace));
+      ReportUnsupportedOptional(unsupported, SourceRange{begin, previous_end_});
+    }
+    if (!EndInitializerList(TokenKind::kRBrace)) {
+      return {};
+    }
+    return MakeTerm(
+        factory_.NewStruct(obj_id, std::move(name), std::move(fields)),
+        height + 1);
+  }
+
+  // '[' listInit? ','? ']'
+  Term ParseCreateList() {
+    int64_t list_id = factory_.NextId(TokenRange(Consume()));
+    std::vector<ListExprElement> elements;
+    int height = 0;
+    if (!AtEndOfInitializerList(TokenKind::kRBracket)) {
+      const SourcePosition begin = Peek().begin;
+      int unsupported = 0;
+      int count = 0;
+      do {
+        if (!ExpectInitializer(TokenKind::kRBracket, /*fields=*/false,
+                               count++ == 0)) {
+          return {};
+        }
+        bool optional = ConsumeIf(TokenKind::kQuestionMark);
+        Term element = ParseExpr(/*counted=*/false);
+        if (halted_) {
+          return {};
+        }
+        if (optional && !options_.enable_optional_syntax) {
+          ++unsupported;
+          elements.push_back(
+              factory_.NewListElement(factory_.NewUnspecified(0), false));
+          continue;
+        }
+        height = std::max(height, element.height);
+        elements.push_back(
+            factory_.NewListElement(std::move(element.expr), optional));
+      } while (NextInitializer(TokenKind::kRBracket));
+      ReportUnsupportedOptional(unsupported, SourceRange{begin, previous_end_});
+    }
+    if (!EndInitializerList(TokenKind::kRBracket)) {
+      return {};
+    }
+    return MakeTerm(factory_.NewList(list_id, std::move(elements)), height + 1);
+  }
+
+  // '{' mapInitializerList? ','? '}'
+  Term ParseCreateMap() {
+    int64_t map_id = factory_.NextId(TokenRange(Consume()));
+    std::vector<MapExprEntry> entries;
+    int height = 0;
+    if (!AtEndOfInitializerList(TokenKind::kRBrace)) {
+      const SourcePosition begin = Peek().begin;
+      int unsupported = 0;
+      int count = 0;
+      do {
+        if (!ExpectInitializer(TokenKind::kRBrace, /*fields=*/false,
+                               count++ == 0)) {
+          return {};
+        }
+        // The visitor allocates the entry id from the ':' before visiting the
+        // key, so the id is reserved now and its range recorded once known.
+        int64_t entry_id = factory_.NextId(SourceRange{});
+        bool optional = ConsumeIf(TokenKind::kQuestionMark);
+        Term key = ParseExpr();
+        Token colon;
+        if (halted_ || !Expect(TokenKind::kColon, &colon)) {
+          return {};
+        }
+        factory_.SetSourceRange(entry_id, TokenRange(colon));
+        Term value = ParseExpr();
+        if (halted_) {
+          return {};
+        }
+        if (optional && !options_.enable_optional_syntax) {
+          ++unsupported;
+          entries.push_back(factory_.NewMapEntry(0, factory_.NewUnspecified(0),
+                                                 factory_.NewUnspecified(0),
+                                                 false));
+          continue;
+        }
+        height = std::max({height, key.height, value.height});
+        entries.push_back(factory_.NewMapEntry(entry_id, std::move(key.expr),
+                                               std::move(value.expr),
+                                               optional));
+      } while (NextInitializer(TokenKind::kRBrace));
+      ReportUnsupportedOptional(unsupported, SourceRange{begin, previous_end_});
+    }
+    if (!EndInitializerList(TokenKind::kRBrace)) {
+      return {};
+    }
+    return MakeTerm(factory_.NewMap(map_id, std::move(entries)), height + 1);
+  }
+
+  // literal: '-'? NUM_INT | NUM_UINT | '-'? NUM_FLOAT | STRING | BYTES
+  //        | 'true' | 'false' | 'null'
+  Term ParseLiteral() {
+    const SourcePosition begin = Peek().begin;
+    absl::string_view sign;
+    if (ConsumeIf(TokenKind::kMinus)) {
+      sign = "-";
+    }
+    Token token = Consume();
+    SourceRange range{begin, token.end};
+    Expr expr;
+    switch (token.kind) {
+      case TokenKind::kNumInt:
+        expr = NewIntLiteral(factory_, range, sign, Text(token));
+        break;
+      case TokenKind::kNumUint:
+        expr = NewUintLiteral(factory_, range, Text(token));
+        break;
+      case TokenKind::kNumFloat:
+        expr = NewDoubleLiteral(factory_, range, sign, Text(token));
+        break;
+      case TokenKind::kString:
+        expr = NewStringLiteral(factory_, range, Text(token));
+        break;
+      case TokenKind::kBytes:
+        expr = NewBytesLiteral(factory_, range, Text(token));
+        break;
+      case TokenKind::kTrue:
+        expr = factory_.NewBoolConst(factory_.NextId(range), true);
+        break;
+      case TokenKind::kFalse:
+        expr = factory_.NewBoolConst(factory_.NextId(range), false);
+        break;
+      default:
+        expr = factory_.NewNullConst(factory_.NextId(range));
+        break;
+    }
+    return MakeTerm(std::move(expr), 1);
+  }
+
+  bool ConsumeIf(TokenKind kind) {
+    if (Peek().kind != kind) {
+      return false;
+    }
+    Consume();
+    return true;
+  }
+
+  // Whether an initializer list ending in `close` has no elements, as in
+  // `[]` or `[,]`.
+  bool AtEndOfInitializerList(TokenKind close) const {
+    return Peek().kind == close ||
+           (Peek().kind == TokenKind::kComma && Peek(1).kind == close);
+  }
+
+  // Consumes the comma separating the next element of an initializer list
+  // ending in `close`, if there is one.
+  bool NextInitializer(TokenKind close) {
+    if (Peek().kind != TokenKind::kComma || Peek(1).kind == close) {
+      return false;
+    }
+    Consume();
+    return true;
+  }
+
+  // Reports the current token unless it may start an element of an
+  // initializer list closed by `close`.
+  bool ExpectInitializer(TokenKind close, bool fields, bool first) {
+    const TokenKind kind = Peek().kind;
+    if (kind == TokenKind::kQuestionMark ||
+        (fields ? kind == TokenKind::kIdentifier : IsExpressionStart(kind))) {
+      return true;
+    }
+    ReportUnexpected(InitializerStart(close, fields, first));
+    return false;
+  }
+
+  // Consumes the optional trailing comma and the `close` token of an
+  // initializer list.
+  bool EndInitializerList(TokenKind close) {
+    if (Peek().kind == TokenKind::kComma && Peek(1).kind == close) {
+      Consume();
+    }
+    if (!ConsumeIf(close)) {
+      ReportUnexpected({TokenKind::kComma, close});
+      return false;
+    }
+    return true;
+  }
+
+  // The visitor reports optional entries, when the syntax is disabled, against
+  // the range of the whole initializer list.
+  void ReportUnsupportedOptional(int count, const SourceRange& range) {
+    for (int i = 0; i < count; ++i) {
+      factory_.ReportError(range, "unsupported syntax '?'");
+    }
+  }
+
+  const cel::Source& source_;
+  const SourceContentView content_;
+  cel::ParserMacroExprFactory factory_;
+  const cel::MacroRegistry& registry_;
+  const cel::ParserOptions& options_;
+  std::vector<Token> tokens_;
+  size_t index_ = 0;
+  SourcePosition previous_end_ = 0;
+  std::string lexer_error_;
+  int expr_depth_ = 0;
+  bool recursion_exceeded_ = false;
+  // Set on the first syntax error, after which parsing unwinds.
+  bool halted_ = false;
+  std::string cancellation_;
+};
+
+}  // namespace
+
+absl::StatusOr<ParseResult> ParseWithRecursiveDescent(
+    const cel::Source& source, const cel::MacroRegistry& registry,
+    const cel::ParserOptions& options) {
+  return RecursiveDescentParser(source, registry, options).Parse();
+}
+
+}  // namespace cel_parser_internal
@@ -0,0 +1,42 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_PARSER_INTERNAL_RECURSIVE_DESCENT_PARSER_H_
+#define THIRD_PARTY_CEL_CPP_PARSER_INTERNAL_RECURSIVE_DESCENT_PARSER_H_
+
+#include "absl/status/statusor.h"
+#include "common/source.h"
+#include "parser/internal/parser_macro_expr_factory.h"
+#include "parser/macro_registry.h"
+#include "parser/options.h"
+
+namespace cel_parser_internal {
+
+// Parses `source` with a hand written lexer and recursive descent parser
+// implementing the grammar in `Cel.g4`, without the ANTLR runtime.
+//
+// The result matches the ANTLR based parser for every valid expression,
+// including expression ids, source positions, macro expansion and the
+// recursion limits of `options`. Semantic errors (reserved identifiers,
+// invalid literals, unsupported optional syntax, macro errors) are reported
+// with the same messages. Syntax errors follow the ANTLR wording where
+// practical, but parsing stops at the first one instead of attempting
+// recovery.
+absl::StatusOr<ParseResult> ParseWithRecursiveDescent(
+    const cel::Source& source, const cel::MacroRegistry& registry,
+    const cel::ParserOptions& options);
+
+}  // namespace cel_parser_internal
+
+#endif  // THIRD_PARTY_CEL_CPP_PARSER_INTERNAL_RECURSIVE_DESCENT_PARSER_H_
@@ -50,6 +50,14 @@ struct ParserOptions final {
 
   // Disable standard macros (has, all, exists, exists_one, filter, map).
   bool disable_standard_macros = false;
+
+  // Use the hand written recursive descent parser instead of the ANTLR
+  // generated one. It produces the same AST, expression ids, source positions
+  // and macro expansions at a fraction of the cost, but does not attempt error
+  // recovery: parsing stops at the first syntax error, and the wording of
+  // syntax errors may differ. `error_recovery_limit` and
+  // `error_recovery_token_lookahead_limit` do not apply.
+  bool enable_recursive_descent_parser = false;
 };
 
 }  // namespace cel
@@ -22,8 +22,6 @@
 #include <exception>
 #include <functional>
 #include <iterator>
-#include <limits>
-#include <map>
 #include <memory>
 #include <string>
 #include <tuple>
@@ -33,22 +31,15 @@
 #include "cel/expr/syntax.pb.h"
 #include "absl/base/macros.h"
 #include "absl/base/optimization.h"
-#include "absl/container/btree_map.h"
-#include "absl/container/flat_hash_map.h"
-#include "absl/functional/overload.h"
 #include "absl/log/absl_check.h"
 #include "absl/memory/memory.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
-#include "absl/strings/match.h"
-#include "absl/strings/numbers.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/str_replace.h"
 #include "absl/strings/string_view.h"
-#include "absl/types/optional.h"
-#include "absl/types/span.h"
 #include "absl/types/variant.h"
 #include "antlr4-runtime.h"
 #include "base/ast_internal/ast_impl.h"
@@ -62,11 +53,12 @@
 #include "extensions/protobuf/internal/ast.h"
 #include "internal/lexis.h"
 #include "internal/status_macros.h"
-#include "internal/strings.h"
 #include "internal/utf8.h"
 #include "parser/internal/CelBaseVisitor.h"
 #include "parser/internal/CelLexer.h"
 #include "parser/internal/CelParser.h"
+#include "parser/internal/parser_macro_expr_factory.h"
+#include "parser/internal/recursive_descent_parser.h"
 #include "parser/macro.h"
 #include "parser/macro_expr_factory.h"
 #include "parser/macro_registry.h"
@@ -101,26 +93,6 @@ Expr ExprFromAny(std::any&& any) {
   return std::move(*expr);
 }
 
-struct ParserError {
-  std::string message;
-  SourceRange range;
-};
-
-std::string DisplayParserError(const cel::Source& source,
-                               const ParserError& error) {
-  auto location =
-      source.GetLocation(error.range.begin).value_or(SourceLocation{});
-  return absl::StrCat(absl::StrFormat("ERROR: %s:%zu:%zu: %s",
-                                      source.description(), location.line,
-                                      // add one to the 0-based column
-                                      location.column + 1, error.message),
-                      source.DisplayErrorLocation(location));
-}
-
-int32_t PositiveOrMax(int32_t value) {
-  return value >= 0 ? value : std::numeric_limits<int32_t>::max();
-}
-
 SourceRange SourceRangeFromToken(const antlr4::Token* token) {
   SourceRange range;
   if (token != nullptr) {
@@ -156,252 +128,6 @@ SourceRange SourceRangeFromParserRuleContext(
 
 }  // namespace
 
-class ParserMacroExprFactory final : public MacroExprFactory {
- public:
-  explicit ParserMacroExprFactory(const cel::Source& source)
-      : MacroExprFactory(), source_(source) {}
-
-  void BeginMacro(SourceRange macro_position) {
-    macro_position_ = macro_position;
-  }
-
-  void EndMacro() { macro_position_ = SourceRange{}; }
-
-  Expr ReportError(absl::string_view message) override {
-    return ReportError(macro_position_, message);
-  }
-
-  Expr ReportError(int64_t expr_id, absl::string_view message) {
-    return ReportError(GetSourceRange(expr_id), message);
-  }
-
-  Expr ReportError(SourceRange range, absl::string_view message) {
-    ++error_count_;
-    if (errors_.size() <= 100) {
-      errors_.push_back(ParserError{std::string(message), range});
-    }
-    return NewUnspecified(NextId(range));
-  }
-
-  Expr ReportErrorAt(const Expr& expr, absl::string_view message) override {
-    return ReportError(GetSourceRange(expr.id()), message);
-  }
-
-  SourceRange GetSourceRange(int64_t id) const {
-    if (auto it = positions_.find(id); it != positions_.end()) {
-      return it->second;
-    }
-    return SourceRange{};
-  }
-
-  int64_t NextId(const SourceRange& range) {
-    auto id = expr_id_++;
-    if (range.begin != -1 || range.end != -1) {
-      positions_.insert(std::pair{id, range});
-    }
-    return id;
-  }
-
-  bool HasErrors() const { return error_count_ != 0; }
-
-  std::string ErrorMessage() {
-    // Errors are collected as they are encountered, not by their location
-    // within the source. To have a more stable error message as implementation
-    // details change, we sort the collected errors by their source location
-    // first.
-    std::stable_sort(
-        errors_.begin(), errors_.end(),
-        [](const ParserError& lhs, const ParserError& rhs) -> bool {
-          auto lhs_begin = PositiveOrMax(lhs.range.begin);
-          auto lhs_end = PositiveOrMax(lhs.range.end);
-          auto rhs_begin = PositiveOrMax(rhs.range.begin);
-          auto rhs_end = PositiveOrMax(rhs.range.end);
-          return lhs_begin < rhs_begin ||
-                 (lhs_begin == rhs_begin && lhs_end < rhs_end);
-        });
-    // Build the summary error message using the sorted errors.
-    bool errors_truncated = error_count_ > 100;
-    std::vector<std::string> messages;
-    messages.reserve(
-        errors_.size() +
-        errors_truncated);  // Reserve space for the transform and an
-                            // additional element when truncation occurs.
-    std::transform(errors_.begin(), errors_.end(), std::back_inserter(messages),
-                   [this](const ParserError& error) {
-                     return cel::DisplayParserError(source_, error);
-                   });
-    if (errors_truncated) {
-      messages.emplace_back(
-          absl::StrCat(error_count_ - 100, " more errors were truncated."));
-    }
-    return absl::StrJoin(messages, "\n");
-  }
-
-  void AddMacroCall(int64_t macro_id, absl::string_view function,
-                    absl::optional<Expr> target, std::vector<Expr> arguments) {
-    macro_calls_.insert(
-        {macro_id, target.has_value()
-                       ? NewMemberCall(0, function, std::move(*target),
-                                       std::move(arguments))
-                       : NewCall(0, function, std::move(arguments))});
-  }
-
-  Expr BuildMacroCallArg(const Expr& expr) {
-    if (auto it = macro_calls_.find(expr.id()); it != macro_calls_.end()) {
-      return NewUnspecified(expr.id());
-    }
-    return absl::visit(
-        absl::Overload(
-            [this, &expr](const UnspecifiedExpr&) -> Expr {
-              return NewUnspecified(expr.id());
-            },
-            [this, &expr](const Constant& const_expr) -> Expr {
-              return NewConst(expr.id(), const_expr);
-            },
-            [this, &expr](const IdentExpr& ident_expr) -> Expr {
-              return NewIdent(expr.id(), ident_expr.name());
-            },
-            [this, &expr](const SelectExpr& select_expr) -> Expr {
-              return select_expr.test_only()
-                         ? NewPresenceTest(
-                               expr.id(),
-                               BuildMacroCallArg(select_expr.operand()),
-                               select_expr.field())
-                         : NewSelect(expr.id(),
-                                     BuildMacroCallArg(select_expr.operand()),
-                                     select_expr.field());
-            },
-            [this, &expr](const CallExpr& call_expr) -> Expr {
-              std::vector<Expr> macro_arguments;
-              macro_arguments.reserve(call_expr.args().size());
-              for (const auto& argument : call_expr.args()) {
-                macro_arguments.push_back(BuildMacroCallArg(argument));
-              }
-              absl::optional<Expr> macro_target;
-              if (call_expr.has_target()) {
-                macro_target = BuildMacroCallArg(call_expr.target());
-              }
-              return macro_target.has_value()
-                         ? NewMemberCall(expr.id(), call_expr.function(),
-                                         std::move(*macro_target),
-                                         std::move(macro_arguments))
-                         : NewCall(expr.id(), call_expr.function(),
-                                   std::move(macro_arguments));
-            },
-            [this, &expr](const ListExpr& list_expr) -> Expr {
-              std::vector<ListExprElement> macro_elements;
-              macro_elements.reserve(list_expr.elements().size());
-              for (const auto& element : list_expr.elements()) {
-                auto& cloned_element = macro_elements.emplace_back();
-                if (element.has_expr()) {
-                  cloned_element.set_expr(BuildMacroCallArg(element.expr()));
-                }
-                cloned_element.set_optional(element.optional());
-              }
-              return NewList(expr.id(), std::move(macro_elements));
-            },
-            [this, &expr](const StructExpr& struct_expr) -> Expr {
-              std::vector<StructExprField> macro_fields;
-              macro_fields.reserve(struct_expr.fields().size());
-              for (const auto& field : struct_expr.fields()) {
-                auto& macro_field = macro_fields.emplace_back();
-                macro_field.set_id(field.id());
-                macro_field.set_name(field.name());
-                macro_field.set_value(BuildMacroCallArg(field.value()));
-                macro_field.set_optional(field.optional());
-              }
-              return NewStruct(expr.id(), struct_expr.name(),
-                               std::move(macro_fields));
-            },
-            [this, &expr](const MapExpr& map_expr) -> Expr {
-              std::vector<MapExprEntry> macro_entries;
-              macro_entries.reserve(map_expr.entries().size());
-              for (const auto& entry : map_expr.entries()) {
-                auto& macro_entry = macro_entries.emplace_back();
-                macro_entry.set_id(entry.id());
-                macro_entry.set_key(BuildMacroCallArg(entry.key()));
-                macro_entry.set_value(BuildMacroCallArg(entry.value()));
-                macro_entry.set_optional(entry.optional());
-              }
-              return NewMap(expr.id(), std::move(macro_entries));
-            },
-            [this, &expr](const ComprehensionExpr& comprehension_expr) -> Expr {
-              return NewComprehension(
-                  expr.id(), comprehension_expr.iter_var(),
-                  BuildMacroCallArg(comprehension_expr.iter_range()),
-                  comprehension_expr.accu_var(),
-                  BuildMacroCallArg(comprehension_expr.accu_init()),
-                  BuildMacroCallArg(comprehension_expr.loop_condition()),
-                  BuildMacroCallArg(comprehension_expr.loop_step()),
-                  BuildMacroCallArg(comprehension_expr.result()));
-            }),
-        expr.kind());
-  }
-
-  using ExprFactory::NewBoolConst;
-  using ExprFactory::NewBytesConst;
-  using ExprFactory::NewCall;
-  using ExprFactory::NewComprehension;
-  using ExprFactory::NewConst;
-  using ExprFactory::NewDoubleConst;
-  using ExprFactory::NewIdent;
-  using ExprFactory::NewIntConst;
-  using ExprFactory::NewList;
-  using ExprFactory::NewListElement;
-  using ExprFactory::NewMap;
-  using ExprFactory::NewMapEntry;
-  using ExprFactory::NewMemberCall;
-  using ExprFactory::NewNullConst;
-  using ExprFactory::NewPresenceTest;
-  using ExprFactory::NewSelect;
-  using ExprFactory::NewStringConst;
-  using ExprFactory::NewStruct;
-  using ExprFactory::NewStructField;
-  using ExprFactory::NewUintConst;
-  using ExprFactory::NewUnspecified;
-
-  const absl::btree_map<int64_t, SourceRange>& positions() const {
-    return positions_;
-  }
-
-  const absl::flat_hash_map<int64_t, Expr>& macro_calls() const {
-    return macro_calls_;
-  }
-
-  absl::flat_hash_map<int64_t, Expr> release_macro_calls() {
-    using std::swap;
-    absl::flat_hash_map<int64_t, Expr> result;
-    swap(result, macro_calls_);
-    return result;
-  }
-
-  void EraseId(ExprId id) {
-    positions_.erase(id);
-    if (expr_id_ == id + 1) {
-      --expr_id_;
-    }
-  }
-
- protected:
-  int64_t NextId() override { return NextId(macro_position_); }
-
-  int64_t CopyId(int64_t id) override {
-    if (id == 0) {
-      return 0;
-    }
-    return NextId(GetSourceRange(id));
-  }
-
- private:
-  int64_t expr_id_ = 1;
-  absl::btree_map<int64_t, SourceRange> positions_;
-  absl::flat_hash_map<int64_t, Expr> macro_calls_;
-  std::vector<ParserError> errors_;
-  size_t error_count_ = 0;
-  const Source& source_;
-  SourceRange macro_position_;
-};
-
 }  // namespace cel
 
 namespace google::api::expr::parser {
@@ -433,6 +159,8 @@ using ::cel::StructExprField;
 using ::cel_parser_internal::CelBaseVisitor;
 using ::cel_parser_internal::CelLexer;
 using ::cel_parser_internal::CelParser;
+using ::cel_parser_internal::ExpressionBalancer;
+using ::cel_parser_internal::ParseResult;
 using common::CelOperator;
 using common::ReverseLookupOperator;
 using ::cel::expr::ParsedExpr;
@@ -525,78 +253,6 @@ class ScopedIncrement final {
   int& recursion_depth_;
 };
 
-// balancer performs tree balancing on operators whose arguments are of equal
-// precedence.
-//
-// The purpose of the balancer is to ensure a compact serialization format for
-// the logical &&, || operators which have a tendency to create long DAGs which
-// are skewed in one direction. Since the operators are commutative re-ordering
-// the terms *must not* affect the evaluation result.
-//
-// Based on code from //third_party/cel/go/parser/helper.go
-class ExpressionBalancer final {
- public:
-  ExpressionBalancer(cel::ParserMacroExprFactory& factory, std::string function,
-                     Expr expr);
-
-  // addTerm adds an operation identifier and term to the set of terms to be
-  // balanced.
-  void AddTerm(int64_t op, Expr term);
-
-  // balance creates a balanced tree from the sub-terms and returns the final
-  // Expr value.
-  Expr Balance();
-
- private:
-  // balancedTree recursively balances the terms provided to a commutative
-  // operator.
-  Expr BalancedTree(int lo, int hi);
-
- private:
-  cel::ParserMacroExprFactory& factory_;
-  std::string function_;
-  std::vector<Expr> terms_;
-  std::vector<int64_t> ops_;
-};
-
-ExpressionBalancer::ExpressionBalancer(cel::ParserMacroExprFactory& factory,
-                                       std::string function, Expr expr)
-    : factory_(factory), function_(std::move(function)) {
-  terms_.push_back(std::move(expr));
-}
-
-void ExpressionBalancer::AddTerm(int64_t op, Expr term) {
-  terms_.push_back(std::move(term));
-  ops_.push_back(op);
-}
-
-Expr ExpressionBalancer::Balance() {
-  if (terms_.size() == 1) {
-    return std::move(terms_[0]);
-  }
-  return BalancedTree(0, ops_.size() - 1);
-}
-
-Expr ExpressionBalancer::BalancedTree(int lo, int hi) {
-  int mid = (lo + hi + 1) / 2;
-
-  std::vector<Expr> arguments;
-  arguments.reserve(2);
-
-  if (mid == lo) {
-    arguments.push_back(std::move(terms_[mid]));
-  } else {
-    arguments.push_back(BalancedTree(lo, mid - 1));
-  }
-
-  if (mid == hi) {
-    arguments.push_back(std::move(terms_[mid + 1]));
-  } else {
-    arguments.push_back(BalancedTree(mid + 1, hi));
-  }
-  return factory_.NewCall(ops_[mid], function_, std::move(arguments));
-}
-
 class ParserVisitor final : public CelBaseVisitor,
                             public antlr4::BaseErrorListener {
  public:
@@ -1256,91 +912,30 @@ std::vector<MapExprEntry> ParserVisitor::visitEntries(
 }
 
 std::any ParserVisitor::visitInt(CelParser::IntContext* ctx) {
-  std::string value;
-  if (ctx->sign) {
-    value = ctx->sign->getText();
-  }
-  value += ctx->tok->getText();
-  int64_t int_value;
-  if (absl::StartsWith(ctx->tok->getText(), "0x")) {
-    if (absl::SimpleHexAtoi(value, &int_value)) {
-      return ExprToAny(factory_.NewIntConst(
-          factory_.NextId(SourceRangeFromParserRuleContext(ctx)), int_value));
-    } else {
-      return ExprToAny(factory_.ReportError(
-          SourceRangeFromParserRuleContext(ctx), "invalid hex int literal"));
-    }
-  }
-  if (absl::SimpleAtoi(value, &int_value)) {
-    return ExprToAny(factory_.NewIntConst(
-        factory_.NextId(SourceRangeFromParserRuleContext(ctx)), int_value));
-  } else {
-    return ExprToAny(factory_.ReportError(SourceRangeFromParserRuleContext(ctx),
-                                          "invalid int literal"));
-  }
+  return ExprToAny(cel_parser_internal::NewIntLiteral(
+      factory_, SourceRangeFromParserRuleContext(ctx),
+      ctx->sign ? ctx->sign->getText() : "", ctx->tok->getText()));
 }
 
 std::any ParserVisitor::visitUint(CelParser::UintContext* ctx) {
-  std::string value = ctx->tok->getText();
-  // trim the 'u' designator included in the uint literal.
-  if (!value.empty()) {
-    value.resize(value.size() - 1);
-  }
-  uint64_t uint_value;
-  if (absl::StartsWith(ctx->tok->getText(), "0x")) {
-    if (absl::SimpleHexAtoi(value, &uint_value)) {
-      return ExprToAny(factory_.NewUintConst(
-          factory_.NextId(SourceRangeFromParserRuleContext(ctx)), uint_value));
-    } else {
-      return ExprToAny(factory_.ReportError(
-          SourceRangeFromParserRuleContext(ctx), "invalid hex uint literal"));
-    }
-  }
-  if (absl::SimpleAtoi(value, &uint_value)) {
-    return ExprToAny(factory_.NewUintConst(
-        factory_.NextId(SourceRangeFromParserRuleContext(ctx)), uint_value));
-  } else {
-    return ExprToAny(factory_.ReportError(SourceRangeFromParserRuleContext(ctx),
-                                          "invalid uint literal"));
-  }
+  return ExprToAny(cel_parser_internal::NewUintLiteral(
+      factory_, SourceRangeFromParserRuleContext(ctx), ctx->tok->getText()));
 }
 
 std::any ParserVisitor::visitDouble(CelParser::DoubleContext* ctx) {
-  std::string value;
-  if (ctx->sign) {
-    value = ctx->sign->getText();
-  }
-  value += ctx->tok->getText();
-  double double_value;
-  if (absl::SimpleAtod(value, &double_value)) {
-    return ExprToAny(factory_.NewDoubleConst(
-        factory_.NextId(SourceRangeFromParserRuleContext(ctx)), double_value));
-  } else {
-    return ExprToAny(factory_.ReportError(SourceRangeFromParserRuleContext(ctx),
-                                          "invalid double literal"));
-  }
+  return ExprToAny(cel_parser_internal::NewDoubleLiteral(
+      factory_, SourceRangeFromParserRuleContext(ctx),
+      ctx->sign ? ctx->sign->getText() : "", ctx->tok->getText()));
 }
 
 std::any ParserVisitor::visitString(CelParser::StringContext* ctx) {
-  auto status_or_value = cel::internal::ParseStringLiteral(ctx->tok->getText());
-  if (!status_or_value.ok()) {
-    return ExprToAny(factory_.ReportError(SourceRangeFromParserRuleContext(ctx),
-                                          status_or_value.status().message()));
-  }
-  return ExprToAny(factory_.NewStringConst(
-      factory_.NextId(SourceRangeFromParserRuleContext(ctx)),
-      std::move(status_or_value).value()));
+  return ExprToAny(cel_parser_internal::NewStringLiteral(
+      factory_, SourceRangeFromParserRuleContext(ctx), ctx->tok->getText()));
 }
 
 std::any ParserVisitor::visitBytes(CelParser::BytesContext* ctx) {
-  auto status_or_value = cel::internal::ParseBytesLiteral(ctx->tok->getText());
-  if (!status_or_value.ok()) {
-    return ExprToAny(factory_.ReportError(SourceRangeFromParserRuleContext(ctx),
-                                          status_or_value.status().message()));
-  }
-  return ExprToAny(factory_.NewBytesConst(
-      factory_.NextId(SourceRangeFromParserRuleContext(ctx)),
-      std::move(status_or_value).value()));
+  return ExprToAny(cel_parser_internal::NewBytesLiteral(
+      factory_, SourceRangeFromParserRuleContext(ctx), ctx->tok->getText()));
 }
 
 std::any ParserVisitor::visitBoolTrue(CelParser::BoolTrueContext* ctx) {
@@ -1359,29 +954,11 @@ std::any ParserVisitor::visitNull(CelParser::NullContext* ctx) {
 }
 
 cel::ast_internal::SourceInfo ParserVisitor::GetSourceInfo() {
-  cel::ast_internal::SourceInfo source_info;
-  source_info.set_location(std::string(source_.description()));
-  for (const auto& positions : factory_.positions()) {
-    source_info.mutable_positions().insert(
-        std::pair{positions.first, positions.second.begin});
-  }
-  source_info.mutable_line_offsets().reserve(source_.line_offsets().size());
-  for (const auto& line_offset : source_.line_offsets()) {
-    source_info.mutable_line_offsets().push_back(line_offset);
-  }
-
-  source_info.mutable_macro_calls() = factory_.release_macro_calls();
-  return source_info;
+  return cel_parser_internal::BuildSourceInfo(source_, factory_);
 }
 
 EnrichedSourceInfo ParserVisitor::enriched_source_info() const {
-  std::map<int64_t, std::pair<int32_t, int32_t>> offsets;
-  for (const auto& positions : factory_.positions()) {
-    offsets.insert(
-        std::pair{positions.first,
-                  std::pair{positions.second.begin, positions.second.end - 1}});
-  }
-  return EnrichedSourceInfo(std::move(offsets));
+  return cel_parser_internal::BuildEnrichedSourceInfo(factory_);
 }
 
 void ParserVisitor::syntaxError(antlr4::Recognizer* recognizer,
@@ -1404,62 +981,18 @@ std::string ParserVisitor::ErrorMessage() { return factory_.ErrorMessage(); }
 Expr ParserVisitor::GlobalCallOrMacroImpl(int64_t expr_id,
                                           absl::string_view function,
                                           std::vector<Expr> args) {
-  if (auto macro = macro_registry_.FindMacro(function, args.size(), false);
-      macro) {
-    std::vector<Expr> macro_args;
-    if (add_macro_calls_) {
-      macro_args.reserve(args.size());
-      for (const auto& arg : args) {
-        macro_args.push_back(factory_.BuildMacroCallArg(arg));
-      }
-    }
-    factory_.BeginMacro(factory_.GetSourceRange(expr_id));
-    auto expr = macro->Expand(factory_, absl::nullopt, absl::MakeSpan(args));
-    factory_.EndMacro();
-    if (expr) {
-      if (add_macro_calls_) {
-        factory_.AddMacroCall(expr->id(), function, absl::nullopt,
-                              std::move(macro_args));
-      }
-      // We did not end up using `expr_id`. Delete metadata.
-      factory_.EraseId(expr_id);
-      return std::move(*expr);
-    }
-  }
-
-  return factory_.NewCall(expr_id, function, std::move(args));
+  return cel_parser_internal::GlobalCallOrMacro(
+      factory_, macro_registry_, add_macro_calls_, expr_id, function,
+      std::move(args));
 }
 
 Expr ParserVisitor::ReceiverCallOrMacroImpl(int64_t expr_id,
                                             absl::string_view function,
                                             Expr target,
                                             std::vector<Expr> args) {
-  if (auto macro = macro_registry_.FindMacro(function, args.size(), true);
-      macro) {
-    Expr macro_target;
-    std::vector<Expr> macro_args;
-    if (add_macro_calls_) {
-      macro_args.reserve(args.size());
-      macro_target = factory_.BuildMacroCallArg(target);
-      for (const auto& arg : args) {
-        macro_args.push_back(factory_.BuildMacroCallArg(arg));
-      }
-    }
-    factory_.BeginMacro(factory_.GetSourceRange(expr_id));
-    auto expr = macro->Expand(factory_, std::ref(target), absl::MakeSpan(args));
-    factory_.EndMacro();
-    if (expr) {
-      if (add_macro_calls_) {
-        factory_.AddMacroCall(expr->id(), function, std::move(macro_target),
-                              std::move(macro_args));
-      }
-      // We did not end up using `expr_id`. Delete metadata.
-      factory_.EraseId(expr_id);
-      return std::move(*expr);
-    }
-  }
-  return factory_.NewMemberCall(expr_id, function, std::move(target),
-                                std::move(args));
+  return cel_parser_internal::ReceiverCallOrMacro(
+      factory_, macro_registry_, add_macro_calls_, expr_id, function,
+      std::move(target), std::move(args));
 }
 
 std::string ParserVisitor::ExtractQualifiedName(antlr4::ParserRuleContext* ctx,
@@ -1597,15 +1130,13 @@ class RecoveryLimitErrorStrategy final : public DefaultErrorStrategy {
   int recovery_token_lookahead_limit_;
 };
 
-struct ParseResult {
-  cel::Expr expr;
-  cel::ast_internal::SourceInfo source_info;
-  EnrichedSourceInfo enriched_source_info;
-};
-
 absl::StatusOr<ParseResult> ParseImpl(const cel::Source& source,
                                       const cel::MacroRegistry& registry,
                                       const ParserOptions& options) {
+  if (options.enable_recursive_descent_parser) {
+    return cel_parser_internal::ParseWithRecursiveDescent(source, registry,
+                                                          options);
+  }
   try {
     CodePointStream input(source.content(), source.description());
     if (input.size() > options.expression_size_codepoint_limit) {
@@ -1662,6 +1193,28 @@ absl::StatusOr<ParseResult> ParseImpl(const cel::Source& source,
   }
 }
 
+absl::StatusOr<std::unique_ptr<cel::Ast>> ParseAstImpl(
+    const cel::Source& source, const cel::MacroRegistry& registry,
+    const ParserOptions& options) {
+  CEL_ASSIGN_OR_RETURN(auto parse_result,
+                       ParseImpl(source, registry, options));
+  return std::make_unique<cel::ast_internal::AstImpl>(
+      std::move(parse_result.expr), std::move(parse_result.source_info));
+}
+
+// Returns the macros enabled by `options`, when no explicit macros are given.
+std::vector<Macro> DefaultMacros(const ParserOptions& options) {
+  std::vector<Macro> macros;
+  if (!options.disable_standard_macros) {
+    macros = Macro::AllMacros();
+  }
+  if (options.enable_optional_syntax) {
+    macros.push_back(cel::OptMapMacro());
+    macros.push_back(cel::OptFlatMapMacro());
+  }
+  return macros;
+}
+
 class ParserImpl : public cel::Parser {
  public:
   explicit ParserImpl(const ParserOptions& options,
@@ -1669,10 +1222,7 @@ class ParserImpl : public cel::Parser {
       : options_(options), macro_registry_(std::move(macro_registry)) {}
   absl::StatusOr<std::unique_ptr<cel::Ast>> Parse(
       const cel::Source& source) const override {
-    CEL_ASSIGN_OR_RETURN(auto parse_result,
-                         ParseImpl(source, macro_registry_, options_));
-    return std::make_unique<cel::ast_internal::AstImpl>(
-        std::move(parse_result.expr), std::move(parse_result.source_info));
+    return ParseAstImpl(source, macro_registry_, options_);
   }
 
  private:
@@ -1722,15 +1272,8 @@ class ParserBuilderImpl : public cel::ParserBuilder {
 absl::StatusOr<ParsedExpr> Parse(absl::string_view expression,
                                  absl::string_view description,
                                  const ParserOptions& options) {
-  std::vector<Macro> macros;
-  if (!options.disable_standard_macros) {
-    macros = Macro::AllMacros();
-  }
-  if (options.enable_optional_syntax) {
-    macros.push_back(cel::OptMapMacro());
-    macros.push_back(cel::OptFlatMapMacro());
-  }
-  return ParseWithMacros(expression, macros, description, options);
+  return ParseWithMacros(expression, DefaultMacros(options), description,
+                         options);
 }
 
 absl::StatusOr<ParsedExpr> ParseWithMacros(absl::string_view expression,
@@ -1776,6 +1319,22 @@ absl::StatusOr<cel::expr::ParsedExpr> Parse(
   return verbose_expr.parsed_expr();
 }
 
+absl::StatusOr<std::unique_ptr<cel::Ast>> ParseAst(
+    const cel::Source& source, const cel::MacroRegistry& registry,
+    const ParserOptions& options) {
+  return ParseAstImpl(source, registry, options);
+}
+
+absl::StatusOr<std::unique_ptr<cel::Ast>> ParseAst(
+    absl::string_view expression, absl::string_view description,
+    const ParserOptions& options) {
+  CEL_ASSIGN_OR_RETURN(auto source,
+                       cel::NewSource(expression, std::string(description)));
+  cel::MacroRegistry macro_registry;
+  CEL_RETURN_IF_ERROR(macro_registry.RegisterMacros(DefaultMacros(options)));
+  return ParseAstImpl(*source, macro_registry, options);
+}
+
 }  // namespace google::api::expr::parser
 
 namespace cel {
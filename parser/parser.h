@@ -28,6 +28,7 @@
 #include "cel/expr/syntax.pb.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
+#include "common/ast.h"
 #include "common/source.h"
 #include "parser/macro.h"
 #include "parser/macro_registry.h"
@@ -88,6 +89,26 @@ absl::StatusOr<cel::expr::ParsedExpr> Parse(
     const cel::Source& source, const cel::MacroRegistry& registry,
     const ParserOptions& options = ParserOptions());
 
+// Parses `source` directly into the native AST. Unlike `Parse`, this does not
+// build a `cel::expr::ParsedExpr` only for it to be converted back by
+// `cel::extensions::CreateAstFromParsedExpr`, so prefer it when the result is
+// type checked or planned. The proto form can still be produced on request
+// with `cel::extensions::CreateParsedExprFromAst`.
+//
+// See comments at the top of the file for information about usage during C++
+// static initialization.
+absl::StatusOr<std::unique_ptr<cel::Ast>> ParseAst(
+    const cel::Source& source, const cel::MacroRegistry& registry,
+    const ParserOptions& options = ParserOptions());
+
+// Same as above, but with the macros enabled by `options`, like `Parse`.
+//
+// See comments at the top of the file for information about usage during C++
+// static initialization.
+absl::StatusOr<std::unique_ptr<cel::Ast>> ParseAst(
+    absl::string_view expression, absl::string_view description = "<input>",
+    const ParserOptions& options = ParserOptions());
+
 }  // namespace google::api::expr::parser
 
 namespace cel {
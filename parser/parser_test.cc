@@ -22,9 +22,11 @@
 
 #include "cel/expr/syntax.pb.h"
 #include "absl/algorithm/container.h"
+#include "absl/log/absl_check.h"
 #include "absl/status/status.h"
 #include "absl/status/status_matchers.h"
 #include "absl/strings/ascii.h"
+#include "absl/strings/match.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
@@ -37,6 +39,7 @@
 #include "internal/benchmark.h"
 #include "internal/testing.h"
 #include "parser/macro.h"
+#include "parser/macro_registry.h"
 #include "parser/options.h"
 #include "parser/source_factory.h"
 #include "testutil/expr_printer.h"
@@ -1445,6 +1448,83 @@ TEST_P(ExpressionTest, Parse) {
   }
 }
 
+struct ErrorDifference {
+  absl::string_view input;
+  absl::string_view error;
+};
+
+// Inputs for which the recursive descent parser reports a different first
+// error than the ANTLR one.
+constexpr ErrorDifference kRecursiveDescentErrorDifferences[] = {
+    // The lexer stops at the unrecognized '@', so the parser cannot tell that
+    // the input after '*' would be valid. '*' is reported as mismatched rather
+    // than extraneous.
+    {"*@a | b",
+     "ERROR: <input>:1:1: Syntax error: mismatched input '*' expecting {'[', "
+     "'{', '(', '.', '-', '!', 'true', 'false', 'null', NUM_FLOAT, NUM_INT, "
+     "NUM_UINT, STRING, BYTES, IDENTIFIER}\n | *@a | b\n | ^"},
+};
+
+std::string ExpectedRecursiveDescentError(const TestInfo& test_info) {
+  for (const ErrorDifference& difference : kRecursiveDescentErrorDifferences) {
+    if (difference.input == test_info.I) {
+      return std::string(difference.error);
+    }
+  }
+  // Semantic errors are all reported, but without error recovery parsing
+  // stops at the first syntax error.
+  absl::string_view errors = test_info.E;
+  if (!absl::StrContains(errors, "Syntax error")) {
+    return std::string(errors);
+  }
+  return std::string(errors.substr(0, errors.find("\nERROR: ")));
+}
+
+TEST_P(ExpressionTest, RecursiveDescentParse) {
+  const TestInfo& test_info = GetParam();
+  ParserOptions options;
+  if (!test_info.M.empty()) {
+    options.add_macro_calls = true;
+  }
+  options.enable_optional_syntax = true;
+  options.enable_recursive_descent_parser = true;
+
+  std::vector<Macro> macros = Macro::AllMacros();
+  macros.push_back(cel::OptMapMacro());
+  macros.push_back(cel::OptFlatMapMacro());
+  auto result = EnrichedParse(test_info.I, macros, "<input>", options);
+  if (test_info.E.empty()) {
+    ASSERT_THAT(result, IsOk());
+  } else {
+    ASSERT_THAT(result, Not(IsOk()));
+    EXPECT_EQ(ExpectedRecursiveDescentError(test_info),
+              result.status().message());
+    return;
+  }
+
+  if (!test_info.P.empty()) {
+    KindAndIdAdorner kind_and_id_adorner;
+    ExprPrinter w(kind_and_id_adorner);
+    EXPECT_EQ(test_info.P, w.PrintProto(result->parsed_expr().expr()));
+  }
+
+  if (!test_info.L.empty()) {
+    LocationAdorner location_adorner(result->parsed_expr().source_info());
+    ExprPrinter w(location_adorner);
+    EXPECT_EQ(test_info.L, w.PrintProto(result->parsed_expr().expr()));
+  }
+
+  if (!test_info.R.empty()) {
+    EXPECT_EQ(test_info.R, ConvertEnrichedSourceInfoToString(
+                               result->enriched_source_info()));
+  }
+
+  if (!test_info.M.empty()) {
+    EXPECT_EQ(test_info.M, ConvertMacroCallsToString(
+                               result->parsed_expr().source_info()));
+  }
+}
+
 TEST(ExpressionTest, TsanOom) {
   Parse(
       "[[a([[???[a[[??[a([[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[["
@@ -1532,6 +1612,18 @@ TEST(ExpressionTest, DisableStandardMacros) {
       << adorned_string;
 }
 
+TEST(ExpressionTest, RecursiveDescentRecursionDepthExceeded) {
+  ParserOptions options;
+  options.max_recursion_depth = 6;
+  options.enable_recursive_descent_parser = true;
+
+  EXPECT_THAT(Parse("(((1 + 2 + 3 + 4 + (5 + 6))))", "", options), IsOk());
+  auto result = Parse("1 + 2 + 3 + 4 + 5 + 6 + 7", "", options);
+  EXPECT_THAT(result, Not(IsOk()));
+  EXPECT_THAT(result.status().message(),
+              HasSubstr("Exceeded max recursion depth of 6 when parsing."));
+}
+
 TEST(ExpressionTest, RecursionDepthIgnoresParentheses) {
   ParserOptions options;
   options.max_recursion_depth = 6;
@@ -1591,6 +1683,55 @@ TEST(NewParserBuilderTest, ForwardsOptions) {
               StatusIs(absl::StatusCode::kInvalidArgument));
 }
 
+TEST(ParseAstTest, MatchesParse) {
+  ParserOptions options;
+  options.enable_optional_syntax = true;
+  for (absl::string_view expression :
+       {"has(a.b) && [].exists(x, x > 0)", "{'a': 1}[?'a'].orValue(2)",
+        "[1, 2].optMap(x, x + 1)", "a.b.c(d) ? x : TestAllTypes{f: 1}"}) {
+    SCOPED_TRACE(expression);
+    ASSERT_OK_AND_ASSIGN(auto parsed_expr, Parse(expression, "", options));
+    ASSERT_OK_AND_ASSIGN(auto ast, ParseAst(expression, "", options));
+    EXPECT_FALSE(ast->IsChecked());
+
+    KindAndIdAdorner kind_and_id_adorner;
+    ExprPrinter w(kind_and_id_adorner);
+    const auto& ast_impl = cel::ast_internal::AstImpl::CastFromPublicAst(*ast);
+    EXPECT_EQ(w.Print(ast_impl.root_expr()),
+              w.PrintProto(parsed_expr.expr()));
+    EXPECT_EQ(ast_impl.source_info().positions().size(),
+              parsed_expr.source_info().positions().size());
+  }
+}
+
+TEST(ParseAstTest, CustomMacros) {
+  ParserOptions options;
+  options.disable_standard_macros = true;
+  cel::MacroRegistry registry;
+  ASSERT_THAT(registry.RegisterMacro(cel::HasMacro()), IsOk());
+  ASSERT_OK_AND_ASSIGN(auto source, cel::NewSource("has(a.b) && [].all(x, x)"));
+
+  ASSERT_OK_AND_ASSIGN(auto ast, ParseAst(*source, registry, options));
+
+  KindAndIdAdorner kind_and_id_adorner;
+  ExprPrinter w(kind_and_id_adorner);
+  const auto& ast_impl = cel::ast_internal::AstImpl::CastFromPublicAst(*ast);
+  EXPECT_EQ(w.Print(ast_impl.root_expr()),
+            "_&&_(\n"
+            "  a^#2:Expr.Ident#.b~test-only~^#4:Expr.Select#,\n"
+            "  []^#5:Expr.CreateList#.all(\n"
+            "    x^#7:Expr.Ident#,\n"
+            "    x^#8:Expr.Ident#\n"
+            "  )^#6:Expr.Call#\n"
+            ")^#9:Expr.Call#");
+}
+
+TEST(ParseAstTest, ReportsErrors) {
+  EXPECT_THAT(ParseAst("a.?b"), StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(ParseAst("1 +"), StatusIs(absl::StatusCode::kInvalidArgument,
+                                        HasSubstr("Syntax error")));
+}
+
 std::string TestName(const testing::TestParamInfo<TestInfo>& test_info) {
   std::string name = absl::StrCat(test_info.index, "-", test_info.param.I);
   absl::c_replace_if(name, [](char c) { return !absl::ascii_isalnum(c); }, '_');
@@ -1614,5 +1755,41 @@ void BM_Parse(benchmark::State& state) {
 
 BENCHMARK(BM_Parse)->ThreadRange(1, std::thread::hardware_concurrency());
 
+void BM_ParseAst(benchmark::State& state) {
+  ParserOptions options;
+  cel::MacroRegistry registry;
+  ABSL_CHECK_OK(registry.RegisterMacros(Macro::AllMacros()));
+  for (auto s : state) {
+    for (const auto& test_case : test_cases) {
+      if (test_case.benchmark) {
+        auto source = cel::NewSource(test_case.I);
+        ABSL_CHECK_OK(source.status());
+        benchmark::DoNotOptimize(ParseAst(**source, registry, options));
+      }
+    }
+  }
+}
+
+BENCHMARK(BM_ParseAst)->ThreadRange(1, std::thread::hardware_concurrency());
+
+void BM_ParseAstRecursiveDescent(benchmark::State& state) {
+  ParserOptions options;
+  options.enable_recursive_descent_parser = true;
+  cel::MacroRegistry registry;
+  ABSL_CHECK_OK(registry.RegisterMacros(Macro::AllMacros()));
+  for (auto s : state) {
+    for (const auto& test_case : test_cases) {
+      if (test_case.benchmark) {
+        auto source = cel::NewSource(test_case.I);
+        ABSL_CHECK_OK(source.status());
+        benchmark::DoNotOptimize(ParseAst(**source, registry, options));
+      }
+    }
+  }
+}
+
+BENCHMARK(BM_ParseAstRecursiveDescent)
+    ->ThreadRange(1, std::thread::hardware_concurrency());
+
 }  // namespace
 }  // namespace google::api::expr::parser
@@ -24,6 +24,7 @@
 #include "absl/types/optional.h"
 #include "base/function.h"
 #include "base/function_descriptor.h"
+#include "common/internal/reference_count.h"
 #include "common/value.h"
 #include "internal/status_macros.h"
 #include "runtime/function_overload_reference.h"
@@ -61,9 +62,16 @@ absl::StatusOr<bool> Activation::ProvideValue(ValueManager& factory,
     return true;
   }
 
-  CEL_ASSIGN_OR_RETURN(auto provided, (*entry.provider)(factory, name));
-  if (provided.has_value()) {
-    entry.value = std::move(provided);
+  absl::StatusOr<absl::optional<Value>> provided;
+  {
+    // The value is cached for every evaluation sharing this activation, so it
+    // must not use reference counts local to the current one.
+    common_internal::SuspendLocalReferenceCounting suspend_local_refcounts;
+    provided = (*entry.provider)(factory, name);
+  }
+  CEL_RETURN_IF_ERROR(provided.status());
+  if (provided->has_value()) {
+    entry.value = *std::move(provided);
     result = *entry.value;
     return true;
   }
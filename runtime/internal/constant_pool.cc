@@ -0,0 +1,168 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/internal/constant_pool.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/hash/hash.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "base/ast_internal/expr.h"
+#include "common/constant.h"
+#include "common/internal/reference_count.h"
+#include "common/memory.h"
+#include "common/value.h"
+#include "common/value_manager.h"
+#include "runtime/internal/convert_constant.h"
+#include "re2/re2.h"
+
+namespace cel::runtime_internal {
+namespace {
+
+using ::cel::common_internal::MakeReferenceCountedString;
+using ::cel::common_internal::ReferenceCount;
+using ::cel::common_internal::StrengthenRef;
+using ::cel::common_internal::StrongUnref;
+using ::cel::common_internal::WeakRef;
+using ::cel::common_internal::WeakUnref;
+
+}  // namespace
+
+ConstantPool::~ConstantPool() {
+  for (const auto& [hash, entries] : data_) {
+    for (const Entry& entry : entries) {
+      WeakUnref(*entry.refcount);
+    }
+  }
+}
+
+absl::StatusOr<Value> ConstantPool::InternConstant(
+    const ast_internal::Constant& constant, ValueManager& value_factory) {
+  if (constant.has_string_value() && !constant.string_value().empty()) {
+    return InternData(Kind::kString, constant.string_value());
+  }
+  if (constant.has_bytes_value() && !constant.bytes_value().empty()) {
+    return InternData(Kind::kBytes, constant.bytes_value());
+  }
+  return ConvertConstant(constant, value_factory);
+}
+
+Value ConstantPool::InternData(Kind kind, absl::string_view data) {
+  // Values borrow the reference count, taking their own strong reference.
+  auto make_value = [kind](const ReferenceCount* refcount,
+                           absl::string_view data) -> Value {
+    if (kind == Kind::kString) {
+      return StringValue(Borrower::ReferenceCount(refcount), data);
+    }
+    return BytesValue(Borrower::ReferenceCount(refcount), data);
+  };
+
+  const size_t hash = absl::HashOf(kind, data);
+  absl::MutexLock lock(&mutex_);
+  std::vector<Entry>& bucket = data_[hash];
+  for (Entry& entry : bucket) {
+    if (entry.kind != kind || !StrengthenRef(*entry.refcount)) {
+      continue;
+    }
+    if (entry.data == data) {
+      Value value = make_value(entry.refcount, entry.data);
+      StrongUnref(*entry.refcount);
+      return value;
+    }
+    StrongUnref(*entry.refcount);
+  }
+
+  auto [refcount, stored] = MakeReferenceCountedString(data);
+  Value value = make_value(refcount, stored);
+  // Trade the strong reference returned above for the weak reference held by
+  // the pool, leaving `value` as the only owner.
+  WeakRef(*refcount);
+  StrongUnref(*refcount);
+  bucket.push_back(Entry{kind, refcount, stored});
+  ++data_size_;
+  MaybeSweepLocked();
+  return value;
+}
+
+void ConstantPool::MaybeSweepLocked() {
+  if (data_size_ + regexes_.size() < next_sweep_) {
+    return;
+  }
+  for (auto it = data_.begin(); it != data_.end();) {
+    std::vector<Entry>& bucket = it->second;
+    auto expired =
+        std::remove_if(bucket.begin(), bucket.end(), [](const Entry& entry) {
+          if (common_internal::IsExpiredRef(*entry.refcount)) {
+            WeakUnref(*entry.refcount);
+            return true;
+          }
+          return false;
+        });
+    data_size_ -= static_cast<size_t>(bucket.end() - expired);
+    bucket.erase(expired, bucket.end());
+    if (bucket.empty()) {
+      data_.erase(it++);
+    } else {
+      ++it;
+    }
+  }
+  absl::erase_if(regexes_,
+                 [](const auto& entry) { return entry.second.expired(); });
+  // Grow the threshold with the live entries so that sweeping stays amortized
+  // constant time per insertion.
+  next_sweep_ =
+      std::max(kMinSweepThreshold, 2 * (data_size_ + regexes_.size()));
+}
+
+std::shared_ptr<const RE2> ConstantPool::InternRegex(
+    absl::string_view pattern) {
+  {
+    absl::MutexLock lock(&mutex_);
+    if (auto it = regexes_.find(pattern); it != regexes_.end()) {
+      if (auto regex = it->second.lock(); regex != nullptr) {
+        return regex;
+      }
+    }
+  }
+  // Compile without holding the lock, which may take a while for large
+  // patterns. If another thread compiled the same pattern in the meantime, its
+  // program wins.
+  auto compiled = std::make_shared<const RE2>(pattern);
+  absl::MutexLock lock(&mutex_);
+  auto [it, inserted] = regexes_.try_emplace(pattern);
+  if (!inserted) {
+    if (auto regex = it->second.lock(); regex != nullptr) {
+      return regex;
+    }
+  }
+  it->second = compiled;
+  if (inserted) {
+    MaybeSweepLocked();
+  }
+  return compiled;
+}
+
+size_t ConstantPool::size() const {
+  absl::MutexLock lock(&mutex_);
+  return data_size_ + regexes_.size();
+}
+
+}  // namespace cel::runtime_internal
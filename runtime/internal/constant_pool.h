@@ -0,0 +1,98 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_RUNTIME_INTERNAL_CONSTANT_POOL_H_
+#define THIRD_PARTY_CEL_CPP_RUNTIME_INTERNAL_CONSTANT_POOL_H_
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/base/nullability.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "base/ast_internal/expr.h"
+#include "common/internal/reference_count.h"
+#include "common/value.h"
+#include "common/value_manager.h"
+#include "re2/re2.h"
+
+namespace cel::runtime_internal {
+
+// Interns the data of constants referenced by the programs of a runtime, so
+// that identical string and bytes literals and precompiled regular
+// expressions are stored once no matter how many programs use them.
+//
+// The pool only holds weak references: an entry is released as soon as the
+// last program using it is destroyed, so replacing programs does not
+// accumulate stale constants. Thread-safe.
+class ConstantPool final {
+ public:
+  ConstantPool() = default;
+  ~ConstantPool();
+
+  ConstantPool(const ConstantPool&) = delete;
+  ConstantPool& operator=(const ConstantPool&) = delete;
+
+  // Converts `constant` into a value like `ConvertConstant`, except that
+  // string and bytes constants too large to be stored inline share their data
+  // with any live value previously returned for an equal constant.
+  absl::StatusOr<Value> InternConstant(
+      const ast_internal::Constant& constant, ValueManager& value_factory);
+
+  // Returns the compiled program for `pattern` with default options, shared
+  // with any live program previously returned for the same pattern. Invalid
+  // patterns are interned as well: callers must check `RE2::ok()`.
+  std::shared_ptr<const RE2> InternRegex(absl::string_view pattern);
+
+  // Returns the number of entries, including ones whose data was released and
+  // that have not been swept yet.
+  size_t size() const;
+
+ private:
+  enum class Kind { kString, kBytes };
+
+  // Minimum number of entries at which expired entries are swept.
+  static constexpr size_t kMinSweepThreshold = 64;
+
+  // An interned string or bytes constant. `data` views storage owned by
+  // `refcount` and may only be read while holding a strong reference.
+  struct Entry {
+    Kind kind;
+    absl::Nonnull<const common_internal::ReferenceCount*> refcount;
+    absl::string_view data;
+  };
+
+  Value InternData(Kind kind, absl::string_view data);
+
+  void MaybeSweepLocked() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  mutable absl::Mutex mutex_;
+  // Keyed by the hash of the data, as the data of an expired entry may no
+  // longer be read.
+  absl::flat_hash_map<size_t, std::vector<Entry>> data_ ABSL_GUARDED_BY(mutex_);
+  size_t data_size_ ABSL_GUARDED_BY(mutex_) = 0;
+  absl::flat_hash_map<std::string, std::weak_ptr<const RE2>> regexes_
+      ABSL_GUARDED_BY(mutex_);
+  // Number of entries at which expired entries are next swept.
+  size_t next_sweep_ ABSL_GUARDED_BY(mutex_) = kMinSweepThreshold;
+};
+
+}  // namespace cel::runtime_internal
+
+#endif  // THIRD_PARTY_CEL_CPP_RUNTIME_INTERNAL_CONSTANT_POOL_H_
@@ -0,0 +1,129 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/internal/constant_pool.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/log/absl_check.h"
+#include "absl/strings/str_cat.h"
+#include "base/ast_internal/expr.h"
+#include "common/constant.h"
+#include "common/memory.h"
+#include "common/value.h"
+#include "common/value_testing.h"
+#include "internal/testing.h"
+#include "runtime/managed_value_factory.h"
+#include "runtime/type_registry.h"
+#include "re2/re2.h"
+
+namespace cel::runtime_internal {
+namespace {
+
+using ::absl_testing::IsOkAndHolds;
+using ::cel::ast_internal::Constant;
+using ::cel::test::BytesValueIs;
+using ::cel::test::IntValueIs;
+using ::cel::test::StringValueIs;
+
+class ConstantPoolTest : public testing::Test {
+ protected:
+  ConstantPoolTest()
+      : value_factory_(type_registry_.GetComposedTypeProvider(),
+                       MemoryManagerRef::ReferenceCounting()) {}
+
+  Value Intern(Constant constant) {
+    auto value = pool_.InternConstant(constant, value_factory_.get());
+    ABSL_CHECK_OK(value.status());
+    return *std::move(value);
+  }
+
+  ConstantPool pool_;
+  TypeRegistry type_registry_;
+  ManagedValueFactory value_factory_;
+};
+
+TEST_F(ConstantPoolTest, SharesStringData) {
+  const std::string text(64, 'a');
+  Value first = Intern(Constant(StringConstant(text)));
+  Value second = Intern(Constant(StringConstant(text)));
+
+  EXPECT_THAT(first, StringValueIs(text));
+  EXPECT_THAT(second, StringValueIs(text));
+  std::string first_scratch;
+  std::string second_scratch;
+  EXPECT_EQ(first.GetString().NativeString(first_scratch).data(),
+            second.GetString().NativeString(second_scratch).data());
+  EXPECT_EQ(pool_.size(), 1);
+}
+
+TEST_F(ConstantPoolTest, DistinguishesStringsAndBytes) {
+  Value string = Intern(Constant(StringConstant("abc")));
+  Value bytes = Intern(Constant(BytesConstant("abc")));
+  Value other = Intern(Constant(StringConstant("abd")));
+
+  EXPECT_THAT(string, StringValueIs("abc"));
+  EXPECT_THAT(bytes, BytesValueIs("abc"));
+  EXPECT_THAT(other, StringValueIs("abd"));
+  EXPECT_EQ(pool_.size(), 3);
+}
+
+TEST_F(ConstantPoolTest, ConvertsOtherConstants) {
+  EXPECT_THAT(pool_.InternConstant(Constant(int64_t{42}), value_factory_.get()),
+              IsOkAndHolds(IntValueIs(42)));
+  EXPECT_EQ(pool_.size(), 0);
+}
+
+TEST_F(ConstantPoolTest, ReleasesUnusedData) {
+  for (int i = 0; i < 1000; ++i) {
+    Value value = Intern(Constant(StringConstant(absl::StrCat("value", i))));
+    EXPECT_THAT(value, StringValueIs(absl::StrCat("value", i)));
+  }
+  // Expired entries are swept as the pool grows.
+  EXPECT_LE(pool_.size(), 64);
+
+  // Data is not resurrected once released.
+  Value value = Intern(Constant(StringConstant("value0")));
+  EXPECT_THAT(value, StringValueIs("value0"));
+}
+
+TEST_F(ConstantPoolTest, SharesRegexPrograms) {
+  std::shared_ptr<const RE2> first = pool_.InternRegex("a+b");
+  std::shared_ptr<const RE2> second = pool_.InternRegex("a+b");
+  std::shared_ptr<const RE2> other = pool_.InternRegex("a*b");
+
+  EXPECT_EQ(first, second);
+  EXPECT_NE(first, other);
+  EXPECT_TRUE(RE2::FullMatch("aab", *first));
+}
+
+TEST_F(ConstantPoolTest, InternsInvalidRegexPrograms) {
+  std::shared_ptr<const RE2> regex = pool_.InternRegex("(");
+
+  ASSERT_NE(regex, nullptr);
+  EXPECT_FALSE(regex->ok());
+}
+
+TEST_F(ConstantPoolTest, ReleasesUnusedRegexPrograms) {
+  std::weak_ptr<const RE2> weak = pool_.InternRegex("a+b");
+
+  EXPECT_TRUE(weak.expired());
+  EXPECT_NE(pool_.InternRegex("a+b"), nullptr);
+}
+
+}  // namespace
+}  // namespace cel::runtime_internal
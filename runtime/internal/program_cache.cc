@@ -0,0 +1,299 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/internal/program_cache.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/casts.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "base/ast_internal/ast_impl.h"
+#include "base/ast_internal/expr.h"
+#include "common/constant.h"
+#include "common/expr.h"
+#include "runtime/runtime.h"
+
+namespace cel::runtime_internal {
+namespace {
+
+// Appends a self delimiting encoding of the AST. Every variable length field
+// is length prefixed and every node starts with its kind, so two encodings are
+// equal only if the encoded ASTs are.
+class KeyEncoder final {
+ public:
+  explicit KeyEncoder(std::string& out) : out_(out) {}
+
+  void Expr(const cel::Expr& expr) {
+    Int(expr.id());
+    Int(static_cast<int64_t>(expr.kind_case()));
+    switch (expr.kind_case()) {
+      case ExprKindCase::kUnspecifiedExpr:
+        break;
+      case ExprKindCase::kConstant:
+        Constant(expr.const_expr());
+        break;
+      case ExprKindCase::kIdentExpr:
+        String(expr.ident_expr().name());
+        break;
+      case ExprKindCase::kSelectExpr: {
+        const auto& select = expr.select_expr();
+        OptionalExpr(select.has_operand(), select.operand());
+        String(select.field());
+        Int(select.test_only());
+        break;
+      }
+      case ExprKindCase::kCallExpr: {
+        const auto& call = expr.call_expr();
+        String(call.function());
+        OptionalExpr(call.has_target(), call.target());
+        Int(static_cast<int64_t>(call.args().size()));
+        for (const auto& arg : call.args()) {
+          Expr(arg);
+        }
+        break;
+      }
+      case ExprKindCase::kListExpr: {
+        const auto& elements = expr.list_expr().elements();
+        Int(static_cast<int64_t>(elements.size()));
+        for (const auto& element : elements) {
+          OptionalExpr(element.has_expr(), element.expr());
+          Int(element.optional());
+        }
+        break;
+      }
+      case ExprKindCase::kStructExpr: {
+        const auto& struct_expr = expr.struct_expr();
+        String(struct_expr.name());
+        Int(static_cast<int64_t>(struct_expr.fields().size()));
+        for (const auto& field : struct_expr.fields()) {
+          Int(field.id());
+          String(field.name());
+          OptionalExpr(field.has_value(), field.value());
+          Int(field.optional());
+        }
+        break;
+      }
+      case ExprKindCase::kMapExpr: {
+        const auto& entries = expr.map_expr().entries();
+        Int(static_cast<int64_t>(entries.size()));
+        for (const auto& entry : entries) {
+          Int(entry.id());
+          OptionalExpr(entry.has_key(), entry.key());
+          OptionalExpr(entry.has_value(), entry.value());
+          Int(entry.optional());
+        }
+        break;
+      }
+      case ExprKindCase::kComprehensionExpr: {
+        const auto& comprehension = expr.comprehension_expr();
+        String(comprehension.iter_var());
+        String(comprehension.iter_var2());
+        String(comprehension.accu_var());
+        OptionalExpr(comprehension.has_iter_range(),
+                     comprehension.iter_range());
+        OptionalExpr(comprehension.has_accu_init(), comprehension.accu_init());
+        OptionalExpr(comprehension.has_loop_condition(),
+                     comprehension.loop_condition());
+        OptionalExpr(comprehension.has_loop_step(),
+                     comprehension.loop_step());
+        OptionalExpr(comprehension.has_result(), comprehension.result());
+        break;
+      }
+    }
+  }
+
+  void Reference(int64_t id, const ast_internal::Reference& reference) {
+    Int(id);
+    String(reference.name());
+    Int(static_cast<int64_t>(reference.overload_id().size()));
+    for (const auto& overload_id : reference.overload_id()) {
+      String(overload_id);
+    }
+    Int(reference.has_value());
+    if (reference.has_value()) {
+      Constant(reference.value());
+    }
+  }
+
+  void Type(const ast_internal::Type& type) {
+    Int(static_cast<int64_t>(type.type_kind().index()));
+    if (type.has_primitive()) {
+      Int(static_cast<int64_t>(type.primitive()));
+    } else if (type.has_wrapper()) {
+      Int(static_cast<int64_t>(type.wrapper()));
+    } else if (type.has_well_known()) {
+      Int(static_cast<int64_t>(type.well_known()));
+    } else if (type.has_list_type()) {
+      Type(type.list_type().elem_type());
+    } else if (type.has_map_type()) {
+      Type(type.map_type().key_type());
+      Type(type.map_type().value_type());
+    } else if (type.has_function()) {
+      Type(type.function().result_type());
+      Types(type.function().arg_types());
+    } else if (type.has_message_type()) {
+      String(type.message_type().type());
+    } else if (type.has_type_param()) {
+      String(type.type_param().type());
+    } else if (type.has_type()) {
+      Type(type.type());
+    } else if (type.has_abstract_type()) {
+      String(type.abstract_type().name());
+      Types(type.abstract_type().parameter_types());
+    }
+  }
+
+  void Int(int64_t value) {
+    uint64_t bits = absl::bit_cast<uint64_t>(value);
+    for (int i = 0; i < 8; ++i) {
+      out_.push_back(static_cast<char>((bits >> (8 * i)) & 0xff));
+    }
+  }
+
+  void String(absl::string_view value) {
+    Int(static_cast<int64_t>(value.size()));
+    out_.append(value.data(), value.size());
+  }
+
+ private:
+  void OptionalExpr(bool present, const cel::Expr& expr) {
+    Int(present);
+    if (present) {
+      Expr(expr);
+    }
+  }
+
+  void Types(const std::vector<ast_internal::Type>& types) {
+    Int(static_cast<int64_t>(types.size()));
+    for (const auto& type : types) {
+      Type(type);
+    }
+  }
+
+  void Constant(const cel::Constant& constant) {
+    Int(static_cast<int64_t>(constant.kind_case()));
+    switch (constant.kind_case()) {
+      case ConstantKindCase::kUnspecified:
+      case ConstantKindCase::kNull:
+        break;
+      case ConstantKindCase::kBool:
+        Int(constant.bool_value());
+        break;
+      case ConstantKindCase::kInt:
+        Int(constant.int_value());
+        break;
+      case ConstantKindCase::kUint:
+        Int(absl::bit_cast<int64_t>(constant.uint_value()));
+        break;
+      case ConstantKindCase::kDouble:
+        Int(absl::bit_cast<int64_t>(constant.double_value()));
+        break;
+      case ConstantKindCase::kBytes:
+        String(constant.bytes_value());
+        break;
+      case ConstantKindCase::kString:
+        String(constant.string_value());
+        break;
+      case ConstantKindCase::kDuration:
+        String(absl::FormatDuration(constant.duration_value()));
+        break;
+      case ConstantKindCase::kTimestamp:
+        String(absl::FormatTime(absl::RFC3339_full,
+                                constant.timestamp_value(),
+                                absl::UTCTimeZone()));
+        break;
+    }
+  }
+
+  std::string& out_;
+};
+
+}  // namespace
+
+std::string ProgramCacheKey(const ast_internal::AstImpl& ast) {
+  std::string key;
+  KeyEncoder encoder(key);
+  encoder.Expr(ast.root_expr());
+
+  // The reference map is unordered, so encode it by ascending id.
+  std::vector<int64_t> ids;
+  ids.reserve(ast.reference_map().size());
+  for (const auto& [id, reference] : ast.reference_map()) {
+    ids.push_back(id);
+  }
+  std::sort(ids.begin(), ids.end());
+  encoder.Int(static_cast<int64_t>(ids.size()));
+  for (int64_t id : ids) {
+    encoder.Reference(id, ast.reference_map().at(id));
+  }
+
+  // Program optimizers plan by checked type, e.g. the select optimization only
+  // rewrites selects on messages and maps, so the type map is part of the key.
+  ids.clear();
+  ids.reserve(ast.type_map().size());
+  for (const auto& [id, type] : ast.type_map()) {
+    ids.push_back(id);
+  }
+  std::sort(ids.begin(), ids.end());
+  encoder.Int(static_cast<int64_t>(ids.size()));
+  for (int64_t id : ids) {
+    encoder.Int(id);
+    encoder.Type(ast.type_map().at(id));
+  }
+  return key;
+}
+
+std::shared_ptr<const Program> ProgramCache::Find(absl::string_view key) {
+  absl::MutexLock lock(&mutex_);
+  auto it = index_.find(key);
+  if (it == index_.end()) {
+    return nullptr;
+  }
+  entries_.splice(entries_.begin(), entries_, it->second);
+  return it->second->second;
+}
+
+std::shared_ptr<const Program> ProgramCache::Insert(
+    std::string key, std::shared_ptr<const Program> program) {
+  absl::MutexLock lock(&mutex_);
+  if (auto it = index_.find(key); it != index_.end()) {
+    entries_.splice(entries_.begin(), entries_, it->second);
+    return it->second->second;
+  }
+  if (capacity_ == 0) {
+    return program;
+  }
+  if (entries_.size() >= capacity_) {
+    index_.erase(entries_.back().first);
+    entries_.pop_back();
+  }
+  entries_.emplace_front(std::move(key), program);
+  index_.insert({entries_.front().first, entries_.begin()});
+  return program;
+}
+
+size_t ProgramCache::size() const {
+  absl::MutexLock lock(&mutex_);
+  return entries_.size();
+}
+
+}  // namespace cel::runtime_internal
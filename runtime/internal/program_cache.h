@@ -0,0 +1,82 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_RUNTIME_INTERNAL_PROGRAM_CACHE_H_
+#define THIRD_PARTY_CEL_CPP_RUNTIME_INTERNAL_PROGRAM_CACHE_H_
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "base/ast_internal/ast_impl.h"
+#include "runtime/runtime.h"
+
+namespace cel::runtime_internal {
+
+// Returns the cache key of `ast`: an exact encoding of everything planning
+// reads from it, i.e. the expression tree with its ids, the reference map and
+// the type map. Program optimizers may plan differently for the same tree
+// checked with different types. Source positions do not affect the planned
+// program and are left out.
+//
+// The key is the encoding itself rather than a hash of it, so distinct ASTs
+// never share a program.
+std::string ProgramCacheKey(const ast_internal::AstImpl& ast);
+
+// Bounded, thread-safe least recently used cache of planned programs.
+//
+// The cache belongs to a single runtime, so the runtime options and
+// registries which also determine the planned program are the same for every
+// entry.
+class ProgramCache final {
+ public:
+  explicit ProgramCache(size_t capacity) : capacity_(capacity) {}
+
+  ProgramCache(const ProgramCache&) = delete;
+  ProgramCache& operator=(const ProgramCache&) = delete;
+
+  // Returns the program cached for `key` and marks it as most recently used,
+  // or null if there is none.
+  std::shared_ptr<const Program> Find(absl::string_view key);
+
+  // Caches `program` for `key`, evicting the least recently used entry if the
+  // cache is full. If another thread cached a program for `key` first, that
+  // program is kept and returned instead.
+  std::shared_ptr<const Program> Insert(std::string key,
+                                        std::shared_ptr<const Program> program);
+
+  size_t size() const;
+
+ private:
+  using Entry = std::pair<std::string, std::shared_ptr<const Program>>;
+  using EntryList = std::list<Entry>;
+
+  const size_t capacity_;
+  mutable absl::Mutex mutex_;
+  // Most recently used first. The index keys view the strings of the list
+  // nodes, which are stable.
+  EntryList entries_ ABSL_GUARDED_BY(mutex_);
+  absl::flat_hash_map<absl::string_view, EntryList::iterator> index_
+      ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace cel::runtime_internal
+
+#endif  // THIRD_PARTY_CEL_CPP_RUNTIME_INTERNAL_PROGRAM_CACHE_H_
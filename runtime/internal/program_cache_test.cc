@@ -0,0 +1,238 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/internal/program_cache.h"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/log/absl_check.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "base/ast.h"
+#include "base/ast_internal/ast_impl.h"
+#include "base/ast_internal/expr.h"
+#include "common/memory.h"
+#include "common/value.h"
+#include "common/value_testing.h"
+#include "extensions/select_optimization.h"
+#include "internal/status_macros.h"
+#include "internal/testing.h"
+#include "internal/testing_descriptor_pool.h"
+#include "parser/parser.h"
+#include "runtime/activation.h"
+#include "runtime/managed_value_factory.h"
+#include "runtime/runtime.h"
+#include "runtime/runtime_builder.h"
+#include "runtime/runtime_options.h"
+#include "runtime/standard_runtime_builder_factory.h"
+
+namespace cel::runtime_internal {
+namespace {
+
+using ::absl_testing::IsOkAndHolds;
+using ::cel::ast_internal::AstImpl;
+using ::cel::extensions::EnableSelectOptimization;
+using ::cel::internal::GetTestingDescriptorPool;
+using ::cel::test::IntValueIs;
+using ::google::api::expr::parser::ParseAst;
+
+std::string KeyOf(absl::string_view expression) {
+  auto ast = ParseAst(expression);
+  ABSL_CHECK_OK(ast.status());
+  return ProgramCacheKey(AstImpl::CastFromPublicAst(**ast));
+}
+
+absl::StatusOr<std::unique_ptr<const Runtime>> MakeRuntime(
+    size_t program_cache_size) {
+  RuntimeOptions options;
+  options.program_cache_size = program_cache_size;
+  CEL_ASSIGN_OR_RETURN(
+      auto builder,
+      CreateStandardRuntimeBuilder(GetTestingDescriptorPool(), options));
+  return std::move(builder).Build();
+}
+
+// Parses a select expression and records `type` as the checked type of its
+// operand.
+absl::StatusOr<std::unique_ptr<Ast>> ParseWithOperandType(
+    absl::string_view expression, ast_internal::Type type) {
+  CEL_ASSIGN_OR_RETURN(auto ast, ParseAst(expression));
+  AstImpl& ast_impl = AstImpl::CastFromPublicAst(*ast);
+  ast_impl.type_map()[ast_impl.root_expr().select_expr().operand().id()] =
+      std::move(type);
+  ast_impl.set_is_checked(true);
+  return ast;
+}
+
+absl::StatusOr<std::shared_ptr<const Program>> CreateShared(
+    const Runtime& runtime, absl::string_view expression) {
+  CEL_ASSIGN_OR_RETURN(auto ast, ParseAst(expression));
+  return runtime.CreateSharedProgram(std::move(ast));
+}
+
+TEST(ProgramCacheKeyTest, EqualForIdenticalAsts) {
+  EXPECT_EQ(KeyOf("a.b + [1, 2u, 3.0, 'x', b'y'].size()"),
+            KeyOf("a.b + [1, 2u, 3.0, 'x', b'y'].size()"));
+  EXPECT_EQ(KeyOf("[1].all(x, x > 0)"), KeyOf("[1].all(x, x > 0)"));
+}
+
+TEST(ProgramCacheKeyTest, IgnoresSourcePositions) {
+  EXPECT_EQ(KeyOf("a+b"), KeyOf("a  +  b"));
+}
+
+TEST(ProgramCacheKeyTest, DistinguishesAsts) {
+  EXPECT_NE(KeyOf("a + b"), KeyOf("a - b"));
+  EXPECT_NE(KeyOf("a + b"), KeyOf("b + a"));
+  EXPECT_NE(KeyOf("1"), KeyOf("1u"));
+  EXPECT_NE(KeyOf("'a'"), KeyOf("b'a'"));
+  EXPECT_NE(KeyOf("a.b"), KeyOf("has(a.b)"));
+  EXPECT_NE(KeyOf("f('ab', 'c')"), KeyOf("f('a', 'bc')"));
+  EXPECT_NE(KeyOf("[1].all(x, x > 0)"), KeyOf("[1].exists(x, x > 0)"));
+  EXPECT_NE(KeyOf("(1 + 2) + 3"), KeyOf("1 + (2 + 3)"));
+}
+
+TEST(ProgramCacheKeyTest, DistinguishesCheckedTypes) {
+  ASSERT_OK_AND_ASSIGN(
+      auto message,
+      ParseWithOperandType("x.y", ast_internal::Type(ast_internal::MessageType(
+                                      "google.protobuf.Any"))));
+  ASSERT_OK_AND_ASSIGN(
+      auto map,
+      ParseWithOperandType(
+          "x.y", ast_internal::Type(ast_internal::MapType(
+                     std::make_unique<ast_internal::Type>(
+                         ast_internal::PrimitiveType::kString),
+                     std::make_unique<ast_internal::Type>(
+                         ast_internal::DynamicType())))));
+
+  const std::string message_key =
+      ProgramCacheKey(AstImpl::CastFromPublicAst(*message));
+  EXPECT_NE(message_key, ProgramCacheKey(AstImpl::CastFromPublicAst(*map)));
+  EXPECT_NE(message_key, KeyOf("x.y"));
+}
+
+TEST(ProgramCacheTest, EvictsLeastRecentlyUsed) {
+  ASSERT_OK_AND_ASSIGN(auto runtime, MakeRuntime(0));
+  ASSERT_OK_AND_ASSIGN(auto one, CreateShared(*runtime, "1"));
+  ASSERT_OK_AND_ASSIGN(auto two, CreateShared(*runtime, "2"));
+  ASSERT_OK_AND_ASSIGN(auto three, CreateShared(*runtime, "3"));
+
+  ProgramCache cache(2);
+  EXPECT_EQ(cache.Insert("one", one), one);
+  EXPECT_EQ(cache.Insert("two", two), two);
+  EXPECT_EQ(cache.Find("one"), one);
+  EXPECT_EQ(cache.Insert("three", three), three);
+
+  EXPECT_EQ(cache.size(), 2);
+  EXPECT_EQ(cache.Find("one"), one);
+  EXPECT_EQ(cache.Find("two"), nullptr);
+  EXPECT_EQ(cache.Find("three"), three);
+}
+
+TEST(ProgramCacheTest, KeepsFirstInsertedProgram) {
+  ASSERT_OK_AND_ASSIGN(auto runtime, MakeRuntime(0));
+  ASSERT_OK_AND_ASSIGN(auto first, CreateShared(*runtime, "1"));
+  ASSERT_OK_AND_ASSIGN(auto second, CreateShared(*runtime, "1"));
+
+  ProgramCache cache(2);
+  EXPECT_EQ(cache.Insert("one", first), first);
+  EXPECT_EQ(cache.Insert("one", second), first);
+  EXPECT_EQ(cache.size(), 1);
+}
+
+TEST(RuntimeProgramCacheTest, SharesPrograms) {
+  ASSERT_OK_AND_ASSIGN(auto runtime, MakeRuntime(8));
+
+  ASSERT_OK_AND_ASSIGN(auto first, CreateShared(*runtime, "x * 2"));
+  ASSERT_OK_AND_ASSIGN(auto second, CreateShared(*runtime, "x  *  2"));
+  ASSERT_OK_AND_ASSIGN(auto other, CreateShared(*runtime, "x * 3"));
+  EXPECT_EQ(first, second);
+  EXPECT_NE(first, other);
+
+  ManagedValueFactory value_factory(runtime->GetTypeProvider(),
+                                    MemoryManagerRef::ReferenceCounting());
+  Activation activation;
+  activation.InsertOrAssignValue("x", IntValue(21));
+  EXPECT_THAT(second->Evaluate(activation, value_factory.get()),
+              IsOkAndHolds(IntValueIs(42)));
+}
+
+TEST(RuntimeProgramCacheTest, SelectOptimizationPlansByOperandType) {
+  RuntimeOptions options;
+  options.program_cache_size = 8;
+  ASSERT_OK_AND_ASSIGN(
+      RuntimeBuilder builder,
+      CreateStandardRuntimeBuilder(GetTestingDescriptorPool(), options));
+  ASSERT_OK(EnableSelectOptimization(builder));
+  ASSERT_OK_AND_ASSIGN(auto runtime, std::move(builder).Build());
+  ManagedValueFactory value_factory(runtime->GetTypeProvider(),
+                                    MemoryManagerRef::ReferenceCounting());
+  Activation activation;
+
+  ASSERT_OK_AND_ASSIGN(
+      auto create_message,
+      CreateShared(
+          *runtime,
+          "cel.expr.conformance.proto3.TestAllTypes{single_int64: 7}"));
+  ASSERT_OK_AND_ASSIGN(
+      Value message, create_message->Evaluate(activation, value_factory.get()));
+  ASSERT_OK_AND_ASSIGN(auto create_map,
+                       CreateShared(*runtime, "{'single_int64': 7}"));
+  ASSERT_OK_AND_ASSIGN(Value map,
+                       create_map->Evaluate(activation, value_factory.get()));
+
+  // Same tree and references, so only the operand type tells the two apart.
+  // The optimized select is planned as a field access for the message and as
+  // a key lookup for the map.
+  ASSERT_OK_AND_ASSIGN(
+      auto message_ast,
+      ParseWithOperandType("x.single_int64",
+                           ast_internal::Type(ast_internal::MessageType(
+                               "cel.expr.conformance.proto3.TestAllTypes"))));
+  ASSERT_OK_AND_ASSIGN(auto select_message,
+                       runtime->CreateSharedProgram(std::move(message_ast)));
+  ASSERT_OK_AND_ASSIGN(
+      auto map_ast,
+      ParseWithOperandType(
+          "x.single_int64",
+          ast_internal::Type(ast_internal::MapType(
+              std::make_unique<ast_internal::Type>(
+                  ast_internal::PrimitiveType::kString),
+              std::make_unique<ast_internal::Type>(
+                  ast_internal::PrimitiveType::kInt64)))));
+  ASSERT_OK_AND_ASSIGN(auto select_map,
+                       runtime->CreateSharedProgram(std::move(map_ast)));
+  EXPECT_NE(select_message, select_map);
+
+  activation.InsertOrAssignValue("x", message);
+  EXPECT_THAT(select_message->Evaluate(activation, value_factory.get()),
+              IsOkAndHolds(IntValueIs(7)));
+  activation.InsertOrAssignValue("x", map);
+  EXPECT_THAT(select_map->Evaluate(activation, value_factory.get()),
+              IsOkAndHolds(IntValueIs(7)));
+}
+
+TEST(RuntimeProgramCacheTest, DisabledByDefault) {
+  ASSERT_OK_AND_ASSIGN(auto runtime, MakeRuntime(0));
+
+  ASSERT_OK_AND_ASSIGN(auto first, CreateShared(*runtime, "x * 2"));
+  ASSERT_OK_AND_ASSIGN(auto second, CreateShared(*runtime, "x * 2"));
+  EXPECT_NE(first, second);
+}
+
+}  // namespace
+}  // namespace cel::runtime_internal
@@ -28,6 +28,7 @@
 #include "eval/public/cel_function_registry.h"
 #include "eval/public/cel_type_registry.h"
 #include "internal/well_known_types.h"
+#include "runtime/internal/constant_pool.h"
 #include "runtime/function_registry.h"
 #include "runtime/type_registry.h"
 #include "google/protobuf/descriptor.h"
@@ -116,6 +117,10 @@ struct RuntimeEnv final {
 
   well_known_types::Reflection well_known_types;
 
+  // Constant data shared by the programs planned with this environment.
+  // Thread-safe.
+  mutable ConstantPool constant_pool;
+
   absl::Nonnull<google::protobuf::MessageFactory*> MutableMessageFactory() const
       ABSL_ATTRIBUTE_LIFETIME_BOUND;
 
@@ -14,12 +14,17 @@
 #include "runtime/internal/runtime_impl.h"
 
 #include <memory>
+#include <string>
 #include <utility>
 
 #include "absl/base/nullability.h"
 #include "absl/status/statusor.h"
+#include "absl/types/optional.h"
 #include "base/ast.h"
+#include "base/ast_internal/ast_impl.h"
 #include "base/type_provider.h"
+#include "common/internal/reference_count.h"
+#include "common/memory.h"
 #include "common/native_type.h"
 #include "common/value.h"
 #include "eval/eval/attribute_trail.h"
@@ -29,7 +34,9 @@
 #include "internal/casts.h"
 #include "internal/status_macros.h"
 #include "runtime/activation_interface.h"
+#include "runtime/internal/program_cache.h"
 #include "runtime/runtime.h"
+#include "runtime/runtime_options.h"
 
 namespace cel::runtime_internal {
 namespace {
@@ -41,13 +48,30 @@ using ::google::api::expr::runtime::ExecutionFrameBase;
 using ::google::api::expr::runtime::FlatExpression;
 using ::google::api::expr::runtime::WrappedDirectStep;
 
+// Returns whether evaluations should use thread-local reference counts for the
+// values they create.
+bool UseLocalReferenceCounting(const RuntimeOptions& options,
+                               ValueManager& value_factory) {
+  return options.enable_local_reference_counting &&
+         value_factory.GetMemoryManager().memory_management() ==
+             MemoryManagement::kReferenceCounting;
+}
+
 class ProgramImpl final : public TraceableProgram {
  public:
   using EvaluationListener = TraceableProgram::EvaluationListener;
   ProgramImpl(
       const std::shared_ptr<const RuntimeImpl::Environment>& environment,
+      std::shared_ptr<ProgramMemoryTracker> memory_tracker,
       FlatExpression impl)
-      : environment_(environment), impl_(std::move(impl)) {}
+      : environment_(environment),
+        memory_tracker_(std::move(memory_tracker)),
+        impl_(std::move(impl)),
+        memory_usage_(impl_.ComputeMemoryUsage()) {
+    memory_tracker_->Add(memory_usage_);
+  }
+
+  ~ProgramImpl() override { memory_tracker_->Remove(memory_usage_); }
 
   absl::StatusOr<Value> Evaluate(const ActivationInterface& activation,
                                  ValueManager& value_factory) const override {
@@ -57,6 +81,12 @@ class ProgramImpl final : public TraceableProgram {
   absl::StatusOr<Value> Trace(const ActivationInterface& activation,
                               EvaluationListener callback,
                               ValueManager& value_factory) const override {
+    // Declared first so temporaries are released before the scope promotes
+    // whatever escapes the evaluation.
+    absl::optional<common_internal::LocalReferenceCountScope> local_refcounts;
+    if (UseLocalReferenceCounting(impl_.options(), value_factory)) {
+      local_refcounts.emplace();
+    }
     auto state = impl_.MakeEvaluatorState(value_factory);
     return impl_.EvaluateWithCallback(activation, std::move(callback), state);
   }
@@ -65,10 +95,14 @@ class ProgramImpl final : public TraceableProgram {
     return environment_->type_registry.GetComposedTypeProvider();
   }
 
+  ProgramMemoryUsage GetMemoryUsage() const override { return memory_usage_; }
+
  private:
   // Keep the Runtime environment alive while programs reference it.
   std::shared_ptr<const RuntimeImpl::Environment> environment_;
+  std::shared_ptr<ProgramMemoryTracker> memory_tracker_;
   FlatExpression impl_;
+  const ProgramMemoryUsage memory_usage_;
 };
 
 class RecursiveProgramImpl final : public TraceableProgram {
@@ -76,8 +110,19 @@ class RecursiveProgramImpl final : public TraceableProgram {
   using EvaluationListener = TraceableProgram::EvaluationListener;
   RecursiveProgramImpl(
       const std::shared_ptr<const RuntimeImpl::Environment>& environment,
+      std::shared_ptr<ProgramMemoryTracker> memory_tracker,
       FlatExpression impl, absl::Nonnull<const DirectExpressionStep*> root)
-      : environment_(environment), impl_(std::move(impl)), root_(root) {}
+      : environment_(environment),
+        memory_tracker_(std::move(memory_tracker)),
+        impl_(std::move(impl)),
+        root_(root),
+        memory_usage_(impl_.ComputeMemoryUsage()) {
+    memory_tracker_->Add(memory_usage_);
+  }
+
+  ~RecursiveProgramImpl() override {
+    memory_tracker_->Remove(memory_usage_);
+  }
 
   absl::StatusOr<Value> Evaluate(const ActivationInterface& activation,
                                  ValueManager& value_factory) const override {
@@ -87,6 +132,10 @@ class RecursiveProgramImpl final : public TraceableProgram {
   absl::StatusOr<Value> Trace(const ActivationInterface& activation,
                               EvaluationListener callback,
                               ValueManager& value_factory) const override {
+    absl::optional<common_internal::LocalReferenceCountScope> local_refcounts;
+    if (UseLocalReferenceCounting(impl_.options(), value_factory)) {
+      local_refcounts.emplace();
+    }
     ComprehensionSlots slots(impl_.comprehension_slots_size());
     ExecutionFrameBase frame(activation, std::move(callback), impl_.options(),
                              value_factory, slots);
@@ -102,11 +151,15 @@ class RecursiveProgramImpl final : public TraceableProgram {
     return environment_->type_registry.GetComposedTypeProvider();
   }
 
+  ProgramMemoryUsage GetMemoryUsage() const override { return memory_usage_; }
+
  private:
   // Keep the Runtime environment alive while programs reference it.
   std::shared_ptr<const RuntimeImpl::Environment> environment_;
+  std::shared_ptr<ProgramMemoryTracker> memory_tracker_;
   FlatExpression impl_;
   absl::Nonnull<const DirectExpressionStep*> root_;
+  const ProgramMemoryUsage memory_usage_;
 };
 
 }  // namespace
@@ -138,11 +191,27 @@ RuntimeImpl::CreateTraceableProgram(
         internal::down_cast<const WrappedDirectStep*>(
             flat_expr.subexpressions().front().front().get())
             ->wrapped();
-    return std::make_unique<RecursiveProgramImpl>(environment_,
-                                                  std::move(flat_expr), root);
+    return std::make_unique<RecursiveProgramImpl>(
+        environment_, memory_tracker_, std::move(flat_expr), root);
   }
 
-  return std::make_unique<ProgramImpl>(environment_, std::move(flat_expr));
+  return std::make_unique<ProgramImpl>(environment_, memory_tracker_,
+                                       std::move(flat_expr));
+}
+
+absl::StatusOr<std::shared_ptr<const Program>>
+RuntimeImpl::CreateSharedProgram(std::unique_ptr<Ast> ast) const {
+  if (program_cache_ == nullptr || ast == nullptr) {
+    return Runtime::CreateSharedProgram(std::move(ast));
+  }
+  std::string key =
+      ProgramCacheKey(ast_internal::AstImpl::CastFromPublicAst(*ast));
+  if (auto program = program_cache_->Find(key); program != nullptr) {
+    return program;
+  }
+  CEL_ASSIGN_OR_RETURN(std::shared_ptr<const Program> program,
+                       CreateTraceableProgram(std::move(ast), {}));
+  return program_cache_->Insert(std::move(key), std::move(program));
 }
 
 bool TestOnly_IsRecursiveImpl(const Program* program) {
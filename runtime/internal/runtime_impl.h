@@ -20,14 +20,17 @@
 
 #include "absl/base/attributes.h"
 #include "absl/base/nullability.h"
+#include "absl/base/thread_annotations.h"
 #include "absl/log/absl_check.h"
 #include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
 #include "base/ast.h"
 #include "base/type_provider.h"
 #include "common/native_type.h"
 #include "eval/compiler/flat_expr_builder.h"
 #include "internal/well_known_types.h"
 #include "runtime/function_registry.h"
+#include "runtime/internal/program_cache.h"
 #include "runtime/internal/runtime_env.h"
 #include "runtime/runtime.h"
 #include "runtime/runtime_options.h"
@@ -35,6 +38,30 @@
 
 namespace cel::runtime_internal {
 
+// Sums the memory usage of the live programs created by a runtime. Programs
+// add their usage when created and remove it when destroyed. Thread-safe.
+class ProgramMemoryTracker final {
+ public:
+  void Add(const ProgramMemoryUsage& usage) {
+    absl::MutexLock lock(&mutex_);
+    usage_ += usage;
+  }
+
+  void Remove(const ProgramMemoryUsage& usage) {
+    absl::MutexLock lock(&mutex_);
+    usage_ -= usage;
+  }
+
+  ProgramMemoryUsage Get() const {
+    absl::MutexLock lock(&mutex_);
+    return usage_;
+  }
+
+ private:
+  mutable absl::Mutex mutex_;
+  ProgramMemoryUsage usage_ ABSL_GUARDED_BY(mutex_);
+};
+
 class RuntimeImpl : public Runtime {
  public:
   using Environment = RuntimeEnv;
@@ -42,7 +69,12 @@ class RuntimeImpl : public Runtime {
   RuntimeImpl(absl::Nonnull<std::shared_ptr<Environment>> environment,
               const RuntimeOptions& options)
       : environment_(std::move(environment)),
-        expr_builder_(environment_, options) {
+        expr_builder_(environment_, options),
+        memory_tracker_(std::make_shared<ProgramMemoryTracker>()) {
+    if (options.program_cache_size > 0) {
+      program_cache_ =
+          std::make_unique<ProgramCache>(options.program_cache_size);
+    }
     ABSL_DCHECK(environment_->well_known_types.IsInitialized());
   }
 
@@ -82,10 +114,17 @@ class RuntimeImpl : public Runtime {
       std::unique_ptr<Ast> ast,
       const Runtime::CreateProgramOptions& options) const override;
 
+  absl::StatusOr<std::shared_ptr<const Program>> CreateSharedProgram(
+      std::unique_ptr<Ast> ast) const override;
+
   const TypeProvider& GetTypeProvider() const override {
     return environment_->type_registry.GetComposedTypeProvider();
   }
 
+  ProgramMemoryUsage GetProgramMemoryUsage() const override {
+    return memory_tracker_->Get();
+  }
+
   // exposed for extensions access
   google::api::expr::runtime::FlatExprBuilder& expr_builder()
       ABSL_ATTRIBUTE_LIFETIME_BOUND {
@@ -102,6 +141,10 @@ class RuntimeImpl : public Runtime {
   // This is used to keep alive the registries while programs reference them.
   std::shared_ptr<Environment> environment_;
   google::api::expr::runtime::FlatExprBuilder expr_builder_;
+  // Shared with the programs, which may outlive the runtime.
+  std::shared_ptr<ProgramMemoryTracker> memory_tracker_;
+  // Null unless `RuntimeOptions::program_cache_size` is set.
+  std::unique_ptr<ProgramCache> program_cache_;
 };
 
 // Exposed for testing to validate program is recursively planned.
@@ -0,0 +1,116 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/internal/time_zone_cache.h"
+
+#include <cstddef>
+#include <string>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_replace.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "absl/types/optional.h"
+
+namespace cel::runtime_internal {
+namespace {
+
+class TimeZoneCache final {
+ public:
+  static TimeZoneCache& Get() {
+    static TimeZoneCache* const kInstance = new TimeZoneCache();
+    return *kInstance;
+  }
+
+  absl::optional<ResolvedTimeZone> Find(absl::string_view tz) const {
+    absl::ReaderMutexLock lock(&mutex_);
+    if (auto it = zones_.find(tz); it != zones_.end()) {
+      return it->second;
+    }
+    return absl::nullopt;
+  }
+
+  void Insert(absl::string_view tz, const ResolvedTimeZone& resolved) {
+    absl::MutexLock lock(&mutex_);
+    if (zones_.size() >= kMaxCachedTimeZones) {
+      return;
+    }
+    zones_.try_emplace(tz, resolved);
+  }
+
+  size_t size() const {
+    absl::ReaderMutexLock lock(&mutex_);
+    return zones_.size();
+  }
+
+ private:
+  TimeZoneCache() = default;
+
+  mutable absl::Mutex mutex_;
+  absl::flat_hash_map<std::string, ResolvedTimeZone> zones_
+      ABSL_GUARDED_BY(mutex_);
+};
+
+absl::StatusOr<ResolvedTimeZone> ResolveUncached(absl::string_view tz) {
+  absl::TimeZone time_zone;
+
+  // Check to see whether the timezone is an IANA timezone.
+  if (absl::LoadTimeZone(tz, &time_zone)) {
+    return ResolvedTimeZone{time_zone, absl::ZeroDuration()};
+  }
+
+  // Check for times of the format: [+-]HH:MM and convert them into durations
+  // specified as [+-]HHhMMm.
+  if (absl::StrContains(tz, ":")) {
+    std::string dur = absl::StrCat(tz, "m");
+    absl::StrReplaceAll({{":", "h"}}, &dur);
+    absl::Duration d;
+    if (absl::ParseDuration(dur, &d)) {
+      return ResolvedTimeZone{absl::UTCTimeZone(), d};
+    }
+  }
+
+  // Otherwise, error.
+  return absl::InvalidArgumentError("Invalid timezone");
+}
+
+}  // namespace
+
+absl::StatusOr<ResolvedTimeZone> ResolveTimeZone(absl::string_view tz) {
+  // Early return if there is no timezone.
+  if (tz.empty()) {
+    return ResolvedTimeZone{absl::UTCTimeZone(), absl::ZeroDuration()};
+  }
+  TimeZoneCache& cache = TimeZoneCache::Get();
+  if (auto cached = cache.Find(tz); cached.has_value()) {
+    return *cached;
+  }
+  // Invalid zones are not cached, they are expected to be rare and caching them
+  // would let arbitrary input strings fill the cache.
+  absl::StatusOr<ResolvedTimeZone> resolved = ResolveUncached(tz);
+  if (resolved.ok()) {
+    cache.Insert(tz, *resolved);
+  }
+  return resolved;
+}
+
+size_t CachedTimeZoneCount() { return TimeZoneCache::Get().size(); }
+
+}  // namespace cel::runtime_internal
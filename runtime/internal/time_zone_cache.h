@@ -0,0 +1,58 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Process-wide cache of the time zone arguments accepted by the timestamp
+// accessor functions (e.g. `ts.getHours("America/New_York")` or
+// `ts.getHours("-08:00")`).
+#ifndef THIRD_PARTY_CEL_CPP_RUNTIME_INTERNAL_TIME_ZONE_CACHE_H_
+#define THIRD_PARTY_CEL_CPP_RUNTIME_INTERNAL_TIME_ZONE_CACHE_H_
+
+#include <cstddef>
+
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/time.h"
+
+namespace cel::runtime_internal {
+
+// A time zone argument resolved to either an IANA time zone or a fixed offset
+// from UTC.
+struct ResolvedTimeZone {
+  absl::TimeZone zone;
+  // Offset applied to the timestamp before the breakdown in `zone`. Zero for
+  // IANA time zones.
+  absl::Duration offset;
+
+  absl::TimeZone::CivilInfo At(absl::Time timestamp) const {
+    return zone.At(timestamp + offset);
+  }
+};
+
+// Upper bound on the number of distinct time zone arguments kept in the
+// cache. Arguments resolved after the cache is full are not retained.
+inline constexpr size_t kMaxCachedTimeZones = 1024;
+
+// Resolves `tz`, which is either empty (UTC), an IANA time zone name or an
+// offset of the form [+-]HH:MM. Successful resolutions are cached for the
+// lifetime of the process. Returns `absl::InvalidArgumentError` if `tz` is
+// not a valid time zone.
+absl::StatusOr<ResolvedTimeZone> ResolveTimeZone(absl::string_view tz);
+
+// Returns the number of time zone arguments currently cached. Exposed for
+// testing.
+size_t CachedTimeZoneCount();
+
+}  // namespace cel::runtime_internal
+
+#endif  // THIRD_PARTY_CEL_CPP_RUNTIME_INTERNAL_TIME_ZONE_CACHE_H_
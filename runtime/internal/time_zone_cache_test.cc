@@ -0,0 +1,83 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/internal/time_zone_cache.h"
+
+#include <cstddef>
+
+#include "absl/status/status.h"
+#include "absl/time/civil_time.h"
+#include "absl/time/time.h"
+#include "internal/testing.h"
+
+namespace cel::runtime_internal {
+namespace {
+
+using ::absl_testing::StatusIs;
+
+absl::Time TestTime() {
+  return absl::FromCivil(absl::CivilSecond(2024, 3, 10, 12, 0, 0),
+                         absl::UTCTimeZone());
+}
+
+TEST(TimeZoneCacheTest, EmptyIsUtc) {
+  ASSERT_OK_AND_ASSIGN(ResolvedTimeZone resolved, ResolveTimeZone(""));
+  EXPECT_EQ(resolved.At(TestTime()).cs, absl::CivilSecond(2024, 3, 10, 12));
+}
+
+TEST(TimeZoneCacheTest, IanaTimeZone) {
+  ASSERT_OK_AND_ASSIGN(ResolvedTimeZone resolved,
+                       ResolveTimeZone("America/Los_Angeles"));
+  EXPECT_EQ(resolved.offset, absl::ZeroDuration());
+  EXPECT_EQ(resolved.At(TestTime()).cs, absl::CivilSecond(2024, 3, 10, 5));
+}
+
+TEST(TimeZoneCacheTest, FixedOffset) {
+  ASSERT_OK_AND_ASSIGN(ResolvedTimeZone resolved, ResolveTimeZone("+05:30"));
+  EXPECT_EQ(resolved.offset, absl::Hours(5) + absl::Minutes(30));
+  EXPECT_EQ(resolved.At(TestTime()).cs,
+            absl::CivilSecond(2024, 3, 10, 17, 30));
+
+  ASSERT_OK_AND_ASSIGN(resolved, ResolveTimeZone("-08:00"));
+  EXPECT_EQ(resolved.At(TestTime()).cs, absl::CivilSecond(2024, 3, 10, 4));
+}
+
+TEST(TimeZoneCacheTest, InvalidTimeZone) {
+  EXPECT_THAT(ResolveTimeZone("Not/AZone"),
+              StatusIs(absl::StatusCode::kInvalidArgument, "Invalid timezone"));
+  EXPECT_THAT(ResolveTimeZone("ab:cd"),
+              StatusIs(absl::StatusCode::kInvalidArgument, "Invalid timezone"));
+}
+
+TEST(TimeZoneCacheTest, CachesResolvedZones) {
+  ASSERT_OK(ResolveTimeZone("Europe/Paris"));
+  size_t count = CachedTimeZoneCount();
+  ASSERT_OK_AND_ASSIGN(ResolvedTimeZone resolved,
+                       ResolveTimeZone("Europe/Paris"));
+  EXPECT_EQ(CachedTimeZoneCount(), count);
+  EXPECT_EQ(resolved.At(TestTime()).cs, absl::CivilSecond(2024, 3, 10, 13));
+
+  ASSERT_OK(ResolveTimeZone("+01:15"));
+  EXPECT_EQ(CachedTimeZoneCount(), count + 1);
+}
+
+TEST(TimeZoneCacheTest, InvalidZonesAreNotCached) {
+  size_t count = CachedTimeZoneCount();
+  EXPECT_THAT(ResolveTimeZone("Invalid/Zone"),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_EQ(CachedTimeZoneCount(), count);
+}
+
+}  // namespace
+}  // namespace cel::runtime_internal
@@ -0,0 +1,153 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/internal/value_hash.h"
+
+#include <cstddef>
+#include <utility>
+
+#include "absl/hash/hash.h"
+#include "absl/status/statusor.h"
+#include "absl/types/optional.h"
+#include "common/value.h"
+#include "common/value_kind.h"
+#include "common/value_manager.h"
+#include "internal/number.h"
+#include "internal/status_macros.h"
+
+namespace cel::runtime_internal {
+
+namespace {
+
+using ::cel::internal::Number;
+
+bool IsNumeric(ValueKind kind) {
+  return kind == ValueKind::kInt || kind == ValueKind::kUint ||
+         kind == ValueKind::kDouble;
+}
+
+Number AsNumber(const Value& value) {
+  switch (value.kind()) {
+    case ValueKind::kInt:
+      return Number::FromInt64(value.GetInt().NativeValue());
+    case ValueKind::kUint:
+      return Number::FromUint64(value.GetUint().NativeValue());
+    default:
+      return Number::FromDouble(value.GetDouble().NativeValue());
+  }
+}
+
+}  // namespace
+
+bool IsHashableValue(const Value& value) {
+  switch (value.kind()) {
+    case ValueKind::kNull:
+    case ValueKind::kBool:
+    case ValueKind::kInt:
+    case ValueKind::kUint:
+    case ValueKind::kDouble:
+    case ValueKind::kString:
+    case ValueKind::kBytes:
+    case ValueKind::kDuration:
+    case ValueKind::kTimestamp:
+      return true;
+    default:
+      return false;
+  }
+}
+
+size_t ValueHash::operator()(const Value& value) const {
+  ValueKind kind = value.kind();
+  switch (kind) {
+    case ValueKind::kNull:
+      return absl::HashOf(kind);
+    case ValueKind::kBool:
+      return absl::HashOf(kind, value.GetBool().NativeValue());
+    case ValueKind::kInt:
+    case ValueKind::kUint:
+    case ValueKind::kDouble: {
+      // Heterogeneous comparisons between ints and doubles convert to double,
+      // so hashing the double representation is the only choice that keeps
+      // equal values in the same bucket. Fold -0.0 into 0.0.
+      double number = AsNumber(value).AsDouble();
+      return absl::HashOf(ValueKind::kDouble, number == 0.0 ? 0.0 : number);
+    }
+    case ValueKind::kString:
+      return absl::HashOf(kind, value.GetString());
+    case ValueKind::kBytes:
+      return absl::HashOf(kind, value.GetBytes());
+    case ValueKind::kDuration:
+      return absl::HashOf(kind, value.GetDuration().NativeValue());
+    case ValueKind::kTimestamp:
+      return absl::HashOf(kind, value.GetTimestamp().NativeValue());
+    default:
+      return absl::HashOf(kind);
+  }
+}
+
+bool ValueEq::operator()(const Value& lhs, const Value& rhs) const {
+  ValueKind kind = lhs.kind();
+  if (IsNumeric(kind) && IsNumeric(rhs.kind())) {
+    return AsNumber(lhs) == AsNumber(rhs);
+  }
+  if (kind != rhs.kind()) {
+    return false;
+  }
+  switch (kind) {
+    case ValueKind::kNull:
+      return true;
+    case ValueKind::kBool:
+      return lhs.GetBool().NativeValue() == rhs.GetBool().NativeValue();
+    case ValueKind::kString:
+      return lhs.GetString().Equals(rhs.GetString());
+    case ValueKind::kBytes:
+      return lhs.GetBytes().Equals(rhs.GetBytes());
+    case ValueKind::kDuration:
+      return lhs.GetDuration().NativeValue() ==
+             rhs.GetDuration().NativeValue();
+    case ValueKind::kTimestamp:
+      return lhs.GetTimestamp().NativeValue() ==
+             rhs.GetTimestamp().NativeValue();
+    default:
+      return false;
+  }
+}
+
+absl::StatusOr<absl::optional<ValueHashSet>> ValueHashSet::FromList(
+    ValueManager& value_manager, const ListValue& list) {
+  ValueHashSet set;
+  CEL_ASSIGN_OR_RETURN(size_t size, list.Size());
+  set.values_.reserve(size);
+  bool hashable = true;
+  CEL_RETURN_IF_ERROR(list.ForEach(
+      value_manager,
+      [&set, &hashable](const Value& element) -> absl::StatusOr<bool> {
+        if (!IsHashableValue(element)) {
+          hashable = false;
+          return false;
+        }
+        set.values_.insert(element);
+        return true;
+      }));
+  if (!hashable) {
+    return absl::nullopt;
+  }
+  return set;
+}
+
+bool ValueHashSet::Contains(const Value& value) const {
+  return values_.contains(value);
+}
+
+}  // namespace cel::runtime_internal
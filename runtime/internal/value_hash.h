@@ -0,0 +1,70 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Hashing support for scalar CEL values that is consistent with CEL
+// heterogeneous equality (e.g. 1 == 1u == 1.0 hash to the same bucket).
+#ifndef THIRD_PARTY_CEL_CPP_RUNTIME_INTERNAL_VALUE_HASH_H_
+#define THIRD_PARTY_CEL_CPP_RUNTIME_INTERNAL_VALUE_HASH_H_
+
+#include <cstddef>
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/status/statusor.h"
+#include "absl/types/optional.h"
+#include "common/value.h"
+#include "common/value_manager.h"
+
+namespace cel::runtime_internal {
+
+// Returns true if `value` can be stored in a `ValueHashSet`. Only scalar kinds
+// with a total, context free equality are hashable: null, bool, int, uint,
+// double, string, bytes, duration and timestamp.
+bool IsHashableValue(const Value& value);
+
+// Hash functor for hashable values. Numeric values hash by their double
+// representation so that numbers that compare equal under heterogeneous
+// equality land in the same bucket.
+struct ValueHash {
+  size_t operator()(const Value& value) const;
+};
+
+// Equality functor for hashable values implementing CEL heterogeneous
+// equality.
+struct ValueEq {
+  bool operator()(const Value& lhs, const Value& rhs) const;
+};
+
+// A set of hashable CEL values.
+class ValueHashSet final {
+ public:
+  // Builds a set from the elements of `list`. Returns `absl::nullopt` if any
+  // element is not hashable, in which case the caller is expected to fall
+  // back to `ListValue::Contains`.
+  static absl::StatusOr<absl::optional<ValueHashSet>> FromList(
+      ValueManager& value_manager, const ListValue& list);
+
+  // Returns true if `value` is a member of the set. `value` must be hashable.
+  bool Contains(const Value& value) const;
+
+  size_t size() const { return values_.size(); }
+
+ private:
+  ValueHashSet() = default;
+
+  absl::flat_hash_set<Value, ValueHash, ValueEq> values_;
+};
+
+}  // namespace cel::runtime_internal
+
+#endif  // THIRD_PARTY_CEL_CPP_RUNTIME_INTERNAL_VALUE_HASH_H_
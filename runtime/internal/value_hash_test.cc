@@ -0,0 +1,135 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/internal/value_hash.h"
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "absl/log/absl_check.h"
+#include "absl/time/time.h"
+#include "common/memory.h"
+#include "common/type.h"
+#include "common/type_reflector.h"
+#include "common/value.h"
+#include "common/values/legacy_value_manager.h"
+#include "internal/testing.h"
+
+namespace cel::runtime_internal {
+namespace {
+
+class ValueHashTest : public testing::Test {
+ public:
+  ValueHashTest()
+      : value_manager_(MemoryManagerRef::ReferenceCounting(),
+                       TypeReflector::Builtin()) {}
+
+  ValueManager& value_manager() { return value_manager_; }
+
+  ListValue MakeList(std::vector<Value> elements) {
+    auto builder = value_manager_.NewListValueBuilder(ListType());
+    ABSL_CHECK_OK(builder.status());
+    for (auto& element : elements) {
+      ABSL_CHECK_OK((*builder)->Add(std::move(element)));
+    }
+    return std::move(**builder).Build();
+  }
+
+ private:
+  common_internal::LegacyValueManager value_manager_;
+};
+
+TEST_F(ValueHashTest, HeterogeneousNumbersHashEqual) {
+  ValueHash hash;
+  ValueEq eq;
+  Value i = IntValue(1);
+  Value u = UintValue(1);
+  Value d = DoubleValue(1.0);
+
+  EXPECT_EQ(hash(i), hash(u));
+  EXPECT_EQ(hash(i), hash(d));
+  EXPECT_TRUE(eq(i, u));
+  EXPECT_TRUE(eq(u, d));
+  EXPECT_TRUE(eq(d, i));
+  EXPECT_FALSE(eq(i, DoubleValue(1.5)));
+  EXPECT_FALSE(
+      eq(IntValue(-1), UintValue(std::numeric_limits<uint64_t>::max())));
+}
+
+TEST_F(ValueHashTest, SignedZero) {
+  ValueHash hash;
+  ValueEq eq;
+
+  EXPECT_EQ(hash(DoubleValue(-0.0)), hash(DoubleValue(0.0)));
+  EXPECT_EQ(hash(DoubleValue(-0.0)), hash(IntValue(0)));
+  EXPECT_TRUE(eq(DoubleValue(-0.0), IntValue(0)));
+}
+
+TEST_F(ValueHashTest, NaNNeverEqual) {
+  ValueEq eq;
+  Value nan = DoubleValue(std::nan(""));
+
+  EXPECT_FALSE(eq(nan, nan));
+}
+
+TEST_F(ValueHashTest, DistinctKinds) {
+  ValueEq eq;
+
+  EXPECT_FALSE(eq(StringValue("1"), IntValue(1)));
+  EXPECT_FALSE(eq(StringValue("a"), BytesValue("a")));
+  EXPECT_FALSE(eq(NullValue(), BoolValue(false)));
+  EXPECT_TRUE(eq(NullValue(), NullValue()));
+  EXPECT_TRUE(eq(StringValue("a"), StringValue("a")));
+  EXPECT_TRUE(eq(BytesValue("a"), BytesValue("a")));
+  EXPECT_TRUE(eq(DurationValue(absl::Seconds(1)),
+                 DurationValue(absl::Milliseconds(1000))));
+  EXPECT_TRUE(eq(TimestampValue(absl::UnixEpoch()),
+                 TimestampValue(absl::FromUnixSeconds(0))));
+}
+
+TEST_F(ValueHashTest, IsHashableValue) {
+  EXPECT_TRUE(IsHashableValue(IntValue(1)));
+  EXPECT_TRUE(IsHashableValue(StringValue("a")));
+  EXPECT_TRUE(IsHashableValue(NullValue()));
+  EXPECT_FALSE(IsHashableValue(MakeList({IntValue(1)})));
+}
+
+TEST_F(ValueHashTest, FromList) {
+  ListValue list =
+      MakeList({IntValue(1), StringValue("a"), DoubleValue(2.5), NullValue()});
+
+  ASSERT_OK_AND_ASSIGN(auto set, ValueHashSet::FromList(value_manager(), list));
+  ASSERT_TRUE(set.has_value());
+  EXPECT_EQ(set->size(), 4);
+  EXPECT_TRUE(set->Contains(UintValue(1)));
+  EXPECT_TRUE(set->Contains(DoubleValue(1.0)));
+  EXPECT_TRUE(set->Contains(StringValue("a")));
+  EXPECT_TRUE(set->Contains(DoubleValue(2.5)));
+  EXPECT_TRUE(set->Contains(NullValue()));
+  EXPECT_FALSE(set->Contains(BytesValue("a")));
+  EXPECT_FALSE(set->Contains(IntValue(2)));
+}
+
+TEST_F(ValueHashTest, FromListNotHashable) {
+  ListValue list = MakeList({IntValue(1), MakeList({IntValue(2)})});
+
+  ASSERT_OK_AND_ASSIGN(auto set, ValueHashSet::FromList(value_manager(), list));
+  EXPECT_FALSE(set.has_value());
+}
+
+}  // namespace
+}  // namespace cel::runtime_internal
@@ -0,0 +1,133 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "internal/status_macros.h"
+#include "internal/testing.h"
+#include "internal/testing_descriptor_pool.h"
+#include "parser/parser.h"
+#include "runtime/regex_precompilation.h"
+#include "runtime/runtime.h"
+#include "runtime/runtime_builder.h"
+#include "runtime/runtime_options.h"
+#include "runtime/standard_runtime_builder_factory.h"
+
+namespace cel {
+namespace {
+
+using ::cel::extensions::EnableRegexPrecompilation;
+using ::cel::internal::GetTestingDescriptorPool;
+using ::google::api::expr::parser::ParseAst;
+using ::testing::Ge;
+using ::testing::Gt;
+
+absl::StatusOr<std::unique_ptr<const Runtime>> MakeRuntime(
+    const RuntimeOptions& options, bool precompile_regex = false) {
+  CEL_ASSIGN_OR_RETURN(
+      RuntimeBuilder builder,
+      CreateStandardRuntimeBuilder(GetTestingDescriptorPool(), options));
+  if (precompile_regex) {
+    CEL_RETURN_IF_ERROR(EnableRegexPrecompilation(builder));
+  }
+  return std::move(builder).Build();
+}
+
+absl::StatusOr<std::unique_ptr<Program>> Plan(const Runtime& runtime,
+                                              absl::string_view expression) {
+  CEL_ASSIGN_OR_RETURN(auto ast, ParseAst(expression));
+  return runtime.CreateProgram(std::move(ast));
+}
+
+TEST(ProgramMemoryUsageTest, AccountsForConstants) {
+  ASSERT_OK_AND_ASSIGN(auto runtime, MakeRuntime(RuntimeOptions()));
+  const std::string text(1000, 'a');
+
+  ASSERT_OK_AND_ASSIGN(auto program,
+                       Plan(*runtime, absl::StrCat("'", text, "' + x")));
+  ProgramMemoryUsage usage = program->GetMemoryUsage();
+
+  EXPECT_THAT(usage.steps, Gt(0));
+  EXPECT_THAT(usage.constants, Ge(text.size()));
+  EXPECT_EQ(usage.regex, 0);
+  EXPECT_EQ(usage.total(),
+            usage.steps + usage.constants + usage.regex + usage.arena);
+}
+
+TEST(ProgramMemoryUsageTest, AccountsForRegexPrograms) {
+  ASSERT_OK_AND_ASSIGN(
+      auto runtime, MakeRuntime(RuntimeOptions(), /*precompile_regex=*/true));
+
+  ASSERT_OK_AND_ASSIGN(auto program, Plan(*runtime, "x.matches('a+b')"));
+
+  EXPECT_THAT(program->GetMemoryUsage().regex, Gt(0));
+}
+
+TEST(ProgramMemoryUsageTest, AccountsForRecursivePlans) {
+  RuntimeOptions options;
+  options.max_recursion_depth = -1;
+  ASSERT_OK_AND_ASSIGN(auto runtime, MakeRuntime(options));
+
+  ASSERT_OK_AND_ASSIGN(auto small, Plan(*runtime, "x + 1"));
+  ASSERT_OK_AND_ASSIGN(auto large, Plan(*runtime, "x + 1 + 2 + 3 + 4 + 5"));
+
+  EXPECT_THAT(large->GetMemoryUsage().steps,
+              Gt(small->GetMemoryUsage().steps));
+}
+
+TEST(ProgramMemoryUsageTest, AccountsForStepArena) {
+  ASSERT_OK_AND_ASSIGN(auto runtime, MakeRuntime(RuntimeOptions()));
+
+  ASSERT_OK_AND_ASSIGN(auto program, Plan(*runtime, "x + 1"));
+
+  // Steps are allocated from the program's step arena, whose first block is
+  // 1 KiB, far more than the few steps of this expression.
+  EXPECT_THAT(program->GetMemoryUsage().steps, Ge(1024));
+}
+
+TEST(ProgramMemoryUsageTest, RuntimeAggregatesLivePrograms) {
+  ASSERT_OK_AND_ASSIGN(auto runtime, MakeRuntime(RuntimeOptions()));
+  EXPECT_EQ(runtime->GetProgramMemoryUsage().total(), 0);
+
+  ASSERT_OK_AND_ASSIGN(auto first, Plan(*runtime, "x + 1"));
+  ASSERT_OK_AND_ASSIGN(auto second, Plan(*runtime, "[x, 'abc'].size()"));
+  EXPECT_EQ(runtime->GetProgramMemoryUsage().total(),
+            first->GetMemoryUsage().total() +
+                second->GetMemoryUsage().total());
+
+  first.reset();
+  EXPECT_EQ(runtime->GetProgramMemoryUsage().total(),
+            second->GetMemoryUsage().total());
+
+  second.reset();
+  EXPECT_EQ(runtime->GetProgramMemoryUsage().total(), 0);
+}
+
+TEST(ProgramMemoryUsageTest, ProgramsOutliveRuntime) {
+  ASSERT_OK_AND_ASSIGN(auto runtime, MakeRuntime(RuntimeOptions()));
+  ASSERT_OK_AND_ASSIGN(auto program, Plan(*runtime, "x + 1"));
+  ProgramMemoryUsage usage = program->GetMemoryUsage();
+
+  runtime.reset();
+
+  EXPECT_EQ(program->GetMemoryUsage().total(), usage.total());
+}
+
+}  // namespace
+}  // namespace cel
@@ -0,0 +1,85 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/regex_cache.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "re2/re2.h"
+
+namespace cel {
+
+std::shared_ptr<const RE2> RegexCache::GetOrCompile(absl::string_view pattern) {
+  static const RE2::Options* const kDefaultOptions = new RE2::Options();
+  return GetOrCompile(pattern, *kDefaultOptions);
+}
+
+std::shared_ptr<const RE2> RegexCache::GetOrCompile(
+    absl::string_view pattern, const RE2::Options& options) {
+  if (max_size_ == 0) {
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    return std::make_shared<const RE2>(pattern, options);
+  }
+  {
+    absl::MutexLock lock(&mutex_);
+    if (auto it = index_.find(MakeKey(pattern, options)); it != index_.end()) {
+      entries_.splice(entries_.begin(), entries_, it->second);
+      hits_.fetch_add(1, std::memory_order_relaxed);
+      return it->second->program;
+    }
+  }
+  misses_.fetch_add(1, std::memory_order_relaxed);
+  // Compile outside of the lock, compilation of large patterns is expensive
+  // and would otherwise serialize unrelated lookups.
+  auto program = std::make_shared<const RE2>(pattern, options);
+
+  absl::MutexLock lock(&mutex_);
+  if (auto it = index_.find(MakeKey(pattern, options)); it != index_.end()) {
+    // Lost a race with another thread compiling the same pattern, prefer the
+    // program that is already shared.
+    entries_.splice(entries_.begin(), entries_, it->second);
+    return it->second->program;
+  }
+  entries_.push_front(Entry{std::string(pattern), program});
+  index_.insert({MakeKey(entries_.front().pattern, options), entries_.begin()});
+  while (entries_.size() > max_size_) {
+    const Entry& victim = entries_.back();
+    index_.erase(MakeKey(victim.pattern, victim.program->options()));
+    entries_.pop_back();
+    evictions_.fetch_add(1, std::memory_order_relaxed);
+  }
+  return program;
+}
+
+RegexCache::Stats RegexCache::stats() const {
+  Stats stats;
+  stats.hits = hits_.load(std::memory_order_relaxed);
+  stats.misses = misses_.load(std::memory_order_relaxed);
+  stats.evictions = evictions_.load(std::memory_order_relaxed);
+  absl::MutexLock lock(&mutex_);
+  stats.size = entries_.size();
+  return stats;
+}
+
+void RegexCache::Clear() {
+  absl::MutexLock lock(&mutex_);
+  index_.clear();
+  entries_.clear();
+}
+
+}  // namespace cel
@@ -0,0 +1,132 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_CEL_CPP_RUNTIME_REGEX_CACHE_H_
+#define THIRD_PARTY_CEL_CPP_RUNTIME_REGEX_CACHE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "re2/re2.h"
+
+namespace cel {
+
+// RegexCache is a thread-safe, size-bounded cache of compiled RE2 programs
+// keyed by the pattern and the RE2 options used to compile it. Entries are
+// evicted in least-recently-used order once `max_size` is exceeded.
+//
+// The cache is used by the `matches` builtin and the regex extension functions
+// when patterns are not known at plan time (e.g. they come from a variable),
+// so that repeated evaluations with the same pattern do not recompile it.
+//
+// Programs are handed out as `std::shared_ptr<const RE2>`, so eviction never
+// invalidates a program that is in use by a concurrent evaluation.
+//
+// Invalid patterns are cached as well: callers must check `RE2::ok()`.
+class RegexCache final {
+ public:
+  struct Stats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    size_t size = 0;
+  };
+
+  // Creates a cache holding at most `max_size` compiled programs. A
+  // `max_size` of 0 disables caching: every lookup compiles a fresh program
+  // and counts as a miss.
+  static std::shared_ptr<RegexCache> Create(size_t max_size) {
+    return std::make_shared<RegexCache>(max_size);
+  }
+
+  explicit RegexCache(size_t max_size) : max_size_(max_size) {}
+
+  RegexCache(const RegexCache&) = delete;
+  RegexCache& operator=(const RegexCache&) = delete;
+
+  // Returns the compiled program for `pattern` with default RE2 options,
+  // compiling it on a miss.
+  std::shared_ptr<const RE2> GetOrCompile(absl::string_view pattern);
+
+  // Returns the compiled program for `pattern` with `options`, compiling it on
+  // a miss.
+  std::shared_ptr<const RE2> GetOrCompile(absl::string_view pattern,
+                                          const RE2::Options& options);
+
+  size_t max_size() const { return max_size_; }
+
+  // Returns a snapshot of the cache counters.
+  Stats stats() const;
+
+  // Drops all cached programs. Counters are preserved.
+  void Clear();
+
+ private:
+  // Key referencing the pattern owned by the corresponding `Entry`.
+  struct KeyView {
+    absl::string_view pattern;
+    int parse_flags;
+    int64_t max_mem;
+    bool longest_match;
+
+    template <typename H>
+    friend H AbslHashValue(H state, const KeyView& key) {
+      return H::combine(std::move(state), key.pattern, key.parse_flags,
+                        key.max_mem, key.longest_match);
+    }
+
+    friend bool operator==(const KeyView& lhs, const KeyView& rhs) {
+      return lhs.pattern == rhs.pattern &&
+             lhs.parse_flags == rhs.parse_flags &&
+             lhs.max_mem == rhs.max_mem &&
+             lhs.longest_match == rhs.longest_match;
+    }
+  };
+
+  struct Entry {
+    std::string pattern;
+    std::shared_ptr<const RE2> program;
+  };
+
+  using EntryList = std::list<Entry>;
+
+  static KeyView MakeKey(absl::string_view pattern,
+                         const RE2::Options& options) {
+    return KeyView{pattern, options.ParseFlags(), options.max_mem(),
+                   options.longest_match()};
+  }
+
+  const size_t max_size_;
+  mutable absl::Mutex mutex_;
+  // Most recently used entries are at the front.
+  EntryList entries_ ABSL_GUARDED_BY(mutex_);
+  absl::flat_hash_map<KeyView, EntryList::iterator> index_
+      ABSL_GUARDED_BY(mutex_);
+  std::atomic<uint64_t> hits_{0};
+  std::atomic<uint64_t> misses_{0};
+  std::atomic<uint64_t> evictions_{0};
+};
+
+}  // namespace cel
+
+#endif  // THIRD_PARTY_CEL_CPP_RUNTIME_REGEX_CACHE_H_
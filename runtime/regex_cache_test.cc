@@ -0,0 +1,136 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "runtime/regex_cache.h"
+
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "internal/testing.h"
+#include "re2/re2.h"
+
+namespace cel {
+namespace {
+
+TEST(RegexCache, ReturnsSameProgramOnHit) {
+  RegexCache cache(4);
+
+  auto first = cache.GetOrCompile("a+b");
+  auto second = cache.GetOrCompile("a+b");
+
+  ASSERT_NE(first, nullptr);
+  EXPECT_TRUE(first->ok());
+  EXPECT_EQ(first.get(), second.get());
+  RegexCache::Stats stats = cache.stats();
+  EXPECT_EQ(stats.hits, 1);
+  EXPECT_EQ(stats.misses, 1);
+  EXPECT_EQ(stats.size, 1);
+}
+
+TEST(RegexCache, KeyedByOptions) {
+  RegexCache cache(4);
+  RE2::Options case_insensitive;
+  case_insensitive.set_case_sensitive(false);
+
+  auto sensitive = cache.GetOrCompile("abc");
+  auto insensitive = cache.GetOrCompile("abc", case_insensitive);
+
+  EXPECT_NE(sensitive.get(), insensitive.get());
+  EXPECT_FALSE(RE2::FullMatch("ABC", *sensitive));
+  EXPECT_TRUE(RE2::FullMatch("ABC", *insensitive));
+  EXPECT_EQ(cache.stats().misses, 2);
+}
+
+TEST(RegexCache, EvictsLeastRecentlyUsed) {
+  RegexCache cache(2);
+
+  auto a = cache.GetOrCompile("a");
+  cache.GetOrCompile("b");
+  // Touch `a` so that `b` becomes the least recently used entry.
+  cache.GetOrCompile("a");
+  cache.GetOrCompile("c");
+
+  RegexCache::Stats stats = cache.stats();
+  EXPECT_EQ(stats.evictions, 1);
+  EXPECT_EQ(stats.size, 2);
+  EXPECT_EQ(cache.GetOrCompile("a").get(), a.get());
+  EXPECT_EQ(cache.stats().hits, 2);
+  cache.GetOrCompile("b");
+  EXPECT_EQ(cache.stats().misses, 4);
+}
+
+TEST(RegexCache, EvictedProgramsRemainUsable) {
+  RegexCache cache(1);
+
+  auto a = cache.GetOrCompile("a+");
+  cache.GetOrCompile("b+");
+
+  EXPECT_TRUE(RE2::FullMatch("aaa", *a));
+}
+
+TEST(RegexCache, CachesInvalidPatterns) {
+  RegexCache cache(2);
+
+  auto invalid = cache.GetOrCompile("(");
+  EXPECT_FALSE(invalid->ok());
+  EXPECT_EQ(cache.GetOrCompile("(").get(), invalid.get());
+}
+
+TEST(RegexCache, ZeroSizeDisablesCaching) {
+  RegexCache cache(0);
+
+  auto first = cache.GetOrCompile("a");
+  auto second = cache.GetOrCompile("a");
+
+  EXPECT_NE(first.get(), second.get());
+  EXPECT_EQ(cache.stats().misses, 2);
+  EXPECT_EQ(cache.stats().size, 0);
+}
+
+TEST(RegexCache, Clear) {
+  RegexCache cache(2);
+
+  cache.GetOrCompile("a");
+  cache.Clear();
+
+  EXPECT_EQ(cache.stats().size, 0);
+  cache.GetOrCompile("a");
+  EXPECT_EQ(cache.stats().misses, 2);
+}
+
+TEST(RegexCache, ConcurrentLookups) {
+  auto cache = RegexCache::Create(8);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&cache]() {
+      for (int i = 0; i < 1000; ++i) {
+        auto program = cache->GetOrCompile(absl::StrCat("x", i % 16, "y"));
+        ASSERT_TRUE(program->ok());
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  RegexCache::Stats stats = cache->stats();
+  EXPECT_EQ(stats.hits + stats.misses, 4000);
+  EXPECT_LE(stats.size, 8);
+}
+
+}  // namespace
+}  // namespace cel
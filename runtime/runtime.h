@@ -17,6 +17,7 @@
 #ifndef THIRD_PARTY_CEL_CPP_RUNTIME_RUNTIME_H_
 #define THIRD_PARTY_CEL_CPP_RUNTIME_RUNTIME_H_
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <utility>
@@ -39,6 +40,42 @@ namespace runtime_internal {
 class RuntimeFriendAccess;
 }  // namespace runtime_internal
 
+// Estimated memory held by planned programs, in bytes.
+//
+// Data shared between programs of the same runtime (e.g. interned string
+// constants and compiled regular expressions) is counted in full by every
+// program referencing it, so sums over programs are an upper bound.
+struct ProgramMemoryUsage {
+  // The execution plan: expression step objects and the containers holding
+  // them.
+  size_t steps = 0;
+  // Data owned by constant values of the plan, outside of the step objects.
+  size_t constants = 0;
+  // Compiled regular expressions.
+  size_t regex = 0;
+  // Memory allocated by the arena used during planning, e.g. for folded
+  // constants.
+  size_t arena = 0;
+
+  size_t total() const { return steps + constants + regex + arena; }
+
+  ProgramMemoryUsage& operator+=(const ProgramMemoryUsage& other) {
+    steps += other.steps;
+    constants += other.constants;
+    regex += other.regex;
+    arena += other.arena;
+    return *this;
+  }
+
+  ProgramMemoryUsage& operator-=(const ProgramMemoryUsage& other) {
+    steps -= other.steps;
+    constants -= other.constants;
+    regex -= other.regex;
+    arena -= other.arena;
+    return *this;
+  }
+};
+
 // Representation of an evaluable CEL expression.
 //
 // See Runtime below for creating new programs.
@@ -76,6 +113,12 @@ class Program {
                                          ValueManager& value_factory) const = 0;
 
   virtual const TypeProvider& GetTypeProvider() const = 0;
+
+  // Returns an estimate of the memory held by the program, e.g. for enforcing
+  // limits on the programs kept per client. The estimate is computed once,
+  // when the program is created. Implementations that do not support this
+  // report zero.
+  virtual ProgramMemoryUsage GetMemoryUsage() const { return {}; }
 };
 
 // Representation for a traceable CEL expression.
@@ -114,6 +157,10 @@ class TraceableProgram : public Program {
 //
 // Runtime instances should be created from a RuntimeBuilder rather than
 // instantiated directly.
+//
+// Runtime instances are thread-safe once built: `CreateProgram` and
+// `CreateTraceableProgram` may be called concurrently from multiple threads,
+// and the resulting programs may be evaluated concurrently as well.
 class Runtime {
  public:
   struct CreateProgramOptions {
@@ -142,8 +189,29 @@ class Runtime {
   CreateTraceableProgram(std::unique_ptr<cel::Ast> ast,
                          const CreateProgramOptions& options) const = 0;
 
+  // Creates a program that may be shared with other callers.
+  //
+  // If `RuntimeOptions::program_cache_size` is set, the runtime keeps
+  // recently created programs and returns the existing instance when `ast`
+  // is identical (expression, ids and resolved references) to the AST of one
+  // of them, skipping planning entirely. Otherwise this is equivalent to
+  // `CreateProgram`.
+  virtual absl::StatusOr<std::shared_ptr<const Program>> CreateSharedProgram(
+      std::unique_ptr<cel::Ast> ast) const {
+    auto program = CreateProgram(std::move(ast));
+    if (!program.ok()) {
+      return std::move(program).status();
+    }
+    return std::shared_ptr<const Program>(std::move(program).value());
+  }
+
   virtual const TypeProvider& GetTypeProvider() const = 0;
 
+  // Returns the sum of `Program::GetMemoryUsage` over the programs created by
+  // this runtime which are still alive. Implementations that do not support
+  // this report zero.
+  virtual ProgramMemoryUsage GetProgramMemoryUsage() const { return {}; }
+
  private:
   friend class runtime_internal::RuntimeFriendAccess;
 
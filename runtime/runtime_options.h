@@ -17,12 +17,16 @@
 #ifndef THIRD_PARTY_CEL_CPP_RUNTIME_RUNTIME_OPTIONS_H_
 #define THIRD_PARTY_CEL_CPP_RUNTIME_RUNTIME_OPTIONS_H_
 
+#include <cstddef>
+#include <memory>
 #include <string>
 
 #include "absl/base/attributes.h"
 
 namespace cel {
 
+class RegexCache;
+
 // Options for unknown processing.
 enum class UnknownProcessingOptions {
   // No unknown processing.
@@ -94,6 +98,12 @@ struct RuntimeOptions {
   // upper bound.
   int regex_max_program_size = 0;
 
+  // Optional cache of compiled RE2 programs used by the regex functions for
+  // patterns that are not constant at plan time (see runtime/regex_cache.h).
+  // The cache is thread-safe and may be shared between runtimes. If unset,
+  // non-constant patterns are compiled on every call.
+  std::shared_ptr<RegexCache> regex_cache;
+
   // Enable string() overloads.
   bool enable_string_conversion = true;
 
@@ -162,6 +172,26 @@ struct RuntimeOptions {
   //
   // Default is false for the modern option type.
   bool use_legacy_container_builders = false;
+
+  // Use thread-local reference counts for values created during an
+  // evaluation with a reference counting memory manager.
+  //
+  // Reference counts created while evaluating are updated without atomic
+  // read-modify-write operations and are promoted to ordinary atomic reference
+  // counts when the evaluation returns. Only safe if extension functions do
+  // not share the values they are given or create with other threads while
+  // the evaluation is in progress. Has no effect when evaluating with an
+  // arena, or unless the library is built with
+  // `CEL_ENABLE_LOCAL_REFERENCE_COUNTING` defined.
+  bool enable_local_reference_counting = false;
+
+  // Maximum number of programs retained by `Runtime::CreateSharedProgram`.
+  //
+  // When non-zero, repeated requests for an AST identical to a recently
+  // planned one return the same immutable program instead of planning it
+  // again. The least recently used program is evicted once the limit is
+  // reached. Zero disables the cache.
+  size_t program_cache_size = 0;
 };
 // LINT.ThenChange(//depot/google3/eval/public/cel_options.h)
 
@@ -90,6 +90,65 @@ absl::StatusOr<ListValue> AppendList(ValueManager& factory, ListValue value1,
   }
   return absl::InvalidArgumentError("Unexpected call to runtime list append.");
 }
+
+absl::Status CopyMapEntries(ValueManager& factory, const MapValue& map,
+                            MapValueBuilder& builder) {
+  return map.ForEach(
+      factory,
+      [&builder](const Value& key, const Value& value) -> absl::StatusOr<bool> {
+        CEL_RETURN_IF_ERROR(builder.Put(key, value));
+        return true;
+      });
+}
+
+// MapInsert returns a copy of `map` with the entry `key: value` added. It is
+// an error for `key` to already be present.
+absl::StatusOr<Value> MapInsert(ValueManager& factory, const MapValue& map,
+                                const Value& key, const Value& value) {
+  CEL_ASSIGN_OR_RETURN(auto size, map.Size());
+  CEL_ASSIGN_OR_RETURN(auto builder, factory.NewMapValueBuilder(MapType{}));
+  builder->Reserve(size + 1);
+  CEL_RETURN_IF_ERROR(CopyMapEntries(factory, map, *builder));
+  if (auto status = builder->Put(key, value); !status.ok()) {
+    return ErrorValue(std::move(status));
+  }
+  return std::move(*builder).Build();
+}
+
+// MapInsertMap returns the union of `map1` and `map2`. It is an error for the
+// maps to have a key in common.
+absl::StatusOr<Value> MapInsertMap(ValueManager& factory, const MapValue& map1,
+                                   const MapValue& map2) {
+  CEL_ASSIGN_OR_RETURN(auto size1, map1.Size());
+  CEL_ASSIGN_OR_RETURN(auto size2, map2.Size());
+  if (size2 == 0) {
+    return map1;
+  }
+  CEL_ASSIGN_OR_RETURN(auto builder, factory.NewMapValueBuilder(MapType{}));
+  builder->Reserve(size1 + size2);
+  CEL_RETURN_IF_ERROR(CopyMapEntries(factory, map1, *builder));
+  if (auto status = CopyMapEntries(factory, map2, *builder); !status.ok()) {
+    return ErrorValue(std::move(status));
+  }
+  return std::move(*builder).Build();
+}
+
+absl::Status RegisterMapInsertFunctions(FunctionRegistry& registry) {
+  CEL_RETURN_IF_ERROR(registry.Register(
+      VariadicFunctionAdapter<absl::StatusOr<Value>, const MapValue&,
+                              const Value&, const Value&>::
+          CreateDescriptor(cel::builtin::kMapInsert, false),
+      VariadicFunctionAdapter<absl::StatusOr<Value>, const MapValue&,
+                              const Value&, const Value&>::
+          WrapFunction(MapInsert)));
+  return registry.Register(
+      BinaryFunctionAdapter<absl::StatusOr<Value>, const MapValue&,
+                            const MapValue&>::
+          CreateDescriptor(cel::builtin::kMapInsert, false),
+      BinaryFunctionAdapter<absl::StatusOr<Value>, const MapValue&,
+                            const MapValue&>::WrapFunction(MapInsertMap));
+}
+
 }  // namespace
 
 absl::Status RegisterContainerFunctions(FunctionRegistry& registry,
@@ -119,13 +178,15 @@ absl::Status RegisterContainerFunctions(FunctionRegistry& registry,
                               const ListValue&>::WrapFunction(ConcatList)));
   }
 
-  return registry.Register(
+  CEL_RETURN_IF_ERROR(registry.Register(
       BinaryFunctionAdapter<
           absl::StatusOr<ListValue>, ListValue,
           const Value&>::CreateDescriptor(cel::builtin::kRuntimeListAppend,
                                           false),
       BinaryFunctionAdapter<absl::StatusOr<ListValue>, ListValue,
-                            const Value&>::WrapFunction(AppendList));
+                            const Value&>::WrapFunction(AppendList)));
+
+  return RegisterMapInsertFunctions(registry);
 }
 
 }  // namespace cel
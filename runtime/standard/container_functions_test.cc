@@ -92,6 +92,25 @@ TEST(RegisterContainerFunctions, RegisterRuntimeListAppend) {
                   std::vector<Kind>{Kind::kList, Kind::kAny})));
 }
 
+TEST(RegisterContainerFunctions, RegisterMapInsert) {
+  FunctionRegistry registry;
+  RuntimeOptions options;
+
+  ASSERT_OK(RegisterContainerFunctions(registry, options));
+
+  EXPECT_THAT(
+      registry.FindStaticOverloads(builtin::kMapInsert, false,
+                                   {Kind::kAny, Kind::kAny, Kind::kAny}),
+      UnorderedElementsAre(MatchesDescriptor(
+          builtin::kMapInsert, false,
+          std::vector<Kind>{Kind::kMap, Kind::kAny, Kind::kAny})));
+  EXPECT_THAT(registry.FindStaticOverloads(builtin::kMapInsert, false,
+                                           {Kind::kAny, Kind::kAny}),
+              UnorderedElementsAre(MatchesDescriptor(
+                  builtin::kMapInsert, false,
+                  std::vector<Kind>{Kind::kMap, Kind::kMap})));
+}
+
 // TODO: move functional parsed expr tests when modern APIs for
 // evaluator available.
 
@@ -13,13 +13,17 @@
 // limitations under the License.
 #include "runtime/standard/regex_functions.h"
 
+#include <memory>
+
 #include "absl/status/status.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
 #include "base/builtins.h"
 #include "base/function_adapter.h"
 #include "common/value.h"
 #include "common/value_manager.h"
 #include "internal/status_macros.h"
+#include "runtime/regex_cache.h"
 #include "re2/re2.h"
 
 namespace cel {
@@ -28,21 +32,30 @@ namespace {}  // namespace
 absl::Status RegisterRegexFunctions(FunctionRegistry& registry,
                                     const RuntimeOptions& options) {
   if (options.enable_regex) {
-    auto regex_matches = [max_size = options.regex_max_program_size](
+    auto regex_matches = [max_size = options.regex_max_program_size,
+                          cache = options.regex_cache](
                              ValueManager& value_factory,
                              const StringValue& target,
                              const StringValue& regex) -> Value {
-      RE2 re2(regex.ToString());
-      if (max_size > 0 && re2.ProgramSize() > max_size) {
+      std::shared_ptr<const RE2> cached;
+      absl::optional<RE2> compiled;
+      const RE2* re2;
+      if (cache != nullptr) {
+        cached = cache->GetOrCompile(regex.ToString());
+        re2 = cached.get();
+      } else {
+        re2 = &compiled.emplace(regex.ToString());
+      }
+      if (max_size > 0 && re2->ProgramSize() > max_size) {
         return value_factory.CreateErrorValue(
             absl::InvalidArgumentError("exceeded RE2 max program size"));
       }
-      if (!re2.ok()) {
+      if (!re2->ok()) {
         return value_factory.CreateErrorValue(
             absl::InvalidArgumentError("invalid regex for match"));
       }
       return value_factory.CreateBoolValue(
-          RE2::PartialMatch(target.ToString(), re2));
+          RE2::PartialMatch(target.ToString(), *re2));
     };
 
     // bind str.matches(re) and matches(str, re)
@@ -14,9 +14,15 @@
 
 #include "runtime/standard/string_functions.h"
 
+#include <cstddef>
+#include <string>
+
+#include "absl/functional/overload.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/cord.h"
 #include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "base/builtins.h"
 #include "base/function_adapter.h"
@@ -28,6 +34,48 @@
 namespace cel {
 namespace {
 
+// Concatenations producing at least this many bytes are built as a rope
+// (`absl::Cord`) instead of a flat string. Repeatedly appending to a growing
+// string, such as an accumulator in a comprehension, then shares the existing
+// contents rather than copying them for every `_+_`, which would make building
+// the string quadratic in its final length. Readers needing a flat view
+// flatten it on demand.
+constexpr size_t kConcatRopeThreshold = 512;
+
+template <typename T>
+size_t ByteSize(const T& value) {
+  return value.NativeValue(
+      [](const auto& native) -> size_t { return native.size(); });
+}
+
+template <typename T>
+bool IsRope(const T& value) {
+  return value.NativeValue(absl::Overload(
+      [](absl::string_view) -> bool { return false; },
+      [](const absl::Cord&) -> bool { return true; }));
+}
+
+template <typename T>
+bool ShouldConcatAsRope(const T& value1, const T& value2) {
+  return IsRope(value1) ||
+         ByteSize(value1) + ByteSize(value2) >= kConcatRopeThreshold;
+}
+
+template <typename T>
+absl::Cord ConcatRope(const T& value1, const T& value2) {
+  absl::Cord result = value1.NativeCord();
+  result.Append(value2.NativeCord());
+  return result;
+}
+
+template <typename T>
+std::string ConcatFlat(const T& value1, const T& value2) {
+  std::string scratch1;
+  std::string scratch2;
+  return absl::StrCat(value1.NativeString(scratch1),
+                      value2.NativeString(scratch2));
+}
+
 // Concatenation for string type.
 absl::StatusOr<StringValue> ConcatString(ValueManager& factory,
                                          const StringValue& value1,
@@ -35,8 +83,10 @@ absl::StatusOr<StringValue> ConcatString(ValueManager& factory,
   // TODO: use StringValue::Concat when remaining interop usages
   // removed. Modern concat implementation forces additional copies when
   // converting to legacy string values.
-  return factory.CreateUncheckedStringValue(
-      absl::StrCat(value1.ToString(), value2.ToString()));
+  if (ShouldConcatAsRope(value1, value2)) {
+    return factory.CreateUncheckedStringValue(ConcatRope(value1, value2));
+  }
+  return factory.CreateUncheckedStringValue(ConcatFlat(value1, value2));
 }
 
 // Concatenation for bytes type.
@@ -46,8 +96,10 @@ absl::StatusOr<BytesValue> ConcatBytes(ValueManager& factory,
   // TODO: use BytesValue::Concat when remaining interop usages
   // removed. Modern concat implementation forces additional copies when
   // converting to legacy string values.
-  return factory.CreateBytesValue(
-      absl::StrCat(value1.ToString(), value2.ToString()));
+  if (ShouldConcatAsRope(value1, value2)) {
+    return factory.CreateBytesValue(ConcatRope(value1, value2));
+  }
+  return factory.CreateBytesValue(ConcatFlat(value1, value2));
 }
 
 bool StringContains(ValueManager&, const StringValue& value,
@@ -13,16 +13,30 @@
 // limitations under the License.
 #include "runtime/standard/string_functions.h"
 
+#include <string>
 #include <vector>
 
+#include "absl/functional/overload.h"
+#include "absl/strings/cord.h"
+#include "absl/strings/string_view.h"
 #include "base/builtins.h"
+#include "base/function.h"
 #include "base/function_descriptor.h"
+#include "base/kind.h"
+#include "base/type_provider.h"
+#include "common/memory.h"
+#include "common/value.h"
+#include "common/values/legacy_value_manager.h"
 #include "internal/testing.h"
+#include "runtime/function_overload_reference.h"
+#include "runtime/function_registry.h"
+#include "runtime/runtime_options.h"
 
 namespace cel {
 namespace {
 
 using ::testing::IsEmpty;
+using ::testing::SizeIs;
 using ::testing::UnorderedElementsAre;
 
 enum class CallStyle { kFree, kReceiver };
@@ -107,6 +121,50 @@ TEST(RegisterStringFunctions, ConcatSkippedWhenDisabled) {
   EXPECT_THAT(overloads[builtin::kAdd], IsEmpty());
 }
 
+bool IsCord(const StringValue& value) {
+  return value.NativeValue(absl::Overload(
+      [](absl::string_view) -> bool { return false; },
+      [](const absl::Cord&) -> bool { return true; }));
+}
+
+TEST(RegisterStringFunctions, ConcatAccumulatesLargeStringsAsRope) {
+  FunctionRegistry registry;
+  RuntimeOptions options;
+  ASSERT_OK(RegisterStringFunctions(registry, options));
+  std::vector<FunctionOverloadReference> overloads =
+      registry.FindStaticOverloads(builtin::kAdd, /*receiver_style=*/false,
+                                   {Kind::kString, Kind::kString});
+  ASSERT_THAT(overloads, SizeIs(1));
+
+  common_internal::LegacyValueManager value_manager(
+      MemoryManagerRef::ReferenceCounting(), TypeProvider::Builtin());
+  Function::InvokeContext context(value_manager);
+
+  // Mirrors `accu + x` in a comprehension.
+  std::string expected;
+  Value accu = StringValue();
+  for (int i = 0; i < 1000; ++i) {
+    ASSERT_OK_AND_ASSIGN(
+        accu, overloads[0].implementation.Invoke(
+                  context, {accu, value_manager.CreateUncheckedStringValue(
+                                      "0123456789")}));
+    expected.append("0123456789");
+    ASSERT_TRUE(accu.IsString());
+  }
+  EXPECT_EQ(accu.GetString().NativeString(), expected);
+  EXPECT_TRUE(IsCord(accu.GetString()));
+
+  // Small results stay flat.
+  ASSERT_OK_AND_ASSIGN(
+      Value small,
+      overloads[0].implementation.Invoke(
+          context, {value_manager.CreateUncheckedStringValue("foo"),
+                    value_manager.CreateUncheckedStringValue("bar")}));
+  ASSERT_TRUE(small.IsString());
+  EXPECT_EQ(small.GetString().NativeString(), "foobar");
+  EXPECT_FALSE(IsCord(small.GetString()));
+}
+
 // TODO: move functional parsed expr tests when modern APIs for
 // evaluator available.
 
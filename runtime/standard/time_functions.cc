@@ -18,15 +18,16 @@
 #include <string>
 
 #include "absl/status/status.h"
-#include "absl/strings/match.h"
-#include "absl/strings/str_replace.h"
+#include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
+#include "absl/time/time.h"
 #include "base/builtins.h"
 #include "base/function_adapter.h"
 #include "common/value.h"
 #include "common/value_manager.h"
 #include "internal/overflow.h"
 #include "internal/status_macros.h"
+#include "runtime/internal/time_zone_cache.h"
 
 namespace cel {
 namespace {
@@ -34,35 +35,12 @@ namespace {
 // Timestamp
 absl::Status FindTimeBreakdown(absl::Time timestamp, absl::string_view tz,
                                absl::TimeZone::CivilInfo* breakdown) {
-  absl::TimeZone time_zone;
-
-  // Early return if there is no timezone.
-  if (tz.empty()) {
-    *breakdown = time_zone.At(timestamp);
-    return absl::OkStatus();
-  }
-
-  // Check to see whether the timezone is an IANA timezone.
-  if (absl::LoadTimeZone(tz, &time_zone)) {
-    *breakdown = time_zone.At(timestamp);
-    return absl::OkStatus();
-  }
-
-  // Check for times of the format: [+-]HH:MM and convert them into durations
-  // specified as [+-]HHhMMm.
-  if (absl::StrContains(tz, ":")) {
-    std::string dur = absl::StrCat(tz, "m");
-    absl::StrReplaceAll({{":", "h"}}, &dur);
-    absl::Duration d;
-    if (absl::ParseDuration(dur, &d)) {
-      timestamp += d;
-      *breakdown = time_zone.At(timestamp);
-      return absl::OkStatus();
-    }
-  }
-
-  // Otherwise, error.
-  return absl::InvalidArgumentError("Invalid timezone");
+  // Named zones and fixed offsets are resolved through a process-wide cache,
+  // avoiding the zoneinfo lookup and offset parsing on every call.
+  CEL_ASSIGN_OR_RETURN(runtime_internal::ResolvedTimeZone time_zone,
+                       runtime_internal::ResolveTimeZone(tz));
+  *breakdown = time_zone.At(timestamp);
+  return absl::OkStatus();
 }
 
 Value GetTimeBreakdownPart(
@@ -176,7 +154,8 @@ absl::Status RegisterTimestampFunctions(FunctionRegistry& registry,
       BinaryFunctionAdapter<Value, absl::Time, const StringValue&>::
           WrapFunction([](ValueManager& value_factory, absl::Time ts,
                           const StringValue& tz) -> Value {
-            return GetFullYear(value_factory, ts, tz.ToString());
+            std::string scratch;
+            return GetFullYear(value_factory, ts, tz.NativeString(scratch));
           })));
 
   CEL_RETURN_IF_ERROR(registry.Register(
@@ -193,7 +172,8 @@ absl::Status RegisterTimestampFunctions(FunctionRegistry& registry,
       BinaryFunctionAdapter<Value, absl::Time, const StringValue&>::
           WrapFunction([](ValueManager& value_factory, absl::Time ts,
                           const StringValue& tz) -> Value {
-            return GetMonth(value_factory, ts, tz.ToString());
+            std::string scratch;
+            return GetMonth(value_factory, ts, tz.NativeString(scratch));
           })));
 
   CEL_RETURN_IF_ERROR(registry.Register(
@@ -210,7 +190,8 @@ absl::Status RegisterTimestampFunctions(FunctionRegistry& registry,
       BinaryFunctionAdapter<Value, absl::Time, const StringValue&>::
           WrapFunction([](ValueManager& value_factory, absl::Time ts,
                           const StringValue& tz) -> Value {
-            return GetDayOfYear(value_factory, ts, tz.ToString());
+            std::string scratch;
+            return GetDayOfYear(value_factory, ts, tz.NativeString(scratch));
           })));
 
   CEL_RETURN_IF_ERROR(registry.Register(
@@ -227,7 +208,8 @@ absl::Status RegisterTimestampFunctions(FunctionRegistry& registry,
       BinaryFunctionAdapter<Value, absl::Time, const StringValue&>::
           WrapFunction([](ValueManager& value_factory, absl::Time ts,
                           const StringValue& tz) -> Value {
-            return GetDayOfMonth(value_factory, ts, tz.ToString());
+            std::string scratch;
+            return GetDayOfMonth(value_factory, ts, tz.NativeString(scratch));
           })));
 
   CEL_RETURN_IF_ERROR(registry.Register(
@@ -244,7 +226,8 @@ absl::Status RegisterTimestampFunctions(FunctionRegistry& registry,
       BinaryFunctionAdapter<Value, absl::Time, const StringValue&>::
           WrapFunction([](ValueManager& value_factory, absl::Time ts,
                           const StringValue& tz) -> Value {
-            return GetDate(value_factory, ts, tz.ToString());
+            std::string scratch;
+            return GetDate(value_factory, ts, tz.NativeString(scratch));
           })));
 
   CEL_RETURN_IF_ERROR(registry.Register(
@@ -261,7 +244,8 @@ absl::Status RegisterTimestampFunctions(FunctionRegistry& registry,
       BinaryFunctionAdapter<Value, absl::Time, const StringValue&>::
           WrapFunction([](ValueManager& value_factory, absl::Time ts,
                           const StringValue& tz) -> Value {
-            return GetDayOfWeek(value_factory, ts, tz.ToString());
+            std::string scratch;
+            return GetDayOfWeek(value_factory, ts, tz.NativeString(scratch));
           })));
 
   CEL_RETURN_IF_ERROR(registry.Register(
@@ -278,7 +262,8 @@ absl::Status RegisterTimestampFunctions(FunctionRegistry& registry,
       BinaryFunctionAdapter<Value, absl::Time, const StringValue&>::
           WrapFunction([](ValueManager& value_factory, absl::Time ts,
                           const StringValue& tz) -> Value {
-            return GetHours(value_factory, ts, tz.ToString());
+            std::string scratch;
+            return GetHours(value_factory, ts, tz.NativeString(scratch));
           })));
 
   CEL_RETURN_IF_ERROR(registry.Register(
@@ -295,7 +280,8 @@ absl::Status RegisterTimestampFunctions(FunctionRegistry& registry,
       BinaryFunctionAdapter<Value, absl::Time, const StringValue&>::
           WrapFunction([](ValueManager& value_factory, absl::Time ts,
                           const StringValue& tz) -> Value {
-            return GetMinutes(value_factory, ts, tz.ToString());
+            std::string scratch;
+            return GetMinutes(value_factory, ts, tz.NativeString(scratch));
           })));
 
   CEL_RETURN_IF_ERROR(registry.Register(
@@ -312,7 +298,8 @@ absl::Status RegisterTimestampFunctions(FunctionRegistry& registry,
       BinaryFunctionAdapter<Value, absl::Time, const StringValue&>::
           WrapFunction([](ValueManager& value_factory, absl::Time ts,
                           const StringValue& tz) -> Value {
-            return GetSeconds(value_factory, ts, tz.ToString());
+            std::string scratch;
+            return GetSeconds(value_factory, ts, tz.NativeString(scratch));
           })));
 
   CEL_RETURN_IF_ERROR(registry.Register(
@@ -329,7 +316,8 @@ absl::Status RegisterTimestampFunctions(FunctionRegistry& registry,
       BinaryFunctionAdapter<Value, absl::Time, const StringValue&>::
           WrapFunction([](ValueManager& value_factory, absl::Time ts,
                           const StringValue& tz) -> Value {
-            return GetMilliseconds(value_factory, ts, tz.ToString());
+            std::string scratch;
+            return GetMilliseconds(value_factory, ts, tz.NativeString(scratch));
           })));
 
   return registry.Register(
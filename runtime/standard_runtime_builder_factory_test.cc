@@ -18,6 +18,7 @@
 #include <memory>
 #include <ostream>
 #include <string>
+#include <thread>  // NOLINT(build/c++11)
 #include <utility>
 #include <vector>
 
@@ -27,6 +28,7 @@
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
 #include "common/memory.h"
 #include "common/source.h"
 #include "common/value.h"
@@ -167,6 +169,37 @@ TEST_P(StandardRuntimeTest, Recursive) {
       << test_case.expression;
 }
 
+TEST_P(StandardRuntimeTest, LocalReferenceCounting) {
+  RuntimeOptions opts;
+  opts.enable_local_reference_counting = true;
+  const EvaluateResultTestCase& test_case = GetTestCase();
+
+  ASSERT_OK_AND_ASSIGN(auto builder,
+                       CreateStandardRuntimeBuilder(
+                           google::protobuf::DescriptorPool::generated_pool(), opts));
+
+  ASSERT_OK_AND_ASSIGN(auto runtime, std::move(builder).Build());
+
+  ASSERT_OK_AND_ASSIGN(ParsedExpr expr,
+                       ParseWithTestMacros(test_case.expression));
+
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<Program> program,
+                       ProtobufRuntimeAdapter::CreateProgram(*runtime, expr));
+
+  common_internal::LegacyValueManager value_factory(memory_manager(),
+                                                    runtime->GetTypeProvider());
+
+  Activation activation;
+  if (test_case.activation_builder != nullptr) {
+    ASSERT_OK(test_case.activation_builder(value_factory, activation));
+  }
+
+  ASSERT_OK_AND_ASSIGN(Value result,
+                       program->Evaluate(activation, value_factory));
+  EXPECT_THAT(result, BoolValueIs(test_case.expected_result))
+      << test_case.expression;
+}
+
 INSTANTIATE_TEST_SUITE_P(
     Basic, StandardRuntimeTest,
     testing::Combine(
@@ -601,5 +634,46 @@ TEST(StandardRuntimeTest, RuntimeIssueSupport) {
   }
 }
 
+// A lazily provided value is cached in the activation and shared by every
+// evaluation using it, so it must not be created with local reference counts.
+TEST(StandardRuntimeTest, LocalReferenceCountingSharedActivation) {
+  RuntimeOptions opts;
+  opts.enable_local_reference_counting = true;
+  ASSERT_OK_AND_ASSIGN(auto builder,
+                       CreateStandardRuntimeBuilder(
+                           google::protobuf::DescriptorPool::generated_pool(), opts));
+  ASSERT_OK_AND_ASSIGN(auto runtime, std::move(builder).Build());
+  ASSERT_OK_AND_ASSIGN(ParsedExpr expr, Parse("x + x"));
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<Program> program,
+                       ProtobufRuntimeAdapter::CreateProgram(*runtime, expr));
+
+  // Long enough not to be stored inline.
+  const std::string text(64, 'a');
+  Activation activation;
+  activation.InsertOrAssignValueProvider(
+      "x",
+      [&text](ValueManager& value_factory,
+              absl::string_view) -> absl::StatusOr<absl::optional<Value>> {
+        return value_factory.CreateUncheckedStringValue(text);
+      });
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&]() {
+      for (int j = 0; j < 100; ++j) {
+        ManagedValueFactory value_factory(
+            program->GetTypeProvider(), MemoryManagerRef::ReferenceCounting());
+        ASSERT_OK_AND_ASSIGN(
+            Value result, program->Evaluate(activation, value_factory.get()));
+        ASSERT_TRUE(result.IsString());
+        EXPECT_EQ(result.GetString().NativeString(), text + text);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
 }  // namespace
 }  // namespace cel